@@ -2,7 +2,7 @@
  * 
  * Ads1015 class member functions for configuration and reading with I2C. 
  *       
- * Copyright (C) 2020 Jaakko Koivuniemi.
+ * Copyright (C) 2020 - 2026 Jaakko Koivuniemi.
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -20,7 +20,7 @@
  ****************************************************************************
  *
  * Sat Aug  8 20:19:22 CDT 2020
- * Edit: Thu 13 Aug 2020 07:47:45 PM CDT
+ * Edit: Sat Oct 17 12:14:09 CDT 2026
  *
  * Jaakko Koivuniemi
  **/
@@ -37,8 +37,7 @@ int16_t Ads1015::GetHighThreshold()
 {
   int16_t HighThreshold = 0;
 
-  I2Chip::I2cWriteUInt8(ADS1015_HIGH_THRESH_REG, address, buffer, error);
-  HighThreshold = (int16_t)I2Chip::I2cReadUInt16(address, buffer, error);
+  HighThreshold = (int16_t)I2Chip::I2cReadRegisterUInt16(ADS1015_HIGH_THRESH_REG, address, buffer, error);
 
   return HighThreshold;
 }
@@ -49,8 +48,7 @@ int16_t Ads1015::GetLowThreshold()
 {
   int16_t LowThreshold = 0;
 
-  I2Chip::I2cWriteUInt8(ADS1015_LOW_THRESH_REG, address, buffer, error);
-  LowThreshold = (int16_t)I2Chip::I2cReadUInt16(address, buffer, error);
+  LowThreshold = (int16_t)I2Chip::I2cReadRegisterUInt16(ADS1015_LOW_THRESH_REG, address, buffer, error);
 
   return LowThreshold;
 } 
@@ -61,8 +59,7 @@ uint16_t Ads1015::GetConfig()
 {
   uint16_t Config = 0;
 
-  I2Chip::I2cWriteUInt8(ADS1015_CONFIG_REG, address, buffer, error);
-  Config = I2Chip::I2cReadUInt16(address, buffer, error);
+  Config = I2Chip::I2cReadRegisterUInt16(ADS1015_CONFIG_REG, address, buffer, error);
 
   return Config;
 } 
@@ -2,7 +2,7 @@
  * 
  * Bme680 class member functions for configuration and reading with I2C. 
  *       
- * Copyright (C) 2020 Jaakko Koivuniemi.
+ * Copyright (C) 2020 - 2026 Jaakko Koivuniemi.
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -20,7 +20,7 @@
  ****************************************************************************
  *
  * Thu Jul  9 15:23:16 CDT 2020
- * Edit: Wed Jul 15 09:08:40 CDT 2020
+ * Edit: Sat Oct 17 14:21:05 CDT 2026
  *
  * Jaakko Koivuniemi
  **/
@@ -69,8 +69,7 @@ uint8_t Bme680::GetID()
 {
   uint8_t ID = 0;
 
-  I2Chip::I2cWriteUInt8(BME680_ID_REG, address, buffer, error);
-  ID = I2Chip::I2cReadUInt8(address, buffer, error);
+  ID = I2Chip::I2cReadRegisterUInt8(BME680_ID_REG, address, buffer, error);
 
   return ID;
 }
@@ -80,8 +79,7 @@ uint8_t Bme680::GetConfig()
 {
   uint8_t config = 0;
 
-  I2Chip::I2cWriteUInt8(BME680_CONFIG_REG, address, buffer, error);
-  config = I2Chip::I2cReadUInt8(address, buffer, error);
+  config = I2Chip::I2cReadRegisterUInt8(BME680_CONFIG_REG, address, buffer, error);
 
   return config;
 }
@@ -92,8 +90,7 @@ uint8_t Bme680::GetControlMeasurement()
 {
   uint8_t ctrlmeas = 0;
 
-  I2Chip::I2cWriteUInt8(BME680_CTRL_MEAS_REG, address, buffer, error);
-  ctrlmeas = I2Chip::I2cReadUInt8(address, buffer, error);
+  ctrlmeas = I2Chip::I2cReadRegisterUInt8(BME680_CTRL_MEAS_REG, address, buffer, error);
 
   return ctrlmeas;
 } 
@@ -103,8 +100,7 @@ uint8_t Bme680::GetHumidityControl()
 {
   uint8_t ctrlhum = 0;
 
-  I2Chip::I2cWriteUInt8(BME680_CTRL_HUM_REG, address, buffer, error);
-  ctrlhum = I2Chip::I2cReadUInt8(address, buffer, error);
+  ctrlhum = I2Chip::I2cReadRegisterUInt8(BME680_CTRL_HUM_REG, address, buffer, error);
 
   return ctrlhum;
 }
@@ -114,8 +110,7 @@ uint8_t Bme680::GetGasControl1()
 {
   uint8_t gasctrl1 = 0;
 
-  I2Chip::I2cWriteUInt8(BME680_CTRL_GAS1_REG, address, buffer, error);
-  gasctrl1 = I2Chip::I2cReadUInt8(address, buffer, error);
+  gasctrl1 = I2Chip::I2cReadRegisterUInt8(BME680_CTRL_GAS1_REG, address, buffer, error);
 
   return gasctrl1;
 }
@@ -125,8 +120,7 @@ uint8_t Bme680::GetGasControl0()
 {
   uint8_t gasctrl0 = 0;
 
-  I2Chip::I2cWriteUInt8(BME680_CTRL_GAS0_REG, address, buffer, error);
-  gasctrl0 = I2Chip::I2cReadUInt8(address, buffer, error);
+  gasctrl0 = I2Chip::I2cReadRegisterUInt8(BME680_CTRL_GAS0_REG, address, buffer, error);
 
   return gasctrl0;
 }
@@ -136,8 +130,7 @@ uint8_t Bme680::GetMeasStatus()
 {
   uint8_t status = 0;
 
-  I2Chip::I2cWriteUInt8(BME680_MEAS_STATUS0_REG, address, buffer, error);
-  status = I2Chip::I2cReadUInt8(address, buffer, error);
+  status = I2Chip::I2cReadRegisterUInt8(BME680_MEAS_STATUS0_REG, address, buffer, error);
 
   return status;
 }
@@ -187,15 +180,13 @@ void Bme680::SetOverSample(uint8_t HOverSample, uint8_t TOverSample, uint8_t POv
 {
   uint8_t ctrl_hum = 0, ctrl_meas = 0;
 
-  I2Chip::I2cWriteUInt8(BME680_CTRL_HUM_REG, address, buffer, error);
-  ctrl_hum = I2Chip::I2cReadUInt8(address, buffer, error);
+  ctrl_hum = I2Chip::I2cReadRegisterUInt8(BME680_CTRL_HUM_REG, address, buffer, error);
 
   HOverSample &= 0x07;
   ctrl_hum &= 0xF8;
   ctrl_hum |= HOverSample;
 
-  I2Chip::I2cWriteUInt8(BME680_CTRL_MEAS_REG, address, buffer, error);
-  ctrl_meas = I2Chip::I2cReadUInt8(address, buffer, error);
+  ctrl_meas = I2Chip::I2cReadRegisterUInt8(BME680_CTRL_MEAS_REG, address, buffer, error);
 
   TOverSample &= 0x07;
   TOverSample = TOverSample << 5;
@@ -221,8 +212,7 @@ void Bme680::SetMode(uint8_t Mode)
 {
   uint8_t ctrl_meas = 0;
 
-  I2Chip::I2cWriteUInt8(BME680_CTRL_MEAS_REG, address, buffer, error);
-  ctrl_meas = I2Chip::I2cReadUInt8(address, buffer, error);
+  ctrl_meas = I2Chip::I2cReadRegisterUInt8(BME680_CTRL_MEAS_REG, address, buffer, error);
   
   Mode &= 0x03;
   ctrl_meas &= 0xFC;
@@ -237,8 +227,7 @@ void Bme680::SetHeaterProfile(uint8_t Profile)
 {
   uint8_t ctrl_gas1 = 0;
 
-  I2Chip::I2cWriteUInt8(BME680_CTRL_GAS1_REG, address, buffer, error);
-  ctrl_gas1 = I2Chip::I2cReadUInt8(address, buffer, error);
+  ctrl_gas1 = I2Chip::I2cReadRegisterUInt8(BME680_CTRL_GAS1_REG, address, buffer, error);
   
   Profile &= 0x0F;
   ctrl_gas1 &= 0xF0;
@@ -272,10 +261,9 @@ void Bme680::SetGasHeatCurrent(uint8_t Profile, uint8_t I)
   I2Chip::I2cWriteRegisterUInt8(reg, I, address, buffer, error);
 }
 
-// Set gas heater temperature profile 0 - 9.
-void Bme680::SetGasHeatTemperature(uint8_t Profile, int8_t Tamb, uint16_t T)
+// Heater resistance from calibration data read with GetCalibration().
+uint8_t Bme680::HeatResistance(int8_t Tamb, uint16_t T)
 {
-  uint8_t reg = BME680_GAS_RES_HEAT_REG + Profile;;
   uint8_t heatres = 0;
   int32_t var1 = 0, var2 = 0, var3 = 0, var4 = 0, var5 = 0;
   int32_t heatresx100 = 0; 
@@ -288,18 +276,83 @@ void Bme680::SetGasHeatTemperature(uint8_t Profile, int8_t Tamb, uint16_t T)
   heatresx100 = (int32_t)((( var4 / var5 ) - 250 ) * 34 );
   heatres = (uint8_t)(( heatresx100 + 50) / 100);
 
+  return heatres;
+}
+
+// Set gas heater temperature profile 0 - 9.
+void Bme680::SetGasHeatTemperature(uint8_t Profile, int8_t Tamb, uint16_t T)
+{
+  uint8_t reg = BME680_GAS_RES_HEAT_REG + Profile;;
+  uint8_t heatres = 0;
+
+  heatres = Bme680::HeatResistance(Tamb, T);
+
   fprintf(stderr, SD_DEBUG "res_heat_%d = %d\n", Profile, heatres);
   
   I2Chip::I2cWriteRegisterUInt8(reg, heatres, address, buffer, error);
 }
 
+// Compute control, configuration and heater registers from profile without
+// reading the chip. Calibration data must be read first. The chip has no
+// auto-increment for writes so the registers are sent as register and data
+// pairs in one transfer. Error -7 is set for values out of range.
+bool Bme680::ApplyProfile(const Bme680Profile & Profile)
+{
+  uint8_t ctrl_gas0 = 0, ctrl_gas1 = 0, ctrl_hum = 0, ctrl_meas = 0, config = 0;
+  uint8_t heatres = 0;
+
+  bool valid = ( Profile.HOverSample <= 5 ) && ( Profile.TOverSample <= 5 ) && ( Profile.POverSample <= 5 ) && ( Profile.Filter <= 7 ) && ( Profile.Mode <= 1 ) && ( Profile.HeaterProfile <= 9 );
+  for(int i = 0; i < 10; i++) if( Profile.HeatTemperature[ i ] > 400 ) valid = false;
+
+  if( !valid )
+  {
+    fprintf(stderr, SD_ERR "%s profile value out of range\n", name.c_str() );
+    error = -7;
+    return false;
+  }
+
+  if( Profile.HeaterOff ) ctrl_gas0 = 0x08;
+
+  if( Profile.RunGas ) ctrl_gas1 = 0x10;
+  ctrl_gas1 |= Profile.HeaterProfile;
+
+  ctrl_hum = Profile.HOverSample;
+
+  ctrl_meas = Profile.TOverSample << 5;
+  ctrl_meas |= Profile.POverSample << 2;
+  ctrl_meas |= Profile.Mode;
+
+  config = Profile.Filter << 2;
+
+  I2Chip::ShadowDefer();
+
+  for(int i = 0; i < 10; i++)
+  {
+    if( Profile.HeatTemperature[ i ] == 0 ) continue;
+
+    heatres = Bme680::HeatResistance(Profile.Tamb, Profile.HeatTemperature[ i ]);
+    fprintf(stderr, SD_DEBUG "res_heat_%d = %d\n", i, heatres);
+
+    I2Chip::ShadowWriteUInt8(BME680_GAS_RES_HEAT_REG + i, heatres, address, buffer, error);
+    I2Chip::ShadowWriteUInt8(BME680_GAS_WAIT_REG + i, Profile.GasWaitTime[ i ], address, buffer, error);
+  }
+
+  I2Chip::ShadowWriteUInt8(BME680_CTRL_GAS0_REG, ctrl_gas0, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(BME680_CTRL_GAS1_REG, ctrl_gas1, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(BME680_CTRL_HUM_REG, ctrl_hum, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(BME680_CTRL_MEAS_REG, ctrl_meas, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(BME680_CONFIG_REG, config, address, buffer, error);
+  I2Chip::ShadowFlush(address, buffer, error);
+
+  return ( error == 0 );
+}
+
 // Run gas conversions.
 void Bme680::RunGas()
 {
   uint8_t ctrl_gas1 = 0;
 
-  I2Chip::I2cWriteUInt8(BME680_CTRL_GAS1_REG, address, buffer, error);
-  ctrl_gas1 = I2Chip::I2cReadUInt8(address, buffer, error);
+  ctrl_gas1 = I2Chip::I2cReadRegisterUInt8(BME680_CTRL_GAS1_REG, address, buffer, error);
   
   ctrl_gas1 |= 0x10;;
 
@@ -312,8 +365,7 @@ void Bme680::NoGas()
 {
   uint8_t ctrl_gas1 = 0;
 
-  I2Chip::I2cWriteUInt8(BME680_CTRL_GAS1_REG, address, buffer, error);
-  ctrl_gas1 = I2Chip::I2cReadUInt8(address, buffer, error);
+  ctrl_gas1 = I2Chip::I2cReadRegisterUInt8(BME680_CTRL_GAS1_REG, address, buffer, error);
   
   ctrl_gas1 &= 0xEF;;
 
@@ -325,8 +377,7 @@ void Bme680::SetFilter(uint8_t Filter)
 {
   uint8_t config = 0;
 
-  I2Chip::I2cWriteUInt8(BME680_CONFIG_REG, address, buffer, error);
-  config = I2Chip::I2cReadUInt8(address, buffer, error);
+  config = I2Chip::I2cReadRegisterUInt8(BME680_CONFIG_REG, address, buffer, error);
   
   Filter &= 0x07;
   Filter = Filter << 2;
@@ -342,8 +393,7 @@ bool Bme680::IsNewData()
   bool newdata = false;
   uint8_t status = 0;
 
-  I2Chip::I2cWriteUInt8(BME680_MEAS_STATUS0_REG, address, buffer, error);
-  status = I2Chip::I2cReadUInt8(address, buffer, error);
+  status = I2Chip::I2cReadRegisterUInt8(BME680_MEAS_STATUS0_REG, address, buffer, error);
 
   if( (status & 0x80) == 0x80 ) newdata = true; else newdata = false;
 
@@ -356,8 +406,7 @@ bool Bme680::IsGasMeasuring()
   bool measuring = false;
   uint8_t status = 0;
 
-  I2Chip::I2cWriteUInt8(BME680_MEAS_STATUS0_REG, address, buffer, error);
-  status = I2Chip::I2cReadUInt8(address, buffer, error);
+  status = I2Chip::I2cReadRegisterUInt8(BME680_MEAS_STATUS0_REG, address, buffer, error);
 
   if( (status & 0x40) == 0x40 ) measuring = true; else measuring = false;
 
@@ -370,8 +419,7 @@ bool Bme680::IsMeasuring()
   bool measuring = false;
   uint8_t status = 0;
 
-  I2Chip::I2cWriteUInt8(BME680_MEAS_STATUS0_REG, address, buffer, error);
-  status = I2Chip::I2cReadUInt8(address, buffer, error);
+  status = I2Chip::I2cReadRegisterUInt8(BME680_MEAS_STATUS0_REG, address, buffer, error);
 
   if( (status & 0x20) == 0x20 ) measuring = true; else measuring = false;
 
@@ -389,8 +437,7 @@ void Bme680::Sleep()
 {
   uint8_t ctrl_meas = 0;
 
-  I2Chip::I2cWriteUInt8(BME680_CTRL_MEAS_REG, address, buffer, error);
-  ctrl_meas = I2Chip::I2cReadUInt8(address, buffer, error);
+  ctrl_meas = I2Chip::I2cReadRegisterUInt8(BME680_CTRL_MEAS_REG, address, buffer, error);
   
   ctrl_meas &= 0xFC;
 
@@ -402,8 +449,7 @@ void Bme680::Forced()
 {
   uint8_t ctrl_meas = 0;
 
-  I2Chip::I2cWriteUInt8(BME680_CTRL_MEAS_REG, address, buffer, error);
-  ctrl_meas = I2Chip::I2cReadUInt8(address, buffer, error);
+  ctrl_meas = I2Chip::I2cReadRegisterUInt8(BME680_CTRL_MEAS_REG, address, buffer, error);
 
   ctrl_meas &= 0xFD;
   ctrl_meas |= 0x01;
@@ -416,9 +462,7 @@ void Bme680::HeaterOn()
 {
   uint8_t ctrl_gas0;
 
-  I2Chip::I2cWriteUInt8(BME680_CTRL_GAS0_REG, address, buffer, error);
-
-  ctrl_gas0 = I2Chip::I2cReadUInt8(address, buffer, error);
+  ctrl_gas0 = I2Chip::I2cReadRegisterUInt8(BME680_CTRL_GAS0_REG, address, buffer, error);
 
   ctrl_gas0 &= 0xF7;
 
@@ -430,9 +474,7 @@ void Bme680::HeaterOff()
 {
   uint8_t ctrl_gas0;
 
-  I2Chip::I2cWriteUInt8(BME680_CTRL_GAS0_REG, address, buffer, error);
-
-  ctrl_gas0 = I2Chip::I2cReadUInt8(address, buffer, error);
+  ctrl_gas0 = I2Chip::I2cReadRegisterUInt8(BME680_CTRL_GAS0_REG, address, buffer, error);
       
   ctrl_gas0 |= 0x08;
 
@@ -442,7 +484,7 @@ void Bme680::HeaterOff()
 // Read chip calibration data and return true if success.
 bool Bme680::GetCalibration()
 {
-  I2Chip::I2cWriteUInt8(BME680_PAR_T2_REG, address, buffer, error);
+  I2Chip::I2cReadRegisters(BME680_PAR_T2_REG, 23, address, buffer, error);
 
   if( error != 0 )
   {
@@ -450,7 +492,20 @@ bool Bme680::GetCalibration()
   }
   else
   {
-    I2Chip::I2cReadBytes(23, address, buffer, error);
+    par_t2 = (int16_t)( (buffer[ 1 ] << 8) | buffer[ 0 ] );
+    par_t3 = (int8_t)buffer[ 2 ];
+    par_p1 = (uint16_t)( (buffer[ 5 ] << 8) | buffer[ 4 ] );
+    par_p2 = (int16_t)( (buffer[ 7 ] << 8) | buffer[ 6 ] );
+    par_p3 = (int8_t)buffer[ 8 ];
+    par_p4 = (int16_t)( (buffer[ 11 ] << 8) | buffer[ 10 ] );
+    par_p5 = (int16_t)( (buffer[ 13 ] << 8) | buffer[ 12 ] );
+    par_p6 = (int8_t)buffer[ 15 ];
+    par_p7 = (int8_t)buffer[ 14 ];
+    par_p8 = (int16_t)( (buffer[ 19 ] << 8) | buffer[ 18 ] );
+    par_p9 = (int16_t)( (buffer[ 21 ] << 8) | buffer[ 20 ] );
+    par_p10 = (uint8_t)buffer[ 22 ];
+
+    I2Chip::I2cReadRegisters(BME680_PAR_H1H2_REG, 14, address, buffer, error);
 
     if( error != 0 )
     {
@@ -458,20 +513,19 @@ bool Bme680::GetCalibration()
     }
     else
     {
-      par_t2 = (int16_t)( (buffer[ 1 ] << 8) | buffer[ 0 ] );
-      par_t3 = (int8_t)buffer[ 2 ];
-      par_p1 = (uint16_t)( (buffer[ 5 ] << 8) | buffer[ 4 ] );
-      par_p2 = (int16_t)( (buffer[ 7 ] << 8) | buffer[ 6 ] );
-      par_p3 = (int8_t)buffer[ 8 ];
-      par_p4 = (int16_t)( (buffer[ 11 ] << 8) | buffer[ 10 ] );
-      par_p5 = (int16_t)( (buffer[ 13 ] << 8) | buffer[ 12 ] );
-      par_p6 = (int8_t)buffer[ 15 ];
-      par_p7 = (int8_t)buffer[ 14 ];
-      par_p8 = (int16_t)( (buffer[ 19 ] << 8) | buffer[ 18 ] );
-      par_p9 = (int16_t)( (buffer[ 21 ] << 8) | buffer[ 20 ] );
-      par_p10 = (uint8_t)buffer[ 22 ];
-
-      I2Chip::I2cWriteUInt8(BME680_PAR_H1H2_REG, address, buffer, error);
+      par_h1 = (uint16_t)( buffer[ 2 ] << 4 | ( buffer[ 1 ] & 0x0F ) );
+      par_h2 = (uint16_t)( (buffer[ 0 ] << 4) | ( buffer[ 1 ] >> 4 ) );
+      par_h3 = (int8_t)buffer[ 3 ];
+      par_h4 = (int8_t)buffer[ 4 ];
+      par_h5 = (int8_t)buffer[ 5 ];
+      par_h6 = (uint8_t)buffer[ 6 ];
+      par_h7 = (int8_t)buffer[ 7 ];
+      par_t1 = (int16_t)( (buffer[ 9 ] << 8) | buffer[ 8 ] );
+      par_g2 = (int16_t)( (buffer[ 11 ] << 8) | buffer[ 10 ] );
+      par_g1 = (int8_t)buffer[ 12 ];
+      par_g3 = (int8_t)buffer[ 13 ];
+
+      I2Chip::I2cReadRegisters(BME680_RANGE_SWITCHING_ERROR_REG, 1, address, buffer, error);
 
       if( error != 0 )
       {
@@ -479,7 +533,9 @@ bool Bme680::GetCalibration()
       }
       else
       {
-        I2Chip::I2cReadBytes(14, address, buffer, error);
+        range_sw_error = ( (int8_t)buffer[ 0 ] ) / 16;
+
+        I2Chip::I2cReadRegisters(BME680_RES_HEAT_RANGE_REG, 1, address, buffer, error);
 
         if( error != 0 )
         {
@@ -487,76 +543,19 @@ bool Bme680::GetCalibration()
         }
         else
         {
-          par_h1 = (uint16_t)( buffer[ 2 ] << 4 | ( buffer[ 1 ] & 0x0F ) );
-          par_h2 = (uint16_t)( (buffer[ 0 ] << 4) | ( buffer[ 1 ] >> 4 ) );
-          par_h3 = (int8_t)buffer[ 3 ];
-          par_h4 = (int8_t)buffer[ 4 ];
-          par_h5 = (int8_t)buffer[ 5 ];
-          par_h6 = (uint8_t)buffer[ 6 ];
-          par_h7 = (int8_t)buffer[ 7 ];
-          par_t1 = (int16_t)( (buffer[ 9 ] << 8) | buffer[ 8 ] );
-          par_g2 = (int16_t)( (buffer[ 11 ] << 8) | buffer[ 10 ] );
-          par_g1 = (int8_t)buffer[ 12 ];
-	  par_g3 = (int8_t)buffer[ 13 ];
-
-          I2Chip::I2cWriteUInt8(BME680_RANGE_SWITCHING_ERROR_REG, address, buffer, error);
+          res_heat_range = (uint8_t)(buffer[ 0 ] >> 4);
+
+          I2Chip::I2cReadRegisters(BME680_RES_HEAT_VAL_REG, 1, address, buffer, error);
+
           if( error != 0 )
           {
             return false;
           }
           else
           {
-            I2Chip::I2cReadBytes(1, address, buffer, error);
-
-            if( error != 0 )
-	    {
-              return false;
-            }
-            else
-            {
-              range_sw_error = ( (int8_t)buffer[ 0 ] ) / 16;
-
-              I2Chip::I2cWriteUInt8(BME680_RES_HEAT_RANGE_REG, address, buffer, error);
-              if( error != 0 )
-              {
-                return false;
-              }
-              else
-              {
-                I2Chip::I2cReadBytes(1, address, buffer, error);
-
-                if( error != 0 )
-                {
-                  return false;
-                }
-                else
-                {
-                  res_heat_range = (uint8_t)(buffer[ 0 ] >> 4);
-
-                  I2Chip::I2cWriteUInt8(BME680_RES_HEAT_VAL_REG, address, buffer, error);
-
-                  if( error != 0 )
-                  {
-                    return false;
-                  }
-                  else
-                  {
-                    I2Chip::I2cReadBytes(1, address, buffer, error);
-
-                    if( error != 0 )
-                    {
-                      return false;
-                    }
-                    else
-                    {
-                      res_heat_val  = (int8_t)buffer[ 0 ];
-                    }
-		  }
-		}
-	      }
-	    }
-	  }
-	}
+            res_heat_val  = (int8_t)buffer[ 0 ];
+          }
+        }
       }
     }
   }
@@ -614,114 +613,98 @@ int Bme680::GetTPHG()
 
   const uint32_t a2[16] = {4096000000, 2048000000, 1024000000, 512000000, 255744255, 127110228, 64000000, 32258064, 16016016, 8000000, 4000000, 2000000, 1000000, 500000, 250000, 125000};
 
-  I2Chip::I2cWriteUInt8(BME680_PRESS_MSB_REG, address, buffer, error);
+  I2Chip::I2cReadRegisters(BME680_PRESS_MSB_REG, 8, address, buffer, error);
   if( error != 0 )
   {
     return error;
   }
   else
   {
-    I2Chip::I2cReadBytes(8, address, buffer, error);
+    tadc =  (uint32_t)( buffer[ 3 ] << 12 );
+    tadc |= (uint32_t)( buffer[ 4 ] << 4 ); 
+    tadc |= (uint32_t)( buffer[ 5 ] >> 4 ); 
+
+    fprintf(stderr, SD_DEBUG "tadc = %d\n", tadc);
+
+    tvar1 = ( (int32_t)tadc >> 3 ) - ( (int32_t)par_t1 << 1);
+    tvar2 = (tvar1 * (int32_t)par_t2 ) >> 11;
+    tvar3 = ((((tvar1 >> 1) * (tvar1 >> 1)) >> 12) * ((int32_t)par_t3 << 4)) >> 14;
+
+    tfine = (int32_t) (tvar2 + tvar3);
+    Temperature = (int16_t)( (tfine * 5 + 128) >> 8); 
+
+    padc =  (uint32_t)( buffer[ 0 ] << 12 );
+    padc |= (uint32_t)( buffer[ 1 ] << 4 ); 
+    padc |= (uint32_t)( buffer[ 2 ] >> 4 ); 
+
+    fprintf(stderr, SD_DEBUG "padc = %d\n", padc);
+
+    pvar1 = ((int32_t)tfine >> 1) - 64000;
+    pvar2 = ((((pvar1 >> 2) * (pvar1 >> 2)) >> 11) * (int32_t)par_p6) >> 2;
+    pvar2 = pvar2 + ( (pvar1 * (int32_t)par_p5) << 1 );
+    pvar2 = (pvar2 >> 2) + ( (int32_t)par_p4 << 16 );
+    pvar1 = (((((pvar1 >> 2) * (pvar1 >> 2)) >> 13) * ((int32_t)par_p3 << 5)) >> 3 ) + ( ( pvar1 * (int32_t)par_p2) >> 1);
+    pvar1 = pvar1 >> 18;
+    pvar1 = ((32768 + pvar1) * (int32_t)par_p1) >> 15;
+    p = 1048576 - padc;
+    p = (int32_t)((p - (pvar2 >> 12)) * ((uint32_t)3125));
+    if( p >= ( 1 << 30 ) ) 
+      p = ( (p / pvar1 ) << 1);
+    else
+      p = ( (p << 1)/ pvar1 );
+      
+    pvar1 = ((int32_t)par_p9 * (int32_t)(((p >> 3) * (p >> 3)) >> 13 )) >> 12;
+    pvar2 = ((int32_t)(p >> 2) * (int32_t)par_p8) >> 13;
+    pvar3 = ((int32_t)(p >> 8) * (int32_t)(p >> 8) * (int32_t)(p >> 8) * (int32_t)par_p10) >> 17;
+    p = (int32_t)p + ((pvar1 + pvar2 + pvar3 + ((int32_t)par_p7 << 7 )) >> 4);
+    Pressure = (uint32_t)p;
+
+    hadc =  (uint16_t)( buffer[ 6 ] << 8 );
+    hadc |= (uint16_t)( buffer[ 7 ] ); 
+
+    fprintf(stderr, SD_DEBUG "hadc = %d\n", hadc);
+
+    tscaled = (int32_t)Temperature;
+    hvar1 = (int32_t)hadc - (int32_t)((int32_t)par_h1 << 4 ) - (((tscaled * (int32_t)par_h3) / ((int32_t)100)) >> 1);
+    hvar2 = ((int32_t)par_h2 * (((tscaled * (int32_t)par_h4) / ((int32_t)100)) + (((tscaled * ((tscaled * (int32_t)par_h5)/((int32_t)100))) >> 6) / ((int32_t)100)) + ((int32_t)(1 << 14)))) >> 10;
+    hvar3 = hvar1 * hvar2;
+    hvar4 = (((int32_t)par_h6 << 7) + ((tscaled * (int32_t)par_h7) / ((int32_t)100))) >> 4;
+    hvar5 = ((hvar3 >> 14) * (hvar3 >> 14)) >> 10;
+    hvar6 = (hvar4 * hvar5) >> 1;
+    h = (hvar3 + hvar6) >> 12;
+    h = (((hvar3 + hvar6) >> 10) * ((int32_t) 1000)) >> 12;
+    Humidity = (uint32_t)h;
+
+    I2Chip::I2cReadRegisters(BME680_GAS_R_MSB_REG, 2, address, buffer, error);
     if( error != 0 )
     {
       return error;
     }
     else
     {
-      tadc =  (uint32_t)( buffer[ 3 ] << 12 );
-      tadc |= (uint32_t)( buffer[ 4 ] << 4 ); 
-      tadc |= (uint32_t)( buffer[ 5 ] >> 4 ); 
-
-      fprintf(stderr, SD_DEBUG "tadc = %d\n", tadc);
-
-      tvar1 = ( (int32_t)tadc >> 3 ) - ( (int32_t)par_t1 << 1);
-      tvar2 = (tvar1 * (int32_t)par_t2 ) >> 11;
-      tvar3 = ((((tvar1 >> 1) * (tvar1 >> 1)) >> 12) * ((int32_t)par_t3 << 4)) >> 14;
-
-      tfine = (int32_t) (tvar2 + tvar3);
-      Temperature = (int16_t)( (tfine * 5 + 128) >> 8); 
-
-      padc =  (uint32_t)( buffer[ 0 ] << 12 );
-      padc |= (uint32_t)( buffer[ 1 ] << 4 ); 
-      padc |= (uint32_t)( buffer[ 2 ] >> 4 ); 
-
-      fprintf(stderr, SD_DEBUG "padc = %d\n", padc);
-
-      pvar1 = ((int32_t)tfine >> 1) - 64000;
-      pvar2 = ((((pvar1 >> 2) * (pvar1 >> 2)) >> 11) * (int32_t)par_p6) >> 2;
-      pvar2 = pvar2 + ( (pvar1 * (int32_t)par_p5) << 1 );
-      pvar2 = (pvar2 >> 2) + ( (int32_t)par_p4 << 16 );
-      pvar1 = (((((pvar1 >> 2) * (pvar1 >> 2)) >> 13) * ((int32_t)par_p3 << 5)) >> 3 ) + ( ( pvar1 * (int32_t)par_p2) >> 1);
-      pvar1 = pvar1 >> 18;
-      pvar1 = ((32768 + pvar1) * (int32_t)par_p1) >> 15;
-      p = 1048576 - padc;
-      p = (int32_t)((p - (pvar2 >> 12)) * ((uint32_t)3125));
-      if( p >= ( 1 << 30 ) ) 
-        p = ( (p / pvar1 ) << 1);
-      else
-        p = ( (p << 1)/ pvar1 );
-      
-      pvar1 = ((int32_t)par_p9 * (int32_t)(((p >> 3) * (p >> 3)) >> 13 )) >> 12;
-      pvar2 = ((int32_t)(p >> 2) * (int32_t)par_p8) >> 13;
-      pvar3 = ((int32_t)(p >> 8) * (int32_t)(p >> 8) * (int32_t)(p >> 8) * (int32_t)par_p10) >> 17;
-      p = (int32_t)p + ((pvar1 + pvar2 + pvar3 + ((int32_t)par_p7 << 7 )) >> 4);
-      Pressure = (uint32_t)p;
-
-      hadc =  (uint16_t)( buffer[ 6 ] << 8 );
-      hadc |= (uint16_t)( buffer[ 7 ] ); 
-
-      fprintf(stderr, SD_DEBUG "hadc = %d\n", hadc);
-
-      tscaled = (int32_t)Temperature;
-      hvar1 = (int32_t)hadc - (int32_t)((int32_t)par_h1 << 4 ) - (((tscaled * (int32_t)par_h3) / ((int32_t)100)) >> 1);
-      hvar2 = ((int32_t)par_h2 * (((tscaled * (int32_t)par_h4) / ((int32_t)100)) + (((tscaled * ((tscaled * (int32_t)par_h5)/((int32_t)100))) >> 6) / ((int32_t)100)) + ((int32_t)(1 << 14)))) >> 10;
-      hvar3 = hvar1 * hvar2;
-      hvar4 = (((int32_t)par_h6 << 7) + ((tscaled * (int32_t)par_h7) / ((int32_t)100))) >> 4;
-      hvar5 = ((hvar3 >> 14) * (hvar3 >> 14)) >> 10;
-      hvar6 = (hvar4 * hvar5) >> 1;
-      h = (hvar3 + hvar6) >> 12;
-      h = (((hvar3 + hvar6) >> 10) * ((int32_t) 1000)) >> 12;
-      Humidity = (uint32_t)h;
-
-      I2Chip::I2cWriteUInt8(BME680_GAS_R_MSB_REG, address, buffer, error);
-      if( error != 0 )
-      {
-        return error;
-      }
-      else
-      {
-        I2Chip::I2cReadBytes(2, address, buffer, error);
-        if( error != 0 )
-        {
-          return error;
-        }
-        else
-        {
-          gadc =  (uint16_t)( buffer[ 0 ] << 2 );
-          gadc |= (uint16_t)( buffer[ 1 ] >> 6 ); 
-          grange = (uint8_t)( buffer[ 1 ] & 0x0F );
+      gadc =  (uint16_t)( buffer[ 0 ] << 2 );
+      gadc |= (uint16_t)( buffer[ 1 ] >> 6 ); 
+      grange = (uint8_t)( buffer[ 1 ] & 0x0F );
 
-          fprintf(stderr, SD_DEBUG "gadc = %d, grange = %d\n", gadc, grange);
+      fprintf(stderr, SD_DEBUG "gadc = %d, grange = %d\n", gadc, grange);
 
-          if( (buffer[ 1 ] & 0x20 ) == 0x20 ) gas_valid = true; 
-          else gas_valid = false;
+      if( (buffer[ 1 ] & 0x20 ) == 0x20 ) gas_valid = true; 
+      else gas_valid = false;
 
-          if( gas_valid ) fprintf(stderr, SD_DEBUG "Gas conversion valid\n");
-          else fprintf(stderr, SD_DEBUG "Gas conversion not valid\n");
+      if( gas_valid ) fprintf(stderr, SD_DEBUG "Gas conversion valid\n");
+      else fprintf(stderr, SD_DEBUG "Gas conversion not valid\n");
 
-          if( (buffer[ 1 ] & 0x10 ) == 0x10 ) heat_stab = true; 
-          else heat_stab = false;
+      if( (buffer[ 1 ] & 0x10 ) == 0x10 ) heat_stab = true; 
+      else heat_stab = false;
 
-          if( heat_stab ) fprintf(stderr, SD_DEBUG "Heater stable\n");
-          else fprintf(stderr, SD_DEBUG "Heater not stable\n");
+      if( heat_stab ) fprintf(stderr, SD_DEBUG "Heater stable\n");
+      else fprintf(stderr, SD_DEBUG "Heater not stable\n");
 
-          gvar1 = (int64_t)(((1340 + ( 5 * (int64_t)range_sw_error ) ) * ((int64_t)a1[ grange ] ) ) >> 16 );
-          gvar2 = (int64_t)( gadc << 15 ) - (int64_t)( 1 << 24) + gvar1;
+      gvar1 = (int64_t)(((1340 + ( 5 * (int64_t)range_sw_error ) ) * ((int64_t)a1[ grange ] ) ) >> 16 );
+      gvar2 = (int64_t)( gadc << 15 ) - (int64_t)( 1 << 24) + gvar1;
 
-          Resistance = (uint32_t)((((int64_t)(a2[ grange ] * (int64_t)gvar1) >> 9 ) + (gvar2 >> 1) ) / gvar2);
+      Resistance = (uint32_t)((((int64_t)(a2[ grange ] * (int64_t)gvar1) >> 9 ) + (gvar2 >> 1) ) / gvar2);
 
-    	}
-      }
     }
   }
   return 0;
@@ -2,7 +2,7 @@
  * 
  * Bme680 class definitions and constructor. Base class is I2Chip. 
  *       
- * Copyright (C) 2020 Jaakko Koivuniemi.
+ * Copyright (C) 2020 - 2026 Jaakko Koivuniemi.
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -20,7 +20,7 @@
  ****************************************************************************
  *
  * Thu Jul  9 10:59:30 CDT 2020
- * Edit: 
+ * Edit: Sat Oct 17 14:21:05 CDT 2026
  *
  * Jaakko Koivuniemi
  **/
@@ -88,6 +88,26 @@
 
 #define BME680_MEAS_STATUS0_REG 0x1D
 
+/// Configuration profile for Bme680 applied with _Bme680::ApplyProfile()_.
+
+/// The profile covers registers CTRL_GAS_0, CTRL_GAS_1, CTRL_HUM, CTRL_MEAS
+/// and CONFIG together with gas wait time and heater resistance for the
+/// heater profiles with nonzero target temperature.
+struct Bme680Profile
+{
+    uint8_t HOverSample = 1;  ///< humidity oversampling 0 - 5
+    uint8_t TOverSample = 1;  ///< temperature oversampling 0 - 5
+    uint8_t POverSample = 1;  ///< pressure oversampling 0 - 5
+    uint8_t Filter = 0;       ///< IIR filter 0 - 7
+    uint8_t Mode = 0;         ///< 0 sleep, 1 forced
+    bool RunGas = false;      ///< run gas conversions
+    bool HeaterOff = false;   ///< turn heater off
+    uint8_t HeaterProfile = 0; ///< heater profile 0 - 9 used in conversion
+    int8_t Tamb = 25;         ///< ambient temperature [C] for heater resistance
+    uint16_t HeatTemperature[ 10 ] = { }; ///< target temperature 0 - 400 C, 0 not written
+    uint8_t GasWaitTime[ 10 ] = { };      ///< gas wait time register value
+};
+
 /// Class for Bme680 inherited from I2Chip base class. 
 
 /// The constructor _Bme680_ sets name tag, device file name and chip address
@@ -163,6 +183,7 @@ class Bme680 : public I2Chip
     /// Construct Bme680 object with parameters.
     Bme680(std::string name, std::string i2cdev, uint16_t address) : I2Chip(name, i2cdev, address) 
     {
+      I2Chip::SetPairWrite( true );
       this->name = name;
       this->i2cdev = i2cdev;
       this->address = address;
@@ -171,6 +192,7 @@ class Bme680 : public I2Chip
     /// Construct Bme680 object with parameters.
     Bme680(std::string name, std::string i2cdev) : I2Chip(name, i2cdev, 0x77) 
     {
+      I2Chip::SetPairWrite( true );
       this->name = name;
       this->i2cdev = i2cdev;
     };
@@ -297,6 +319,12 @@ class Bme680 : public I2Chip
     /// Set gas heater temperature profile 0 - 9.
     void SetGasHeatTemperature(uint8_t Profile, int8_t Tamb, uint16_t T);
 
+    /// Heater resistance register value for target temperature T.
+    uint8_t HeatResistance(int8_t Tamb, uint16_t T);
+
+    /// Check profile, compute register image and write it in one transfer.
+    bool ApplyProfile(const Bme680Profile & Profile);
+
     /// Set gas heater current bytes 0 - 9.
     void SetGasHeatCurrent(uint8_t Profile, uint8_t I);
 
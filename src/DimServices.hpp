@@ -0,0 +1,146 @@
+/**************************************************************************
+ *
+ * DimServices class for DIM services generated from channel schemas.
+ *
+ * Copyright (C) 2026 Jaakko Koivuniemi.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************
+ *
+ * Sun Oct 18 13:41:26 CDT 2026
+ * Edit: Sun Oct 18 13:41:26 CDT 2026
+ *
+ * Jaakko Koivuniemi
+ **/
+
+
+
+#ifndef _DIMSERVICES_HPP
+#define _DIMSERVICES_HPP
+
+#include <dis.hxx>
+#include "Schema.hpp"
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <string.h>
+#include <stdint.h>
+
+/// DIM services of chips with layout from channel schemas.
+
+/// A service is added for each configured chip with Add() and publishes
+/// the doubles of its record followed by the integers. Reading threads
+/// only copy the latest record with Set(). Update() is called once per
+/// cycle and updates in one pass the services whose values have changed
+/// since the last update, unchanged services are not sent again.
+class DimServices
+{
+    /// One DIM service and its values.
+    struct Service
+    {
+      std::string name;          ///< service name without server
+      std::string format;        ///< DIM format
+      std::vector<char> data;    ///< values published by DIM
+      std::vector<char> latest;  ///< latest values from reading thread
+      DimService *service;       ///< DIM service
+    };
+
+    std::string server;            ///< DIM server name
+    std::vector<Service *> services; ///< services by index
+    std::vector<Service *> changed; ///< services to update in this cycle
+    std::mutex lock;               ///< lock for latest values
+    std::atomic<uint64_t> updates; ///< number of service updates
+    std::atomic<uint64_t> unchanged; ///< number of updates skipped
+
+  public:
+    /// Construct DimServices of DIM server.
+    DimServices(std::string server) : server( server ), updates( 0 ), unchanged( 0 ) { }
+
+    virtual ~DimServices()
+    {
+      for(auto & s : services)
+      {
+        delete s->service;
+        delete s;
+      }
+    }
+
+    /// Add service _server/name_ with doubles and _Ni_ integers of record and return its index.
+    template<class R> int Add(const std::string & name, int Ni = Schema<R>::Ni)
+    {
+      Service *s = new Service;
+
+      s->name = name;
+      s->format = SchemaFormat(Schema<R>::Nd, Ni);
+      s->data.assign(Schema<R>::Nd * sizeof( double ) + Ni * sizeof( int ), 0);
+      s->latest = s->data;
+      s->service = new DimService( ( server + "/" + name ).c_str(), s->format.c_str(), s->data.data(), s->data.size() );
+      services.push_back( s );
+      changed.reserve( services.size() );
+
+      return services.size() - 1;
+    }
+
+    /// Set latest values of service from record, ignored if index is negative.
+    template<class R> void Set(int index, const R & record)
+    {
+      double dbl_array[ Schema<R>::Nd + 1 ];
+      int int_array[ Schema<R>::Ni + 1 ];
+
+      if( index < 0 ) return;
+
+      Schema<R>::Pack(record, dbl_array, int_array);
+
+      std::lock_guard<std::mutex> guard( lock );
+
+      Service *s = services[ index ];
+      size_t nd = Schema<R>::Nd * sizeof( double );
+      memcpy(s->latest.data(), dbl_array, nd);
+      memcpy(s->latest.data() + nd, int_array, s->latest.size() - nd);
+    }
+
+    /// Update services with changed values.
+    void Update()
+    {
+      changed.clear();
+
+      lock.lock();
+      for(auto & s : services)
+      {
+        if( memcmp(s->data.data(), s->latest.data(), s->data.size()) == 0 ) continue;
+
+        memcpy(s->data.data(), s->latest.data(), s->data.size());
+        changed.push_back( s );
+      }
+      lock.unlock();
+
+      for(auto & s : changed) s->service->updateService();
+
+      updates += changed.size();
+      unchanged += services.size() - changed.size();
+    }
+
+    /// Get number of services.
+    size_t GetServices() { return services.size(); }
+
+    /// Get number of service updates.
+    uint64_t GetUpdates() { return updates; }
+
+    /// Get number of updates skipped with unchanged values.
+    uint64_t GetUnchanged() { return unchanged; }
+};
+
+#endif
@@ -2,7 +2,7 @@
  * 
  * File class member functions. 
  *       
- * Copyright (C) 2020 Jaakko Koivuniemi.
+ * Copyright (C) 2020 - 2026 Jaakko Koivuniemi.
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -20,82 +20,135 @@
  ****************************************************************************
  *
  * Mon Jul 13 15:27:20 CDT 2020
- * Edit: 
+ * Edit: Sun Oct 18 11:20:37 CDT 2026
  *
  * Jaakko Koivuniemi
  **/
 
 #include "File.hpp"
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <math.h>
 
 using namespace std;
 
+double File::deadband = 0;
+double File::refresh = 600;
+Snapshot *File::snapshot = nullptr;
+Mqtt *File::mqtt = nullptr;
+std::atomic<uint64_t> File::writes( 0 );
+std::atomic<uint64_t> File::skipped( 0 );
+
 /// File constructor to initialize all parameters.
 File::File(std::string dir, std::string fname)
 {
     this->Directory = dir;
     this->FileName = fname;
+    this->written = false;
+    this->last = 0;
+    this->lasttime = {0, 0};
+    this->channel = snapshot ? snapshot->Add( fname ) : -1;
+    this->topic = mqtt ? mqtt->Add( fname ) : -1;
+    SetPaths();
 }
 
 File::~File() { };
 
+/// The temporary file is hidden and in the same directory so that rename
+/// replaces the file atomically.
+void File::SetPaths()
+{
+  path = Directory + FileName;
+  temp = Directory + "." + FileName + ".tmp";
+}
 
-/// File member function to open file and write string to it.
-bool File::Write(std::string str)
+/// Not a number is always written.
+bool File::Unchanged(double val)
+{
+  struct timespec now;
+
+  if( deadband <= 0 || !written || !( fabs( val - last ) <= deadband ) ) return false;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  if( refresh > 0 && ( now.tv_sec - lasttime.tv_sec ) + 1e-9 * ( now.tv_nsec - lasttime.tv_nsec ) >= refresh ) return false;
+
+  return true;
+}
+
+/// File member function to replace file with new content.
+bool File::Publish(const char *buf, size_t len)
 {
-  std::string ofile;
-  ofile = Directory + FileName;
+  int fd = open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
 
-  std::ofstream outfile( ofile );
+  if( fd < 0 ) return false;
 
-  if( outfile.good() )
+  bool ok = ( write(fd, buf, len) == (ssize_t)len );
+  if( close( fd ) < 0 ) ok = false;
+
+  if( ok && rename(temp.c_str(), path.c_str()) == 0 )
   {
-    outfile << str << "\n";
-    outfile.close();
+    writes++;
     return true;
   }
-  else
-  {
-    return false;
-  }
+
+  unlink( temp.c_str() );
+
+  return false;
 }
 
-/// File member function to open file and write float to it.
+/// File member function to write string to file.
+bool File::Write(std::string str)
+{
+  str += "\n";
+
+  return Publish(str.data(), str.length());
+}
+
+/// File member function to write float to file, formatted as with ostream.
 bool File::Write(double val)
 {
-  std::string ofile;
-  ofile = Directory + FileName;
+  if( snapshot ) snapshot->Set(channel, val);
 
-  std::ofstream outfile( ofile );
+  char buf[ 32 ];
 
-  if( outfile.good() )
+  if( Unchanged( val ) )
   {
-    outfile << val << "\n";
-    outfile.close();
+    skipped++;
     return true;
   }
-  else
-  {
-    return false;
-  }
+
+  int n = snprintf(buf, sizeof( buf ), "%g\n", val);
+  if( mqtt ) mqtt->Publish(topic, buf, n - 1);
+  if( !Publish(buf, n) ) return false;
+
+  written = true;
+  last = val;
+  clock_gettime(CLOCK_MONOTONIC, &lasttime);
+
+  return true;
 }
 
-/// File member function to open file and write integer to it.
+/// File member function to write integer to file.
 bool File::Write(int val)
 {
-  std::string ofile;
-  ofile = Directory + FileName;
+  if( snapshot ) snapshot->Set(channel, val);
 
-  std::ofstream outfile( ofile );
+  char buf[ 16 ];
 
-  if( outfile.good() )
+  if( Unchanged( val ) )
   {
-    outfile << val << "\n";
-    outfile.close();
+    skipped++;
     return true;
   }
-  else
-  {
-    return false;
-  }
-}
 
+  int n = snprintf(buf, sizeof( buf ), "%d\n", val);
+  if( mqtt ) mqtt->Publish(topic, buf, n - 1);
+  if( !Publish(buf, n) ) return false;
+
+  written = true;
+  last = val;
+  clock_gettime(CLOCK_MONOTONIC, &lasttime);
+
+  return true;
+}
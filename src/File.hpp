@@ -2,7 +2,7 @@
  * 
  * File class definitions and constructor. 
  *       
- * Copyright (C) 2020 Jaakko Koivuniemi.
+ * Copyright (C) 2020 - 2026 Jaakko Koivuniemi.
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -20,7 +20,7 @@
  ****************************************************************************
  *
  * Mon Jul 13 15:04:39 CDT 2020
- * Edit: 
+ * Edit: Sun Oct 18 11:20:37 CDT 2026
  *
  * Jaakko Koivuniemi
  **/
@@ -31,14 +31,52 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include "Snapshot.hpp"
+#include "Mqtt.hpp"
+#include <atomic>
+#include <time.h>
+#include <stdint.h>
 
 /// Class for file writing and reading functions. 
 
 /// The constructor _File_ sets directory and file name for writing data.
+/// A new value is written to a temporary file in the same directory and
+/// renamed over the old file, so readers see either the old or the new
+/// value and never an empty file. With a deadband a number is written
+/// only when it differs from the last written value by more than the
+/// deadband, or when the file is older than the refresh interval.
+/// Numbers are also written to the shared memory snapshot, if one is set
+/// before the file objects are constructed, also within the deadband.
+/// Numbers written to the file are published to MQTT topic of the same
+/// name when a publisher is set.
 class File
 {
     std::string Directory;       ///< directory 
     std::string FileName;     ///< file name
+    std::string path;         ///< full path of file
+    std::string temp;         ///< temporary file renamed to path
+
+    bool written;             ///< a number has been written
+    double last;              ///< last written number
+    struct timespec lasttime; ///< time of last write
+    int channel;              ///< channel in snapshot or -1
+    int topic;                ///< topic of MQTT publisher or -1
+
+    static double deadband;   ///< change needed to write number
+    static double refresh;    ///< maximum time between writes [s]
+    static Snapshot *snapshot; ///< snapshot of latest numbers or nullptr
+    static Mqtt *mqtt;        ///< MQTT publisher or nullptr
+    static std::atomic<uint64_t> writes;  ///< number of files written
+    static std::atomic<uint64_t> skipped; ///< number of writes skipped within deadband
+
+    /// Set full and temporary file paths.
+    void SetPaths();
+
+    /// Return true if number is within deadband of last written and file is not too old.
+    bool Unchanged(double val);
+
+    /// Write buffer to temporary file and rename it over the file, return true if success.
+    bool Publish(const char *buf, size_t len);
 
   public:
     /// Construct File object. 
@@ -56,10 +94,28 @@ class File
     std::string GetFile() { return FileName; }
 
     /// Set directory.
-    void SetDir(std::string dir) { this->Directory = dir; }
+    void SetDir(std::string dir) { this->Directory = dir; SetPaths(); }
 
     /// Set file name.
-    void SetFile(std::string fname) { this->FileName = fname; }
+    void SetFile(std::string fname) { this->FileName = fname; SetPaths(); }
+
+    /// Set change of number needed to write it to any file, 0 to write every value.
+    static void SetDeadband(double deadband) { File::deadband = deadband; }
+
+    /// Set maximum time between writes of unchanged number [s], 0 for no limit.
+    static void SetRefresh(double refresh) { File::refresh = refresh; }
+
+    /// Write numbers also to channel of snapshot, call before constructing files.
+    static void SetSnapshot(Snapshot *snapshot) { File::snapshot = snapshot; }
+
+    /// Publish written numbers also to MQTT, call before constructing files.
+    static void SetMqtt(Mqtt *mqtt) { File::mqtt = mqtt; }
+
+    /// Get number of files written.
+    static uint64_t GetWrites() { return writes; }
+
+    /// Get number of writes skipped within deadband.
+    static uint64_t GetSkipped() { return skipped; }
 
     /// Write string to file and return true if success.
     bool Write(std::string str);
@@ -2,7 +2,7 @@
  * 
  * Htu21d class member functions for configuration and reading with I2Chip. 
  *       
- * Copyright (C) 2020 Jaakko Koivuniemi.
+ * Copyright (C) 2020 - 2026 Jaakko Koivuniemi.
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -20,7 +20,7 @@
  ****************************************************************************
  *
  * Fri Jul 24 09:44:39 CDT 2020
- * Edit: 
+ * Edit: Sat Oct 17 12:14:09 CDT 2026
  *
  * Jaakko Koivuniemi
  **/
@@ -37,8 +37,7 @@ uint8_t Htu21d::GetUserRegister()
 {
   uint8_t reg = 0;
 
-  I2cWriteUInt8(HTU21D_READ_USER_REG, HTU21D_ADDRESS, buffer, error);
-  reg = I2cReadUInt8(HTU21D_ADDRESS, buffer, error);
+  reg = I2cReadRegisterUInt8(HTU21D_READ_USER_REG, HTU21D_ADDRESS, buffer, error);
 
   return reg;
 }
@@ -0,0 +1,298 @@
+/**************************************************************************
+ *
+ * I2CBus class member functions for shared I2C device file access.
+ *
+ * Copyright (C) 2026 Jaakko Koivuniemi.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************
+ *
+ * Sat Oct 17 09:31:05 CDT 2026
+ * Edit: Sun Oct 18 12:34:09 CDT 2026
+ *
+ * Jaakko Koivuniemi
+ **/
+
+#include "I2CBus.hpp"
+#include <string.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#include <errno.h>
+
+using namespace std;
+
+std::map<std::string, I2CBus *> I2CBus::buses;
+
+/// I2CBus constructor to initialize all parameters.
+I2CBus::I2CBus(std::string i2cdev)
+{
+  this->i2cdev = i2cdev;
+}
+
+I2CBus::~I2CBus()
+{
+  Close();
+}
+
+/// lock for map of shared bus objects
+static std::mutex gmtx;
+
+/// Return existing bus object for the device file or create a new one.
+/// The objects live until the program exits.
+I2CBus * I2CBus::Get(std::string i2cdev)
+{
+  std::lock_guard<std::mutex> guard( gmtx );
+
+  std::map<std::string, I2CBus *>::iterator it = buses.find( i2cdev );
+  if( it != buses.end() ) return it->second;
+
+  I2CBus *bus = new I2CBus( i2cdev );
+  buses[ i2cdev ] = bus;
+
+  return bus;
+}
+
+std::vector<I2CBus *> I2CBus::GetAll()
+{
+  std::vector<I2CBus *> all;
+  std::lock_guard<std::mutex> guard( gmtx );
+
+  for(auto & b : buses) all.push_back( b.second );
+
+  return all;
+}
+
+/// Open the device file once. If opening fails it is tried again on the
+/// next transfer.
+bool I2CBus::Open(int & error)
+{
+  char message[ 500 ] = "";
+
+  if( fd >= 0 ) return true;
+
+  if( ( fd = open(i2cdev.c_str(), O_RDWR) ) < 0 )
+  {
+    strncpy(message, strerror( errno ), 400);
+    fprintf(stderr, SD_ERR "Failed to open I2C port. %s\n", message);
+    error = -1;
+    errors++;
+    return false;
+  }
+
+  slave = -1;
+  fprintf(stderr, SD_DEBUG "Opened I2C port %s\n", i2cdev.c_str() );
+
+  return true;
+}
+
+/// Only the outermost call locks the device file. If the locking fails it
+/// is tried again maximum I2LOCK_MAX times while sleeping one second between
+/// the attempts.
+bool I2CBus::Lock(int & error)
+{
+  int rd;
+  int cnt = 0;
+  char message[ 500 ] = "";
+
+  mtx.lock();
+
+  if( depth > 0 )
+  {
+    depth++;
+    return true;
+  }
+
+  if( !Open( error ) )
+  {
+    mtx.unlock();
+    return false;
+  }
+
+  rd = flock(fd, LOCK_EX|LOCK_NB);
+
+  // try again if port locking failed
+  cnt = I2LOCK_MAX;
+  while( rd != 0 && errno == EWOULDBLOCK && cnt > 0 )
+  {
+    sleep( 1 );
+    rd = flock(fd, LOCK_EX|LOCK_NB);
+    cnt--;
+  }
+
+  if( rd )
+  {
+    strncpy(message, strerror( errno ), 400);
+    fprintf(stderr, SD_ERR "Failed to lock I2C port. %s\n", message);
+    error = -2;
+    errors++;
+    mtx.unlock();
+    return false;
+  }
+
+  depth = 1;
+
+  return true;
+}
+
+/// The device file lock is released when the outermost Lock() is matched.
+void I2CBus::Unlock()
+{
+  if( depth > 0 )
+  {
+    depth--;
+    if( depth == 0 && fd >= 0 ) flock(fd, LOCK_UN);
+  }
+
+  mtx.unlock();
+}
+
+/// The slave address is kept per open file so the ioctl is needed only
+/// when another chip on the bus is addressed.
+bool I2CBus::Select(uint16_t address, int & error)
+{
+  char message[ 500 ] = "";
+
+  if( slave == (int)address ) return true;
+
+  if( ioctl(fd, I2C_SLAVE, address) < 0 )
+  {
+    strncpy(message, strerror( errno ), 400);
+    fprintf(stderr, SD_ERR "Unable to get bus access to talk to slave. %s\n", message);
+    slave = -1;
+    error = -3;
+    errors++;
+    return false;
+  }
+
+  slave = address;
+
+  return true;
+}
+
+/// Lock the bus, select slave and read N bytes.
+/// https://www.kernel.org/doc/Documentation/i2c/dev-interface
+bool I2CBus::Read(int Nbytes, uint16_t address, uint8_t *buffer, int & error)
+{
+  char message[ 500 ] = "";
+
+  if( !Lock( error ) ) return false;
+
+  if( !Select( address, error ) )
+  {
+    Unlock();
+    return false;
+  }
+
+  if( read(fd, buffer, Nbytes) != Nbytes )
+  {
+    strncpy(message, strerror( errno ), 400);
+    fprintf(stderr, SD_ERR "Unable to read from slave. %s\n", message);
+    error = -4;
+    errors++;
+    Unlock();
+    return false;
+  }
+
+  Unlock();
+  error = 0;
+
+  return true;
+}
+
+/// Lock the bus, select slave and write N bytes.
+/// https://www.kernel.org/doc/Documentation/i2c/dev-interface
+bool I2CBus::Write(int Nbytes, uint16_t address, const uint8_t *buffer, int & error)
+{
+  char message[ 500 ] = "";
+
+  if( !Lock( error ) ) return false;
+
+  if( !Select( address, error ) )
+  {
+    Unlock();
+    return false;
+  }
+
+  if( write(fd, buffer, Nbytes) != Nbytes )
+  {
+    strncpy(message, strerror( errno ), 400);
+    fprintf(stderr, SD_ERR "Error writing to I2C slave. %s\n", message);
+    error = -4;
+    errors++;
+    Unlock();
+    return false;
+  }
+
+  Unlock();
+  error = 0;
+
+  return true;
+}
+
+/// Lock the bus and do one I2C_RDWR ioctl with a write message followed
+/// by a read message. The slave address is given in the messages so the
+/// cached I2C_SLAVE selection is not changed.
+/// https://www.kernel.org/doc/Documentation/i2c/dev-interface
+bool I2CBus::WriteRead(uint16_t address, const uint8_t *wbuffer, int Wbytes, uint8_t *rbuffer, int Rbytes, int & error)
+{
+  char message[ 500 ] = "";
+  struct i2c_msg msgs[ 2 ];
+  struct i2c_rdwr_ioctl_data xfer;
+
+  msgs[ 0 ].addr = address;
+  msgs[ 0 ].flags = 0;
+  msgs[ 0 ].len = (uint16_t)Wbytes;
+  msgs[ 0 ].buf = (uint8_t *)wbuffer;
+
+  msgs[ 1 ].addr = address;
+  msgs[ 1 ].flags = I2C_M_RD;
+  msgs[ 1 ].len = (uint16_t)Rbytes;
+  msgs[ 1 ].buf = rbuffer;
+
+  xfer.msgs = msgs;
+  xfer.nmsgs = 2;
+
+  if( !Lock( error ) ) return false;
+
+  if( ioctl(fd, I2C_RDWR, &xfer) != 2 )
+  {
+    strncpy(message, strerror( errno ), 400);
+    fprintf(stderr, SD_ERR "Combined I2C transfer failed. %s\n", message);
+    error = -4;
+    errors++;
+    Unlock();
+    return false;
+  }
+
+  Unlock();
+  error = 0;
+
+  return true;
+}
+
+/// Close the device file and forget the selected slave.
+void I2CBus::Close()
+{
+  std::lock_guard<std::recursive_mutex> guard( mtx );
+
+  if( fd >= 0 ) close( fd );
+
+  fd = -1;
+  slave = -1;
+  depth = 0;
+}
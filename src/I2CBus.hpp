@@ -0,0 +1,130 @@
+/**************************************************************************
+ *
+ * I2CBus class definitions and constructor.
+ *
+ * Copyright (C) 2026 Jaakko Koivuniemi.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************
+ *
+ * Sat Oct 17 09:12:40 CDT 2026
+ * Edit: Sun Oct 18 12:34:09 CDT 2026
+ *
+ * Jaakko Koivuniemi
+ **/
+
+#ifndef _I2CBUS_HPP
+#define _I2CBUS_HPP
+
+#include <linux/i2c-dev.h>
+#include <linux/i2c.h>
+#include <systemd/sd-daemon.h>
+#include <stdint.h>
+#include <string>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <vector>
+
+#define I2LOCK_MAX 10        ///< Maximum number of times I2C device file locking is attempted.
+
+/// Class for one I2C bus device file shared by all chips on the bus.
+
+/// The device file is opened once and kept open for the lifetime of the
+/// program. The slave address selected with _ioctl(I2C_SLAVE)_ is cached
+/// so that the ioctl is only called when a different chip is addressed.
+/// Use _I2CBus::Get()_ to get the shared object for a device file.
+class I2CBus
+{
+    std::string i2cdev;  ///< device file to read and write serial data
+    int fd = -1;         ///< open file descriptor or -1 if closed
+    int slave = -1;      ///< slave address selected now or -1 if none
+    int depth = 0;       ///< nesting depth of Lock() calls
+    std::atomic<uint64_t> errors{ 0 }; ///< number of failed transfers
+
+    /// serialize threads using the same bus
+    std::recursive_mutex mtx;
+
+    /// shared bus objects by device file name
+    static std::map<std::string, I2CBus *> buses;
+
+    /// Open device file if not open yet and return true if success.
+    bool Open(int & error);
+
+  public:
+    /// Construct I2CBus object for device file.
+    I2CBus(std::string i2cdev);
+
+    virtual ~I2CBus();
+
+    /// Get shared I2CBus object for device file, create it if needed.
+    static I2CBus * Get(std::string i2cdev);
+
+    /// Get all shared bus objects.
+    static std::vector<I2CBus *> GetAll();
+
+    /// Get number of failed opens, locks and transfers.
+    uint64_t GetErrors() { return errors; }
+
+    /// Get I2C bus device file name.
+    std::string GetDevice() { return i2cdev; }
+
+    /// Get file descriptor, -1 if device file is not open.
+    int GetFd() { return fd; }
+
+    /// Lock bus for this process and return true if success.
+
+    /// The calls can be nested, the device file is locked with _flock()_
+    /// only on the outermost call. Holding the lock over several transfers
+    /// saves a lock and unlock per transfer.
+    /// Error codes: -1 failed to open I2C port, -2 failed to lock I2C port.
+    bool Lock(int & error);
+
+    /// Release lock taken with Lock().
+    void Unlock();
+
+    /// Select slave address if different from cached one and return true if success.
+
+    /// Error codes: -3 unable to get bus access to talk to slave.
+    bool Select(uint16_t address, int & error);
+
+    /// Read N bytes from I2C address to buffer and return true if success.
+
+    /// Error codes: -1 failed to open I2C port, -2 failed to lock I2C port,
+    /// -3 unable to get bus access to talk to slave, -4 unable to read
+    /// from slave.
+    bool Read(int Nbytes, uint16_t address, uint8_t *buffer, int & error);
+
+    /// Write N bytes from buffer to I2C address and return true if success.
+
+    /// Error codes: -1 failed to open I2C port, -2 failed to lock I2C port,
+    /// -3 unable to get bus access to talk to slave, -4 unable to write
+    /// to slave.
+    bool Write(int Nbytes, uint16_t address, const uint8_t *buffer, int & error);
+
+    /// Write and then read in one combined transfer and return true if success.
+
+    /// The two messages are sent with _ioctl(I2C_RDWR)_ using a repeated
+    /// start between them, so no other master can move the register pointer
+    /// after it has been written.
+    /// Error codes: -1 failed to open I2C port, -2 failed to lock I2C port,
+    /// -4 combined transfer failed.
+    bool WriteRead(uint16_t address, const uint8_t *wbuffer, int Wbytes, uint8_t *rbuffer, int Rbytes, int & error);
+
+    /// Close device file. It is opened again on next transfer.
+    void Close();
+};
+
+#endif
@@ -2,7 +2,7 @@
  * 
  * I2Chip class member functions for configuration and reading chips. 
  *       
- * Copyright (C) 2020 Jaakko Koivuniemi.
+ * Copyright (C) 2020 - 2026 Jaakko Koivuniemi.
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -20,7 +20,7 @@
  ****************************************************************************
  *
  * Fri Jul  3 15:57:37 CDT 2020
- * Edit: Wed Jul 15 08:59:36 CDT 2020
+ * Edit: Sat Oct 17 14:21:05 CDT 2026
  *
  * Jaakko Koivuniemi
  **/
@@ -28,10 +28,7 @@
 
 #include "I2Chip.hpp"
 #include <string.h>
-#include <sys/ioctl.h>
-#include <sys/file.h>
-#include <unistd.h>
-#include <errno.h>
+#include <stdio.h>
 
 using namespace std;
 
@@ -42,231 +39,76 @@ I2Chip::I2Chip(std::string name, std::string i2cdev, uint16_t address)
   this->name = name;
   this->i2cdev = i2cdev;
   this->address = address;
+  this->bus = I2CBus::Get( i2cdev );
 };
 
 I2Chip::~I2Chip() { };
 
 /// I2Chip member function to read one byte from given address.
 
-/// After opening the device file the port is locked to avoid any other
-/// process using the interface at the same time. If the locking fails it
-/// is tried again maximum I2LOCK_MAX times while sleeping one second between
-/// the attempts. One byte is transfered from the I2C chip. 
+/// The transfer goes through the shared I2CBus object which keeps the
+/// device file open and locks it to avoid any other process using the
+/// interface at the same time. One byte is transfered from the I2C chip. 
 /// https://www.kernel.org/doc/Documentation/i2c/dev-interface
 uint8_t I2Chip::I2cReadUInt8(uint16_t address, uint8_t *buffer, int & error)
 {
-  int fd, rd;
   uint8_t rdata = 0;
-  int cnt = 0;
   char message[ 500 ] = "";
 
-  if( ( fd = open(i2cdev.c_str(), O_RDWR) ) < 0 )
-  {
-    strncpy(message, strerror( errno ), 400);
-    fprintf(stderr, SD_ERR "Failed to open I2C port. %s\n", message);
-    error = -1;
-    return 0;
-  }
-
-  rd = flock(fd, LOCK_EX|LOCK_NB);
-
-  // try again if port locking failed
-  cnt = I2LOCK_MAX;
-  while( rd == 1 && cnt > 0 )
-  {
-    sleep( 1 );
-    rd = flock(fd, LOCK_EX|LOCK_NB);
-    cnt--;
-  }
-
-  if( rd )
-  {
-    strncpy(message, strerror( errno ), 400);
-    fprintf(stderr, SD_ERR "Failed to lock I2C port. %s\n", message);
-    close( fd );
-    error = -2;
-    return 0;
-  }
-
-  if( ioctl(fd, I2C_SLAVE, address) < 0 )
-  {
-    strncpy(message, strerror( errno ), 400);
-    fprintf(stderr, SD_ERR "Unable to get bus access to talk to slave. %s\n", message);
-    close( fd );
-    error = -3;
-    return 0;
-  }
-
   sprintf(message, "I2C[%02X] read\n", address);
   fprintf(stderr, SD_DEBUG "%s", message);
 
-  if( read(fd, buffer, 1) != 1 )
-  {
-    strncpy(message, strerror( errno ), 400);
-    fprintf(stderr, SD_ERR "Unable to read from slave. %s\n", message);
-    close( fd );
-    error = -4;
-    return 0;
-  }
-  else
-  {
-    rdata = buffer[ 0 ];
-    sprintf(message, "I2C received [%02X] (%d)\n", buffer[0], rdata);
-    fprintf(stderr, SD_DEBUG "%s", message);
-  }
+  if( !bus->Read(1, address, buffer, error) ) return 0;
 
-  close( fd );
-  error = 0;
+  rdata = buffer[ 0 ];
+  sprintf(message, "I2C received [%02X] (%d)\n", buffer[0], rdata);
+  fprintf(stderr, SD_DEBUG "%s", message);
 
   return rdata;
 }
 
 /// I2Chip member function to read two bytes from given address.
 
-/// After opening the device file the port is locked to avoid any other
-/// process using the interface at the same time. If the locking fails it
-/// is tried again maximum I2LOCK_MAX times while sleeping one second between
-/// the attempts. Two bytes are transfered from the I2C chip. 
+/// The transfer goes through the shared I2CBus object which keeps the
+/// device file open and locks it to avoid any other process using the
+/// interface at the same time. Two bytes are transfered from the I2C chip. 
 /// https://www.kernel.org/doc/Documentation/i2c/dev-interface
 uint16_t I2Chip::I2cReadUInt16(uint16_t address, uint8_t *buffer, int & error)
 {
-  int fd, rd;
   uint16_t rdata = 0;
-  int cnt = 0;
   char message[ 500 ] = "";
 
-  if( ( fd = open(i2cdev.c_str(), O_RDWR) ) < 0 )
-  {
-    strncpy(message, strerror( errno ), 400);
-    fprintf(stderr, SD_ERR "Failed to open I2C port. %s\n", message);
-    error = -1;
-    return 0;
-  }
-
-  rd = flock(fd, LOCK_EX|LOCK_NB);
-
-  // try again if port locking failed
-  cnt = I2LOCK_MAX;
-  while( rd == 1 && cnt > 0 )
-  {
-    sleep( 1 );
-    rd = flock(fd, LOCK_EX|LOCK_NB);
-    cnt--;
-  }
-
-  if( rd )
-  {
-    strncpy(message, strerror( errno ), 400);
-    fprintf(stderr, SD_ERR "Failed to lock I2C port. %s\n", message);
-    close( fd );
-    error = -2;
-    return 0;
-  }
-
-  if( ioctl(fd, I2C_SLAVE, address) < 0 )
-  {
-    strncpy(message, strerror( errno ), 400);
-    fprintf(stderr, SD_ERR "Unable to get bus access to talk to slave. %s\n", message);
-    close( fd );
-    error = -3;
-    return 0;
-  }
-
   sprintf(message, "I2C[%02X] read\n", address);
   fprintf(stderr, SD_DEBUG "%s", message);
 
-  if( read(fd, buffer, 2) != 2 )
-  {
-    strncpy(message, strerror( errno ), 400);
-    fprintf(stderr, SD_ERR "Unable to read from slave. %s\n", message);
-    close( fd );
-    error = -4;
-    return 0;
-  }
-  else
-  {
-    rdata = 256*buffer[ 0 ] + buffer[ 1 ];
-    sprintf(message, "I2C received [%02X %02X] (%d)\n", buffer[0], buffer[1], rdata);
-    fprintf(stderr, SD_DEBUG "%s", message);
-  }
+  if( !bus->Read(2, address, buffer, error) ) return 0;
 
-  close( fd );
-  error = 0;
+  rdata = 256*buffer[ 0 ] + buffer[ 1 ];
+  sprintf(message, "I2C received [%02X %02X] (%d)\n", buffer[0], buffer[1], rdata);
+  fprintf(stderr, SD_DEBUG "%s", message);
 
   return rdata;
 }
 
 /// I2Chip member function to read four bytes from given address.
 
-/// After opening the device file the port is locked to avoid any other
-/// process using the interface at the same time. If the locking fails it
-/// is tried again maximum I2LOCK_MAX times while sleeping one second between
-/// the attempts. Four bytes are transfered from the I2C chip. 
+/// The transfer goes through the shared I2CBus object which keeps the
+/// device file open and locks it to avoid any other process using the
+/// interface at the same time. Four bytes are transfered from the I2C chip. 
 /// https://www.kernel.org/doc/Documentation/i2c/dev-interface
 uint32_t I2Chip::I2cReadUInt32(uint16_t address, uint8_t *buffer, int & error)
 {
-  int fd, rd;
   uint32_t rdata = 0;
-  int cnt = 0;
   char message[ 500 ] = "";
 
-  if( ( fd = open(i2cdev.c_str(), O_RDWR) ) < 0 )
-  {
-    strncpy(message, strerror( errno ), 400);
-    fprintf(stderr, SD_ERR "Failed to open I2C port. %s\n", message);
-    error = -1;
-    return 0;
-  }
-      
-  rd = flock(fd, LOCK_EX|LOCK_NB);
-
-  // try again if port locking failed
-  cnt = I2LOCK_MAX;
-  while( rd == 1 && cnt > 0 )
-  {
-    sleep( 1 );
-    rd = flock(fd, LOCK_EX|LOCK_NB);
-    cnt--;
-  }
-
-  if( rd )
-  {
-    strncpy(message, strerror( errno ), 400);
-    fprintf(stderr, SD_ERR "Failed to lock I2C port. %s\n", message);
-    close( fd );
-    error = -2;
-    return 0;
-  }
-
-  if( ioctl(fd, I2C_SLAVE, address) < 0 )
-  {
-    strncpy(message, strerror( errno ), 400);
-    fprintf(stderr, SD_ERR "Unable to get bus access to talk to slave. %s\n", message);
-    close( fd );
-    error = -3;
-    return 0;
-  }
-
   sprintf(message, "I2C[%02X] read\n", address);
   fprintf(stderr, SD_DEBUG "%s", message);
 
-  if( read(fd, buffer, 4) != 4 )
-  {
-    strncpy(message, strerror( errno ), 400);
-    fprintf(stderr, SD_ERR "Unable to read from slave. %s\n", message);
-    close( fd );
-    error = -4;
-    return 0;
-  }
-  else
-  {
-    rdata = 16777216 * buffer[ 0 ] + 65536 * buffer[ 1 ] + 256 * buffer[ 2 ] + buffer[ 3 ];
-    sprintf(message, "I2C received [%02X %02X %02X %02X] (%d)\n", buffer[0], buffer[1], buffer[2], buffer[3], rdata);
-    fprintf(stderr, SD_DEBUG "%s", message);
-  }
+  if( !bus->Read(4, address, buffer, error) ) return 0;
 
-  close( fd );
-  error = 0;
+  rdata = 16777216 * buffer[ 0 ] + 65536 * buffer[ 1 ] + 256 * buffer[ 2 ] + buffer[ 3 ];
+  sprintf(message, "I2C received [%02X %02X %02X %02X] (%d)\n", buffer[0], buffer[1], buffer[2], buffer[3], rdata);
+  fprintf(stderr, SD_DEBUG "%s", message);
 
   return rdata;
 }
@@ -279,8 +121,6 @@ uint32_t I2Chip::I2cReadUInt32(uint16_t address, uint8_t *buffer, int & error)
 // from slave and -5 more or less data received than expected.
 void I2Chip::I2cReadBytes(int Nbytes, uint16_t address, uint8_t *buffer, int & error)
 {
-  int fd, rd;
-  int cnt = 0;
   char message[ 500 ] = "";
 
   if( Nbytes > BUFFER_MAX )
@@ -291,257 +131,124 @@ void I2Chip::I2cReadBytes(int Nbytes, uint16_t address, uint8_t *buffer, int & e
     return;
   }
 
-  if( ( fd = open(i2cdev.c_str(), O_RDWR) ) < 0 )
-  {
-    strncpy(message, strerror( errno ), 400);
-    fprintf(stderr, SD_ERR "Failed to open I2C port. %s\n", message);
-    error = -1;
-    return;
-  }
-      
-  rd = flock(fd, LOCK_EX|LOCK_NB);
+  sprintf(message, "I2C[%02X] read\n", address);
+  fprintf(stderr, SD_DEBUG "%s", message);
 
-  // try again if port locking failed
-  cnt = I2LOCK_MAX;
-  while( rd == 1 && cnt > 0 )
-  {
-    sleep( 1 );
-    rd = flock(fd, LOCK_EX|LOCK_NB);
-    cnt--;
-  }
+  if( !bus->Read(Nbytes, address, buffer, error) ) return;
 
-  if( rd )
-  {
-    strncpy(message, strerror( errno ), 400);
-    fprintf(stderr, SD_ERR "Failed to lock I2C port. %s\n", message);
-    close( fd );
-    error = -2;
-    return;
-  }
+  sprintf(message, "I2C received [");
+  if( Nbytes > 160 ) Nbytes = 160;
+  for(int i = 0; i < Nbytes; i++ ) sprintf(message + strlen(message), "%02X ", buffer[ i ]);
+  sprintf(message + strlen(message), "]\n");
+  fprintf(stderr, SD_DEBUG "%s", message);
 
-  if( ioctl(fd, I2C_SLAVE, address) < 0 )
-  {
-    strncpy(message, strerror( errno ), 400);
-    fprintf(stderr, SD_ERR "Unable to get bus access to talk to slave. %s\n", message);
-    close( fd );
-    error = -3;
+  return;
+}
+
+/// I2Chip member function to read N bytes starting from given register.
+
+/// The register pointer write and the read are done in one I2C_RDWR
+/// transfer with repeated start. This halves the number of bus transactions
+/// compared to I2cWriteUInt8() followed by a read, and no other process can
+/// change the register pointer between the two.
+void I2Chip::I2cReadRegisters(uint8_t reg, int Nbytes, uint16_t address, uint8_t *buffer, int & error)
+{
+  char message[ 500 ] = "";
+
+  if( Nbytes > BUFFER_MAX )
+  { 
+    sprintf(message, "%d is more than I2C read buffer size.\n", Nbytes);
+    fprintf(stderr, SD_ERR "%s", message);
+    error = -6;
     return;
   }
 
-  sprintf(message, "I2C[%02X] read\n", address);
+  sprintf(message, "I2C[%02X] read register [%02X]\n", address, reg);
   fprintf(stderr, SD_DEBUG "%s", message);
 
-  if( read(fd, buffer, Nbytes) != Nbytes )
-  {
-    strncpy(message, strerror( errno ), 400);
-    fprintf(stderr, SD_ERR "Unable to read from slave. %s\n", message);
-    close( fd );
-    error = -4;
-    return;
-  }
-  else
-  {
-    sprintf(message, "I2C received [");
-    if( Nbytes > 160 ) Nbytes = 160;
-    for(int i = 0; i < Nbytes; i++ ) sprintf(message + strlen(message), "%02X ", buffer[ i ]);
-    sprintf(message + strlen(message), "]\n");
-    fprintf(stderr, SD_DEBUG "%s", message);
-  }
+  if( !bus->WriteRead(address, &reg, 1, buffer, Nbytes, error) ) return;
 
-  close( fd );
-  error = 0;
+  sprintf(message, "I2C received [");
+  if( Nbytes > 160 ) Nbytes = 160;
+  for(int i = 0; i < Nbytes; i++ ) sprintf(message + strlen(message), "%02X ", buffer[ i ]);
+  sprintf(message + strlen(message), "]\n");
+  fprintf(stderr, SD_DEBUG "%s", message);
 
   return;
 }
 
-/// I2Chip member function to write one byte to given address.
+/// I2Chip member function to read one byte from given register.
+uint8_t I2Chip::I2cReadRegisterUInt8(uint8_t reg, uint16_t address, uint8_t *buffer, int & error)
+{
+  I2Chip::I2cReadRegisters(reg, 1, address, buffer, error);
 
-/// After opening the device file the port is locked to avoid any other
-/// process using the interface at the same time. If the locking fails it
-/// is tried again maximum I2LOCK_MAX times while sleeping one second between
-/// the attempts. One byte is transfered to the I2C chip. 
-/// https://www.kernel.org/doc/Documentation/i2c/dev-interface
-void I2Chip::I2cWriteUInt8(uint8_t data, uint16_t address, uint8_t *buffer, int & error){
-  int fd, rd;
-  int cnt = 0;
-  char message[ 500 ] = "";
+  if( error != 0 ) return 0;
 
-  if( ( fd = open(i2cdev.c_str(), O_RDWR) ) < 0 ) 
-  {
-    strncpy(message, strerror( errno ), 400);
-    fprintf(stderr, SD_ERR "Failed to open I2C port. %s\n", message);
-    error = -1;
-    return;
-  }
+  return buffer[ 0 ];
+}
 
-  rd = flock(fd, LOCK_EX|LOCK_NB);
+/// I2Chip member function to read two bytes from given register.
+uint16_t I2Chip::I2cReadRegisterUInt16(uint8_t reg, uint16_t address, uint8_t *buffer, int & error)
+{
+  I2Chip::I2cReadRegisters(reg, 2, address, buffer, error);
 
-  // try again if port locking failed
-  cnt = I2LOCK_MAX;
-  while( rd == 1 && cnt > 0 )
-  {
-    sleep( 1 );
-    rd = flock(fd, LOCK_EX|LOCK_NB);
-    cnt--;
-  }
+  if( error != 0 ) return 0;
 
- if( rd )
-  {
-    strncpy(message, strerror( errno ), 400);
-    fprintf(stderr, SD_ERR "Failed to open i2c port. %s\n", message);
-    close( fd );
-    return;
-  }
+  return 256*buffer[ 0 ] + buffer[ 1 ];
+}
 
-  if( ioctl(fd, I2C_SLAVE, address) < 0 ) 
-  {
-    strncpy(message, strerror( errno ), 400);
-    fprintf(stderr, SD_ERR "Unable to get bus access to talk to slave. %s\n", message);
-    close( fd );
-    error = -3;
-    return;
-  }
+/// I2Chip member function to write one byte to given address.
+
+/// The transfer goes through the shared I2CBus object which keeps the
+/// device file open and locks it to avoid any other process using the
+/// interface at the same time. One byte is transfered to the I2C chip. 
+/// https://www.kernel.org/doc/Documentation/i2c/dev-interface
+void I2Chip::I2cWriteUInt8(uint8_t data, uint16_t address, uint8_t *buffer, int & error)
+{
+  char message[ 500 ] = "";
 
   buffer[ 0 ] = data; 
   sprintf(message, "I2C[%02X] write byte [%02X]\n", address, buffer[ 0 ] );
   fprintf(stderr, SD_DEBUG "%s", message);
 
-  if( write(fd, buffer, 1) != 1 ) 
-  {
-    strncpy(message, strerror( errno ), 400);
-    fprintf(stderr, SD_ERR "Error writing to I2C slave. %s\n", message);
-    close( fd );
-    error = -4;
-    return;
-  }
-
-  close( fd );
-  error = 0;
+  bus->Write(1, address, buffer, error);
 
   return;
 }
 
 /// I2Chip member function to write one byte to given register address.
 
-/// After opening the device file the port is locked to avoid any other
-/// process using the interface at the same time. If the locking fails it
-/// is tried again maximum I2LOCK_MAX times while sleeping one second between
-/// the attempts. One register pointer byte is transfered to the I2C chip
-/// followed by one data byte. 
+/// The transfer goes through the shared I2CBus object which keeps the
+/// device file open and locks it to avoid any other process using the
+/// interface at the same time. One register pointer byte is transfered to
+/// the I2C chip followed by one data byte. 
 /// https://www.kernel.org/doc/Documentation/i2c/dev-interface
 void I2Chip::I2cWriteRegisterUInt8(uint8_t reg, uint8_t data, uint16_t address, uint8_t *buffer, int & error)
 {
-  int fd, rd;
-  int cnt = 0;
   char message[ 500 ] = "";
 
-  if( ( fd = open(i2cdev.c_str(), O_RDWR) ) < 0 ) 
-  {
-    strncpy(message, strerror( errno ), 400);
-    fprintf(stderr, SD_ERR "Failed to open I2C port. %s\n", message);
-    error = -1;
-    return;
-  }
-
-  rd = flock(fd, LOCK_EX|LOCK_NB);
-
-  // try again if port locking failed
-  cnt = I2LOCK_MAX;
-  while( rd == 1 && cnt > 0 )
-  {
-    sleep( 1 );
-    rd = flock(fd, LOCK_EX|LOCK_NB);
-    cnt--;
-  }
-
- if( rd )
-  {
-    strncpy(message, strerror( errno ), 400);
-    fprintf(stderr, SD_ERR "Failed to open i2c port. %s\n", message);
-    close( fd );
-    return;
-  }
-
-  if( ioctl(fd, I2C_SLAVE, address) < 0 ) 
-  {
-    strncpy(message, strerror( errno ), 400);
-    fprintf(stderr, SD_ERR "Unable to get bus access to talk to slave. %s\n", message);
-    close( fd );
-    error = -3;
-    return;
-  }
-
   buffer[ 0 ] = reg; 
   buffer[ 1 ] = data;
 
   sprintf(message, "I2C[%02X] write byte [%02X] to register [%02X]\n", address, buffer[ 1 ], buffer[ 0 ] );
   fprintf(stderr, SD_DEBUG "%s", message);
 
-  if( write(fd, buffer, 2) != 2 ) 
-  {
-    strncpy(message, strerror( errno ), 400);
-    fprintf(stderr, SD_ERR "Error writing to I2C slave. %s\n", message);
-    close( fd );
-    error = -4;
-    return;
-  }
-
-  close( fd );
-  error = 0;
+  bus->Write(2, address, buffer, error);
 
   return;
 }
 
 /// I2Chip member function to write two bytes to given register address.
 
-/// After opening the device file the port is locked to avoid any other
-/// process using the interface at the same time. If the locking fails it
-/// is tried again maximum I2LOCK_MAX times while sleeping one second between
-/// the attempts. One register pointer byte is transfered to the I2C chip
-/// followed by two data bytes. 
+/// The transfer goes through the shared I2CBus object which keeps the
+/// device file open and locks it to avoid any other process using the
+/// interface at the same time. One register pointer byte is transfered to
+/// the I2C chip followed by two data bytes. 
 /// https://www.kernel.org/doc/Documentation/i2c/dev-interface
 void I2Chip::I2cWriteRegisterUInt16(uint8_t reg, uint16_t data, uint16_t address, uint8_t *buffer, int & error)
 {
-  int fd, rd;
-  int cnt = 0;
   char message[ 500 ] = "";
 
-  if( ( fd = open(i2cdev.c_str(), O_RDWR) ) < 0 ) 
-  {
-    strncpy(message, strerror( errno ), 400);
-    fprintf(stderr, SD_ERR "Failed to open I2C port. %s\n", message);
-    error = -1;
-    return;
-  }
-
-  rd = flock(fd, LOCK_EX|LOCK_NB);
-
-  // try again if port locking failed
-  cnt = I2LOCK_MAX;
-  while( rd == 1 && cnt > 0 )
-  {
-    sleep( 1 );
-    rd = flock(fd, LOCK_EX|LOCK_NB);
-    cnt--;
-  }
-
- if( rd )
-  {
-    strncpy(message, strerror( errno ), 400);
-    fprintf(stderr, SD_ERR "Failed to open i2c port. %s\n", message);
-    close( fd );
-    return;
-  }
-
-  if( ioctl(fd, I2C_SLAVE, address) < 0 ) 
-  {
-    strncpy(message, strerror( errno ), 400);
-    fprintf(stderr, SD_ERR "Unable to get bus access to talk to slave. %s\n", message);
-    close( fd );
-    error = -3;
-    return;
-  }
-
   buffer[ 0 ] = reg; 
   buffer[ 1 ] = (uint8_t)(( data & 0xFF00 ) >> 8); 
   buffer[ 2 ] = (uint8_t)( data & 0x00FF ); 
@@ -549,17 +256,7 @@ void I2Chip::I2cWriteRegisterUInt16(uint8_t reg, uint16_t data, uint16_t address
   sprintf(message, "I2C[%02X] write bytes [%02X %02X] to register [%02X]\n", address, buffer[ 1 ], buffer[ 2 ], buffer[ 0 ] );
   fprintf(stderr, SD_DEBUG "%s", message);
 
-  if( write(fd, buffer, 3) != 3 ) 
-  {
-    strncpy(message, strerror( errno ), 400);
-    fprintf(stderr, SD_ERR "Error writing to I2C slave. %s\n", message);
-    close( fd );
-    error = -4;
-    return;
-  }
-
-  close( fd );
-  error = 0;
+  bus->Write(3, address, buffer, error);
 
   return;
 }
@@ -572,8 +269,6 @@ void I2Chip::I2cWriteRegisterUInt16(uint8_t reg, uint16_t data, uint16_t address
 // from slave and -5 more or less data received than expected.
 void I2Chip::I2cWriteBytes(int Nbytes, uint16_t address, uint8_t *buffer, int & error)
 {
-  int fd, rd;
-  int cnt = 0;
   char message[ 500 ] = "";
 
   if( Nbytes > BUFFER_MAX )
@@ -584,58 +279,151 @@ void I2Chip::I2cWriteBytes(int Nbytes, uint16_t address, uint8_t *buffer, int &
     return;
   }
 
-  if( ( fd = open(i2cdev.c_str(), O_RDWR) ) < 0 )
+  sprintf(message, "I2C[%02X] write\n", address);
+  fprintf(stderr, SD_DEBUG "%s", message);
+
+  bus->Write(Nbytes, address, buffer, error);
+
+  return;
+}
+
+/// Shadow registers are kept for one chip address only. If a derived class
+/// switches address all cached values are dropped.
+void I2Chip::ShadowCheckAddress(uint16_t address)
+{
+  if( address != shadowaddress )
   {
-    strncpy(message, strerror( errno ), 400);
-    fprintf(stderr, SD_ERR "Failed to open I2C port. %s\n", message);
-    error = -1;
-    return;
+    ShadowInvalidate();
+    shadowaddress = address;
   }
-      
-  rd = flock(fd, LOCK_EX|LOCK_NB);
+}
+
+/// I2Chip member function to read one register through shadow cache.
+uint8_t I2Chip::ShadowReadUInt8(uint8_t reg, uint16_t address, uint8_t *buffer, int & error)
+{
+  uint8_t data = 0;
+
+  ShadowCheckAddress( address );
 
-  // try again if port locking failed
-  cnt = I2LOCK_MAX;
-  while( rd == 1 && cnt > 0 )
+  if( shadowvalid.test( reg ) )
   {
-    sleep( 1 );
-    rd = flock(fd, LOCK_EX|LOCK_NB);
-    cnt--;
+    error = 0;
+    return shadow[ reg ];
   }
 
-  if( rd )
+  data = I2Chip::I2cReadRegisterUInt8(reg, address, buffer, error);
+
+  if( error == 0 )
   {
-    strncpy(message, strerror( errno ), 400);
-    fprintf(stderr, SD_ERR "Failed to lock I2C port. %s\n", message);
-    close( fd );
-    error = -2;
-    return;
+    shadow[ reg ] = data;
+    shadowvalid.set( reg );
   }
 
-  if( ioctl(fd, I2C_SLAVE, address) < 0 )
+  return data;
+}
+
+/// I2Chip member function to write one register through shadow cache.
+void I2Chip::ShadowWriteUInt8(uint8_t reg, uint8_t data, uint16_t address, uint8_t *buffer, int & error)
+{
+  ShadowCheckAddress( address );
+
+  shadow[ reg ] = data;
+  shadowvalid.set( reg );
+
+  if( deferred )
   {
-    strncpy(message, strerror( errno ), 400);
-    fprintf(stderr, SD_ERR "Unable to get bus access to talk to slave. %s\n", message);
-    close( fd );
-    error = -3;
+    shadowdirty.set( reg );
+    error = 0;
     return;
   }
 
-  sprintf(message, "I2C[%02X] write", address);
-  fprintf(stderr, SD_DEBUG "%s", message);
+  I2Chip::I2cWriteRegisterUInt8(reg, data, address, buffer, error);
+
+  if( error != 0 ) shadowvalid.reset( reg );
+
+  return;
+}
+
+/// I2Chip member function to write dirty shadow registers in bursts.
 
-  if( write(fd, buffer, Nbytes) != Nbytes ) 
+/// Each run of consecutive dirty registers is sent as register pointer,
+/// or'ed with the auto-increment flag if the run is longer than one,
+/// followed by the register values. For chips using register and data
+/// pairs the dirty registers are collected in one transfer instead.
+void I2Chip::ShadowFlush(uint16_t address, uint8_t *buffer, int & error)
+{
+  int first = 0, last = 0, Nbytes = 0;
+  int err = 0;
+
+  ShadowCheckAddress( address );
+  deferred = false;
+  error = 0;
+
+  while( pairwrite && ( first < SHADOW_MAX ) )
   {
-    strncpy(message, strerror( errno ), 400);
-    fprintf(stderr, SD_ERR "Error writing to I2C slave. %s\n", message);
-    close( fd );
-    error = -4;
-    return;
+    Nbytes = 0;
+    for(last = first; ( last < SHADOW_MAX ) && ( Nbytes + 2 <= BUFFER_MAX ); last++)
+    {
+      if( !shadowdirty.test( last ) ) continue;
+      buffer[ Nbytes++ ] = (uint8_t)last;
+      buffer[ Nbytes++ ] = shadow[ last ];
+    }
+
+    if( Nbytes > 0 ) I2Chip::I2cWriteBytes(Nbytes, address, buffer, err);
+
+    if( ( Nbytes > 0 ) && ( err == 0 ) )
+    {
+      for(int i = first; i < last; i++) shadowdirty.reset( i );
+    }
+    else if( Nbytes > 0 ) error = err;
+
+    first = last;
   }
 
-  close( fd );
-  error = 0;
+  while( first < SHADOW_MAX )
+  {
+    if( !shadowdirty.test( first ) ) { first++; continue; }
+
+    last = first;
+    while( ( last + 1 < SHADOW_MAX ) && shadowdirty.test( last + 1 ) && ( last + 2 - first < BUFFER_MAX ) ) last++;
+
+    Nbytes = last - first + 1;
+    buffer[ 0 ] = (uint8_t)first;
+    if( Nbytes > 1 ) buffer[ 0 ] |= autoinc;
+    for(int i = 0; i < Nbytes; i++) buffer[ i + 1 ] = shadow[ first + i ];
+
+    I2Chip::I2cWriteBytes(Nbytes + 1, address, buffer, err);
+
+    if( err == 0 )
+    {
+      for(int i = first; i <= last; i++) shadowdirty.reset( i );
+    }
+    else error = err;
+
+    first = last + 1;
+  }
 
   return;
 }
 
+/// I2Chip member function to read registers into shadow cache.
+void I2Chip::ShadowRefresh(uint8_t reg, int Nbytes, uint16_t address, uint8_t *buffer, int & error)
+{
+  ShadowCheckAddress( address );
+
+  if( reg + Nbytes > SHADOW_MAX ) Nbytes = SHADOW_MAX - reg;
+
+  if( Nbytes > 1 ) I2Chip::I2cReadRegisters(reg | autoinc, Nbytes, address, buffer, error);
+  else I2Chip::I2cReadRegisters(reg, Nbytes, address, buffer, error);
+
+  if( error != 0 ) return;
+
+  for(int i = 0; i < Nbytes; i++)
+  {
+    if( shadowdirty.test( reg + i ) ) continue;
+    shadow[ reg + i ] = buffer[ i ];
+    shadowvalid.set( reg + i );
+  }
+
+  return;
+}
@@ -2,7 +2,7 @@
  * 
  * I2Chip class definitions and constructor. 
  *       
- * Copyright (C) 2020 Jaakko Koivuniemi.
+ * Copyright (C) 2020 - 2026 Jaakko Koivuniemi.
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -20,7 +20,7 @@
  ****************************************************************************
  *
  * Fri Jul  3 11:54:51 CDT 2020
- * Edit: 
+ * Edit: Sat Oct 17 14:21:05 CDT 2026
  *
  * Jaakko Koivuniemi
  **/
@@ -28,18 +28,25 @@
 #ifndef _I2CHIP_HPP
 #define _I2CHIP_HPP 
 
-#include <linux/i2c-dev.h>
-#include <linux/i2c.h>
+#include "I2CBus.hpp"
 #include <systemd/sd-daemon.h>
 #include <string>
+#include <bitset>
 
-#define I2LOCK_MAX 10        ///< Maximum number of times I2C device file locking is attempted. 
 #define BUFFER_MAX 256  ///< Maximum size for I2C read-write buffer.
+#define SHADOW_MAX 256  ///< Number of 8-bit registers in shadow cache.
 
 /// Class for chips with Inter-Integrated Circuit interface (I2C).
 
 /// The constructor _I2Chip()_ takes name tag, device file for reading
-/// and writing serial data, 
+/// and writing serial data, and chip address. All chips on the same device
+/// file share one I2CBus object which keeps the device file open.
+///
+/// Each chip keeps a shadow copy of the 8-bit registers it has written or
+/// read through _ShadowReadUInt8()_ and _ShadowWriteUInt8()_. Setters can
+/// then modify control registers without first reading them over the bus.
+/// Between _ShadowDefer()_ and _ShadowFlush()_ writes only mark registers
+/// dirty and consecutive dirty registers are written in one burst.
 
 class I2Chip
 {
@@ -47,10 +54,22 @@ class I2Chip
     std::string i2cdev; ///< device file to read and write serial data
     uint16_t address; ///< I2C chip address
     int error;       ///< error flag for I2C communication
+    I2CBus *bus;     ///< shared bus for device file
 
     /// buffer to transfer serial data to and from chip
     uint8_t buffer[ BUFFER_MAX ] = { };
 
+    uint8_t shadow[ SHADOW_MAX ] = { }; ///< shadow copy of chip registers
+    std::bitset<SHADOW_MAX> shadowvalid; ///< shadow register matches chip
+    std::bitset<SHADOW_MAX> shadowdirty; ///< shadow register not yet written
+    uint16_t shadowaddress = 0; ///< chip address shadow registers belong to
+    uint8_t autoinc = 0;  ///< register auto-increment flag for bursts
+    bool pairwrite = false; ///< bursts as register and data pairs
+    bool deferred = false; ///< collect writes until ShadowFlush()
+
+    /// Drop shadow registers if chip address has changed.
+    void ShadowCheckAddress(uint16_t address);
+
   public:
     /// Construct I2Chips object.
     I2Chip();
@@ -69,8 +88,11 @@ class I2Chip
     /// Set I2C chip name tag.
     void SetName(std::string name) { this->name = name; }
 
+    /// Get shared I2C bus object.
+    I2CBus * GetBus() { return bus; }
+
     /// Set I2C chip device file name.
-    void SetDevice(std::string i2cdev) { this->i2cdev = i2cdev; }
+    void SetDevice(std::string i2cdev) { this->i2cdev = i2cdev; this->bus = I2CBus::Get( i2cdev ); }
 
     /// Read one byte from I2C address and return unsigned value.
 
@@ -108,6 +130,27 @@ class I2Chip
     /// from slave and -5 more or less data received than expected.
     void I2cReadBytes(int Nbytes, uint16_t address, uint8_t *buffer, int & error);
 
+    /// Read N bytes starting from 8-bit register on I2C address.
+
+    /// The register pointer is written and the data read in one combined
+    /// transfer with repeated start. For chips which need a flag for
+    /// register auto-increment the flag must be included in _reg_.
+    /// Error codes: -1 failed to open I2C port, -2 failed to lock I2C port,
+    /// -4 combined transfer failed and -6 more than buffer size requested.
+    void I2cReadRegisters(uint8_t reg, int Nbytes, uint16_t address, uint8_t *buffer, int & error);
+
+    /// Read 8-bit register on I2C address and return unsigned value.
+
+    /// The register pointer is written and the data read in one combined
+    /// transfer with repeated start. Error codes as in I2cReadRegisters().
+    uint8_t I2cReadRegisterUInt8(uint8_t reg, uint16_t address, uint8_t *buffer, int & error);
+
+    /// Read two bytes from register on I2C address and return unsigned value.
+
+    /// The first byte in read buffer is the most significant byte in conversion
+    /// to uint16_t data type. Error codes as in I2cReadRegisters().
+    uint16_t I2cReadRegisterUInt16(uint8_t reg, uint16_t address, uint8_t *buffer, int & error);
+
     /// Write one byte to I2C address.
 
     /// The chip I2C address and pointer to buffer are given as parameters.
@@ -142,6 +185,48 @@ class I2Chip
     /// from slave and -5 more or less data transfered than expected.
     void I2cWriteBytes(int Nbytes, uint16_t address, uint8_t *buffer, int & error);
 
+    /// Set flag or'ed with first register in burst transfers.
+    void SetAutoIncrement(uint8_t autoinc) { this->autoinc = autoinc; }
+
+    /// Use register and data pairs in burst writes for chips without
+    /// write auto-increment.
+    void SetPairWrite(bool pairwrite) { this->pairwrite = pairwrite; }
+
+    /// Read 8-bit register from shadow cache or from chip if not cached.
+
+    /// Only use for registers which the chip itself does not modify.
+    /// Error codes as in I2cReadRegisters().
+    uint8_t ShadowReadUInt8(uint8_t reg, uint16_t address, uint8_t *buffer, int & error);
+
+    /// Write 8-bit register through shadow cache.
+
+    /// The register is written to chip immediately unless ShadowDefer()
+    /// has been called, in which case it is only marked dirty.
+    /// Error codes as in I2cWriteRegisterUInt8().
+    void ShadowWriteUInt8(uint8_t reg, uint8_t data, uint16_t address, uint8_t *buffer, int & error);
+
+    /// Collect following shadow register writes until ShadowFlush().
+    void ShadowDefer() { deferred = true; }
+
+    /// Write all dirty shadow registers to chip.
+
+    /// Consecutive dirty registers are written in one auto-increment burst.
+    /// With SetPairWrite() all dirty registers are written in one transfer
+    /// as register and data pairs. Registers which failed to be written stay dirty.
+    /// Error codes as in I2cWriteBytes().
+    void ShadowFlush(uint16_t address, uint8_t *buffer, int & error);
+
+    /// Read N registers from chip into shadow cache in one transfer.
+
+    /// Error codes as in I2cReadRegisters().
+    void ShadowRefresh(uint8_t reg, int Nbytes, uint16_t address, uint8_t *buffer, int & error);
+
+    /// Forget all shadow registers, for example after chip reset.
+    void ShadowInvalidate() { shadowvalid.reset(); shadowdirty.reset(); }
+
+    /// Forget one shadow register which the chip may have changed.
+    void ShadowInvalidate(uint8_t reg) { shadowvalid.reset( reg ); shadowdirty.reset( reg ); }
+
 };
 
 #endif
@@ -2,7 +2,7 @@
  * 
  * Lis2mdl class member functions for configuration and reading with I2C. 
  *       
- * Copyright (C) 2022 Jaakko Koivuniemi.
+ * Copyright (C) 2022 - 2026 Jaakko Koivuniemi.
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -20,7 +20,7 @@
  ****************************************************************************
  *
  * Sat 26 Mar 2022 10:50:20 AM CET
- * Edit: Fri Apr 22 17:20:05 CDT 2022
+ * Edit: Sat Oct 17 14:21:05 CDT 2026
  *
  * Jaakko Koivuniemi
  **/
@@ -37,8 +37,7 @@ int16_t Lis2mdl::GetXOffset()
 {
   int16_t data = -9999;
 
-  I2Chip::I2cWriteUInt8(LIS2MDL_OFFSET_X_REG_L | LIS2MDL_MULTI_RW, address, buffer, error);
-  I2Chip::I2cReadBytes(2, address, buffer, error);
+  I2Chip::I2cReadRegisters(LIS2MDL_OFFSET_X_REG_L | LIS2MDL_MULTI_RW, 2, address, buffer, error);
 
   if( error == 0 )
   {
@@ -61,8 +60,7 @@ int16_t Lis2mdl::GetYOffset()
 {
   int16_t data = -9999;
 
-  I2Chip::I2cWriteUInt8(LIS2MDL_OFFSET_Y_REG_L | LIS2MDL_MULTI_RW, address, buffer, error);
-  I2Chip::I2cReadBytes(2, address, buffer, error);
+  I2Chip::I2cReadRegisters(LIS2MDL_OFFSET_Y_REG_L | LIS2MDL_MULTI_RW, 2, address, buffer, error);
       
   if( error == 0 )
   {
@@ -85,8 +83,7 @@ int16_t Lis2mdl::GetZOffset()
 {
   int16_t data = -9999;
 
-  I2Chip::I2cWriteUInt8(LIS2MDL_OFFSET_Z_REG_L | LIS2MDL_MULTI_RW, address, buffer, error);
-  I2Chip::I2cReadBytes(2, address, buffer, error);
+  I2Chip::I2cReadRegisters(LIS2MDL_OFFSET_Z_REG_L | LIS2MDL_MULTI_RW, 2, address, buffer, error);
       
   if( error == 0 )
   {
@@ -109,8 +106,7 @@ bool Lis2mdl::WhoAmI()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS2MDL_WHO_AM_I, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS2MDL_WHO_AM_I, address, buffer, error);
 
   return (reg == 0x40);
 }
@@ -120,11 +116,10 @@ void Lis2mdl::TempCompEnable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS2MDL_CFG_REG_A, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS2MDL_CFG_REG_A, address, buffer, error);
   reg |= 0x80;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS2MDL_CFG_REG_A, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS2MDL_CFG_REG_A, reg, address, buffer, error);
 }
 
 /// Clear bit COMP_TEMP_EN in register CFG_REG_A.
@@ -132,35 +127,72 @@ void Lis2mdl::TempCompDisable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS2MDL_CFG_REG_A, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS2MDL_CFG_REG_A, address, buffer, error);
   reg &= 0x7F;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS2MDL_CFG_REG_A, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS2MDL_CFG_REG_A, reg, address, buffer, error);
 }
 
-/// Set bit REBOOT in register CFG_REG_A.
+/// Set bit REBOOT in register CFG_REG_A. The chip reloads its registers
+/// so all shadow registers are invalidated.
 void Lis2mdl::Reboot()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS2MDL_CFG_REG_A, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS2MDL_CFG_REG_A, address, buffer, error);
   reg |= 0x40;
 
   I2Chip::I2cWriteRegisterUInt8(LIS2MDL_CFG_REG_A, reg, address, buffer, error);
+  I2Chip::ShadowInvalidate();
 }
 
-/// Set bit SOFT_RST in register CFG_REG_A.
+/// Set bit SOFT_RST in register CFG_REG_A. The chip reloads its registers
+/// so all shadow registers are invalidated.
 void Lis2mdl::SoftReset()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS2MDL_CFG_REG_A, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS2MDL_CFG_REG_A, address, buffer, error);
   reg |= 0x20;
 
   I2Chip::I2cWriteRegisterUInt8(LIS2MDL_CFG_REG_A, reg, address, buffer, error);
+  I2Chip::ShadowInvalidate();
+}
+
+/// Compute registers CFG_REG_A - CFG_REG_C from profile without reading
+/// the chip and write them in one auto-increment burst. Error -7 is set for
+/// values out of range.
+bool Lis2mdl::ApplyProfile(const Lis2mdlProfile & Profile)
+{
+  uint8_t cfg[ 3 ] = { };
+
+  if( ( Profile.DataRate > 3 ) || ( Profile.OpMode > 3 ) )
+  {
+    fprintf(stderr, SD_ERR "%s profile value out of range\n", name.c_str() );
+    error = -7;
+    return false;
+  }
+
+  if( Profile.TempComp ) cfg[ 0 ] |= 0x80;
+  if( Profile.LowPower ) cfg[ 0 ] |= 0x10;
+  cfg[ 0 ] |= Profile.DataRate << 2;
+  cfg[ 0 ] |= Profile.OpMode;
+
+  if( Profile.OffsetCancelSingle ) cfg[ 1 ] |= 0x10;
+  if( Profile.OffsetCancel ) cfg[ 1 ] |= 0x02;
+  if( Profile.LowPass ) cfg[ 1 ] |= 0x01;
+
+  if( Profile.BlockData ) cfg[ 2 ] |= 0x10;
+  if( Profile.LittleEndian ) cfg[ 2 ] |= 0x08;
+  if( Profile.SelfTest ) cfg[ 2 ] |= 0x02;
+
+  I2Chip::ShadowDefer();
+  for(int i = 0; i < 3; i++) I2Chip::ShadowWriteUInt8(LIS2MDL_CFG_REG_A + i, cfg[ i ], address, buffer, error);
+  I2Chip::ShadowFlush(address, buffer, error);
+
+  if( Profile.OpMode == 1 ) I2Chip::ShadowInvalidate(LIS2MDL_CFG_REG_A);
+
+  return ( error == 0 );
 }
 
 /// Set bit LP in register CFG_REG_A.
@@ -168,11 +200,10 @@ void Lis2mdl::LowPowerEnable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS2MDL_CFG_REG_A, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS2MDL_CFG_REG_A, address, buffer, error);
   reg |= 0x10;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS2MDL_CFG_REG_A, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS2MDL_CFG_REG_A, reg, address, buffer, error);
 }
 
 /// Clear bit LP in register CFG_REG_A.
@@ -180,11 +211,10 @@ void Lis2mdl::LowPowerDisable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS2MDL_CFG_REG_A, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS2MDL_CFG_REG_A, address, buffer, error);
   reg &= 0xEF;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS2MDL_CFG_REG_A, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS2MDL_CFG_REG_A, reg, address, buffer, error);
 }
 
 /// Read bits ODR[1:0] in register CFG_REG_A.
@@ -192,8 +222,7 @@ uint8_t Lis2mdl::GetDataRate()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS2MDL_CFG_REG_A, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS2MDL_CFG_REG_A, address, buffer, error);
   reg &= 0x0C;
   reg = reg >> 2;
 
@@ -206,12 +235,11 @@ void Lis2mdl::SetDataRate(uint8_t DataRate)
   uint8_t reg = 0;
   DataRate &= 0x03;
 
-  I2Chip::I2cWriteUInt8(LIS2MDL_CFG_REG_A, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS2MDL_CFG_REG_A, address, buffer, error);
   reg &= 0xF3;
   reg |=  DataRate << 2;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS2MDL_CFG_REG_A, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS2MDL_CFG_REG_A, reg, address, buffer, error);
 }
 
 /// Read bits MD[1:0] from register CFG_REG_A.
@@ -219,8 +247,7 @@ uint8_t Lis2mdl::GetOpMode()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS2MDL_CFG_REG_A, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS2MDL_CFG_REG_A, address, buffer, error);
   reg &= 0x03;
 
   return reg;
@@ -232,12 +259,11 @@ void Lis2mdl::SetOpMode(uint8_t OpMode)
   uint8_t reg = 0;
   OpMode &= 0x03;
 
-  I2Chip::I2cWriteUInt8(LIS2MDL_CFG_REG_A, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS2MDL_CFG_REG_A, address, buffer, error);
   reg &= 0xFC;
   reg |= OpMode;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS2MDL_CFG_REG_A, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS2MDL_CFG_REG_A, reg, address, buffer, error);
 }
 
 /// Set bits MD1 and set MD0 in register CFG_REG_A.
@@ -245,24 +271,24 @@ void Lis2mdl::IdleMode()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS2MDL_CFG_REG_A, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS2MDL_CFG_REG_A, address, buffer, error);
   reg |= 0x03;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS2MDL_CFG_REG_A, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS2MDL_CFG_REG_A, reg, address, buffer, error);
 }
 
-/// Clear bit MD1 and set MD0 in register CFG_REG_A.
+/// Clear bit MD1 and set MD0 in register CFG_REG_A. The chip returns to idle
+/// after conversion so the shadow register is invalidated.
 void Lis2mdl::SingleMode()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS2MDL_CFG_REG_A, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS2MDL_CFG_REG_A, address, buffer, error);
   reg &= 0xFD;
   reg |= 0x01;
 
   I2Chip::I2cWriteRegisterUInt8(LIS2MDL_CFG_REG_A, reg, address, buffer, error);
+  I2Chip::ShadowInvalidate(LIS2MDL_CFG_REG_A);
 }
 
 /// Clear bits MD1 and MD0 in register CFG_REG_A.
@@ -270,11 +296,10 @@ void Lis2mdl::ContinuousMode()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS2MDL_CFG_REG_A, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS2MDL_CFG_REG_A, address, buffer, error);
   reg &= 0xFC;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS2MDL_CFG_REG_A, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS2MDL_CFG_REG_A, reg, address, buffer, error);
 }
 
 /// Set bit OFF_CANC_ONE_SHOT in register CFG_REG_B.
@@ -282,11 +307,10 @@ void Lis2mdl::OffsetCancelSingleEnable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS2MDL_CFG_REG_B, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS2MDL_CFG_REG_B, address, buffer, error);
   reg |= 0x10;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS2MDL_CFG_REG_B, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS2MDL_CFG_REG_B, reg, address, buffer, error);
 }
 
 /// Clear bit OFF_CANC_ONE_SHOT in register CFG_REG_B.
@@ -294,11 +318,10 @@ void Lis2mdl::OffsetCancelSingleDisable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS2MDL_CFG_REG_B, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS2MDL_CFG_REG_B, address, buffer, error);
   reg &= 0xEF;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS2MDL_CFG_REG_B, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS2MDL_CFG_REG_B, reg, address, buffer, error);
 }
 
 /// Set bit OFF_CANC in register CFG_REG_B.
@@ -306,11 +329,10 @@ void Lis2mdl::OffsetCancelEnable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS2MDL_CFG_REG_B, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS2MDL_CFG_REG_B, address, buffer, error);
   reg |= 0x02;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS2MDL_CFG_REG_B, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS2MDL_CFG_REG_B, reg, address, buffer, error);
 }
 
 /// Clear bit OFF_CANC in register CFG_REG_B.
@@ -318,11 +340,10 @@ void Lis2mdl::OffsetCancelDisable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS2MDL_CFG_REG_B, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS2MDL_CFG_REG_B, address, buffer, error);
   reg &= 0xFD;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS2MDL_CFG_REG_B, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS2MDL_CFG_REG_B, reg, address, buffer, error);
 }
 
 /// Set bit LPF in register CFG_REG_B.
@@ -330,11 +351,10 @@ void Lis2mdl::LowPassEnable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS2MDL_CFG_REG_B, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS2MDL_CFG_REG_B, address, buffer, error);
   reg |= 0x01;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS2MDL_CFG_REG_B, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS2MDL_CFG_REG_B, reg, address, buffer, error);
 }
 
 /// Clear bit LPF in register CFG_REG_B.
@@ -342,11 +362,10 @@ void Lis2mdl::LowPassDisable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS2MDL_CFG_REG_B, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS2MDL_CFG_REG_B, address, buffer, error);
   reg &= 0xFE;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS2MDL_CFG_REG_B, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS2MDL_CFG_REG_B, reg, address, buffer, error);
 }
 
 /// Set bit BDU in register CFG_REG_C.
@@ -354,10 +373,9 @@ void Lis2mdl::BlockDataEnable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS2MDL_CFG_REG_C, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS2MDL_CFG_REG_C, address, buffer, error);
   reg |= 0x10;
-  I2Chip::I2cWriteRegisterUInt8(LIS2MDL_CFG_REG_C, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS2MDL_CFG_REG_C, reg, address, buffer, error);
 }
 
 /// Clear bit BDU in register CFG_REG_C.
@@ -365,11 +383,10 @@ void Lis2mdl::BlockDataDisable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS2MDL_CFG_REG_C, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS2MDL_CFG_REG_C, address, buffer, error);
   reg &= 0xEF;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS2MDL_CFG_REG_C, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS2MDL_CFG_REG_C, reg, address, buffer, error);
 }
 
 /// Clear bit BLE in register CFG_REG_C.
@@ -377,11 +394,10 @@ void Lis2mdl::BigEndian()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS2MDL_CFG_REG_C, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS2MDL_CFG_REG_C, address, buffer, error);
   reg &= 0xF7;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS2MDL_CFG_REG_C, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS2MDL_CFG_REG_C, reg, address, buffer, error);
 }
 
 /// Set bit BLE in register CFG_REG_C.
@@ -389,11 +405,10 @@ void Lis2mdl::LittleEndian()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS2MDL_CFG_REG_C, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS2MDL_CFG_REG_C, address, buffer, error);
   reg |= 0x08;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS2MDL_CFG_REG_C, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS2MDL_CFG_REG_C, reg, address, buffer, error);
 }
 
 /// Read register STATUS_REG.
@@ -401,8 +416,7 @@ uint8_t Lis2mdl::GetStatus()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS2MDL_STATUS_REG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS2MDL_STATUS_REG, address, buffer, error);
 
   return reg;
 }
@@ -412,9 +426,7 @@ uint16_t Lis2mdl::GetIntThreshold()
 {
   uint16_t data = 9999;
 
-  I2Chip::I2cWriteUInt8(LIS2MDL_INT_THS_L_REG | LIS2MDL_MULTI_RW, address, buffer, error);
-
-  I2Chip::I2cReadBytes(2, address, buffer, error);
+  I2Chip::I2cReadRegisters(LIS2MDL_INT_THS_L_REG | LIS2MDL_MULTI_RW, 2, address, buffer, error);
   if( error == 0 )
   {
     data = (uint16_t)( buffer[ 0 ] ) | ( buffer[ 1 ] << 8 );
@@ -436,7 +448,7 @@ bool Lis2mdl::ReadB()
 {
   bool success = true;
 
-  I2Chip::I2cWriteUInt8(LIS2MDL_OUTX_L_REG | LIS2MDL_MULTI_RW, address, buffer, error);
+  I2Chip::I2cReadRegisters(LIS2MDL_OUTX_L_REG | LIS2MDL_MULTI_RW, 8, address, buffer, error);
 
   if( error != 0 )
   {
@@ -444,25 +456,16 @@ bool Lis2mdl::ReadB()
   }
   else
   { 
-    I2cReadBytes(8, address, buffer, error);
-
-    if( error != 0 )
-    {
-      success = false;
-    }
-    else
-    { 
-      outX = (int16_t)( buffer[ 0 ] | ( buffer[ 1 ] << 8 ) );
-      outY = (int16_t)( buffer[ 2 ] | ( buffer[ 3 ] << 8 ) );
-      outZ = (int16_t)( buffer[ 4 ] | ( buffer[ 5 ] << 8 ) );
-      temp = (int16_t)( buffer[ 6 ] | ( buffer[ 7 ] << 8 ) );
+    outX = (int16_t)( buffer[ 0 ] | ( buffer[ 1 ] << 8 ) );
+    outY = (int16_t)( buffer[ 2 ] | ( buffer[ 3 ] << 8 ) );
+    outZ = (int16_t)( buffer[ 4 ] | ( buffer[ 5 ] << 8 ) );
+    temp = (int16_t)( buffer[ 6 ] | ( buffer[ 7 ] << 8 ) );
       
-      Bx = 100 * outX / Gain;
-      By = 100 * outY / Gain;
-      Bz = 100 * outZ / Gain;
-      T = temp / 256.0 + 25.0;
-    }   
-  }
+    Bx = 100 * outX / Gain;
+    By = 100 * outY / Gain;
+    Bz = 100 * outZ / Gain;
+    T = temp / 256.0 + 25.0;
+  }   
 
   return success;
 }
@@ -472,7 +475,7 @@ bool Lis2mdl::ReadBx()
 {
   bool success = true;
 
-  I2Chip::I2cWriteUInt8(LIS2MDL_OUTX_H_REG | LIS2MDL_MULTI_RW, address, buffer, error);
+  I2Chip::I2cReadRegisters(LIS2MDL_OUTX_H_REG | LIS2MDL_MULTI_RW, 2, address, buffer, error);
 
   if( error != 0 )
   {
@@ -480,17 +483,8 @@ bool Lis2mdl::ReadBx()
   }
   else
   {
-    I2cReadBytes(2, address, buffer, error);
-
-    if( error != 0 )
-    {
-      success = false;
-    }
-    else
-    {
-      outX = (int16_t)( buffer[ 0 ] | ( buffer[ 1 ] << 8 ) );
-      Bx = 100 * outX / Gain;
-    }
+    outX = (int16_t)( buffer[ 0 ] | ( buffer[ 1 ] << 8 ) );
+    Bx = 100 * outX / Gain;
   }
 
   return success;
@@ -501,7 +495,7 @@ bool Lis2mdl::ReadBy()
 {
   bool success = true;
 
-  I2Chip::I2cWriteUInt8(LIS2MDL_OUTY_H_REG | LIS2MDL_MULTI_RW, address, buffer, error);
+  I2Chip::I2cReadRegisters(LIS2MDL_OUTY_H_REG | LIS2MDL_MULTI_RW, 2, address, buffer, error);
 
   if( error != 0 )
   {
@@ -509,17 +503,8 @@ bool Lis2mdl::ReadBy()
   }
   else
   {
-    I2cReadBytes(2, address, buffer, error);
-
-    if( error != 0 )
-    {
-      success = false;
-    }
-    else
-    {
-      outY = (int16_t)( buffer[ 0 ] | ( buffer[ 1 ] << 8 ) );
-      By = 100 * outY / Gain;
-    }
+    outY = (int16_t)( buffer[ 0 ] | ( buffer[ 1 ] << 8 ) );
+    By = 100 * outY / Gain;
   }
 
   return success;
@@ -530,7 +515,7 @@ bool Lis2mdl::ReadBz()
 {
   bool success = true;
 
-  I2Chip::I2cWriteUInt8(LIS2MDL_OUTZ_H_REG | LIS2MDL_MULTI_RW, address, buffer, error);
+  I2Chip::I2cReadRegisters(LIS2MDL_OUTZ_H_REG | LIS2MDL_MULTI_RW, 2, address, buffer, error);
 
   if( error != 0 )
   {
@@ -538,17 +523,8 @@ bool Lis2mdl::ReadBz()
   }
   else
   {
-    I2cReadBytes(2, address, buffer, error);
-
-    if( error != 0 )
-    {
-      success = false;
-    }
-    else
-    {
-      outZ = (int16_t)( buffer[ 0 ] | ( buffer[ 1 ] << 8 ) );
-      Bz = 100 * outZ / Gain;
-    }
+    outZ = (int16_t)( buffer[ 0 ] | ( buffer[ 1 ] << 8 ) );
+    Bz = 100 * outZ / Gain;
   }
 
   return success;
@@ -560,8 +536,7 @@ bool Lis2mdl::NewDataXYZ()
   bool newdata = false;
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS2MDL_STATUS_REG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS2MDL_STATUS_REG, address, buffer, error);
   reg &= 0x08;
 
   if( reg == 0x00) newdata = false; else newdata = true;
@@ -575,8 +550,7 @@ bool Lis2mdl::OverRunXYZ()
   bool overrun = false;
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS2MDL_STATUS_REG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS2MDL_STATUS_REG, address, buffer, error);
   reg &= 0x80;
 
   if( reg == 0x00) overrun = false; else overrun = true;
@@ -589,11 +563,10 @@ void Lis2mdl::SelfTestEnable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS2MDL_CFG_REG_C, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS2MDL_CFG_REG_C, address, buffer, error);
   reg |= 0x02;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS2MDL_CFG_REG_C, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS2MDL_CFG_REG_C, reg, address, buffer, error);
 }
 
 /// Clear bit Self_test in register CFG_REG_C. 
@@ -601,11 +574,10 @@ void Lis2mdl::SelfTestDisable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS2MDL_CFG_REG_C, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS2MDL_CFG_REG_C, address, buffer, error);
   reg &= 0xFD;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS2MDL_CFG_REG_C, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS2MDL_CFG_REG_C, reg, address, buffer, error);
 }
 
 
@@ -614,8 +586,7 @@ uint8_t Lis2mdl::GetIntConfig()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS2MDL_INT_CTRL_REG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS2MDL_INT_CTRL_REG, address, buffer, error);
 
   return reg;
 }
@@ -625,7 +596,7 @@ void Lis2mdl::SetIntConfig(uint8_t IntConf)
 {
   IntConf &= 0xE7;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS2MDL_INT_CTRL_REG, IntConf, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS2MDL_INT_CTRL_REG, IntConf, address, buffer, error);
 }
 
 /// Read register INT_SOURCE_REG.
@@ -633,8 +604,7 @@ uint8_t Lis2mdl::GetIntSource()
 {
   uint8_t reg = 0;
       
-  I2Chip::I2cWriteUInt8(LIS2MDL_INT_SOURCE_REG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS2MDL_INT_SOURCE_REG, address, buffer, error);
       
   return reg;
 }
@@ -2,7 +2,7 @@
  * 
  * Lis2mdl class definitions and constructor. Base class is I2Chip. 
  *       
- * Copyright (C) 2022 Jaakko Koivuniemi.
+ * Copyright (C) 2022 - 2026 Jaakko Koivuniemi.
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -20,7 +20,7 @@
  ****************************************************************************
  *
  * Fri 25 Mar 2022 05:38:47 PM CET
- * Edit: Fri Apr 22 17:19:40 CDT 2022
+ * Edit: Sat Oct 17 14:21:05 CDT 2026
  *
  * Jaakko Koivuniemi
  **/
@@ -56,6 +56,23 @@
 
 #define LIS2MDL_MULTI_RW   0x80
 
+/// Configuration profile for Lis2mdl applied with _Lis2mdl::ApplyProfile()_.
+
+/// The profile covers registers CFG_REG_A - CFG_REG_C.
+struct Lis2mdlProfile
+{
+    bool TempComp = false;    ///< temperature compensation
+    bool LowPower = false;    ///< low-power mode
+    uint8_t DataRate = 0;     ///< ODR[1:0] 0 - 3
+    uint8_t OpMode = 3;       ///< MD[1:0] 0 continuous, 1 single, 2 - 3 idle
+    bool OffsetCancelSingle = false; ///< OFF_CANC_ONE_SHOT
+    bool OffsetCancel = false; ///< OFF_CANC
+    bool LowPass = false;     ///< LPF
+    bool BlockData = false;   ///< block data update
+    bool LittleEndian = false; ///< BLE
+    bool SelfTest = false;    ///< self-test
+};
+
 /// Class for Lis2mdl inherited from I2Chip base class. 
 
 /// The constructor _Lis2mdl_ sets name tag, device file name and chip address
@@ -86,6 +103,7 @@ class Lis2mdl : public I2Chip
     /// Construct Lis2mdl object with parameters using default address.
     Lis2mdl(std::string name, std::string i2cdev) : I2Chip(name, i2cdev, 0x1E)
    {
+      I2Chip::SetAutoIncrement( LIS2MDL_MULTI_RW );
       this->name = name;
       this->i2cdev = i2cdev;
    };
@@ -104,6 +122,12 @@ class Lis2mdl : public I2Chip
     /// Get last error number.
     int GetError() { return error; }
 
+    /// Read N registers from chip into shadow cache in one transfer.
+    void ShadowRefresh(uint8_t reg, int Nbytes) { I2Chip::ShadowRefresh(reg, Nbytes, address, buffer, error); }
+
+    /// Write shadow registers collected after ShadowDefer() to chip.
+    void ShadowFlush() { I2Chip::ShadowFlush(address, buffer, error); }
+
     /// Get magnetic field value Bx[G] from last reading. 
     double GetBx() { return Bx; }
 
@@ -167,6 +191,9 @@ class Lis2mdl : public I2Chip
     /// Soft reset.
     void SoftReset();
 
+    /// Check profile, compute register image and write it in one burst.
+    bool ApplyProfile(const Lis2mdlProfile & Profile);
+
     /// Enable low-power mode.
     void LowPowerEnable();
 
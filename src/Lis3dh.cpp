@@ -2,7 +2,7 @@
  * 
  * Lis3dh class member functions for configuration and reading with I2C. 
  *       
- * Copyright (C) 2022 Jaakko Koivuniemi.
+ * Copyright (C) 2022 - 2026 Jaakko Koivuniemi.
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -20,7 +20,7 @@
  ****************************************************************************
  *
  * Sat Feb 26 19:29:54 CST 2022
- * Edit:
+ * Edit: Sat Oct 17 14:21:05 CDT 2026
  *
  * Jaakko Koivuniemi
  **/
@@ -38,8 +38,7 @@ bool Lis3dh::WhoAmI()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_WHO_AM_I, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS3DH_WHO_AM_I, address, buffer, error);
 
   return (reg == 0x33);
 }
@@ -49,8 +48,7 @@ uint8_t Lis3dh::GetStatus()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_STATUS_REG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS3DH_STATUS_REG, address, buffer, error);
 
   return reg;
 }
@@ -60,8 +58,7 @@ uint8_t Lis3dh::GetReference()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_REFERENCE, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS3DH_REFERENCE, address, buffer, error);
 
   return reg;
 }
@@ -71,8 +68,7 @@ uint8_t Lis3dh::GetCtrlReg1()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG1, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS3DH_CTRL_REG1, address, buffer, error);
 
   return reg;
 }
@@ -82,11 +78,10 @@ void Lis3dh::TempEnable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_TEMP_CFG_REG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_TEMP_CFG_REG, address, buffer, error);
   reg |= 0x40;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_TEMP_CFG_REG, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_TEMP_CFG_REG, reg, address, buffer, error);
 }
 
 /// Clear TEMP_EN bit in register TEMP_CFG_REG.
@@ -94,11 +89,10 @@ void Lis3dh::TempDisable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_TEMP_CFG_REG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_TEMP_CFG_REG, address, buffer, error);
   reg &= 0xBF;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_TEMP_CFG_REG, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_TEMP_CFG_REG, reg, address, buffer, error);
 }
 
 /// Enable ADC.
@@ -106,11 +100,10 @@ void Lis3dh::ADCEnable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_TEMP_CFG_REG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_TEMP_CFG_REG, address, buffer, error);
   reg |= 0x80;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_TEMP_CFG_REG, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_TEMP_CFG_REG, reg, address, buffer, error);
 }
 
 /// Disable ADC.
@@ -118,11 +111,10 @@ void Lis3dh::ADCDisable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_TEMP_CFG_REG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_TEMP_CFG_REG, address, buffer, error);
   reg &= 0x7F;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_TEMP_CFG_REG, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_TEMP_CFG_REG, reg, address, buffer, error);
 }
 
 /// Read bits ODR[3:0] from register CTRL_REG1.
@@ -130,8 +122,7 @@ uint8_t Lis3dh::GetDataRate()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG1, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS3DH_CTRL_REG1, address, buffer, error);
   reg &= 0xF0;
   reg = reg >> 4;
 
@@ -144,12 +135,11 @@ void Lis3dh::SetDataRate(uint8_t DataRate)
   uint8_t reg = 0;
   DataRate &= 0x0F;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG1, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG1, address, buffer, error);
 
   reg &= 0x0F;
   reg |=  DataRate << 4;
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG1, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG1, reg, address, buffer, error);
 }
 
 /// Set bit Xen in register CTRL_REG1. 
@@ -157,11 +147,10 @@ void Lis3dh::XEnable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG1, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG1, address, buffer, error);
   reg |= 0x01;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG1, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG1, reg, address, buffer, error);
 }
 
 /// Clear bit Xen in register CTRL_REG1. 
@@ -169,11 +158,10 @@ void Lis3dh::XDisable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG1, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG1, address, buffer, error);
   reg &= 0xFE;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG1, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG1, reg, address, buffer, error);
 }
 
 /// Set bit Yen in register CTRL_REG1. 
@@ -181,11 +169,10 @@ void Lis3dh::YEnable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG1, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG1, address, buffer, error);
   reg |= 0x02;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG1, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG1, reg, address, buffer, error);
 }
 
 /// Clear bit Yen in register CTRL_REG1. 
@@ -193,11 +180,10 @@ void Lis3dh::YDisable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG1, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG1, address, buffer, error);
   reg &= 0xFD;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG1, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG1, reg, address, buffer, error);
 }
 
 /// Set bit Zen in register CTRL_REG1. 
@@ -205,11 +191,10 @@ void Lis3dh::ZEnable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG1, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG1, address, buffer, error);
   reg |= 0x04;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG1, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG1, reg, address, buffer, error);
 }
 
 /// Clear bit Zen in register CTRL_REG1. 
@@ -217,11 +202,10 @@ void Lis3dh::ZDisable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG1, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG1, address, buffer, error);
   reg &= 0xFB;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG1, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG1, reg, address, buffer, error);
 }
 
 /// Read bits HPM[1:0] in register CTRL_REG2.
@@ -229,8 +213,7 @@ uint8_t Lis3dh::GetHpm()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG2, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS3DH_CTRL_REG2, address, buffer, error);
   reg &= 0xC0;
   reg = reg >> 6;
 
@@ -243,12 +226,11 @@ void Lis3dh::SetHpm(uint8_t Hpm)
   uint8_t reg = 0;
   Hpm &= 0x03;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG2, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG2, address, buffer, error);
   reg &= 0x3F;
   reg |=  Hpm << 6;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG2, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG2, reg, address, buffer, error);
 }
 
 /// Read bits HPCF[2:1] from register CTRL_REG2.
@@ -256,8 +238,7 @@ uint8_t Lis3dh::GetHpcf()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG2, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS3DH_CTRL_REG2, address, buffer, error);
   reg &= 0xCF;
   reg = reg >> 4;
 
@@ -270,12 +251,11 @@ void Lis3dh::SetHpcf(uint8_t Hpcf)
   uint8_t reg = 0;
   Hpcf &= 0x03;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG2, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG2, address, buffer, error);
   reg &= 0xCF;
   reg |=  Hpcf << 4;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG2, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG2, reg, address, buffer, error);
 }
 
 /// Clear bit FDS in register CTRL_REG2. 
@@ -283,11 +263,10 @@ void Lis3dh::FdBypass()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG2, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG2, address, buffer, error);
   reg &= 0xF7;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG2, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG2, reg, address, buffer, error);
 }
 
 /// Set bit FDS in register CTRL_REG2. 
@@ -295,11 +274,10 @@ void Lis3dh::FdSelect()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG2, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG2, address, buffer, error);
   reg |= 0x08;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG2, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG2, reg, address, buffer, error);
 }
 
 /// Set bit HP_IA1 in CTRL_REG2.
@@ -307,11 +285,10 @@ void Lis3dh::HpIa1Enable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG2, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG2, address, buffer, error);
   reg |= 0x01;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG2, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG2, reg, address, buffer, error);
 }
 
 /// Clear bit HP_IA1 in CTRL_REG2.
@@ -319,11 +296,10 @@ void Lis3dh::HpIa1Bypass()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG2, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG2, address, buffer, error);
   reg &= 0xFE;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG2, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG2, reg, address, buffer, error);
 }
 
 /// Set bit HP_IA2 in CTRL_REG2.
@@ -331,11 +307,10 @@ void Lis3dh::HpIa2Enable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG2, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG2, address, buffer, error);
   reg |= 0x02;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG2, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG2, reg, address, buffer, error);
 }
 
 /// Clear bit HP_IA2 in CTRL_REG2.
@@ -343,11 +318,10 @@ void Lis3dh::HpIa2Bypass()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG2, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG2, address, buffer, error);
   reg &= 0xFD;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG2, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG2, reg, address, buffer, error);
 }
 
 /// Set bit HPCLICK in CTRL_REG2.
@@ -355,11 +329,10 @@ void Lis3dh::HpClickEnable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG2, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG2, address, buffer, error);
   reg |= 0x04;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG2, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG2, reg, address, buffer, error);
 }
 
 /// Clear bit HPCLICK in CTRL_REG2.
@@ -367,11 +340,10 @@ void Lis3dh::HpClickDisable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG2, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG2, address, buffer, error);
   reg &= 0xFB;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG2, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG2, reg, address, buffer, error);
 }
 
 
@@ -380,11 +352,10 @@ void Lis3dh::BlockDataEnable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG4, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG4, address, buffer, error);
   reg |= 0x80; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG4, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG4, reg, address, buffer, error);
 }
 
 /// Clear bit BDU in CTRL_REG4.
@@ -392,11 +363,10 @@ void Lis3dh::BlockDataDisable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG4, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG4, address, buffer, error);
   reg &= 0x7F; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG4, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG4, reg, address, buffer, error);
 }
 
 /// Read bits FS[1:0] from register CTRL_REG4.
@@ -404,8 +374,7 @@ uint8_t Lis3dh::GetFullScale()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG4, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS3DH_CTRL_REG4, address, buffer, error);
   reg &= 0x30;
   reg = reg >> 4;
 
@@ -418,12 +387,11 @@ void Lis3dh::SetFullScale(uint8_t FullScale)
   uint8_t reg = 0;
   FullScale &= 0x03;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG4, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG4, address, buffer, error);
   reg &= 0xCF;
   reg |=  FullScale << 4;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG4, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG4, reg, address, buffer, error);
 
   if( FullScale == 0 ) FS = 2;
   else if( FullScale == 1 ) FS = 4;
@@ -436,11 +404,10 @@ void Lis3dh::BigEndian()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG4, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG4, address, buffer, error);
   reg |= 0x40; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG4, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG4, reg, address, buffer, error);
 }
 
 /// Clear bit BLE in CTRL_REG4.
@@ -448,11 +415,10 @@ void Lis3dh::LittleEndian()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG4, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG4, address, buffer, error);
   reg &= 0xBF; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG4, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG4, reg, address, buffer, error);
 }
 
 /// Set bit LPen in CTRL_REG1 and clear HR bit in CTRL_REG4.
@@ -460,17 +426,15 @@ void Lis3dh::LowPowerMode()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG1, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG1, address, buffer, error);
   reg |= 0x08; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG1, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG1, reg, address, buffer, error);
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG4, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG4, address, buffer, error);
   reg &= 0xF7; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG4, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG4, reg, address, buffer, error);
 
   So = 0.016; // Sensitivity at +-2 g full-scale
 }
@@ -480,17 +444,15 @@ void Lis3dh::NormalMode()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG1, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG1, address, buffer, error);
   reg &= 0xF7; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG1, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG1, reg, address, buffer, error);
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG4, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG4, address, buffer, error);
   reg &= 0xF7; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG4, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG4, reg, address, buffer, error);
 
   So = 0.004; // Sensitivity at +-2 g full-scale
 }
@@ -500,17 +462,15 @@ void Lis3dh::HighResolutionMode()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG1, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG1, address, buffer, error);
   reg &= 0xF7; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG1, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG1, reg, address, buffer, error);
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG4, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG4, address, buffer, error);
   reg |= 0x08; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG4, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG4, reg, address, buffer, error);
   
   So = 0.001; // Sensitivity at +-2 g full-scale
 }
@@ -521,24 +481,78 @@ void Lis3dh::SetSelfTest(uint8_t STMode)
   uint8_t reg = 0;
   STMode &= 0x03;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG4, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG4, address, buffer, error);
   reg &= 0xF9;
   reg |=  STMode << 1;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG4, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG4, reg, address, buffer, error);
 }
 
-/// Set bit BOOT in CTRL_REG5.
+/// Set bit BOOT in CTRL_REG5. The chip reloads its registers
+/// so all shadow registers are invalidated.
 void Lis3dh::Boot()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG5, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG5, address, buffer, error);
   reg |= 0x80; 
 
   I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG5, reg, address, buffer, error);
+  I2Chip::ShadowInvalidate();
+}
+
+/// Compute registers TEMP_CFG_REG, CTRL_REG1 - CTRL_REG6 and FIFO_CTRL_REG
+/// from profile without reading the chip. Registers from TEMP_CFG_REG to
+/// CTRL_REG6 are written in one auto-increment burst followed by
+/// FIFO_CTRL_REG. Error -7 is set for values out of range.
+bool Lis3dh::ApplyProfile(const Lis3dhProfile & Profile)
+{
+  uint8_t temp_cfg = 0, ctrl1 = 0, ctrl4 = 0, ctrl5 = 0, fifo_ctrl = 0;
+
+  if( ( Profile.DataRate > 9 ) || ( Profile.Mode > 2 ) || ( Profile.FullScale > 3 ) || ( Profile.FifoMode > 3 ) || ( Profile.Watermark > 31 ) )
+  {
+    fprintf(stderr, SD_ERR "%s profile value out of range\n", name.c_str() );
+    error = -7;
+    return false;
+  }
+
+  if( Profile.ADCEnable ) temp_cfg |= 0x80;
+  if( Profile.TempEnable ) temp_cfg |= 0x40;
+
+  ctrl1 = Profile.DataRate << 4;
+  if( Profile.Mode == 0 ) ctrl1 |= 0x08;
+  if( Profile.ZEnable ) ctrl1 |= 0x04;
+  if( Profile.YEnable ) ctrl1 |= 0x02;
+  if( Profile.XEnable ) ctrl1 |= 0x01;
+
+  if( Profile.BlockData ) ctrl4 |= 0x80;
+  if( Profile.BigEndian ) ctrl4 |= 0x40;
+  ctrl4 |= Profile.FullScale << 4;
+  if( Profile.Mode == 2 ) ctrl4 |= 0x08;
+
+  if( Profile.FifoEnable ) ctrl5 |= 0x40;
+
+  fifo_ctrl = Profile.FifoMode << 6;
+  if( Profile.StreamInt2 ) fifo_ctrl |= 0x20;
+  fifo_ctrl |= Profile.Watermark;
+
+  I2Chip::ShadowDefer();
+  I2Chip::ShadowWriteUInt8(LIS3DH_TEMP_CFG_REG, temp_cfg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG1, ctrl1, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG2, Profile.CtrlReg2, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG3, Profile.CtrlReg3, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG4, ctrl4, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG5, ctrl5, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG6, Profile.CtrlReg6, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_FIFO_CTRL_REG, fifo_ctrl, address, buffer, error);
+  I2Chip::ShadowFlush(address, buffer, error);
+
+  FS = 2 << Profile.FullScale;
+  if( Profile.Mode == 0 ) So = 16;
+  else if( Profile.Mode == 1 ) So = 4;
+  else So = 1;
+
+  return ( error == 0 );
 }
 
 /// Set bit FIFO_EN in CTRL_REG5.
@@ -546,11 +560,10 @@ void Lis3dh::FifoEnable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG5, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG5, address, buffer, error);
   reg |= 0x40; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG5, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG5, reg, address, buffer, error);
 }
 
 /// Clear bit FIFO_EN in CTRL_REG5.
@@ -558,11 +571,10 @@ void Lis3dh::FifoDisable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG5, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG5, address, buffer, error);
   reg &= 0xBF; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG5, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG5, reg, address, buffer, error);
 }
 
 /// Read bits FM[1:0] from register FIFO_CTRL_REG.
@@ -570,8 +582,7 @@ uint8_t Lis3dh::GetFifoMode()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_FIFO_CTRL_REG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS3DH_FIFO_CTRL_REG, address, buffer, error);
   reg &= 0xC0;
   reg = reg >> 6;
 
@@ -584,12 +595,11 @@ void Lis3dh::SetFifoMode(uint8_t FifoMode)
   uint8_t reg = 0;
   FifoMode &= 0x03;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_FIFO_CTRL_REG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_FIFO_CTRL_REG, address, buffer, error);
   reg &= 0x3F;
   reg |=  FifoMode << 6;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_FIFO_CTRL_REG, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_FIFO_CTRL_REG, reg, address, buffer, error);
 }
 
 /// Clear bit TR in FIFO_CTRL_REG.
@@ -597,11 +607,10 @@ void Lis3dh::StreamFifoInt1()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_FIFO_CTRL_REG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_FIFO_CTRL_REG, address, buffer, error);
   reg &= 0xDF; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_FIFO_CTRL_REG, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_FIFO_CTRL_REG, reg, address, buffer, error);
 }
 
 /// Set bit TR in FIFO_CTRL_REG.
@@ -609,11 +618,10 @@ void Lis3dh::StreamFifoInt2()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_FIFO_CTRL_REG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_FIFO_CTRL_REG, address, buffer, error);
   reg |= 0x20; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_FIFO_CTRL_REG, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_FIFO_CTRL_REG, reg, address, buffer, error);
 }
 
 /// Read bits FTH[4:0] from register FIFO_CTRL_REG.
@@ -621,8 +629,7 @@ uint8_t Lis3dh::GetWatermark()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_FIFO_CTRL_REG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS3DH_FIFO_CTRL_REG, address, buffer, error);
   reg &= 0x1F;
 
   return reg;
@@ -634,12 +641,11 @@ void Lis3dh::SetWatermark(uint8_t Wtm)
   uint8_t reg = 0;
 
   Wtm &= 0x1F;
-  I2Chip::I2cWriteUInt8(LIS3DH_FIFO_CTRL_REG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_FIFO_CTRL_REG, address, buffer, error);
   reg &= 0xE0;
   reg |= Wtm;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_FIFO_CTRL_REG, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_FIFO_CTRL_REG, reg, address, buffer, error);
 }
 
 /// Read FIFO_SRC_REG and return true if WTM bit set. 
@@ -647,8 +653,7 @@ bool Lis3dh::Watermark()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_FIFO_SRC_REG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS3DH_FIFO_SRC_REG, address, buffer, error);
   reg &= 0x80;
 
   return (reg == 0x80);
@@ -659,8 +664,7 @@ bool Lis3dh::Overrun()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_FIFO_SRC_REG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS3DH_FIFO_SRC_REG, address, buffer, error);
   reg &= 0x40;
 
   return (reg == 0x40);
@@ -671,8 +675,7 @@ bool Lis3dh::Empty()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_FIFO_SRC_REG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS3DH_FIFO_SRC_REG, address, buffer, error);
   reg &= 0x20;
 
   return (reg == 0x20);
@@ -683,8 +686,7 @@ uint8_t Lis3dh::Samples()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_FIFO_SRC_REG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS3DH_FIFO_SRC_REG, address, buffer, error);
   reg &= 0x1F;
 
   return reg;
@@ -695,8 +697,7 @@ bool Lis3dh::NewDataXYZ()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_STATUS_REG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS3DH_STATUS_REG, address, buffer, error);
   reg &= 0x08;
 
   return (reg == 0x08);
@@ -706,8 +707,7 @@ bool Lis3dh::NewDataXYZ()
 bool Lis3dh::OverRunXYZ()
 {
   uint8_t reg = 0;
-  I2Chip::I2cWriteUInt8(LIS3DH_STATUS_REG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS3DH_STATUS_REG, address, buffer, error);
   reg &= 0x80;
   return (reg == 0x80);
 }
@@ -717,11 +717,10 @@ void Lis3dh::ClickInt1Enable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG3, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG3, address, buffer, error);
   reg |= 0x80; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG3, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG3, reg, address, buffer, error);
 }
 
 /// Clear bit I1_CLICK in CTRL_REG3.
@@ -729,11 +728,10 @@ void Lis3dh::ClickInt1Disable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG3, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG3, address, buffer, error);
   reg &= 0x7F; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG3, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG3, reg, address, buffer, error);
 }
 
 /// Set bit I1_IA1 in CTRL_REG3.
@@ -741,11 +739,10 @@ void Lis3dh::Ia1Int1Enable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG3, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG3, address, buffer, error);
   reg |= 0x40; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG3, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG3, reg, address, buffer, error);
 }
 
 /// Clear bit I1_IA1 in CTRL_REG3.
@@ -753,11 +750,10 @@ void Lis3dh::Ia1Int1Disable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG3, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG3, address, buffer, error);
   reg &= 0xBF; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG3, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG3, reg, address, buffer, error);
 }
 
 /// Set bit I1_IA2 in CTRL_REG3.
@@ -765,11 +761,10 @@ void Lis3dh::Ia2Int1Enable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG3, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG3, address, buffer, error);
   reg |= 0x20; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG3, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG3, reg, address, buffer, error);
 }
 
 /// Clear bit I1_IA2 in CTRL_REG3.
@@ -777,11 +772,10 @@ void Lis3dh::Ia2Int1Disable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG3, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG3, address, buffer, error);
   reg &= 0xDF; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG3, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG3, reg, address, buffer, error);
 }
 
 /// Set bit I1_ZYXDA in CTRL_REG3.
@@ -789,11 +783,10 @@ void Lis3dh::ZYXDaInt1Enable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG3, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG3, address, buffer, error);
   reg |= 0x10; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG3, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG3, reg, address, buffer, error);
 }
 
 /// Clear bit I1_ZYXDA in CTRL_REG3.
@@ -801,11 +794,10 @@ void Lis3dh::ZYXDaInt1Disable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG3, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG3, address, buffer, error);
   reg &= 0xEF; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG3, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG3, reg, address, buffer, error);
 }
 
 /// Set bit I1_321DA in CTRL_REG3.
@@ -813,11 +805,10 @@ void Lis3dh::Da321Int1Enable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG3, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG3, address, buffer, error);
   reg |= 0x08; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG3, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG3, reg, address, buffer, error);
 }
 
 /// Clear bit I1_321DA in CTRL_REG3.
@@ -825,11 +816,10 @@ void Lis3dh::Da321Int1Disable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG3, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG3, address, buffer, error);
   reg &= 0xF7; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG3, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG3, reg, address, buffer, error);
 }
 
 /// Set bit I1_WTM in CTRL_REG3.
@@ -837,11 +827,10 @@ void Lis3dh::WtmInt1Enable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG3, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG3, address, buffer, error);
   reg |= 0x04; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG3, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG3, reg, address, buffer, error);
 }
 
 /// Clear bit I1_WTM in CTRL_REG3.
@@ -849,11 +838,10 @@ void Lis3dh::WtmInt1Disable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG3, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG3, address, buffer, error);
   reg &= 0xFB; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG3, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG3, reg, address, buffer, error);
 }
 
 /// Set bit I1_OVERRUN in CTRL_REG3.
@@ -861,11 +849,10 @@ void Lis3dh::OverrunInt1Enable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG3, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG3, address, buffer, error);
   reg |= 0x02; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG3, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG3, reg, address, buffer, error);
 }
 
 /// Clear bit I1_OVERRUN in CTRL_REG3.
@@ -873,11 +860,10 @@ void Lis3dh::OverrunInt1Disable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG3, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG3, address, buffer, error);
   reg &= 0xFD; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG3, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG3, reg, address, buffer, error);
 }
 
 /// Set bit I2_CLICK in CTRL_REG6.
@@ -885,11 +871,10 @@ void Lis3dh::ClickInt2Enable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG6, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG6, address, buffer, error);
   reg |= 0x80; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG6, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG6, reg, address, buffer, error);
 }
 
 /// Clear bit I2_CLICK in CTRL_REG6.
@@ -897,11 +882,10 @@ void Lis3dh::ClickInt2Disable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG6, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG6, address, buffer, error);
   reg &= 0x7F; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG6, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG6, reg, address, buffer, error);
 }
 
 /// Set bit I2_IA1 in CTRL_REG6.
@@ -909,11 +893,10 @@ void Lis3dh::Ia1Int2Enable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG6, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG6, address, buffer, error);
   reg |= 0x40; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG6, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG6, reg, address, buffer, error);
 }
 
 /// Clear bit I2_IA1 in CTRL_REG6.
@@ -921,11 +904,10 @@ void Lis3dh::Ia1Int2Disable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG6, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG6, address, buffer, error);
   reg &= 0xBF; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG6, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG6, reg, address, buffer, error);
 }
 
 /// Set bit I2_IA2 in CTRL_REG6.
@@ -933,11 +915,10 @@ void Lis3dh::Ia2Int2Enable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG6, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG6, address, buffer, error);
   reg |= 0x20; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG6, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG6, reg, address, buffer, error);
 }
 
 /// Clear bit I2_IA2 in CTRL_REG6.
@@ -945,11 +926,10 @@ void Lis3dh::Ia2Int2Disable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG6, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG6, address, buffer, error);
   reg &= 0xDF; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG6, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG6, reg, address, buffer, error);
 }
 
 /// Set bit I2_BOOT in CTRL_REG6.
@@ -957,11 +937,10 @@ void Lis3dh::Int2BootEnable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG6, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG6, address, buffer, error);
   reg |= 0x10; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG6, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG6, reg, address, buffer, error);
 }
 
 /// Clear bit I2_BOOT in CTRL_REG6.
@@ -969,11 +948,10 @@ void Lis3dh::Int2BootDisable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG6, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG6, address, buffer, error);
   reg &= 0xEF; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG6, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG6, reg, address, buffer, error);
 }
 
 /// Set bit I2_ACT in CTRL_REG6.
@@ -981,11 +959,10 @@ void Lis3dh::ActivityInt2Enable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG6, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG6, address, buffer, error);
   reg |= 0x08; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG6, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG6, reg, address, buffer, error);
 }
 
 
@@ -994,11 +971,10 @@ void Lis3dh::ActivityInt2Disable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG6, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG6, address, buffer, error);
   reg &= 0xF7; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG6, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG6, reg, address, buffer, error);
 }
 
 /// Clear bit INT_POLARITY in CTRL_REG6.
@@ -1006,11 +982,10 @@ void Lis3dh::IntActiveHigh()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG6, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG6, address, buffer, error);
   reg &= 0xFD; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG6, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG6, reg, address, buffer, error);
 }
 
 /// Set bit INT_POLARITY in CTRL_REG6.
@@ -1018,11 +993,10 @@ void Lis3dh::IntActiveLow()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CTRL_REG6, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CTRL_REG6, address, buffer, error);
   reg |= 0x02; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CTRL_REG6, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CTRL_REG6, reg, address, buffer, error);
 }
 
 /// Set bit ZD in CLICK_CFG.
@@ -1030,11 +1004,10 @@ void Lis3dh::DoubleTapZEnable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CLICK_CFG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CLICK_CFG, address, buffer, error);
   reg |= 0x20; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CLICK_CFG, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CLICK_CFG, reg, address, buffer, error);
 }
 
 /// Clear bit ZD in CLICK_CFG.
@@ -1042,11 +1015,10 @@ void Lis3dh::DoubleTapZDisable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CLICK_CFG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CLICK_CFG, address, buffer, error);
   reg &= 0xDF; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CLICK_CFG, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CLICK_CFG, reg, address, buffer, error);
 }
 
 /// Set bit ZS in CLICK_CFG.
@@ -1054,11 +1026,10 @@ void Lis3dh::SingleTapZEnable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CLICK_CFG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CLICK_CFG, address, buffer, error);
   reg |= 0x10; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CLICK_CFG, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CLICK_CFG, reg, address, buffer, error);
 }
 
 /// Clear bit ZS in CLICK_CFG.
@@ -1066,11 +1037,10 @@ void Lis3dh::SingleTapZDisable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CLICK_CFG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CLICK_CFG, address, buffer, error);
   reg &= 0xEF; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CLICK_CFG, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CLICK_CFG, reg, address, buffer, error);
 }
 
 /// Set bit YD in CLICK_CFG.
@@ -1078,11 +1048,10 @@ void Lis3dh::DoubleTapYEnable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CLICK_CFG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CLICK_CFG, address, buffer, error);
   reg |= 0x08; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CLICK_CFG, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CLICK_CFG, reg, address, buffer, error);
 }
 
 /// Clear bit YD in CLICK_CFG.
@@ -1090,11 +1059,10 @@ void Lis3dh::DoubleTapYDisable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CLICK_CFG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CLICK_CFG, address, buffer, error);
   reg &= 0xF7; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CLICK_CFG, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CLICK_CFG, reg, address, buffer, error);
 }
 
 /// Set bit YS in CLICK_CFG.
@@ -1102,11 +1070,10 @@ void Lis3dh::SingleTapYEnable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CLICK_CFG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CLICK_CFG, address, buffer, error);
   reg |= 0x04; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CLICK_CFG, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CLICK_CFG, reg, address, buffer, error);
 }
 
 /// Clear bit YS in CLICK_CFG.
@@ -1114,11 +1081,10 @@ void Lis3dh::SingleTapYDisable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CLICK_CFG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CLICK_CFG, address, buffer, error);
   reg &= 0xFB; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CLICK_CFG, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CLICK_CFG, reg, address, buffer, error);
 }
 
 /// Set bit XD in CLICK_CFG.
@@ -1126,11 +1092,10 @@ void Lis3dh::DoubleTapXEnable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CLICK_CFG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CLICK_CFG, address, buffer, error);
   reg |= 0x02; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CLICK_CFG, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CLICK_CFG, reg, address, buffer, error);
 }
 
 /// Clear bit XD in CLICK_CFG.
@@ -1138,11 +1103,10 @@ void Lis3dh::DoubleTapXDisable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CLICK_CFG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CLICK_CFG, address, buffer, error);
   reg &= 0xFD; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CLICK_CFG, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CLICK_CFG, reg, address, buffer, error);
 }
 
 /// Set bit XS in CLICK_CFG.
@@ -1150,11 +1114,10 @@ void Lis3dh::SingleTapXEnable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CLICK_CFG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CLICK_CFG, address, buffer, error);
   reg |= 0x01; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CLICK_CFG, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CLICK_CFG, reg, address, buffer, error);
 }
 
 /// Clear bit XS in CLICK_CFG.
@@ -1162,11 +1125,10 @@ void Lis3dh::SingleTapXDisable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CLICK_CFG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CLICK_CFG, address, buffer, error);
   reg &= 0xFE; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CLICK_CFG, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CLICK_CFG, reg, address, buffer, error);
 }
 
 /// Read CLICK_SRC and return true if IA bit set. 
@@ -1174,8 +1136,7 @@ bool Lis3dh::ClickInt()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CLICK_SRC, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS3DH_CLICK_SRC, address, buffer, error);
   reg &= 0x40;
 
   return (reg == 0x40);
@@ -1186,8 +1147,7 @@ bool Lis3dh::DoubleClick()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CLICK_SRC, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS3DH_CLICK_SRC, address, buffer, error);
   reg &= 0x20;
       
   return (reg == 0x20);
@@ -1198,8 +1158,7 @@ bool Lis3dh::SingleClick()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CLICK_SRC, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS3DH_CLICK_SRC, address, buffer, error);
   reg &= 0x10;
       
   return (reg == 0x10);
@@ -1210,8 +1169,7 @@ bool Lis3dh::ClickSign()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CLICK_SRC, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS3DH_CLICK_SRC, address, buffer, error);
   reg &= 0x08;
       
   return (reg == 0x08);
@@ -1222,8 +1180,7 @@ bool Lis3dh::ClickZ()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CLICK_SRC, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS3DH_CLICK_SRC, address, buffer, error);
   reg &= 0x04;
       
   return (reg == 0x04);
@@ -1234,8 +1191,7 @@ bool Lis3dh::ClickY()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CLICK_SRC, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS3DH_CLICK_SRC, address, buffer, error);
   reg &= 0x02;
       
   return (reg == 0x02);
@@ -1246,8 +1202,7 @@ bool Lis3dh::ClickX()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CLICK_SRC, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS3DH_CLICK_SRC, address, buffer, error);
   reg &= 0x01;
       
   return (reg == 0x01);
@@ -1258,8 +1213,7 @@ uint8_t Lis3dh::GetClickThs()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CLICK_THS, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS3DH_CLICK_THS, address, buffer, error);
   reg &= 0x7F;
       
   return reg;
@@ -1271,12 +1225,11 @@ void Lis3dh::SetClickThs(uint8_t Ths)
   uint8_t reg = 0;
   Ths &= 0x7F;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CLICK_THS, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CLICK_THS, address, buffer, error);
   reg &= 0x80;
   reg |= Ths;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CLICK_THS, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CLICK_THS, reg, address, buffer, error);
 }
 
 /// Set bit LIR_Click in CLICK_THS.
@@ -1284,11 +1237,10 @@ void Lis3dh::ClickLatchEnable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CLICK_THS, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CLICK_THS, address, buffer, error);
   reg |= 0x80; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CLICK_THS, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CLICK_THS, reg, address, buffer, error);
 }
 
 /// Clear bit LIR_Click in CLICK_THS.
@@ -1296,11 +1248,10 @@ void Lis3dh::ClickLatchDisable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_CLICK_THS, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_CLICK_THS, address, buffer, error);
   reg &= 0x7F; 
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_CLICK_THS, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_CLICK_THS, reg, address, buffer, error);
 }
 
 /// Modify bits TLI[6:0] in register TIME_LIMIT.
@@ -1309,24 +1260,23 @@ void Lis3dh::SetClickTlimit(uint8_t Tli)
   uint8_t reg = 0;
   Tli &= 0x7F;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_TIME_LIMIT, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_TIME_LIMIT, address, buffer, error);
   reg &= 0x80;
   reg |= Tli;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_TIME_LIMIT, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_TIME_LIMIT, reg, address, buffer, error);
 }
 
 /// Modify bits TLA[7:0] in register TIME_LATENCY.
 void Lis3dh::SetClickTlatency(uint8_t Tla)
 {
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_TIME_LATENCY, Tla, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_TIME_LATENCY, Tla, address, buffer, error);
 }
 
 /// Modify bits TW[7:0] in register TIME_WINDOW.
 void Lis3dh::SetClickTwindow(uint8_t Tw)
 {
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_TIME_WINDOW, Tw, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_TIME_WINDOW, Tw, address, buffer, error);
 }
 
 /// Read bits Acth[6:0] from register ACT_THS.
@@ -1334,8 +1284,7 @@ uint8_t Lis3dh::GetActThreshold()
 {
   uint8_t reg;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_ACT_THS, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS3DH_ACT_THS, address, buffer, error);
   reg &= 0x7F;
       
   return reg;
@@ -1347,12 +1296,11 @@ void Lis3dh::SetActThreshold(uint8_t Ths)
   uint8_t reg = 0;
   Ths &= 0x7F;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_ACT_THS, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3DH_ACT_THS, address, buffer, error);
   reg &= 0x80;
   reg |= Ths;
 
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_ACT_THS, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_ACT_THS, reg, address, buffer, error);
 }
 
 /// Read bits ActD[7:0] from register ACT_DUR.
@@ -1360,8 +1308,7 @@ uint8_t Lis3dh::GetActDuration()
 {
   uint8_t reg;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_ACT_DUR, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS3DH_ACT_DUR, address, buffer, error);
       
   return reg;
 }
@@ -1369,7 +1316,7 @@ uint8_t Lis3dh::GetActDuration()
 /// Modify bits ActD[7:0] in register ACT_DUR.
 void Lis3dh::SetActDuration(uint8_t Dur)
 {
-  I2Chip::I2cWriteRegisterUInt8(LIS3DH_ACT_DUR, Dur, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3DH_ACT_DUR, Dur, address, buffer, error);
 }
 
 /// Self-test procedure. Return true if success.
@@ -1383,7 +1330,7 @@ bool Lis3dh::Readg()
 {
   bool success = true;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_OUT_X_L | LIS3DH_MULTI_RW, address, buffer, error);
+  I2Chip::I2cReadRegisters(LIS3DH_OUT_X_L | LIS3DH_MULTI_RW, 6, address, buffer, error);
 
   if( error != 0 )
   {
@@ -1391,22 +1338,13 @@ bool Lis3dh::Readg()
   }
   else
   {
-    I2cReadBytes(6, address, buffer, error);
-
-    if( error != 0 )
-    {
-      success = false;
-    }
-    else
-    {
-      outX = (int16_t)( buffer[ 0 ] | ( buffer[ 1 ] << 8 ) );
-      outY = (int16_t)( buffer[ 2 ] | ( buffer[ 3 ] << 8 ) );
-      outZ = (int16_t)( buffer[ 4 ] | ( buffer[ 5 ] << 8 ) );
+    outX = (int16_t)( buffer[ 0 ] | ( buffer[ 1 ] << 8 ) );
+    outY = (int16_t)( buffer[ 2 ] | ( buffer[ 3 ] << 8 ) );
+    outZ = (int16_t)( buffer[ 4 ] | ( buffer[ 5 ] << 8 ) );
 
-      gx =  FS * (double)outX / 32768.0;
-      gy =  FS * (double)outY / 32768.0;
-      gz =  FS * (double)outZ / 32768.0;
-    }
+    gx =  FS * (double)outX / 32768.0;
+    gy =  FS * (double)outY / 32768.0;
+    gz =  FS * (double)outZ / 32768.0;
   }
 
   return success;
@@ -1417,7 +1355,7 @@ bool Lis3dh::ReadAdc()
 {
   bool success = true;
 
-  I2Chip::I2cWriteUInt8(LIS3DH_OUT_ADC1_L | LIS3DH_MULTI_RW, address, buffer, error);
+  I2Chip::I2cReadRegisters(LIS3DH_OUT_ADC1_L | LIS3DH_MULTI_RW, 6, address, buffer, error);
 
   if( error != 0 )
   {
@@ -1425,18 +1363,9 @@ bool Lis3dh::ReadAdc()
   }
   else
   {
-    I2cReadBytes(6, address, buffer, error);
-
-    if( error != 0 )
-    {
-      success = false;
-    }
-    else
-    {
-      Adc1 = (int16_t)( buffer[ 0 ] | ( buffer[ 1 ] << 8 ) );
-      Adc2 = (int16_t)( buffer[ 2 ] | ( buffer[ 3 ] << 8 ) );
-      Adc3 = (int16_t)( buffer[ 4 ] | ( buffer[ 5 ] << 8 ) );
-    }
+    Adc1 = (int16_t)( buffer[ 0 ] | ( buffer[ 1 ] << 8 ) );
+    Adc2 = (int16_t)( buffer[ 2 ] | ( buffer[ 3 ] << 8 ) );
+    Adc3 = (int16_t)( buffer[ 4 ] | ( buffer[ 5 ] << 8 ) );
   }
 
   return success;
@@ -1452,31 +1381,22 @@ int8_t Lis3dh::ReadFifo()
 
   if( samples > 0 && samples <= 32 )
   { 
-    I2Chip::I2cWriteUInt8(LIS3DH_OUT_X_L | LIS3DH_MULTI_RW, address, buffer, error);
+    I2Chip::I2cReadRegisters(LIS3DH_OUT_X_L | LIS3DH_MULTI_RW, 6 * samples, address, buffer, error);
 
     if( error != 0 )
     {
-      return -1;
+      return -2;
     }
     else
     {
-      I2cReadBytes(6 * samples, address, buffer, error);
-
-      if( error != 0 )
-      {
-        return -2;
-      }
-      else
+      for( int i = 0; i < samples; i++)
       {
-        for( int i = 0; i < samples; i++)
-        {
-          FifoX[ i ] = (int16_t)( buffer[ 0 + 6 * i ] | ( buffer[ 1 + 6 * i ] << 8 ) );
-          FifoY[ i ] = (int16_t)( buffer[ 2 + 6 * i ] | ( buffer[ 3 + 6 * i ] << 8 ) );
-          FifoZ[ i ] = (int16_t)( buffer[ 4 + 6 * i ] | ( buffer[ 5 + 6 * i ] << 8 ) );
-        }
-
-        NFifo = samples;
+        FifoX[ i ] = (int16_t)( buffer[ 0 + 6 * i ] | ( buffer[ 1 + 6 * i ] << 8 ) );
+        FifoY[ i ] = (int16_t)( buffer[ 2 + 6 * i ] | ( buffer[ 3 + 6 * i ] << 8 ) );
+        FifoZ[ i ] = (int16_t)( buffer[ 4 + 6 * i ] | ( buffer[ 5 + 6 * i ] << 8 ) );
       }
+
+      NFifo = samples;
     }
   }
 
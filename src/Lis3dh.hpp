@@ -2,7 +2,7 @@
  * 
  * Lis3dh class definitions and constructor. Base class is I2Chip. 
  *       
- * Copyright (C) 2022 Jaakko Koivuniemi.
+ * Copyright (C) 2022 - 2026 Jaakko Koivuniemi.
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -20,7 +20,7 @@
  ****************************************************************************
  *
  * Fri Feb 25 16:10:43 CST 2022
- * Edit: Sat Apr 23 14:50:42 CDT 2022
+ * Edit: Sat Oct 17 14:21:05 CDT 2026
  *
  * Jaakko Koivuniemi
  **/
@@ -74,6 +74,32 @@
 #define LIS3DH_ACT_DUR        0x3F
 #define LIS3DH_MULTI_RW       0x80
 
+/// Configuration profile for Lis3dh applied with _Lis3dh::ApplyProfile()_.
+
+/// The profile covers registers TEMP_CFG_REG, CTRL_REG1 - CTRL_REG6 and
+/// FIFO_CTRL_REG. Registers CTRL_REG2, CTRL_REG3 and CTRL_REG6 are given
+/// as raw values.
+struct Lis3dhProfile
+{
+    uint8_t DataRate = 0;     ///< ODR[3:0] 0 - 9
+    uint8_t Mode = 1;         ///< 0 low power, 1 normal, 2 high resolution
+    bool XEnable = true;      ///< enable X axis
+    bool YEnable = true;      ///< enable Y axis
+    bool ZEnable = true;      ///< enable Z axis
+    uint8_t FullScale = 0;    ///< FS[1:0] 0 - 3
+    bool BlockData = false;   ///< block data update
+    bool BigEndian = false;   ///< big endian data selection
+    bool ADCEnable = false;   ///< enable ADC
+    bool TempEnable = false;  ///< enable temperature sensor
+    bool FifoEnable = false;  ///< enable FIFO
+    uint8_t FifoMode = 0;     ///< FM[1:0] 0 - 3
+    uint8_t Watermark = 0;    ///< FTH[4:0] 0 - 31
+    bool StreamInt2 = false;  ///< stream-to-FIFO trigger from INT2
+    uint8_t CtrlReg2 = 0;     ///< raw CTRL_REG2 high-pass filter settings
+    uint8_t CtrlReg3 = 0;     ///< raw CTRL_REG3 INT1 routing
+    uint8_t CtrlReg6 = 0;     ///< raw CTRL_REG6 INT2 routing
+};
+
 /// Class for Lis3dh inherited from I2Chip base class. 
 
 /// The constructor _Lis3dh_ sets name tag, device file name and chip address
@@ -112,6 +138,7 @@ class Lis3dh : public I2Chip
     /// Construct Lis3dh object with parameters.
     Lis3dh(std::string name, std::string i2cdev, uint16_t address) : I2Chip(name, i2cdev, address)
    {
+      I2Chip::SetAutoIncrement( LIS3DH_MULTI_RW );
       this->name = name;
       this->i2cdev = i2cdev;
       this->address = address;
@@ -120,6 +147,7 @@ class Lis3dh : public I2Chip
     /// Construct Lis3dh object with parameters using default address.
     Lis3dh(std::string name, std::string i2cdev) : I2Chip(name, i2cdev, 0x18)
    {
+      I2Chip::SetAutoIncrement( LIS3DH_MULTI_RW );
       this->name = name;
       this->i2cdev = i2cdev;
    };
@@ -138,6 +166,12 @@ class Lis3dh : public I2Chip
     /// Get last error number.
     int GetError() { return error; }
 
+    /// Read N registers from chip into shadow cache in one transfer.
+    void ShadowRefresh(uint8_t reg, int Nbytes) { I2Chip::ShadowRefresh(reg, Nbytes, address, buffer, error); }
+
+    /// Write shadow registers collected after ShadowDefer() to chip.
+    void ShadowFlush() { I2Chip::ShadowFlush(address, buffer, error); }
+
     /// Get g-force x from last reading. 
     double Getgx() { return gx; }
 
@@ -315,6 +349,9 @@ class Lis3dh : public I2Chip
     /// Reboot memory content.
     void Boot();
 
+    /// Check profile, compute register image and write it in bursts.
+    bool ApplyProfile(const Lis3dhProfile & Profile);
+
     /// Enable FIFO.
     void FifoEnable();
 
@@ -2,7 +2,7 @@
  * 
  * Lis3mdl class member functions for configuration and reading with I2C. 
  *       
- * Copyright (C) 2021 - 2022 Jaakko Koivuniemi.
+ * Copyright (C) 2021 - 2026 Jaakko Koivuniemi.
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -20,7 +20,7 @@
  ****************************************************************************
  *
  * Fri Sep 10 16:30:57 CDT 2021
- * Edit: Fri Apr 22 19:13:02 CDT 2022
+ * Edit: Sat Oct 17 14:21:05 CDT 2026
  *
  * Jaakko Koivuniemi
  **/
@@ -37,10 +37,9 @@ void Lis3mdl::TempEnable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3MDL_CTRL_REG1, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3MDL_CTRL_REG1, address, buffer, error);
   reg |= 0x80;
-  I2Chip::I2cWriteRegisterUInt8(LIS3MDL_CTRL_REG1, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3MDL_CTRL_REG1, reg, address, buffer, error);
 }
 
 /// Clear TEMP_EN bit in register CTRL_REG1.
@@ -48,10 +47,9 @@ void Lis3mdl::TempDisable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3MDL_CTRL_REG1, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3MDL_CTRL_REG1, address, buffer, error);
   reg &= 0x7F;
-  I2Chip::I2cWriteRegisterUInt8(LIS3MDL_CTRL_REG1, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3MDL_CTRL_REG1, reg, address, buffer, error);
 }
 
 /// Read bits OM[1:0] in register CTRL_REG1.
@@ -59,8 +57,7 @@ uint8_t Lis3mdl::GetXYOpMode()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3MDL_CTRL_REG1, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS3MDL_CTRL_REG1, address, buffer, error);
   reg &= 0x7F;
   reg = reg >> 5;
 
@@ -73,11 +70,10 @@ void Lis3mdl::SetXYOpMode(uint8_t OpModeXY)
   uint8_t reg = 0;
 
   OpModeXY &= 0x03;
-  I2Chip::I2cWriteUInt8(LIS3MDL_CTRL_REG1, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3MDL_CTRL_REG1, address, buffer, error);
   reg &= 0x9F;
   reg |=  OpModeXY << 5;
-  I2Chip::I2cWriteRegisterUInt8(LIS3MDL_CTRL_REG1, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3MDL_CTRL_REG1, reg, address, buffer, error);
 }
 
 /// Read bits DO[2:0] in register CTRL_REG1.
@@ -85,8 +81,7 @@ uint8_t Lis3mdl::GetDataRate()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3MDL_CTRL_REG1, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS3MDL_CTRL_REG1, address, buffer, error);
   reg &= 0x1C;
   reg = reg >> 2;
 
@@ -100,11 +95,10 @@ void Lis3mdl::SetDataRate(uint8_t DataRate)
 
   DataRate &= 0x07;
 
-  I2Chip::I2cWriteUInt8(LIS3MDL_CTRL_REG1, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3MDL_CTRL_REG1, address, buffer, error);
   reg &= 0xE3;
   reg |=  DataRate << 2;
-  I2Chip::I2cWriteRegisterUInt8(LIS3MDL_CTRL_REG1, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3MDL_CTRL_REG1, reg, address, buffer, error);
 }
 
 /// Set bit FAST_ODR in register CTRL_REG1. 
@@ -112,10 +106,9 @@ void Lis3mdl::FastDataEnable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3MDL_CTRL_REG1, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3MDL_CTRL_REG1, address, buffer, error);
   reg |= 0x02;
-  I2Chip::I2cWriteRegisterUInt8(LIS3MDL_CTRL_REG1, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3MDL_CTRL_REG1, reg, address, buffer, error);
 }
 
 
@@ -124,10 +117,9 @@ void Lis3mdl::FastDataDisable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3MDL_CTRL_REG1, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3MDL_CTRL_REG1, address, buffer, error);
   reg &= 0xFD;
-  I2Chip::I2cWriteRegisterUInt8(LIS3MDL_CTRL_REG1, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3MDL_CTRL_REG1, reg, address, buffer, error);
 }
 
 /// Set bit ST in register CTRL_REG1. 
@@ -135,10 +127,9 @@ void Lis3mdl::SelfTestEnable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3MDL_CTRL_REG1, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3MDL_CTRL_REG1, address, buffer, error);
   reg |= 0x01;
-  I2Chip::I2cWriteRegisterUInt8(LIS3MDL_CTRL_REG1, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3MDL_CTRL_REG1, reg, address, buffer, error);
 }
 
 /// Clear bit ST in register CTRL_REG1. 
@@ -146,10 +137,9 @@ void Lis3mdl::SelfTestDisable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3MDL_CTRL_REG1, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3MDL_CTRL_REG1, address, buffer, error);
   reg &= 0xFE;
-  I2Chip::I2cWriteRegisterUInt8(LIS3MDL_CTRL_REG1, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3MDL_CTRL_REG1, reg, address, buffer, error);
 }
 
 /// Read bits FS[0:1] in register CTRL_REG2.
@@ -157,8 +147,7 @@ uint8_t Lis3mdl::GetFullScale()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3MDL_CTRL_REG2, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS3MDL_CTRL_REG2, address, buffer, error);
   reg &= 0x60;
   reg = reg >> 5;
       
@@ -172,12 +161,11 @@ void Lis3mdl::SetFullScale(uint8_t FullScale)
 
   FullScale &= 0x03;
 
-  I2Chip::I2cWriteUInt8(LIS3MDL_CTRL_REG2, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3MDL_CTRL_REG2, address, buffer, error);
   reg &= 0x9F;
   reg |= FullScale << 5;
   reg &= 0x6C;
-  I2Chip::I2cWriteRegisterUInt8(LIS3MDL_CTRL_REG2, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3MDL_CTRL_REG2, reg, address, buffer, error);
 
   switch( FullScale )
   {
@@ -196,28 +184,73 @@ void Lis3mdl::SetFullScale(uint8_t FullScale)
   }
 }
 
-/// Set bit REBOOT in register CTRL_REG2. 
+/// Set bit REBOOT in register CTRL_REG2. The chip reloads its registers
+/// so all shadow registers are invalidated.
 void Lis3mdl::Reboot()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3MDL_CTRL_REG2, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3MDL_CTRL_REG2, address, buffer, error);
   reg |= 0x80;
   reg &= 0x6C;
   I2Chip::I2cWriteRegisterUInt8(LIS3MDL_CTRL_REG2, reg, address, buffer, error);
+  I2Chip::ShadowInvalidate();
 }
 
-/// Set bit SOFT_RST in register CTRL_REG2. 
+/// Set bit SOFT_RST in register CTRL_REG2. The chip reloads its registers
+/// so all shadow registers are invalidated.
 void Lis3mdl::SoftReset()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3MDL_CTRL_REG2, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3MDL_CTRL_REG2, address, buffer, error);
   reg |= 0x40;
   reg &= 0x6C;
   I2Chip::I2cWriteRegisterUInt8(LIS3MDL_CTRL_REG2, reg, address, buffer, error);
+  I2Chip::ShadowInvalidate();
+}
+
+/// Compute registers CTRL_REG1 - CTRL_REG5 from profile without reading
+/// the chip and write them in one auto-increment burst. Error -7 is set for
+/// values out of range.
+bool Lis3mdl::ApplyProfile(const Lis3mdlProfile & Profile)
+{
+  uint8_t ctrl[ 5 ] = { };
+  const double gain[ 4 ] = {6842, 3421, 2281, 1711};
+
+  if( ( Profile.XYOpMode > 3 ) || ( Profile.DataRate > 7 ) || ( Profile.FullScale > 3 ) || ( Profile.OpMode > 3 ) || ( Profile.ZOpMode > 3 ) )
+  {
+    fprintf(stderr, SD_ERR "%s profile value out of range\n", name.c_str() );
+    error = -7;
+    return false;
+  }
+
+  if( Profile.TempEnable ) ctrl[ 0 ] |= 0x80;
+  ctrl[ 0 ] |= Profile.XYOpMode << 5;
+  ctrl[ 0 ] |= Profile.DataRate << 2;
+  if( Profile.FastData ) ctrl[ 0 ] |= 0x02;
+  if( Profile.SelfTest ) ctrl[ 0 ] |= 0x01;
+
+  ctrl[ 1 ] = Profile.FullScale << 5;
+
+  if( Profile.LowPower ) ctrl[ 2 ] |= 0x20;
+  ctrl[ 2 ] |= Profile.OpMode;
+
+  ctrl[ 3 ] = Profile.ZOpMode << 2;
+  if( Profile.LittleEndian ) ctrl[ 3 ] |= 0x02;
+
+  if( Profile.FastRead ) ctrl[ 4 ] |= 0x80;
+  if( Profile.BlockData ) ctrl[ 4 ] |= 0x40;
+
+  I2Chip::ShadowDefer();
+  for(int i = 0; i < 5; i++) I2Chip::ShadowWriteUInt8(LIS3MDL_CTRL_REG1 + i, ctrl[ i ], address, buffer, error);
+  I2Chip::ShadowFlush(address, buffer, error);
+
+  if( Profile.OpMode == 1 ) I2Chip::ShadowInvalidate(LIS3MDL_CTRL_REG3);
+
+  Gain = gain[ Profile.FullScale ];
+
+  return ( error == 0 );
 }
 
 /// Set bit LP in register CTRL_REG3.
@@ -225,11 +258,10 @@ void Lis3mdl::LowPowerEnable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3MDL_CTRL_REG3, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3MDL_CTRL_REG3, address, buffer, error);
   reg |= 0x20;
   reg &= 0x27;
-  I2Chip::I2cWriteRegisterUInt8(LIS3MDL_CTRL_REG3, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3MDL_CTRL_REG3, reg, address, buffer, error);
 }
 
 /// Clear bit LP in register CTRL_REG3.
@@ -237,10 +269,9 @@ void Lis3mdl::LowPowerDisable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3MDL_CTRL_REG3, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3MDL_CTRL_REG3, address, buffer, error);
   reg &= 0x27;
-  I2Chip::I2cWriteRegisterUInt8(LIS3MDL_CTRL_REG3, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3MDL_CTRL_REG3, reg, address, buffer, error);
 }
 
 /// Read bits MD[1:0] from register CTRL_REG3.
@@ -248,8 +279,7 @@ uint8_t Lis3mdl::GetOpMode()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3MDL_CTRL_REG3, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS3MDL_CTRL_REG3, address, buffer, error);
   reg &= 0x03;
       
   return reg;
@@ -262,11 +292,10 @@ void Lis3mdl::SetOpMode(uint8_t OpMode)
 
   OpMode &= 0x03;
 
-  I2Chip::I2cWriteUInt8(LIS3MDL_CTRL_REG3, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3MDL_CTRL_REG3, address, buffer, error);
   reg |= OpMode;
   reg &= 0x27;
-  I2Chip::I2cWriteRegisterUInt8(LIS3MDL_CTRL_REG3, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3MDL_CTRL_REG3, reg, address, buffer, error);
 }
 
 /// Set bits MD1 and MD0 in register CTRL_REG3.
@@ -274,11 +303,10 @@ void Lis3mdl::PowerDown()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3MDL_CTRL_REG3, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3MDL_CTRL_REG3, address, buffer, error);
   reg |= 0x03;
   reg &= 0x27;
-  I2Chip::I2cWriteRegisterUInt8(LIS3MDL_CTRL_REG3, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3MDL_CTRL_REG3, reg, address, buffer, error);
 }
 
 /// Clear bits MD1 and MD0 in register CTRL_REG3.
@@ -286,22 +314,22 @@ void Lis3mdl::ContinuousMode()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3MDL_CTRL_REG3, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3MDL_CTRL_REG3, address, buffer, error);
   reg &= 0x24;
-  I2Chip::I2cWriteRegisterUInt8(LIS3MDL_CTRL_REG3, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3MDL_CTRL_REG3, reg, address, buffer, error);
 }
 
-/// Clear bit MD1 and set MD0 in register CTRL_REG3.
+/// Clear bit MD1 and set MD0 in register CTRL_REG3. The chip returns to idle
+/// after conversion so the shadow register is invalidated.
 void Lis3mdl::SingleConversionMode()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3MDL_CTRL_REG3, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3MDL_CTRL_REG3, address, buffer, error);
   reg &= 0x26;
   reg |= 0x01;
   I2Chip::I2cWriteRegisterUInt8(LIS3MDL_CTRL_REG3, reg, address, buffer, error);
+  I2Chip::ShadowInvalidate(LIS3MDL_CTRL_REG3);
 }
 
 /// Read bits OMZ[1:0] from register CTRL_REG4.
@@ -309,8 +337,7 @@ uint8_t Lis3mdl::GetZOpMode()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3MDL_CTRL_REG4, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS3MDL_CTRL_REG4, address, buffer, error);
   reg &= 0x0C;
   reg = reg >> 2;
 
@@ -324,11 +351,10 @@ void Lis3mdl::SetZOpMode(uint8_t ZOpMode)
 
   ZOpMode &= 0x03;
 
-  I2Chip::I2cWriteUInt8(LIS3MDL_CTRL_REG4, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3MDL_CTRL_REG4, address, buffer, error);
   reg &= 0x02;
   reg |= ZOpMode <<  2;
-  I2Chip::I2cWriteRegisterUInt8(LIS3MDL_CTRL_REG4, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3MDL_CTRL_REG4, reg, address, buffer, error);
 }
 
 /// Clear bit BLE in register CTRL_REG4.
@@ -336,10 +362,9 @@ void Lis3mdl::BigEndian()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3MDL_CTRL_REG4, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3MDL_CTRL_REG4, address, buffer, error);
   reg &= 0x0C;
-  I2Chip::I2cWriteRegisterUInt8(LIS3MDL_CTRL_REG4, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3MDL_CTRL_REG4, reg, address, buffer, error);
 }
 
 /// Set bit BLE in register CTRL_REG4.
@@ -347,11 +372,10 @@ void Lis3mdl::LittleEndian()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3MDL_CTRL_REG4, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3MDL_CTRL_REG4, address, buffer, error);
   reg |= 0x02;
   reg &= 0x0E;
-  I2Chip::I2cWriteRegisterUInt8(LIS3MDL_CTRL_REG4, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3MDL_CTRL_REG4, reg, address, buffer, error);
 }
 
 /// Set bit FAST_READ in register CTRL_REG5..
@@ -359,11 +383,10 @@ void Lis3mdl::FastReadEnable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3MDL_CTRL_REG5, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3MDL_CTRL_REG5, address, buffer, error);
   reg |= 0x80;
   reg &= 0xC0;
-  I2Chip::I2cWriteRegisterUInt8(LIS3MDL_CTRL_REG5, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3MDL_CTRL_REG5, reg, address, buffer, error);
 }
 
 /// Clear bit FAST_READ in register CTRL_REG5..
@@ -371,10 +394,9 @@ void Lis3mdl::FastReadDisable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3MDL_CTRL_REG5, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3MDL_CTRL_REG5, address, buffer, error);
   reg &= 0x40;
-  I2Chip::I2cWriteRegisterUInt8(LIS3MDL_CTRL_REG5, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3MDL_CTRL_REG5, reg, address, buffer, error);
 }
 
 /// Set bit BDU in register CTRL_REG5.
@@ -382,11 +404,10 @@ void Lis3mdl::BlockDataEnable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3MDL_CTRL_REG5, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3MDL_CTRL_REG5, address, buffer, error);
   reg |= 0x40;
   reg &= 0xC0;
-  I2Chip::I2cWriteRegisterUInt8(LIS3MDL_CTRL_REG5, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3MDL_CTRL_REG5, reg, address, buffer, error);
 }
 
 /// Clear bit BDU in register CTRL_REG5.
@@ -394,10 +415,9 @@ void Lis3mdl::BlockDataDisable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3MDL_CTRL_REG5, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LIS3MDL_CTRL_REG5, address, buffer, error);
   reg &= 0x80;
-  I2Chip::I2cWriteRegisterUInt8(LIS3MDL_CTRL_REG5, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3MDL_CTRL_REG5, reg, address, buffer, error);
 }
 
 /// Read register STATUS_REG.
@@ -405,8 +425,7 @@ uint8_t Lis3mdl::GetStatus()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3MDL_STATUS_REG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS3MDL_STATUS_REG, address, buffer, error);
 
   return reg;
 }
@@ -416,8 +435,7 @@ uint8_t Lis3mdl::GetIntConfig()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3MDL_INT_CFG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS3MDL_INT_CFG, address, buffer, error);
       
   return reg;
 }
@@ -426,7 +444,7 @@ uint8_t Lis3mdl::GetIntConfig()
 void Lis3mdl::SetIntConfig(uint8_t IntConf)
 {
   IntConf &= 0xEF;
-  I2Chip::I2cWriteRegisterUInt8(LIS3MDL_INT_CFG, IntConf, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3MDL_INT_CFG, IntConf, address, buffer, error);
 }
 
 /// Read register INT_SRC.
@@ -434,8 +452,7 @@ uint8_t Lis3mdl::GetIntSource()
 {
   uint8_t reg = 0;
       
-  I2Chip::I2cWriteUInt8(LIS3MDL_INT_SRC, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS3MDL_INT_SRC, address, buffer, error);
       
   return reg;
 }
@@ -443,7 +460,7 @@ uint8_t Lis3mdl::GetIntSource()
 /// Write register INT_SRC.
 void Lis3mdl::SetIntSource(uint8_t IntSource)
 {
-  I2Chip::I2cWriteRegisterUInt8(LIS3MDL_INT_SRC, IntSource, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LIS3MDL_INT_SRC, IntSource, address, buffer, error);
 }
 
 /// Get interrupt threshold 0 - 65535.
@@ -451,8 +468,7 @@ uint16_t Lis3mdl::GetIntThreshold()
 {
   uint16_t data;
 
-  I2Chip::I2cWriteUInt8(LIS3MDL_INT_THS_L | LIS3MDL_MULTI_RW, address, buffer, error);
-  data = I2Chip::I2cReadUInt16(address, buffer, error);
+  data = I2Chip::I2cReadRegisterUInt16(LIS3MDL_INT_THS_L | LIS3MDL_MULTI_RW, address, buffer, error);
 
   return data;
 }
@@ -468,8 +484,7 @@ bool Lis3mdl::WhoAmI()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3MDL_WHO_AM_I, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS3MDL_WHO_AM_I, address, buffer, error);
       
   return (reg == 0x3D);
 }
@@ -479,33 +494,24 @@ bool Lis3mdl::ReadB()
 {
   bool success = true;
 
-  I2Chip::I2cWriteUInt8(LIS3MDL_OUT_X_L | LIS3MDL_MULTI_RW, address, buffer, error);
-
+  I2Chip::I2cReadRegisters(LIS3MDL_OUT_X_L | LIS3MDL_MULTI_RW, 8, address, buffer, error);
+      
   if( error != 0 )
   {
     success = false;
   }
   else
   { 
-    I2cReadBytes(8, address, buffer, error);
-      
-    if( error != 0 )
-    {
-      success = false;
-    }
-    else
-    { 
-      outX = (int16_t)( buffer[ 0 ] | ( buffer[ 1 ] << 8 ) );
-      outY = (int16_t)( buffer[ 2 ] | ( buffer[ 3 ] << 8 ) );
-      outZ = (int16_t)( buffer[ 4 ] | ( buffer[ 5 ] << 8 ) );
-      temp = (int16_t)( buffer[ 6 ] | ( buffer[ 7 ] << 8 ) );
-
-      Bx = 100 * outX / Gain;
-      By = 100 * outY / Gain;
-      Bz = 100 * outZ / Gain;
-      T = temp / 256.0 + 25.0;
-    }   
-  }
+    outX = (int16_t)( buffer[ 0 ] | ( buffer[ 1 ] << 8 ) );
+    outY = (int16_t)( buffer[ 2 ] | ( buffer[ 3 ] << 8 ) );
+    outZ = (int16_t)( buffer[ 4 ] | ( buffer[ 5 ] << 8 ) );
+    temp = (int16_t)( buffer[ 6 ] | ( buffer[ 7 ] << 8 ) );
+
+    Bx = 100 * outX / Gain;
+    By = 100 * outY / Gain;
+    Bz = 100 * outZ / Gain;
+    T = temp / 256.0 + 25.0;
+  }   
 
   return success;
 }
@@ -515,7 +521,7 @@ bool Lis3mdl::ReadBx()
 {
   bool success = true;
 
-  I2Chip::I2cWriteUInt8(LIS3MDL_OUT_X_L | LIS3MDL_MULTI_RW, address, buffer, error);
+  I2Chip::I2cReadRegisters(LIS3MDL_OUT_X_L | LIS3MDL_MULTI_RW, 2, address, buffer, error);
 
   if( error != 0 )
   {
@@ -523,17 +529,8 @@ bool Lis3mdl::ReadBx()
   }
   else
   {
-    I2cReadBytes(2, address, buffer, error);
-
-    if( error != 0 )
-    {
-      success = false;
-    }
-    else
-    {
-      outX = (int16_t)( buffer[ 0 ] | ( buffer[ 1 ] << 8 ) );
-      Bx = 100 * outX / Gain;
-    }
+    outX = (int16_t)( buffer[ 0 ] | ( buffer[ 1 ] << 8 ) );
+    Bx = 100 * outX / Gain;
   }
 
   return success;
@@ -544,7 +541,7 @@ bool Lis3mdl::ReadBy()
 {
   bool success = true;
 
-  I2Chip::I2cWriteUInt8(LIS3MDL_OUT_Y_L | LIS3MDL_MULTI_RW, address, buffer, error);
+  I2Chip::I2cReadRegisters(LIS3MDL_OUT_Y_L | LIS3MDL_MULTI_RW, 2, address, buffer, error);
 
   if( error != 0 )
   {
@@ -552,17 +549,8 @@ bool Lis3mdl::ReadBy()
   }
   else
   {
-    I2cReadBytes(2, address, buffer, error);
-
-    if( error != 0 )
-    {
-      success = false;
-    }
-    else
-    {
-      outY = (int16_t)( buffer[ 0 ] | ( buffer[ 1 ] << 8 ) );
-      By = 100 * outY / Gain;
-    }
+    outY = (int16_t)( buffer[ 0 ] | ( buffer[ 1 ] << 8 ) );
+    By = 100 * outY / Gain;
   }
       
   return success;
@@ -573,7 +561,7 @@ bool Lis3mdl::ReadBz()
 {
   bool success = true;
 
-  I2Chip::I2cWriteUInt8(LIS3MDL_OUT_Z_L | LIS3MDL_MULTI_RW, address, buffer, error);
+  I2Chip::I2cReadRegisters(LIS3MDL_OUT_Z_L | LIS3MDL_MULTI_RW, 2, address, buffer, error);
 
   if( error != 0 )
   {
@@ -581,17 +569,8 @@ bool Lis3mdl::ReadBz()
   }
   else
   {
-    I2cReadBytes(2, address, buffer, error);
-
-    if( error != 0 )
-    {
-      success = false;
-    }
-    else
-    {
-      outZ = (int16_t)( buffer[ 0 ] | ( buffer[ 1 ] << 8 ) );
-      Bz = 100 * outZ / Gain;
-    }
+    outZ = (int16_t)( buffer[ 0 ] | ( buffer[ 1 ] << 8 ) );
+    Bz = 100 * outZ / Gain;
   }
       
   return success;
@@ -603,8 +582,7 @@ bool Lis3mdl::NewDataXYZ()
   bool newdata = false;
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LIS3MDL_STATUS_REG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS3MDL_STATUS_REG, address, buffer, error);
   reg &= 0x08;
   if( reg == 0x00) newdata = false; else newdata = true;
   
@@ -617,8 +595,7 @@ bool Lis3mdl::OverRunXYZ()
   bool overrun = false;
   uint8_t reg = 0;
 	
-  I2Chip::I2cWriteUInt8(LIS3MDL_STATUS_REG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LIS3MDL_STATUS_REG, address, buffer, error);
   reg &= 0x80;
   if( reg == 0x00) overrun = false; else overrun = true;
   
@@ -631,14 +608,14 @@ bool Lis3mdl::OverRunXYZ()
 //  bool success = false;
 //  uint16_t outZ = 0;
 //
-//  I2Chip::I2cWriteRegisterUInt8(LIS3MDL_CTRL_REG1, 0x1C, address, buffer, error);
+//  I2Chip::ShadowWriteUInt8(LIS3MDL_CTRL_REG1, 0x1C, address, buffer, error);
 //  if( error != 0 )
 //  {
 //    success = false;
 //  }
 //  else
 //  {
-//    I2Chip::I2cWriteRegisterUInt8(LIS3MDL_CTRL_REG1, 0x40, address, buffer, error);
+//    I2Chip::ShadowWriteUInt8(LIS3MDL_CTRL_REG1, 0x40, address, buffer, error);
 //    if( error != 0 )
 //    {
 //      success = false;
@@ -646,7 +623,7 @@ bool Lis3mdl::OverRunXYZ()
 //    else
 //    {
 //      usleep( 20000 );
-//      I2Chip::I2cWriteRegisterUInt8(LIS3MDL_CTRL_REG1, 0x00, address, buffer, error);
+//      I2Chip::ShadowWriteUInt8(LIS3MDL_CTRL_REG1, 0x00, address, buffer, error);
 //    }
 //
 //  }
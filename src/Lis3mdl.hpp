@@ -2,7 +2,7 @@
  * 
  * Lis3mdl class definitions and constructor. Base class is I2Chip. 
  *       
- * Copyright (C) 2021 - 2022 Jaakko Koivuniemi.
+ * Copyright (C) 2021 - 2026 Jaakko Koivuniemi.
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -20,7 +20,7 @@
  ****************************************************************************
  *
  * Fri Sep 10 13:40:47 CDT 2021
- * Edit: Fri Apr 22 19:05:55 CDT 2022
+ * Edit: Sat Oct 17 14:21:05 CDT 2026
  *
  * Jaakko Koivuniemi
  **/
@@ -51,6 +51,25 @@
 #define LIS3MDL_INT_THS_H  0x33
 #define LIS3MDL_MULTI_RW   0x80
 
+/// Configuration profile for Lis3mdl applied with _Lis3mdl::ApplyProfile()_.
+
+/// The profile covers registers CTRL_REG1 - CTRL_REG5.
+struct Lis3mdlProfile
+{
+    bool TempEnable = false;  ///< enable temperature sensor
+    uint8_t XYOpMode = 0;     ///< OM[1:0] 0 - 3
+    uint8_t DataRate = 4;     ///< DO[2:0] 0 - 7
+    bool FastData = false;    ///< FAST_ODR
+    bool SelfTest = false;    ///< self-test
+    uint8_t FullScale = 0;    ///< FS[1:0] 0 - 3
+    bool LowPower = false;    ///< low-power mode
+    uint8_t OpMode = 3;       ///< MD[1:0] 0 continuous, 1 single, 2 - 3 power-down
+    uint8_t ZOpMode = 0;      ///< OMZ[1:0] 0 - 3
+    bool LittleEndian = false; ///< little endian data selection
+    bool FastRead = false;    ///< FAST_READ
+    bool BlockData = false;   ///< block data update
+};
+
 /// Class for Lis3mdl inherited from I2Chip base class. 
 
 /// The constructor _Lis3mdl_ sets name tag, device file name and chip address
@@ -81,6 +100,7 @@ class Lis3mdl : public I2Chip
     /// Construct Lis3mdl object with parameters.
     Lis3mdl(std::string name, std::string i2cdev, uint16_t address) : I2Chip(name, i2cdev, address)
    {
+      I2Chip::SetAutoIncrement( LIS3MDL_MULTI_RW );
       this->name = name;
       this->i2cdev = i2cdev;
       this->address = address;
@@ -89,6 +109,7 @@ class Lis3mdl : public I2Chip
     /// Construct Lis3mdl object with parameters using default address.
     Lis3mdl(std::string name, std::string i2cdev) : I2Chip(name, i2cdev, 0x1C)
    {
+      I2Chip::SetAutoIncrement( LIS3MDL_MULTI_RW );
       this->name = name;
       this->i2cdev = i2cdev;
    };
@@ -107,6 +128,12 @@ class Lis3mdl : public I2Chip
     /// Get last error number.
     int GetError() { return error; }
 
+    /// Read N registers from chip into shadow cache in one transfer.
+    void ShadowRefresh(uint8_t reg, int Nbytes) { I2Chip::ShadowRefresh(reg, Nbytes, address, buffer, error); }
+
+    /// Write shadow registers collected after ShadowDefer() to chip.
+    void ShadowFlush() { I2Chip::ShadowFlush(address, buffer, error); }
+
     /// Get magnetic field value Bx[G] from last reading. 
     double GetBx() { return Bx; }
 
@@ -185,6 +212,9 @@ class Lis3mdl : public I2Chip
     /// Soft reset.
     void SoftReset();
 
+    /// Check profile, compute register image and write it in one burst.
+    bool ApplyProfile(const Lis3mdlProfile & Profile);
+
     /// Enable low-power mode.
     void LowPowerEnable();
 
@@ -2,7 +2,7 @@
  * 
  * Ltr390uv class member functions for configuration and reading with I2Chip. 
  *       
- * Copyright (C) 2022 Jaakko Koivuniemi.
+ * Copyright (C) 2022 - 2026 Jaakko Koivuniemi.
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -20,7 +20,7 @@
  ****************************************************************************
  *
  * Sun 01 May 2022 06:41:35 PM CDT
- * Edit: Sat 14 May 2022 02:19:35 PM CDT
+ * Edit: Sat Oct 17 14:21:05 CDT 2026
  *
  * Jaakko Koivuniemi
  **/
@@ -31,16 +31,67 @@ using namespace std;
 
 Ltr390uv::~Ltr390uv() { };
 
-/// Set bit SW Reset in MAIN_CTRL register.
+/// Set bit SW Reset in MAIN_CTRL register. The chip reloads its registers
+/// so all shadow registers are invalidated.
 void Ltr390uv::Reset()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LTR390UV_MAIN_CTRL, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LTR390UV_MAIN_CTRL, address, buffer, error);
   reg |= 0x10;
 
   I2Chip::I2cWriteRegisterUInt8(LTR390UV_MAIN_CTRL, reg, address, buffer, error);
+  I2Chip::ShadowInvalidate();
+}
+
+/// Compute registers from profile without reading the chip. Measurement
+/// rate and gain, interrupt configuration and thresholds are written in
+/// bursts of consecutive registers before MAIN_CTRL enables the sensor.
+/// Error -7 is set for values out of range.
+bool Ltr390uv::ApplyProfile(const Ltr390uvProfile & Profile)
+{
+  uint8_t main_ctrl = 0, int_cfg = 0;
+  uint8_t thrs[ 6 ] = { };
+  const double inttime[ 6 ] = {4.0, 2.0, 1.0, 0.5, 0.25, 0.125};
+  const uint8_t alsgain[ 5 ] = {1, 3, 6, 9, 18};
+
+  if( ( Profile.Resolution > 5 ) || ( Profile.MeasRate > 7 ) || ( Profile.Gain > 4 ) || ( Profile.IntPersist > 15 ) || ( Profile.ThrsUp > 0xFFFFF ) || ( Profile.ThrsLow > 0xFFFFF ) )
+  {
+    fprintf(stderr, SD_ERR "%s profile value out of range\n", name.c_str() );
+    error = -7;
+    return false;
+  }
+
+  if( Profile.Ultraviolet ) main_ctrl |= 0x08;
+  if( Profile.Enable ) main_ctrl |= 0x02;
+
+  if( Profile.IntUltraviolet ) int_cfg = 0x30; else int_cfg = 0x10;
+  if( Profile.IntEnable ) int_cfg |= 0x04;
+
+  for(int i = 0; i < 3; i++)
+  {
+    thrs[ i ] = (uint8_t)( ( Profile.ThrsUp >> ( 8 * i ) ) & 0xFF );
+    thrs[ i + 3 ] = (uint8_t)( ( Profile.ThrsLow >> ( 8 * i ) ) & 0xFF );
+  }
+
+  I2Chip::ShadowDefer();
+  I2Chip::ShadowWriteUInt8(LTR390UV_ALS_UVS_MEAS_RATE, ( Profile.Resolution << 4 ) | Profile.MeasRate, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LTR390UV_ALS_UVS_GAIN, Profile.Gain, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LTR390UV_INT_CFG, int_cfg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LTR390UV_INT_PTS, Profile.IntPersist << 4, address, buffer, error);
+  for(int i = 0; i < 6; i++) I2Chip::ShadowWriteUInt8(LTR390UV_ALS_UVS_THRES_UP_0 + i, thrs[ i ], address, buffer, error);
+  I2Chip::ShadowFlush(address, buffer, error);
+
+  if( error != 0 ) return false;
+
+  I2Chip::ShadowWriteUInt8(LTR390UV_MAIN_CTRL, main_ctrl, address, buffer, error);
+
+  IntTime = inttime[ Profile.Resolution ];
+  AlsGain = alsgain[ Profile.Gain ];
+  ThrsUpper = Profile.ThrsUp;
+  ThrsLow = Profile.ThrsLow;
+
+  return ( error == 0 );
 }
 
 /// Clear bit UVS_Mode in MAIN_CTRL register.
@@ -48,11 +99,10 @@ void Ltr390uv::AmbientLightMode()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LTR390UV_MAIN_CTRL, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LTR390UV_MAIN_CTRL, address, buffer, error);
   reg &= 0xF7;
 
-  I2Chip::I2cWriteRegisterUInt8(LTR390UV_MAIN_CTRL, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LTR390UV_MAIN_CTRL, reg, address, buffer, error);
 }
 
 /// Set bit UVS_Mode in MAIN_CTRL register.
@@ -60,11 +110,10 @@ void Ltr390uv::UltravioletMode()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LTR390UV_MAIN_CTRL, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LTR390UV_MAIN_CTRL, address, buffer, error);
   reg |= 0x08;
 
-  I2Chip::I2cWriteRegisterUInt8(LTR390UV_MAIN_CTRL, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LTR390UV_MAIN_CTRL, reg, address, buffer, error);
 }
 
 /// Clear ALS/UVS Enable bit in MAIN_CTRL register.
@@ -72,11 +121,10 @@ void Ltr390uv::LightDisable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LTR390UV_MAIN_CTRL, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LTR390UV_MAIN_CTRL, address, buffer, error);
   reg &= 0xFD;
 
-  I2Chip::I2cWriteRegisterUInt8(LTR390UV_MAIN_CTRL, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LTR390UV_MAIN_CTRL, reg, address, buffer, error);
 }
 
 /// Set ALS/UVS Enable bit in MAIN_CTRL register.
@@ -84,11 +132,10 @@ void Ltr390uv::LightEnable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LTR390UV_MAIN_CTRL, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LTR390UV_MAIN_CTRL, address, buffer, error);
   reg |= 0x02;
 
-  I2Chip::I2cWriteRegisterUInt8(LTR390UV_MAIN_CTRL, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LTR390UV_MAIN_CTRL, reg, address, buffer, error);
 }
 
 /// Read bits [6:4] from register ALS_UVS_MEAS_RATE.
@@ -96,8 +143,7 @@ uint8_t Ltr390uv::GetResolution()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LTR390UV_ALS_UVS_MEAS_RATE, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LTR390UV_ALS_UVS_MEAS_RATE, address, buffer, error);
   reg &= 0x70;
   
   return ( reg >> 4 );
@@ -111,12 +157,11 @@ void Ltr390uv::SetResolution(uint8_t Resolution)
 
   if( Resolution < 6 )
   {
-    I2Chip::I2cWriteUInt8(LTR390UV_ALS_UVS_MEAS_RATE, address, buffer, error);
-    reg = I2Chip::I2cReadUInt8(address, buffer, error);
+    reg = I2Chip::ShadowReadUInt8(LTR390UV_ALS_UVS_MEAS_RATE, address, buffer, error);
     reg &= 0x07;
     reg |= Resolution << 4;
 
-    I2Chip::I2cWriteRegisterUInt8(LTR390UV_ALS_UVS_MEAS_RATE, reg, address, buffer, error);
+    I2Chip::ShadowWriteUInt8(LTR390UV_ALS_UVS_MEAS_RATE, reg, address, buffer, error);
 
 // set IntTime here
     switch( Resolution )
@@ -148,8 +193,7 @@ uint8_t Ltr390uv::GetMeasRate()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LTR390UV_ALS_UVS_MEAS_RATE, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LTR390UV_ALS_UVS_MEAS_RATE, address, buffer, error);
   reg &= 0x07;
   
   return reg;
@@ -161,12 +205,11 @@ void Ltr390uv::SetMeasRate(uint8_t MeasRate)
   uint8_t reg = 0;
   MeasRate &= 0x07;
 
-  I2Chip::I2cWriteUInt8(LTR390UV_ALS_UVS_MEAS_RATE, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LTR390UV_ALS_UVS_MEAS_RATE, address, buffer, error);
   reg &= 0x77;
   reg |= MeasRate;
 
-  I2Chip::I2cWriteRegisterUInt8(LTR390UV_ALS_UVS_MEAS_RATE, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LTR390UV_ALS_UVS_MEAS_RATE, reg, address, buffer, error);
 }
 
 /// Read bits [2:0] from register ALS_UVS_GAIN.
@@ -174,8 +217,7 @@ uint8_t Ltr390uv::GetGain()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LTR390UV_ALS_UVS_GAIN, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LTR390UV_ALS_UVS_GAIN, address, buffer, error);
   reg &= 0x07;
   
   return reg;
@@ -188,7 +230,7 @@ void Ltr390uv::SetGain(uint8_t Gain)
 
   if( Gain < 5 )
   {
-    I2Chip::I2cWriteRegisterUInt8(LTR390UV_ALS_UVS_GAIN, Gain, address, buffer, error);
+    I2Chip::ShadowWriteUInt8(LTR390UV_ALS_UVS_GAIN, Gain, address, buffer, error);
 
     // set AlsGain here
     switch( Gain )
@@ -217,8 +259,7 @@ uint8_t Ltr390uv::GetID()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LTR390UV_PART_ID, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LTR390UV_PART_ID, address, buffer, error);
   
   return reg;
 }
@@ -228,8 +269,7 @@ uint8_t Ltr390uv::GetStatus()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LTR390UV_MAIN_STATUS, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LTR390UV_MAIN_STATUS, address, buffer, error);
   
   return reg;
 }
@@ -239,8 +279,7 @@ bool Ltr390uv::IsPowerOn()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LTR390UV_MAIN_STATUS, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LTR390UV_MAIN_STATUS, address, buffer, error);
   reg &= 0x20;
  
   return ( reg == 0x20 );
@@ -251,8 +290,7 @@ bool Ltr390uv::IsInterrupt()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LTR390UV_MAIN_STATUS, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LTR390UV_MAIN_STATUS, address, buffer, error);
   reg &= 0x10;
  
   return ( reg == 0x10 );
@@ -263,21 +301,19 @@ bool Ltr390uv::NewData()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LTR390UV_MAIN_STATUS, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LTR390UV_MAIN_STATUS, address, buffer, error);
   reg &= 0x08;
  
   return ( reg == 0x08 );
 }
 
-/// Read registers ALS_DATA_0, ALS_DATA_1 and ALS_DATA_2.
+/// Read registers ALS_DATA_0, ALS_DATA_1 and ALS_DATA_2 in one transfer.
 bool Ltr390uv::ReadAmbientLight()
 {
   bool success = true;
-  uint8_t reg = 0;
   uint32_t data = 0;
 
-  I2Chip::I2cWriteUInt8(LTR390UV_ALS_DATA_0, address, buffer, error);
+  I2Chip::I2cReadRegisters(LTR390UV_ALS_DATA_0, 3, address, buffer, error);
 
   if( error != 0 )
   {
@@ -285,64 +321,23 @@ bool Ltr390uv::ReadAmbientLight()
   }
   else
   {
-    reg = I2Chip::I2cReadUInt8(address, buffer, error);
-
-    if( error != 0 )
-    {
-      success = false;
-    }
-    else
-    {
-      data = (uint32_t)reg;
-
-      I2Chip::I2cWriteUInt8(LTR390UV_ALS_DATA_1, address, buffer, error);
-
-      if( error != 0 )
-      {
-        success = false;
-      }
-      else
-      {
-        reg = I2Chip::I2cReadUInt8(address, buffer, error);
-
-	if( error != 0 )
-        {
-          success = false;
-	}
-        else
-        {
-          data |= ( (uint32_t)reg ) << 8;
-
-	  I2Chip::I2cWriteUInt8(LTR390UV_ALS_DATA_2, address, buffer, error);
-
-          if( error != 0 )
-          {
-            success = false;
-          }
-          else
-          {
-            reg = I2Chip::I2cReadUInt8(address, buffer, error);
-
-            data |= ( (uint32_t)reg ) << 16;
-            AlsData = data;
-            Ambientlight = 0.6 * AlsData * Wfact / ( AlsGain * IntTime );
-	  }
-	}
-      }
-    }
+    data = (uint32_t)buffer[ 0 ];
+    data |= ( (uint32_t)buffer[ 1 ] ) << 8;
+    data |= ( (uint32_t)buffer[ 2 ] ) << 16;
+    AlsData = data;
+    Ambientlight = 0.6 * AlsData * Wfact / ( AlsGain * IntTime );
   }
 
   return success;
 }
 
-/// Read registers UVS_DATA_0, UVS_DATA_1 and UVS_DATA_2.
+/// Read registers UVS_DATA_0, UVS_DATA_1 and UVS_DATA_2 in one transfer.
 bool Ltr390uv::ReadUltraviolet()
 {
   bool success = true;
-  uint8_t reg = 0;
   uint32_t data = 0;
 
-  I2Chip::I2cWriteUInt8(LTR390UV_UVS_DATA_0, address, buffer, error);
+  I2Chip::I2cReadRegisters(LTR390UV_UVS_DATA_0, 3, address, buffer, error);
 
   if( error != 0 )
   {
@@ -350,51 +345,11 @@ bool Ltr390uv::ReadUltraviolet()
   }
   else
   {
-    reg = I2Chip::I2cReadUInt8(address, buffer, error);
-
-    if( error != 0 )
-    {
-      success = false;
-    }
-    else
-    {
-      data = (uint32_t)reg;
-
-      I2Chip::I2cWriteUInt8(LTR390UV_UVS_DATA_1, address, buffer, error);
-
-      if( error != 0 )
-      {
-        success = false;
-      }
-      else
-      {
-        reg = I2Chip::I2cReadUInt8(address, buffer, error);
-    
-        if( error != 0 )
-        {
-          success = false;
-	}
-        else
-        {
-          data |= ( (uint32_t)reg ) << 8;
-
-          I2Chip::I2cWriteUInt8(LTR390UV_UVS_DATA_2, address, buffer, error);
-
-          if( error != 0 )
-          {
-            success = false;
-          }
-          else
-          {
-            reg = I2Chip::I2cReadUInt8(address, buffer, error);
-
-            data |= ( (uint32_t)reg ) << 16;
-            UviData = data;
-            UVI = UviData * Wfact / UVsensitivity;
-	  }
-	}
-      }
-    }
+    data = (uint32_t)buffer[ 0 ];
+    data |= ( (uint32_t)buffer[ 1 ] ) << 8;
+    data |= ( (uint32_t)buffer[ 2 ] ) << 16;
+    UviData = data;
+    UVI = UviData * Wfact / UVsensitivity;
   }
 
   return success;
@@ -405,12 +360,11 @@ void Ltr390uv::IntAmbientLight()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LTR390UV_INT_CFG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LTR390UV_INT_CFG, address, buffer, error);
   reg &= 0x14;
   reg |= 0x10;
 
-  I2Chip::I2cWriteRegisterUInt8(LTR390UV_INT_CFG, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LTR390UV_INT_CFG, reg, address, buffer, error);
 }
 
 /// Set bits [5:4] to 11 in INT_CFG register.
@@ -418,12 +372,11 @@ void Ltr390uv::IntUltraviolet()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LTR390UV_INT_CFG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LTR390UV_INT_CFG, address, buffer, error);
   reg &= 0x34;
   reg |= 0x30;
 
-  I2Chip::I2cWriteRegisterUInt8(LTR390UV_INT_CFG, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LTR390UV_INT_CFG, reg, address, buffer, error);
 }
 
 /// Set bit 2 in INT_CFG register.
@@ -431,11 +384,10 @@ void Ltr390uv::IntEnable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LTR390UV_INT_CFG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LTR390UV_INT_CFG, address, buffer, error);
   reg |= 0x04;
 
-  I2Chip::I2cWriteRegisterUInt8(LTR390UV_INT_CFG, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LTR390UV_INT_CFG, reg, address, buffer, error);
 }
 
 /// Clear bit 2 in INT_CFG register.
@@ -443,11 +395,10 @@ void Ltr390uv::IntDisable()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LTR390UV_INT_CFG, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::ShadowReadUInt8(LTR390UV_INT_CFG, address, buffer, error);
   reg &= 0x30;
 
-  I2Chip::I2cWriteRegisterUInt8(LTR390UV_INT_CFG, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LTR390UV_INT_CFG, reg, address, buffer, error);
 }
 
 /// Read bits [7:4] from INT_PTS register.
@@ -455,8 +406,7 @@ uint8_t Ltr390uv::GetIntPersist()
 {
   uint8_t reg = 0;
 
-  I2Chip::I2cWriteUInt8(LTR390UV_INT_PTS, address, buffer, error);
-  reg = I2Chip::I2cReadUInt8(address, buffer, error);
+  reg = I2Chip::I2cReadRegisterUInt8(LTR390UV_INT_PTS, address, buffer, error);
 
   return ( reg >> 4 );
 }
@@ -467,17 +417,16 @@ void Ltr390uv::SetIntPersist(uint8_t IntPersist)
   IntPersist &= 0x0F;
   IntPersist = IntPersist << 4;
 
-  I2Chip::I2cWriteRegisterUInt8(LTR390UV_INT_PTS, IntPersist, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LTR390UV_INT_PTS, IntPersist, address, buffer, error);
 }
 
-/// Read registers ALS_UVS_THRES_LOW_0, ALS_UVS_THRES_LOW_1 and ALS_UVS_THRES_LOW_2.
+/// Read registers ALS_UVS_THRES_LOW_0, ALS_UVS_THRES_LOW_1 and ALS_UVS_THRES_LOW_2 in one transfer.
 bool Ltr390uv::ReadThrsLow()
 {
   bool success = true;
-  uint8_t reg = 0;
   uint32_t data = 0;
 
-  I2Chip::I2cWriteUInt8(LTR390UV_ALS_UVS_THRES_LOW_0, address, buffer, error);
+  I2Chip::I2cReadRegisters(LTR390UV_ALS_UVS_THRES_LOW_0, 3, address, buffer, error);
 
   if( error != 0 )
   {
@@ -485,51 +434,12 @@ bool Ltr390uv::ReadThrsLow()
   }
   else
   {
-    reg = I2Chip::I2cReadUInt8(address, buffer, error);
-
-    if( error != 0 )
-    {
-      success = false;
-    }
-    else
-    {
-      data = (uint32_t)reg;
-
-      I2Chip::I2cWriteUInt8(LTR390UV_ALS_UVS_THRES_LOW_1, address, buffer, error);
-
-      if( error != 0 )
-      {
-        success = false;
-      }
-      else
-      {
-        reg = I2Chip::I2cReadUInt8(address, buffer, error);
-    
-        if( error != 0 )
-        {
-          success = false;
-	}
-        else
-        {
-          data |= ( (uint32_t)reg ) << 8;
-  
-          I2Chip::I2cWriteUInt8(LTR390UV_ALS_UVS_THRES_LOW_2, address, buffer, error);
-          if( error != 0 )
-          {
-            success = false;
-          }
-          else
-          {
-            reg = I2Chip::I2cReadUInt8(address, buffer, error);
-
-	    data |= ( (uint32_t)reg ) << 16;
-            ThrsLow = data;
-	  }
-	}
-      }
-    }
+    data = (uint32_t)buffer[ 0 ];
+    data |= ( (uint32_t)buffer[ 1 ] ) << 8;
+    data |= ( (uint32_t)buffer[ 2 ] ) << 16;
+    ThrsLow = data;
   }
-  
+
   return success;
 }
 
@@ -538,25 +448,24 @@ void Ltr390uv::SetThrsLow(uint32_t ThrsLow)
 {
   uint8_t reg = (uint8_t)( ThrsLow & 0xFF );
 
-  I2Chip::I2cWriteRegisterUInt8(LTR390UV_ALS_UVS_THRES_LOW_0, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LTR390UV_ALS_UVS_THRES_LOW_0, reg, address, buffer, error);
 
   reg = (uint8_t)( ( ThrsLow & 0xFF00 ) >> 8 );
 
-  I2Chip::I2cWriteRegisterUInt8(LTR390UV_ALS_UVS_THRES_LOW_1, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LTR390UV_ALS_UVS_THRES_LOW_1, reg, address, buffer, error);
 
   reg = (uint8_t)( ( ThrsLow & 0xF0000 ) >> 16 );
 
-  I2Chip::I2cWriteRegisterUInt8(LTR390UV_ALS_UVS_THRES_LOW_2, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LTR390UV_ALS_UVS_THRES_LOW_2, reg, address, buffer, error);
 }
 
-/// Read registers ALS_UVS_THRES_UP_0, ALS_UVS_THRES_UP_1 and ALS_UVS_THRES_UP_2.
+/// Read registers ALS_UVS_THRES_UP_0, ALS_UVS_THRES_UP_1 and ALS_UVS_THRES_UP_2 in one transfer.
 bool Ltr390uv::ReadThrsUp()
 {
   bool success = true;
-  uint8_t reg = 0;
   uint32_t data = 0;
 
-  I2Chip::I2cWriteUInt8(LTR390UV_ALS_UVS_THRES_UP_0, address, buffer, error);
+  I2Chip::I2cReadRegisters(LTR390UV_ALS_UVS_THRES_UP_0, 3, address, buffer, error);
 
   if( error != 0 )
   {
@@ -564,51 +473,12 @@ bool Ltr390uv::ReadThrsUp()
   }
   else
   {
-    reg = I2Chip::I2cReadUInt8(address, buffer, error);
-
-    if( error != 0 )
-    {
-      success = false;
-    }
-    else
-    {
-      data = (uint32_t)reg;
-
-      I2Chip::I2cWriteUInt8(LTR390UV_ALS_UVS_THRES_UP_1, address, buffer, error);
-
-      if( error != 0 )
-      {
-        success = false;
-      }
-      else
-      {
-        reg = I2Chip::I2cReadUInt8(address, buffer, error);
-    
-        if( error != 0 )
-        {
-          success = false;
-	}
-        else
-        {
-          data |= ( (uint32_t)reg ) << 8;
-  
-          I2Chip::I2cWriteUInt8(LTR390UV_ALS_UVS_THRES_UP_2, address, buffer, error);
-          if( error != 0 )
-          {
-            success = false;
-          }
-          else
-          {
-            reg = I2Chip::I2cReadUInt8(address, buffer, error);
-    
-	    data |= ( (uint32_t)reg ) << 16;
-            ThrsUpper = data;
-	  }
-	}
-      }
-    }
+    data = (uint32_t)buffer[ 0 ];
+    data |= ( (uint32_t)buffer[ 1 ] ) << 8;
+    data |= ( (uint32_t)buffer[ 2 ] ) << 16;
+    ThrsUpper = data;
   }
-  
+
   return success;
 }
 
@@ -619,14 +489,14 @@ void Ltr390uv::SetThrsUp(uint32_t ThrsUp)
 {
   uint8_t reg = (uint8_t)( ThrsUp & 0xFF );
 
-  I2Chip::I2cWriteRegisterUInt8(LTR390UV_ALS_UVS_THRES_UP_0, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LTR390UV_ALS_UVS_THRES_UP_0, reg, address, buffer, error);
 
   reg = (uint8_t)( ( ThrsUp & 0xFF00 ) >> 8 );
 
-  I2Chip::I2cWriteRegisterUInt8(LTR390UV_ALS_UVS_THRES_UP_1, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LTR390UV_ALS_UVS_THRES_UP_1, reg, address, buffer, error);
 
   reg = (uint8_t)( ( ThrsUp & 0xF0000 ) >> 16 );
 
-  I2Chip::I2cWriteRegisterUInt8(LTR390UV_ALS_UVS_THRES_UP_2, reg, address, buffer, error);
+  I2Chip::ShadowWriteUInt8(LTR390UV_ALS_UVS_THRES_UP_2, reg, address, buffer, error);
 }
 
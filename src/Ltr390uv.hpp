@@ -2,7 +2,7 @@
  * 
  * Ltr390uv class definitions and constructor. Base class is I2Chip. 
  *       
- * Copyright (C) 2022 Jaakko Koivuniemi.
+ * Copyright (C) 2022 - 2026 Jaakko Koivuniemi.
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -20,7 +20,7 @@
  ****************************************************************************
  *
  * Sun 01 May 2022 01:28:36 PM CDT
- * Edit: 
+ * Edit: Sat Oct 17 14:21:05 CDT 2026
  *
  * Jaakko Koivuniemi
  **/
@@ -50,6 +50,24 @@
 #define LTR390UV_ALS_UVS_THRES_LOW_1 0x25
 #define LTR390UV_ALS_UVS_THRES_LOW_2 0x26
 
+/// Configuration profile for Ltr390uv applied with _Ltr390uv::ApplyProfile()_.
+
+/// The profile covers registers MAIN_CTRL, ALS_UVS_MEAS_RATE, ALS_UVS_GAIN,
+/// INT_CFG, INT_PST and the interrupt thresholds.
+struct Ltr390uvProfile
+{
+    bool Ultraviolet = false; ///< UVS mode instead of ALS mode
+    bool Enable = false;      ///< ALS/UVS enable
+    uint8_t Resolution = 2;   ///< bits [6:4] 0 - 5 in ALS_UVS_MEAS_RATE
+    uint8_t MeasRate = 2;     ///< bits [2:0] 0 - 7 in ALS_UVS_MEAS_RATE
+    uint8_t Gain = 1;         ///< bits [2:0] 0 - 4 in ALS_UVS_GAIN
+    bool IntUltraviolet = false; ///< interrupt from UVS instead of ALS
+    bool IntEnable = false;   ///< interrupt enable
+    uint8_t IntPersist = 0;   ///< bits [7:4] 0 - 15 in INT_PST
+    uint32_t ThrsUp = 0xFFFFF; ///< 20-bit upper interrupt threshold
+    uint32_t ThrsLow = 0;     ///< 20-bit lower interrupt threshold
+};
+
 /// Class for Ltr390uv inherited from I2Chip base class. 
 
 /// The constructor _Ltr390uv_ sets name tag, device file name and chip address
@@ -99,6 +117,12 @@ class Ltr390uv : public I2Chip
     /// Get last error number.
     int GetError() { return error; }
 
+    /// Read N registers from chip into shadow cache in one transfer.
+    void ShadowRefresh(uint8_t reg, int Nbytes) { I2Chip::ShadowRefresh(reg, Nbytes, address, buffer, error); }
+
+    /// Write shadow registers collected after ShadowDefer() to chip.
+    void ShadowFlush() { I2Chip::ShadowFlush(address, buffer, error); }
+
     /// Get ambien light value in lux from last reading. 
     double GetAmbientLight() { return Ambientlight; }
 
@@ -126,6 +150,9 @@ class Ltr390uv : public I2Chip
     /// Reset.
     void Reset();
 
+    /// Check profile, compute register image and write it in bursts.
+    bool ApplyProfile(const Ltr390uvProfile & Profile);
+
     /// Ambient light mode.
     void AmbientLightMode();
 
@@ -0,0 +1,420 @@
+/**************************************************************************
+ *
+ * Metrics class member functions for Prometheus exporter.
+ *
+ * Copyright (C) 2026 Jaakko Koivuniemi.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************
+ *
+ * Sun Oct 18 12:34:09 CDT 2026
+ * Edit: Sun Oct 18 12:34:09 CDT 2026
+ *
+ * Jaakko Koivuniemi
+ **/
+
+
+
+#include "Metrics.hpp"
+#include <sys/socket.h>
+#include <netdb.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <ctype.h>
+#include <math.h>
+#include <algorithm>
+
+using namespace std;
+
+/// Metrics constructor.
+Metrics::Metrics(std::string address, Snapshot *snapshot, Scheduler *scheduler)
+{
+  this->address = address;
+  this->snapshot = snapshot;
+  this->scheduler = scheduler;
+  seq = UINT64_MAX;
+  channelpart = 0;
+  lfd = -1;
+  running = false;
+  scrapes = 0;
+}
+
+Metrics::~Metrics()
+{
+  Metrics::Stop();
+}
+
+void Metrics::AddCounter(std::string name, std::string help, std::function<uint64_t()> get)
+{
+  Counter c;
+
+  c.name = name;
+  c.help = help;
+  c.get = get;
+  counters.push_back( c );
+}
+
+/// Channel names are split at underscores. The chip address is either
+/// appended to the chip as in _pca9535x20_, or the next part as in
+/// _tmp102_x48_ and _max31865_00_. The rest is the quantity, a channel
+/// without one, as of TMP102, has temperature _T_.
+void Metrics::AddGauges()
+{
+  for(size_t i = 0; i < snapshot->GetChannels(); i++)
+  {
+    std::vector<std::string> parts;
+    std::string name = snapshot->GetName( i ), chip, addr = "", quantity = "";
+    size_t start = 0, end;
+
+    while( ( end = name.find('_', start) ) != std::string::npos )
+    {
+      parts.push_back( name.substr(start, end - start) );
+      start = end + 1;
+    }
+    parts.push_back( name.substr( start ) );
+
+    chip = parts[ 0 ];
+    size_t p = 1, n = chip.length();
+    if( n > 3 && chip[ n - 3 ] == 'x' && isxdigit( chip[ n - 2 ] ) && isxdigit( chip[ n - 1 ] ) )
+    {
+      addr = "0x" + chip.substr(n - 2);
+      chip.resize(n - 3);
+    }
+    else if( parts.size() > 1 && parts[ 1 ].length() > 1 && parts[ 1 ][ 0 ] == 'x' && isxdigit( parts[ 1 ][ 1 ] ) )
+    {
+      addr = "0" + parts[ 1 ];
+      p = 2;
+    }
+    else if( parts.size() > 1 && parts[ 1 ].length() > 0 && all_of(parts[ 1 ].begin(), parts[ 1 ].end(), ::isdigit) )
+    {
+      addr = parts[ 1 ];
+      p = 2;
+    }
+
+    for(; p < parts.size(); p++) quantity += ( quantity == "" ? "" : "_" ) + parts[ p ];
+    if( quantity == "" ) quantity = "T";
+
+    Gauge g;
+    g.channel = i;
+    g.family = "i2chipd_" + quantity;
+    g.sample = g.family + "{chip=\"" + chip + "\"";
+    if( addr != "" ) g.sample += ",address=\"" + addr + "\"";
+    g.sample += "}";
+    g.ts = 0;
+    g.length = 0;
+    gauges.push_back( g );
+  }
+
+  std::stable_sort(gauges.begin(), gauges.end(), [](const Gauge & a, const Gauge & b) { return a.family < b.family; });
+}
+
+/// Start after snapshot is open, the channels are fixed then.
+bool Metrics::Start(int & error)
+{
+  struct addrinfo hints, *res = nullptr;
+  std::string host = "", port = address;
+  size_t colon = address.rfind(':');
+
+  if( colon != std::string::npos )
+  {
+    host = address.substr(0, colon);
+    port = address.substr(colon + 1);
+  }
+
+  memset(&hints, 0, sizeof( hints ));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_flags = AI_PASSIVE;
+
+  int rc = getaddrinfo(host == "" ? nullptr : host.c_str(), port.c_str(), &hints, &res);
+  if( rc != 0 )
+  {
+    fprintf(stderr, SD_ERR "metrics address %s: %s\n", address.c_str(), gai_strerror( rc ));
+    error = EINVAL;
+    return false;
+  }
+
+  for(struct addrinfo *a = res; a && lfd < 0; a = a->ai_next)
+  {
+    int one = 1;
+
+    lfd = socket(a->ai_family, a->ai_socktype | SOCK_CLOEXEC, a->ai_protocol);
+    if( lfd < 0 ) continue;
+
+    setsockopt(lfd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof( one ));
+    if( bind(lfd, a->ai_addr, a->ai_addrlen) < 0 || listen(lfd, 8) < 0 )
+    {
+      error = errno;
+      close( lfd );
+      lfd = -1;
+    }
+  }
+  freeaddrinfo( res );
+
+  if( lfd < 0 )
+  {
+    fprintf(stderr, SD_ERR "can not listen on %s: %s\n", address.c_str(), strerror( error ));
+    return false;
+  }
+
+  AddGauges();
+  buses = I2CBus::GetAll();
+  body.reserve( 65536 );
+  header.reserve( 256 );
+
+  fprintf(stderr, SD_INFO "metrics of %zu channels on %s\n", gauges.size(), address.c_str());
+
+  running = true;
+  thread = std::thread(&Metrics::Run, this);
+
+  return true;
+}
+
+/// The server thread notices the stop within its poll timeout.
+void Metrics::Stop()
+{
+  running = false;
+
+  if( thread.joinable() ) thread.join();
+
+  if( lfd >= 0 )
+  {
+    close( lfd );
+    lfd = -1;
+  }
+}
+
+void Metrics::Append(const char *format, ...)
+{
+  char line[ 256 ];
+  va_list args;
+
+  va_start(args, format);
+  int n = vsnprintf(line, sizeof( line ), format, args);
+  va_end(args);
+
+  if( n > 0 ) body.append(line, n < (int)sizeof( line ) ? n : sizeof( line ) - 1);
+}
+
+/// The channel part is built again only if the snapshot has changed, and
+/// the values only of channels with a new timestamp are formatted. The
+/// internal metrics are appended on each scrape.
+void Metrics::Render()
+{
+  if( snapshot->GetSeq() != seq )
+  {
+    const std::string *family = nullptr;
+
+    seq = snapshot->Read( copy );
+    body.clear();
+
+    for(auto & g : gauges)
+    {
+      const struct i2chipd_snapshot_channel & c = copy[ g.channel ];
+
+      if( c.ts == 0 ) continue;
+
+      if( c.ts != g.ts )
+      {
+        if( std::isnan( c.value ) ) g.length = snprintf(g.value, sizeof( g.value ), "NaN");
+        else if( std::isinf( c.value ) ) g.length = snprintf(g.value, sizeof( g.value ), c.value > 0 ? "+Inf" : "-Inf");
+        else g.length = snprintf(g.value, sizeof( g.value ), "%.10g", c.value);
+        g.ts = c.ts;
+      }
+
+      if( !family || *family != g.family )
+      {
+        body += "# TYPE ";
+        body += g.family;
+        body += " gauge\n";
+        family = &g.family;
+      }
+
+      body += g.sample;
+      body += ' ';
+      body.append(g.value, g.length);
+      body += '\n';
+    }
+
+    channelpart = body.size();
+  }
+
+  body.resize( channelpart );
+
+  if( scheduler )
+  {
+    scheduler->GetStats( stats );
+
+    Append("# HELP i2chipd_task_cycles_total Completed reading cycles.\n# TYPE i2chipd_task_cycles_total counter\n");
+    for(auto & st : stats) Append("i2chipd_task_cycles_total{task=\"%s\"} %llu\n", st.name.c_str(), (unsigned long long)st.cycles);
+    Append("# HELP i2chipd_task_overruns_total Cycles finished after next deadline.\n# TYPE i2chipd_task_overruns_total counter\n");
+    for(auto & st : stats) Append("i2chipd_task_overruns_total{task=\"%s\"} %llu\n", st.name.c_str(), (unsigned long long)st.overruns);
+    Append("# HELP i2chipd_task_skipped_total Deadlines skipped without reading.\n# TYPE i2chipd_task_skipped_total counter\n");
+    for(auto & st : stats) Append("i2chipd_task_skipped_total{task=\"%s\"} %llu\n", st.name.c_str(), (unsigned long long)st.skipped);
+    Append("# HELP i2chipd_task_exec_seconds Last trigger and collect time.\n# TYPE i2chipd_task_exec_seconds gauge\n");
+    for(auto & st : stats) Append("i2chipd_task_exec_seconds{task=\"%s\"} %.6f\n", st.name.c_str(), 1e-6 * st.exectime);
+    Append("# HELP i2chipd_task_exec_max_seconds Maximum trigger and collect time.\n# TYPE i2chipd_task_exec_max_seconds gauge\n");
+    for(auto & st : stats) Append("i2chipd_task_exec_max_seconds{task=\"%s\"} %.6f\n", st.name.c_str(), 1e-6 * st.exectimemax);
+    Append("# HELP i2chipd_task_jitter_seconds Last start delay from deadline.\n# TYPE i2chipd_task_jitter_seconds gauge\n");
+    for(auto & st : stats) Append("i2chipd_task_jitter_seconds{task=\"%s\"} %.6f\n", st.name.c_str(), 1e-6 * st.jitter);
+    Append("# HELP i2chipd_task_jitter_max_seconds Maximum start delay from deadline.\n# TYPE i2chipd_task_jitter_max_seconds gauge\n");
+    for(auto & st : stats) Append("i2chipd_task_jitter_max_seconds{task=\"%s\"} %.6f\n", st.name.c_str(), 1e-6 * st.jittermax);
+  }
+
+  Append("# HELP i2chipd_bus_errors_total Failed opens, locks and transfers of I2C bus.\n# TYPE i2chipd_bus_errors_total counter\n");
+  for(auto & b : buses) Append("i2chipd_bus_errors_total{bus=\"%s\"} %llu\n", b->GetDevice().c_str(), (unsigned long long)b->GetErrors());
+
+  for(auto & c : counters)
+  {
+    Append("# HELP %s %s\n# TYPE %s counter\n", c.name.c_str(), c.help.c_str(), c.name.c_str());
+    Append("%s %llu\n", c.name.c_str(), (unsigned long long)c.get());
+  }
+
+  Append("# HELP i2chipd_scrapes_total Responses to metrics requests.\n# TYPE i2chipd_scrapes_total counter\ni2chipd_scrapes_total %llu\n", (unsigned long long)scrapes);
+}
+
+/// Header and body are sent with one call.
+bool Metrics::Reply(int fd, const char *status, const std::string & content, bool keepalive)
+{
+  char line[ 256 ];
+  struct iovec iov[ 2 ];
+  struct msghdr msg;
+
+  int n = snprintf(line, sizeof( line ), "HTTP/1.1 %s\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\nContent-Length: %zu\r\nConnection: %s\r\n\r\n", status, content.size(), keepalive ? "keep-alive" : "close");
+
+  header.assign(line, n);
+  iov[ 0 ].iov_base = (void *)header.data();
+  iov[ 0 ].iov_len = header.size();
+  iov[ 1 ].iov_base = (void *)content.data();
+  iov[ 1 ].iov_len = content.size();
+
+  memset(&msg, 0, sizeof( msg ));
+  msg.msg_iov = iov;
+  msg.msg_iovlen = 2;
+
+  while( msg.msg_iovlen > 0 )
+  {
+    ssize_t w = sendmsg(fd, &msg, MSG_NOSIGNAL);
+    if( w <= 0 ) return false;
+
+    while( msg.msg_iovlen > 0 && (size_t)w >= msg.msg_iov[ 0 ].iov_len )
+    {
+      w -= msg.msg_iov[ 0 ].iov_len;
+      msg.msg_iov++;
+      msg.msg_iovlen--;
+    }
+    if( msg.msg_iovlen > 0 )
+    {
+      msg.msg_iov[ 0 ].iov_base = (char *)msg.msg_iov[ 0 ].iov_base + w;
+      msg.msg_iov[ 0 ].iov_len -= w;
+    }
+  }
+
+  return true;
+}
+
+/// HTTP/1.0 requests and requests with _Connection: close_ close the
+/// connection after the response.
+bool Metrics::Handle(int fd, const char *request)
+{
+  static const std::string notfound = "not found\n", badrequest = "bad request\n";
+  bool keepalive = ( strstr(request, " HTTP/1.1\r\n") != nullptr && strcasestr(request, "\r\nConnection: close") == nullptr );
+
+  if( strncmp(request, "GET ", 4) != 0 )
+  {
+    Reply(fd, "400 Bad Request", badrequest, false);
+    return false;
+  }
+
+  const char *path = request + 4;
+  if( strncmp(path, "/metrics ", 9) != 0 && strncmp(path, "/metrics?", 9) != 0 )
+  {
+    return Reply(fd, "404 Not Found", notfound, keepalive) && keepalive;
+  }
+
+  Render();
+  scrapes++;
+
+  return Reply(fd, "200 OK", body, keepalive) && keepalive;
+}
+
+/// Metrics member function running the server thread.
+
+/// Scrapers are served one request at a time from a single thread. A
+/// response is sent with blocking writes limited by a send timeout.
+void Metrics::Run()
+{
+  std::vector<struct pollfd> fds;
+  std::vector<std::string> input;
+  char buf[ 512 ];
+
+  fds.push_back( {lfd, POLLIN, 0} );
+  input.push_back( "" );
+
+  while( running )
+  {
+    if( poll(fds.data(), fds.size(), 200) <= 0 ) continue;
+
+    if( fds[ 0 ].revents & POLLIN )
+    {
+      int cfd = accept4(lfd, nullptr, nullptr, SOCK_CLOEXEC);
+
+      if( cfd >= 0 && fds.size() > METRICS_MAX_CLIENTS ) close( cfd );
+      else if( cfd >= 0 )
+      {
+        struct timeval timeout = {METRICS_TIMEOUT / 1000, 1000 * ( METRICS_TIMEOUT % 1000 )};
+
+        setsockopt(cfd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof( timeout ));
+        fds.push_back( {cfd, POLLIN, 0} );
+        input.push_back( "" );
+        input.back().reserve( METRICS_MAX_REQUEST );
+      }
+    }
+
+    for(size_t c = 1; c < fds.size(); c++)
+    {
+      if( fds[ c ].revents == 0 ) continue;
+
+      ssize_t n = recv(fds[ c ].fd, buf, sizeof( buf ), 0);
+      bool ok = ( n > 0 );
+
+      if( ok ) input[ c ].append(buf, n);
+
+      size_t pos;
+      while( ok && ( pos = input[ c ].find("\r\n\r\n") ) != std::string::npos )
+      {
+        input[ c ][ pos + 2 ] = '\0';
+        ok = Handle(fds[ c ].fd, input[ c ].c_str());
+        input[ c ].erase(0, pos + 4);
+      }
+
+      if( input[ c ].size() > METRICS_MAX_REQUEST ) ok = false;
+
+      if( !ok )
+      {
+        close( fds[ c ].fd );
+        fds.erase( fds.begin() + c );
+        input.erase( input.begin() + c );
+        c--;
+      }
+    }
+  }
+
+  for(size_t c = 1; c < fds.size(); c++) close( fds[ c ].fd );
+}
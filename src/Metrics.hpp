@@ -0,0 +1,135 @@
+/**************************************************************************
+ *
+ * Metrics class definitions and constructor.
+ *
+ * Copyright (C) 2026 Jaakko Koivuniemi.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************
+ *
+ * Sun Oct 18 12:34:09 CDT 2026
+ * Edit: Sun Oct 18 12:34:09 CDT 2026
+ *
+ * Jaakko Koivuniemi
+ **/
+
+
+
+#ifndef _METRICS_HPP
+#define _METRICS_HPP
+
+#include <systemd/sd-daemon.h>
+#include "Snapshot.hpp"
+#include "Scheduler.hpp"
+#include "I2CBus.hpp"
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <stdint.h>
+
+#define METRICS_MAX_CLIENTS 16   ///< maximum connected scrapers
+#define METRICS_MAX_REQUEST 2048 ///< maximum length of request header
+#define METRICS_TIMEOUT 1000     ///< timeout of sending response [ms]
+
+/// Prometheus exporter on HTTP/1.1.
+
+/// _GET /metrics_ returns the latest value of every channel of the
+/// snapshot as a gauge in the Prometheus text format, followed by timing
+/// statistics of the scheduled tasks, I2C bus errors and added counters.
+/// Channel _chip_xAA_quantity_ is exported as _i2chipd_quantity_ with
+/// labels _chip_ and _address_, channels without value are left out.
+///
+/// The values are read from the snapshot in memory and never from the
+/// chips. The channel part of the response is kept between scrapes and
+/// only channels with new samples are formatted again, so scrapes use
+/// the same buffers and do not allocate.
+class Metrics
+{
+    /// One channel exported as gauge.
+    struct Gauge
+    {
+      int channel;               ///< index in snapshot
+      std::string family;        ///< metric name
+      std::string sample;        ///< metric name with labels
+      int64_t ts;                ///< time of formatted value [us]
+      char value[ 32 ];          ///< formatted value
+      int length;                ///< length of formatted value
+    };
+
+    /// Counter added with AddCounter().
+    struct Counter
+    {
+      std::string name;          ///< metric name
+      std::string help;          ///< description
+      std::function<uint64_t()> get; ///< get current value
+    };
+
+    std::string address;           ///< listening address and port
+    Snapshot *snapshot;            ///< latest values
+    Scheduler *scheduler;          ///< scheduled tasks or nullptr
+    std::vector<Gauge> gauges;     ///< gauges sorted by family
+    std::vector<Counter> counters; ///< added counters
+    std::vector<struct i2chipd_snapshot_channel> copy; ///< copy of snapshot
+    std::vector<SchedulerStats> stats; ///< copy of task statistics
+    std::vector<I2CBus *> buses;   ///< buses for error counts
+    uint64_t seq;                  ///< snapshot sequence of channel part
+    std::string body;              ///< response body
+    size_t channelpart;            ///< length of channel part in body
+    std::string header;            ///< response header
+    int lfd;                       ///< listening socket
+    std::thread thread;            ///< server thread
+    std::atomic<bool> running;     ///< server thread runs while true
+    std::atomic<uint64_t> scrapes; ///< number of responses to /metrics
+
+    /// Serve scrapers until Stop() is called.
+    void Run();
+
+    /// Create gauges from snapshot channel names.
+    void AddGauges();
+
+    /// Update body with new values, format only changed channels.
+    void Render();
+
+    /// Append printf formatted text to body.
+    void Append(const char *format, ...) __attribute__(( format( printf, 2, 3 ) ));
+
+    /// Handle complete request header and return false if connection is closed.
+    bool Handle(int fd, const char *request);
+
+    /// Send header and body, return false on error.
+    bool Reply(int fd, const char *status, const std::string & content, bool keepalive);
+
+  public:
+    /// Construct Metrics on _address_, _host:port_ or only port, with latest values of snapshot.
+    Metrics(std::string address, Snapshot *snapshot, Scheduler *scheduler);
+
+    virtual ~Metrics();
+
+    /// Export counter, call before Start().
+    void AddCounter(std::string name, std::string help, std::function<uint64_t()> get);
+
+    /// Get number of scrapes served.
+    uint64_t GetScrapes() { return scrapes; }
+
+    /// Create socket and start server thread, return true in success.
+    bool Start(int & error);
+
+    /// Stop server thread and close socket.
+    void Stop();
+};
+
+#endif
@@ -0,0 +1,509 @@
+/**************************************************************************
+ *
+ * Mqtt class member functions for publishing values to MQTT broker.
+ *
+ * Copyright (C) 2026 Jaakko Koivuniemi.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************
+ *
+ * Sun Oct 18 11:20:37 CDT 2026
+ * Edit: Sun Oct 18 11:20:37 CDT 2026
+ *
+ * Jaakko Koivuniemi
+ **/
+
+
+
+#include "Mqtt.hpp"
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netdb.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+
+using namespace std;
+
+/// Mqtt constructor, the port is 1883 if not given in _broker_.
+Mqtt::Mqtt(std::string broker, std::string prefix, std::string client, int size)
+{
+  size_t colon = broker.rfind(':');
+
+  if( colon != std::string::npos )
+  {
+    this->host = broker.substr(0, colon);
+    this->port = broker.substr(colon + 1);
+  }
+  else
+  {
+    this->host = broker;
+    this->port = "1883";
+  }
+
+  this->prefix = prefix;
+  this->client = client;
+  this->qos = 0;
+  this->retain = false;
+  this->queue.resize( size > 0 ? size : 1 );
+  this->head = 0;
+  this->count = 0;
+  this->nextid = 1;
+  this->fd = -1;
+  this->lastsend = 0;
+  this->pingsent = 0;
+  this->running = false;
+  this->published = 0;
+  this->dropped = 0;
+  this->connects = 0;
+  this->connected = false;
+  this->batch.reserve( MQTT_MAX_BATCH );
+  this->inflight.reserve( MQTT_MAX_INFLIGHT );
+}
+
+Mqtt::~Mqtt()
+{
+  Mqtt::Stop();
+}
+
+int Mqtt::Add(std::string name)
+{
+  if( running ) return -1;
+
+  topics.push_back( prefix + name );
+
+  return topics.size() - 1;
+}
+
+/// Values longer than _MQTT_MAX_PAYLOAD_ are truncated.
+bool Mqtt::Publish(int topic, const char *payload, size_t length)
+{
+  if( topic < 0 ) return false;
+
+  std::lock_guard<std::mutex> guard( lock );
+
+  if( count == queue.size() )
+  {
+    dropped++;
+    return false;
+  }
+
+  MqttMessage & msg = queue[ ( head + count ) % queue.size() ];
+  msg.topic = topic;
+  msg.length = ( length < MQTT_MAX_PAYLOAD ? length : MQTT_MAX_PAYLOAD );
+  memcpy(msg.payload, payload, msg.length);
+  count++;
+
+  return true;
+}
+
+size_t Mqtt::GetQueued()
+{
+  std::lock_guard<std::mutex> guard( lock );
+
+  return count;
+}
+
+void Mqtt::Start()
+{
+  if( running || topics.empty() ) return;
+
+  fprintf(stderr, SD_INFO "MQTT publisher to %s:%s with QoS %d, %zu topics\n", host.c_str(), port.c_str(), qos, topics.size());
+
+  running = true;
+  thread = std::thread(&Mqtt::Run, this);
+}
+
+/// The publisher thread notices the stop within _MQTT_INTERVAL_.
+void Mqtt::Stop()
+{
+  running = false;
+
+  if( thread.joinable() ) thread.join();
+}
+
+int64_t Mqtt::Now()
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (int64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+/// Remaining length is encoded with 7 bits in each byte.
+void Mqtt::AppendLength(size_t length)
+{
+  do
+  {
+    uint8_t b = length & 0x7F;
+    length >>= 7;
+    if( length > 0 ) b |= 0x80;
+    out += (char)b;
+  }
+  while( length > 0 );
+}
+
+void Mqtt::AppendString(const std::string & str)
+{
+  out += (char)( str.length() >> 8 );
+  out += (char)( str.length() & 0xFF );
+  out += str;
+}
+
+void Mqtt::AppendPublish(const MqttMessage & msg, bool dup)
+{
+  const std::string & topic = topics[ msg.topic ];
+
+  out += (char)( 0x30 | ( dup ? 0x08 : 0 ) | ( qos << 1 ) | ( retain ? 0x01 : 0 ) );
+  AppendLength( 2 + topic.length() + ( qos > 0 ? 2 : 0 ) + msg.length );
+  AppendString( topic );
+  if( qos > 0 )
+  {
+    out += (char)( msg.id >> 8 );
+    out += (char)( msg.id & 0xFF );
+  }
+  out.append(msg.payload, msg.length);
+}
+
+/// Clean session is used, so messages without PUBACK are sent again by
+/// this client after CONNACK.
+bool Mqtt::Connect()
+{
+  struct addrinfo hints, *res = nullptr;
+
+  memset(&hints, 0, sizeof( hints ));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+
+  int rc = getaddrinfo(host.c_str(), port.c_str(), &hints, &res);
+  if( rc != 0 )
+  {
+    fprintf(stderr, SD_WARNING "can not resolve MQTT broker %s: %s\n", host.c_str(), gai_strerror( rc ));
+    return false;
+  }
+
+  int err = 0;
+  for(struct addrinfo *a = res; a && fd < 0; a = a->ai_next)
+  {
+    fd = socket(a->ai_family, a->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, a->ai_protocol);
+    if( fd < 0 )
+    {
+      err = errno;
+      continue;
+    }
+
+    if( connect(fd, a->ai_addr, a->ai_addrlen) < 0 )
+    {
+      struct pollfd p = {fd, POLLOUT, 0};
+      socklen_t len = sizeof( err );
+
+      err = errno;
+      if( err == EINPROGRESS )
+      {
+        if( poll(&p, 1, MQTT_TIMEOUT) == 1 ) getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len);
+        else err = ETIMEDOUT;
+      }
+
+      if( err != 0 )
+      {
+        close( fd );
+        fd = -1;
+      }
+    }
+  }
+  freeaddrinfo( res );
+
+  if( fd < 0 )
+  {
+    fprintf(stderr, SD_WARNING "can not connect to MQTT broker %s:%s: %s\n", host.c_str(), port.c_str(), strerror( err ));
+    return false;
+  }
+
+  int one = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof( one ));
+
+  uint8_t flags = 0x02;
+  size_t length = 10 + 2 + client.length();
+  if( user != "" )
+  {
+    flags |= 0x80;
+    length += 2 + user.length();
+  }
+  if( passwd != "" )
+  {
+    flags |= 0x40;
+    length += 2 + passwd.length();
+  }
+
+  out.clear();
+  out += (char)0x10;
+  AppendLength( length );
+  AppendString( "MQTT" );
+  out += (char)0x04;
+  out += (char)flags;
+  out += (char)( MQTT_KEEPALIVE >> 8 );
+  out += (char)( MQTT_KEEPALIVE & 0xFF );
+  AppendString( client );
+  if( user != "" ) AppendString( user );
+  if( passwd != "" ) AppendString( passwd );
+
+  in.clear();
+  pingsent = 0;
+  if( !Send( out ) ) return false;
+
+  int64_t deadline = Now() + MQTT_TIMEOUT;
+  while( !connected && fd >= 0 && Now() < deadline )
+  {
+    struct pollfd p = {fd, POLLIN, 0};
+    if( poll(&p, 1, MQTT_INTERVAL) > 0 && !Receive() ) return false;
+  }
+
+  if( !connected )
+  {
+    if( fd >= 0 )
+    {
+      fprintf(stderr, SD_WARNING "no CONNACK from MQTT broker %s:%s\n", host.c_str(), port.c_str());
+      Disconnect();
+    }
+    return false;
+  }
+
+  connects++;
+  fprintf(stderr, SD_INFO "connected to MQTT broker %s:%s\n", host.c_str(), port.c_str());
+
+  if( !inflight.empty() )
+  {
+    out.clear();
+    for(auto & m : inflight) AppendPublish(m, true);
+    if( !Send( out ) ) return false;
+  }
+
+  return true;
+}
+
+void Mqtt::Disconnect()
+{
+  if( fd >= 0 ) close( fd );
+
+  fd = -1;
+  connected = false;
+  in.clear();
+  pingsent = 0;
+}
+
+bool Mqtt::Send(const std::string & data)
+{
+  size_t sent = 0;
+
+  while( sent < data.length() && fd >= 0 )
+  {
+    ssize_t n = send(fd, data.data() + sent, data.length() - sent, MSG_NOSIGNAL);
+
+    if( n > 0 )
+    {
+      sent += n;
+      continue;
+    }
+
+    if( n < 0 && ( errno == EAGAIN || errno == EWOULDBLOCK ) )
+    {
+      struct pollfd p = {fd, POLLOUT, 0};
+      if( poll(&p, 1, MQTT_TIMEOUT) == 1 ) continue;
+      errno = ETIMEDOUT;
+    }
+
+    if( n < 0 && errno == EINTR ) continue;
+
+    fprintf(stderr, SD_WARNING "MQTT broker %s:%s send error: %s\n", host.c_str(), port.c_str(), strerror( errno ));
+    Disconnect();
+    return false;
+  }
+
+  lastsend = Now();
+
+  return fd >= 0;
+}
+
+/// Only CONNACK, PUBACK and PINGRESP are expected from the broker.
+bool Mqtt::Receive()
+{
+  uint8_t buf[ 512 ];
+  ssize_t n;
+
+  while( ( n = read(fd, buf, sizeof( buf )) ) > 0 ) in.insert(in.end(), buf, buf + n);
+
+  if( n == 0 || ( errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR ) )
+  {
+    fprintf(stderr, SD_WARNING "MQTT broker %s:%s closed connection\n", host.c_str(), port.c_str());
+    Disconnect();
+    return false;
+  }
+
+  size_t pos = 0;
+  while( in.size() - pos >= 2 )
+  {
+    size_t length = 0, i = pos + 1;
+    int shift = 0;
+
+    while( i < in.size() && shift < 28 )
+    {
+      length |= (size_t)( in[ i ] & 0x7F ) << shift;
+      shift += 7;
+      if( ( in[ i++ ] & 0x80 ) == 0 ) break;
+    }
+    if( ( in[ i - 1 ] & 0x80 ) != 0 || in.size() - i < length ) break;
+
+    const uint8_t *body = in.data() + i;
+    switch( in[ pos ] >> 4 )
+    {
+      case 2:
+        if( length < 2 || body[ 1 ] != 0 )
+        {
+          fprintf(stderr, SD_ERR "MQTT broker %s:%s refused connection, code %d\n", host.c_str(), port.c_str(), length < 2 ? -1 : body[ 1 ]);
+          Disconnect();
+          return false;
+        }
+        connected = true;
+        break;
+
+      case 4:
+        if( length >= 2 )
+        {
+          uint16_t id = ( body[ 0 ] << 8 ) | body[ 1 ];
+          for(auto m = inflight.begin(); m != inflight.end(); m++)
+          {
+            if( m->id == id )
+            {
+              inflight.erase( m );
+              break;
+            }
+          }
+        }
+        break;
+
+      case 13:
+        pingsent = 0;
+        break;
+    }
+
+    pos = i + length;
+  }
+
+  in.erase(in.begin(), in.begin() + pos);
+
+  return true;
+}
+
+/// Messages are removed from the queue only after they are written to the
+/// socket, so a failed write leaves them waiting for the next connection.
+bool Mqtt::Flush()
+{
+  size_t room = MQTT_MAX_BATCH;
+
+  if( qos > 0 && MQTT_MAX_INFLIGHT - inflight.size() < room ) room = MQTT_MAX_INFLIGHT - inflight.size();
+
+  batch.clear();
+  lock.lock();
+  for(size_t i = 0; i < count && i < room; i++) batch.push_back( queue[ ( head + i ) % queue.size() ] );
+  lock.unlock();
+
+  if( batch.empty() ) return true;
+
+  out.clear();
+  for(auto & m : batch)
+  {
+    if( qos > 0 )
+    {
+      m.id = nextid++;
+      if( nextid == 0 ) nextid = 1;
+      inflight.push_back( m );
+    }
+    AppendPublish(m, false);
+  }
+
+  if( !Send( out ) )
+  {
+    if( qos > 0 ) inflight.resize( inflight.size() - batch.size() );
+    return false;
+  }
+
+  lock.lock();
+  head = ( head + batch.size() ) % queue.size();
+  count -= batch.size();
+  lock.unlock();
+
+  published += batch.size();
+
+  return true;
+}
+
+/// Publisher thread function.
+
+/// Connect is retried with back-off from 1 s to 60 s. A PINGREQ is sent when nothing has been sent for half of the keep alive
+/// interval and the connection is closed if no PINGRESP comes within the
+/// interval.
+void Mqtt::Run()
+{
+  int wait = 1;
+  int64_t retry = 0;
+
+  while( running )
+  {
+    if( fd < 0 )
+    {
+      if( Now() < retry || !Connect() )
+      {
+        if( Now() >= retry )
+        {
+          fprintf(stderr, SD_NOTICE "%zu MQTT messages queued, retry in %d s\n", GetQueued(), wait);
+          retry = Now() + 1000 * wait;
+          if( wait < 60 ) wait = ( 2 * wait < 60 ) ? 2 * wait : 60;
+        }
+        poll(nullptr, 0, MQTT_INTERVAL);
+        continue;
+      }
+      wait = 1;
+    }
+
+    struct pollfd p = {fd, POLLIN, 0};
+    if( poll(&p, 1, MQTT_INTERVAL) > 0 && !Receive() ) continue;
+
+    if( !Flush() ) continue;
+
+    int64_t now = Now();
+    if( pingsent > 0 && now - pingsent > 1000 * MQTT_KEEPALIVE )
+    {
+      fprintf(stderr, SD_WARNING "no PINGRESP from MQTT broker %s:%s\n", host.c_str(), port.c_str());
+      Disconnect();
+    }
+    else if( pingsent == 0 && now - lastsend >= 500 * MQTT_KEEPALIVE )
+    {
+      pingsent = now;
+      Send( std::string("\xC0\x00", 2) );
+    }
+  }
+
+  if( fd >= 0 )
+  {
+    Flush();
+    Send( std::string("\xE0\x00", 2) );
+    Disconnect();
+  }
+}
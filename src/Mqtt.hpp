@@ -0,0 +1,170 @@
+/**************************************************************************
+ *
+ * Mqtt class definitions and constructor.
+ *
+ * Copyright (C) 2026 Jaakko Koivuniemi.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************
+ *
+ * Sun Oct 18 11:20:37 CDT 2026
+ * Edit: Sun Oct 18 11:20:37 CDT 2026
+ *
+ * Jaakko Koivuniemi
+ **/
+
+
+
+#ifndef _MQTT_HPP
+#define _MQTT_HPP
+
+#include <systemd/sd-daemon.h>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <stdint.h>
+
+#define MQTT_MAX_PAYLOAD 32    ///< maximum length of value published
+#define MQTT_MAX_INFLIGHT 64   ///< QoS 1 messages waiting for PUBACK
+#define MQTT_MAX_BATCH 256     ///< messages sent with one write
+#define MQTT_KEEPALIVE 60      ///< keep alive interval [s]
+#define MQTT_INTERVAL 100      ///< interval of sending queued messages [ms]
+#define MQTT_TIMEOUT 5000      ///< timeout of connect and send [ms]
+
+/// One value waiting to be published.
+struct MqttMessage
+{
+  int topic = -1;                     ///< index of topic
+  uint16_t id = 0;                    ///< packet identifier with QoS 1
+  uint8_t length = 0;                 ///< length of payload
+  char payload[ MQTT_MAX_PAYLOAD ];   ///< value as text
+};
+
+/// MQTT 3.1.1 publisher with one persistent connection.
+
+/// Reading threads only copy the value to a bounded queue. The publisher
+/// thread sends the queued messages every _MQTT_INTERVAL_ ms, all messages
+/// of one cycle with one write, and with QoS 1 keeps up to
+/// _MQTT_MAX_INFLIGHT_ messages waiting for acknowledgement at a time.
+/// While the broker is not connected messages stay in the queue, and
+/// the connection is retried with back-off from 1 s to 60 s. Messages
+/// not acknowledged are sent again after reconnect. When the queue is
+/// full new messages are dropped and counted.
+class Mqtt
+{
+    std::string host;             ///< broker host
+    std::string port;             ///< broker port
+    std::string prefix;           ///< prefix of topics
+    std::string client;           ///< client identifier
+    std::string user;             ///< user name or empty
+    std::string passwd;           ///< password or empty
+    int qos;                      ///< quality of service 0 or 1
+    bool retain;                  ///< broker keeps last value of topic
+    std::vector<std::string> topics; ///< topics by index
+    std::vector<MqttMessage> queue; ///< ring buffer of waiting messages
+    size_t head;                  ///< index of oldest waiting message
+    size_t count;                 ///< number of waiting messages
+    std::mutex lock;              ///< lock for queue
+    std::vector<MqttMessage> batch; ///< messages of one send cycle
+    std::vector<MqttMessage> inflight; ///< QoS 1 messages waiting for PUBACK
+    uint16_t nextid;              ///< next packet identifier
+    int fd;                       ///< socket to broker or -1
+    std::string out;              ///< packets to send
+    std::vector<uint8_t> in;      ///< received bytes not yet parsed
+    int64_t lastsend;             ///< time of last send [ms]
+    int64_t pingsent;             ///< time of unanswered PINGREQ [ms] or 0
+    std::thread thread;           ///< publisher thread
+    std::atomic<bool> running;    ///< publisher runs while true
+    std::atomic<uint64_t> published; ///< messages sent
+    std::atomic<uint64_t> dropped; ///< messages dropped with full queue
+    std::atomic<uint64_t> connects; ///< successful connects
+    std::atomic<bool> connected;  ///< broker is connected
+
+    /// Publish queued messages until Stop() is called.
+    void Run();
+
+    /// Connect to broker and wait for CONNACK, return true in success.
+    bool Connect();
+
+    /// Close connection to broker.
+    void Disconnect();
+
+    /// Send whole buffer, return false and disconnect on error.
+    bool Send(const std::string & data);
+
+    /// Read and handle packets from broker, return false and disconnect on error.
+    bool Receive();
+
+    /// Send queued messages that fit in the inflight window, return false on error.
+    bool Flush();
+
+    /// Append PUBLISH packet of message.
+    void AppendPublish(const MqttMessage & msg, bool dup);
+
+    /// Append remaining length of packet.
+    void AppendLength(size_t length);
+
+    /// Append length prefixed string.
+    void AppendString(const std::string & str);
+
+    /// Get monotonic time [ms].
+    static int64_t Now();
+
+  public:
+    /// Construct Mqtt with broker _host:port_, topic prefix and client identifier.
+    Mqtt(std::string broker, std::string prefix, std::string client, int size);
+
+    virtual ~Mqtt();
+
+    /// Set user name and password, call before Start().
+    void SetLogin(std::string user, std::string passwd) { this->user = user; this->passwd = passwd; }
+
+    /// Set quality of service 0 or 1, call before Start().
+    void SetQos(int qos) { this->qos = ( qos > 0 ? 1 : 0 ); }
+
+    /// Set retain flag of messages, call before Start().
+    void SetRetain(bool retain) { this->retain = retain; }
+
+    /// Add topic _prefix + name_ before Start() and return its index, -1 if started.
+    int Add(std::string name);
+
+    /// Queue value of topic, return false if queue full.
+    bool Publish(int topic, const char *payload, size_t length);
+
+    /// Get number of messages sent.
+    uint64_t GetPublished() { return published; }
+
+    /// Get number of messages dropped because of full queue.
+    uint64_t GetDropped() { return dropped; }
+
+    /// Get number of connects to broker.
+    uint64_t GetConnects() { return connects; }
+
+    /// Get number of messages waiting in queue.
+    size_t GetQueued();
+
+    /// Return true if broker is connected.
+    bool IsConnected() { return connected; }
+
+    /// Start publisher thread, connection is made by the thread.
+    void Start();
+
+    /// Send waiting messages if connected, disconnect and stop publisher thread.
+    void Stop();
+};
+
+#endif
@@ -2,7 +2,7 @@
  * 
  * Pca9535 class member functions for configuration and reading with I2Chip. 
  *       
- * Copyright (C) 2023 Jaakko Koivuniemi.
+ * Copyright (C) 2023 - 2026 Jaakko Koivuniemi.
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -20,7 +20,7 @@
  ****************************************************************************
  *
  * Fri  3 Nov 15:04:38 CDT 2023
- * Edit: 
+ * Edit: Sat Oct 17 12:14:09 CDT 2026
  *
  * Jaakko Koivuniemi
  **/
@@ -36,8 +36,7 @@ uint16_t Pca9535::GetInputs()
 {
   uint16_t Inputs;
 
-  I2Chip::I2cWriteUInt8(PCA9535_INPUT_PORT_0, address, buffer, error);
-  Inputs = I2Chip::I2cReadUInt16(address, buffer, error);
+  Inputs = I2Chip::I2cReadRegisterUInt16(PCA9535_INPUT_PORT_0, address, buffer, error);
 
   return Inputs;
 }
@@ -47,8 +46,7 @@ uint16_t Pca9535::GetOutputs()
 {
   uint16_t Outputs;
 
-  I2Chip::I2cWriteUInt8(PCA9535_OUTPUT_PORT_0, address, buffer, error);
-  Outputs = I2Chip::I2cReadUInt16(address, buffer, error);
+  Outputs = I2Chip::I2cReadRegisterUInt16(PCA9535_OUTPUT_PORT_0, address, buffer, error);
 
   return Outputs;
 }
@@ -58,8 +56,7 @@ uint16_t Pca9535::GetPolInversions()
 {
   uint16_t Polarities;
 
-  I2Chip::I2cWriteUInt8(PCA9535_POLARITY_INVERSION_0, address, buffer, error);
-  Polarities = I2Chip::I2cReadUInt16(address, buffer, error);
+  Polarities = I2Chip::I2cReadRegisterUInt16(PCA9535_POLARITY_INVERSION_0, address, buffer, error);
 
   return Polarities;
 }
@@ -69,8 +66,7 @@ uint16_t Pca9535::GetPortConfigs()
 {
   uint16_t Configs;
 
-  I2Chip::I2cWriteUInt8(PCA9535_CONFIG_PORT_0, address, buffer, error);
-  Configs = I2Chip::I2cReadUInt16(address, buffer, error);
+  Configs = I2Chip::I2cReadRegisterUInt16(PCA9535_CONFIG_PORT_0, address, buffer, error);
 
   return Configs;
 }
@@ -0,0 +1,502 @@
+/**************************************************************************
+ *
+ * QueryServer class member functions for local queries of samples.
+ *
+ * Copyright (C) 2026 Jaakko Koivuniemi.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************
+ *
+ * Sun Oct 18 01:10:36 CDT 2026
+ * Edit: Sun Oct 18 02:41:25 CDT 2026
+ *
+ * Jaakko Koivuniemi
+ **/
+
+
+#include "QueryServer.hpp"
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <stdio.h>
+#include <sstream>
+#include <algorithm>
+
+using namespace std;
+
+/// QueryServer constructor.
+QueryServer::QueryServer(std::string path, Recent *recent)
+{
+  this->path = path;
+  this->recent = recent;
+  reader = nullptr;
+  lfd = -1;
+  running = false;
+  requests = 0;
+}
+
+QueryServer::~QueryServer()
+{
+  QueryServer::Stop();
+}
+
+/// An old socket file left by a crash is removed before bind.
+bool QueryServer::Start(int & error)
+{
+  struct sockaddr_un addr;
+
+  if( path.length() >= sizeof( addr.sun_path ) )
+  {
+    fprintf(stderr, SD_ERR "query socket path %s too long\n", path.c_str());
+    error = ENAMETOOLONG;
+    return false;
+  }
+
+  memset(&addr, 0, sizeof( addr ));
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, path.c_str(), sizeof( addr.sun_path ) - 1);
+
+  lfd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if( lfd < 0 )
+  {
+    fprintf(stderr, SD_ERR "can not create query socket: %s\n", strerror( errno ));
+    error = errno;
+    return false;
+  }
+
+  unlink( path.c_str() );
+  if( bind(lfd, (struct sockaddr *)&addr, sizeof( addr )) < 0 || listen(lfd, 8) < 0 )
+  {
+    fprintf(stderr, SD_ERR "can not listen on %s: %s\n", path.c_str(), strerror( errno ));
+    error = errno;
+    close( lfd );
+    lfd = -1;
+    return false;
+  }
+
+  // replies have only sample values, so any local user may connect
+  chmod(path.c_str(), 0666);
+
+  fprintf(stderr, SD_INFO "query service on %s\n", path.c_str());
+
+  running = true;
+  thread = std::thread(&QueryServer::Run, this);
+
+  return true;
+}
+
+/// The query thread notices the stop within its poll timeout.
+void QueryServer::Stop()
+{
+  running = false;
+
+  if( thread.joinable() ) thread.join();
+
+  if( lfd >= 0 )
+  {
+    close( lfd );
+    lfd = -1;
+    unlink( path.c_str() );
+  }
+
+  if( reader )
+  {
+    sqlite3_close( reader );
+    reader = nullptr;
+  }
+}
+
+/// QueryServer member function running the query thread.
+
+/// Clients are served one request at a time from a single thread, so the
+/// database connections need no locking. A reply is sent with blocking
+/// writes limited by a send timeout.
+void QueryServer::Run()
+{
+  std::vector<struct pollfd> fds;
+  std::vector<std::string> input;
+  char buf[ 512 ];
+
+  fds.push_back( {lfd, POLLIN, 0} );
+  input.push_back( "" );
+
+  while( running )
+  {
+    if( poll(fds.data(), fds.size(), 200) <= 0 ) continue;
+
+    if( fds[ 0 ].revents & POLLIN )
+    {
+      int cfd = accept4(lfd, nullptr, nullptr, SOCK_CLOEXEC);
+
+      if( cfd >= 0 && fds.size() > QUERYSERVER_MAX_CLIENTS ) close( cfd );
+      else if( cfd >= 0 )
+      {
+        struct timeval timeout = {1, 0};
+
+        setsockopt(cfd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof( timeout ));
+        fds.push_back( {cfd, POLLIN, 0} );
+        input.push_back( "" );
+      }
+    }
+
+    for(size_t c = 1; c < fds.size(); c++)
+    {
+      if( fds[ c ].revents == 0 ) continue;
+
+      ssize_t n = recv(fds[ c ].fd, buf, sizeof( buf ), 0);
+      bool ok = ( n > 0 );
+
+      if( ok ) input[ c ].append(buf, n);
+
+      size_t pos;
+      while( ok && ( pos = input[ c ].find( '\n' ) ) != std::string::npos )
+      {
+        std::string reply = Handle( input[ c ].substr(0, pos) );
+        input[ c ].erase(0, pos + 1);
+
+        for(size_t done = 0; ok && done < reply.size(); )
+        {
+          ssize_t w = send(fds[ c ].fd, reply.data() + done, reply.size() - done, MSG_NOSIGNAL);
+
+          if( w > 0 ) done += w;
+          else ok = false;
+        }
+      }
+
+      if( input[ c ].size() > QUERYSERVER_MAX_REQUEST ) ok = false;
+
+      if( !ok )
+      {
+        close( fds[ c ].fd );
+        fds.erase( fds.begin() + c );
+        input.erase( input.begin() + c );
+        c--;
+      }
+    }
+  }
+
+  for(size_t c = 1; c < fds.size(); c++) close( fds[ c ].fd );
+}
+
+/// Channel is split at the first and last dot, so the chip name may have dots.
+bool QueryServer::Find(const std::string & channel, SQLite *& db, std::string & name, std::string & column, int & index, std::string & reply)
+{
+  size_t first = channel.find( '.' ), last = channel.rfind( '.' );
+
+  if( first == std::string::npos || first == last )
+  {
+    reply = "error channel is table.name.column\n\n";
+    return false;
+  }
+
+  auto t = tables.find( channel.substr(0, first) );
+  if( t == tables.end() )
+  {
+    reply = "error unknown table\n\n";
+    return false;
+  }
+
+  db = t->second;
+  name = channel.substr(first + 1, last - first - 1);
+  column = channel.substr(last + 1);
+
+  std::vector<std::string> columns = db->GetColumns();
+  auto c = std::find(columns.begin(), columns.end(), column);
+  if( c == columns.end() )
+  {
+    reply = "error unknown column\n\n";
+    return false;
+  }
+  index = c - columns.begin();
+
+  return true;
+}
+
+/// QueryServer member function to reply to request.
+std::string QueryServer::Handle(const std::string & request)
+{
+  istringstream in( request );
+  std::string command, channel, name, column, reply;
+  long long t0 = 0, t1 = 0;
+  char line[ 64 ];
+  SQLite *db = nullptr;
+  int index = 0;
+
+  requests++;
+  in >> command >> channel >> t0 >> t1;
+
+  int64_t now = SQLite::TimeStamp();
+  if( t0 <= 0 ) t0 += now;
+  if( t1 <= 0 ) t1 += now;
+
+  if( command == "channels" )
+  {
+    for(auto & key : recent->GetKeys())
+    {
+      auto t = tables.find( key.substr(0, key.find( '.' )) );
+      if( t == tables.end() ) continue;
+
+      for(auto & c : t->second->GetColumns()) reply += key + "." + c + "\n";
+    }
+  }
+  else if( command == "latest" )
+  {
+    if( !Find(channel, db, name, column, index, reply) ) return reply;
+
+    int64_t ts = 0;
+    double value = 0;
+    bool found = recent->Latest(db->GetTable() + "." + name, index, ts, value);
+
+    // before first sample after start the newest row of last two days is used
+    if( !found )
+    {
+      std::vector<std::string> files = Files(db, now - 172800000000LL, now);
+
+      for(auto f = files.rbegin(); !found && f != files.rend(); f++)
+      {
+        sqlite3 *conn = Open( *f );
+        if( !conn ) continue;
+
+        sqlite3_stmt *stmt = Prepare(conn, "select ts," + column + " from " + db->GetTable() + " where name=? and ts>=? and ts<=? order by ts desc limit 1", name, now - 172800000000LL, now);
+        if( stmt && sqlite3_step( stmt ) == SQLITE_ROW )
+        {
+          ts = sqlite3_column_int64(stmt, 0);
+          value = sqlite3_column_double(stmt, 1);
+          found = true;
+        }
+        sqlite3_finalize( stmt );
+        Release( conn );
+      }
+    }
+
+    if( !found ) return "error no samples\n\n";
+
+    snprintf(line, sizeof( line ), "%lld %.10g\n", (long long)ts, value);
+    reply = line;
+  }
+  else if( command == "range" )
+  {
+    if( !Find(channel, db, name, column, index, reply) ) return reply;
+
+    std::string key = db->GetTable() + "." + name;
+    std::vector<int64_t> ts;
+    std::vector<double> values;
+    int64_t oldest = recent->GetOldest( key );
+    int64_t split = ( oldest >= 0 && oldest <= t1 ) ? oldest : t1 + 1;
+
+    if( t0 < split ) Select(db, name, column, t0, std::min<int64_t>(split - 1, t1), ts, values);
+    if( split <= t1 ) recent->Range(key, index, std::max<int64_t>(split, t0), t1, ts, values);
+
+    for(size_t i = 0; i < ts.size() && i < QUERYSERVER_MAX_ROWS; i++)
+    {
+      snprintf(line, sizeof( line ), "%lld %.10g\n", (long long)ts[ i ], values[ i ]);
+      reply += line;
+    }
+  }
+  else if( command == "aggregate" )
+  {
+    if( !Find(channel, db, name, column, index, reply) ) return reply;
+
+    std::string key = db->GetTable() + "." + name;
+    RecentStats s;
+    int64_t oldest = recent->GetOldest( key );
+    int64_t split = ( oldest >= 0 && oldest < t1 ) ? std::max<int64_t>(oldest, t0) : t1;
+
+    if( t0 < split )
+    {
+      auto r = rollups.find( db->GetTable() );
+      int level = -1;
+
+      // coarsest level with at least four buckets before the split
+      if( r != rollups.end() && index < r->second->GetColumns() )
+      {
+        for(int l = 0; l < r->second->GetLevels(); l++)
+        {
+          if( 4 * r->second->GetWidth( l ) <= split - t0 ) level = l;
+        }
+      }
+
+      if( level >= 0 )
+      {
+        int64_t w = r->second->GetWidth( level );
+        int64_t a = ( t0 + w - 1 ) / w * w, b = split / w * w;
+
+        SelectSummary(db, name, column, t0, a, s);
+        SelectRollup(r->second, level, name, column, a, b, s);
+        SelectSummary(db, name, column, b, split, s);
+      }
+      else SelectSummary(db, name, column, t0, split, s);
+    }
+
+    RecentStats r;
+    if( split < t1 && recent->Stats(key, index, split, t1 - 1, r) && r.count > 0 )
+    {
+      if( s.count == 0 || r.min < s.min ) s.min = r.min;
+      if( s.count == 0 || r.max > s.max ) s.max = r.max;
+      s.sum += r.sum;
+      s.count += r.count;
+    }
+
+    snprintf(line, sizeof( line ), "%llu %.10g %.10g %.10g\n", (unsigned long long)s.count, s.min, s.max, s.count > 0 ? s.sum / s.count : 0.0);
+    reply = line;
+  }
+  else return "error unknown command\n\n";
+
+  return reply + "\n";
+}
+
+/// With day partitions the raw rows are in one file for each UTC day.
+std::vector<std::string> QueryServer::Files(SQLite *db, int64_t t0, int64_t t1)
+{
+  std::vector<std::string> files;
+  const int64_t day = 86400000000LL;
+
+  if( !db->GetPartition() )
+  {
+    files.push_back( db->GetFile() );
+    return files;
+  }
+
+  if( t1 - t0 > 366 * day ) t0 = t1 - 366 * day;
+
+  for(int64_t t = t0 - t0 % day; t <= t1; t += day)
+  {
+    std::string file = db->GetFileAt( t );
+    if( access(file.c_str(), F_OK) == 0 ) files.push_back( file );
+  }
+
+  return files;
+}
+
+/// Partition files are opened for each request so that old files removed
+/// by retention are not held open.
+sqlite3 *QueryServer::Open(const std::string & file)
+{
+  sqlite3 *conn = nullptr;
+  bool main = ( tables.empty() || file == tables.begin()->second->GetFile() );
+
+  if( main && reader ) return reader;
+
+  if( sqlite3_open_v2(file.c_str(), &conn, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK )
+  {
+    fprintf(stderr, SD_ERR "can not open %s for queries: %s\n", file.c_str(), conn ? sqlite3_errmsg( conn ) : "no memory");
+    sqlite3_close( conn );
+    return nullptr;
+  }
+
+  sqlite3_busy_timeout(conn, 100);
+  if( main ) reader = conn;
+
+  return conn;
+}
+
+/// QueryServer member function to close partition file connection.
+void QueryServer::Release(sqlite3 *conn)
+{
+  if( conn != reader ) sqlite3_close( conn );
+}
+
+/// Table and column names are checked against insert statements before
+/// they are put to SQL.
+sqlite3_stmt *QueryServer::Prepare(sqlite3 *conn, const std::string & sql, const std::string & name, int64_t t0, int64_t t1)
+{
+  sqlite3_stmt *stmt = nullptr;
+
+  if( sqlite3_prepare_v2(conn, sql.c_str(), -1, &stmt, 0) != SQLITE_OK )
+  {
+    fprintf(stderr, SD_ERR "query prepare failed: %s\n", sqlite3_errmsg( conn ));
+    return nullptr;
+  }
+
+  sqlite3_bind_text(stmt, 1, name.c_str(), name.length(), SQLITE_TRANSIENT);
+  sqlite3_bind_int64(stmt, 2, t0);
+  sqlite3_bind_int64(stmt, 3, t1);
+
+  return stmt;
+}
+
+/// QueryServer member function to read raw rows.
+void QueryServer::Select(SQLite *db, const std::string & name, const std::string & column, int64_t t0, int64_t t1, std::vector<int64_t> & ts, std::vector<double> & values)
+{
+  std::string sql = "select ts," + column + " from " + db->GetTable() + " where name=? and ts>=? and ts<=? order by ts limit " + to_string( QUERYSERVER_MAX_ROWS );
+
+  for(auto & f : Files(db, t0, t1))
+  {
+    sqlite3 *conn = Open( f );
+    if( !conn ) continue;
+
+    sqlite3_stmt *stmt = Prepare(conn, sql, name, t0, t1);
+    while( stmt && ts.size() < QUERYSERVER_MAX_ROWS && sqlite3_step( stmt ) == SQLITE_ROW )
+    {
+      ts.push_back( sqlite3_column_int64(stmt, 0) );
+      values.push_back( sqlite3_column_double(stmt, 1) );
+    }
+    sqlite3_finalize( stmt );
+    Release( conn );
+  }
+}
+
+/// QueryServer member function to summarize raw rows.
+void QueryServer::SelectSummary(SQLite *db, const std::string & name, const std::string & column, int64_t t0, int64_t t1, RecentStats & s)
+{
+  std::string sql = "select count(" + column + "),min(" + column + "),max(" + column + "),total(" + column + ") from " + db->GetTable() + " where name=? and ts>=? and ts<?";
+
+  if( t0 >= t1 ) return;
+
+  for(auto & f : Files(db, t0, t1))
+  {
+    sqlite3 *conn = Open( f );
+    if( !conn ) continue;
+
+    sqlite3_stmt *stmt = Prepare(conn, sql, name, t0, t1);
+    if( stmt ) Merge(s, stmt);
+    sqlite3_finalize( stmt );
+    Release( conn );
+  }
+}
+
+/// Aggregate tables are in the main file also with day partitions.
+void QueryServer::SelectRollup(Rollup *rollup, int l, const std::string & name, const std::string & column, int64_t t0, int64_t t1, RecentStats & s)
+{
+  SQLite *level = rollup->GetLevel( l );
+  std::string sql = "select sum(count),min(" + column + "_min),max(" + column + "_max),total(" + column + "_mean*count) from " + level->GetTable() + " where name=? and ts>=? and ts<?";
+
+  if( t0 >= t1 ) return;
+
+  sqlite3 *conn = Open( level->GetFile() );
+  if( !conn ) return;
+
+  sqlite3_stmt *stmt = Prepare(conn, sql, name, t0, t1);
+  if( stmt ) Merge(s, stmt);
+  sqlite3_finalize( stmt );
+  Release( conn );
+}
+
+/// Statement returns count, minimum, maximum and sum.
+void QueryServer::Merge(RecentStats & s, sqlite3_stmt *stmt)
+{
+  if( sqlite3_step( stmt ) != SQLITE_ROW || sqlite3_column_int64(stmt, 0) == 0 ) return;
+
+  double min = sqlite3_column_double(stmt, 1), max = sqlite3_column_double(stmt, 2);
+
+  if( s.count == 0 || min < s.min ) s.min = min;
+  if( s.count == 0 || max > s.max ) s.max = max;
+  s.sum += sqlite3_column_double(stmt, 3);
+  s.count += sqlite3_column_int64(stmt, 0);
+}
@@ -0,0 +1,131 @@
+/**************************************************************************
+ *
+ * QueryServer class definitions and constructor.
+ *
+ * Copyright (C) 2026 Jaakko Koivuniemi.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************
+ *
+ * Sun Oct 18 01:10:36 CDT 2026
+ * Edit: Sun Oct 18 02:41:25 CDT 2026
+ *
+ * Jaakko Koivuniemi
+ **/
+
+
+#ifndef _QUERYSERVER_HPP
+#define _QUERYSERVER_HPP
+
+#include <systemd/sd-daemon.h>
+#include "SQLite.hpp"
+#include "Rollup.hpp"
+#include "Recent.hpp"
+#include <sqlite3.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <thread>
+#include <atomic>
+#include <stdint.h>
+
+#define QUERYSERVER_MAX_ROWS 100000  ///< maximum rows in one range reply
+#define QUERYSERVER_MAX_CLIENTS 16   ///< maximum connected clients
+#define QUERYSERVER_MAX_REQUEST 1024 ///< maximum length of request line
+
+/// Read-only query service on a Unix domain socket.
+
+/// Clients send one request per line and each reply ends with an empty
+/// line. Channels are named _table.name.column_ and times are in us since
+/// epoch, or relative to now if zero or negative.
+///
+///     latest channel             ts value
+///     range channel t0 t1        ts value on each line, t0 <= ts <= t1
+///     aggregate channel t0 t1    count min max mean of t0 <= ts < t1
+///     channels                   one channel on each line
+///
+/// Samples still in the recent ring are served from memory. Older samples
+/// are read from the database with read-only connections of the query
+/// thread, aggregates from the aggregate tables where whole buckets fit
+/// in the window and from raw rows for the rest. Errors are replied as
+/// _error_ followed by the reason.
+class QueryServer
+{
+    std::string path;              ///< socket path
+    Recent *recent;                ///< recent samples in memory
+    std::map<std::string, SQLite *> tables; ///< raw tables by name
+    std::map<std::string, Rollup *> rollups; ///< aggregate tables by raw table name
+    sqlite3 *reader;               ///< read-only connection to main file
+    int lfd;                       ///< listening socket
+    std::thread thread;            ///< query thread
+    std::atomic<bool> running;     ///< query thread runs while true
+    std::atomic<uint64_t> requests; ///< number of requests served
+
+    /// Serve clients until Stop() is called.
+    void Run();
+
+    /// Reply to one request line.
+    std::string Handle(const std::string & request);
+
+    /// Find table, chip name and column index of channel, return false with error reply if unknown.
+    bool Find(const std::string & channel, SQLite *& db, std::string & name, std::string & column, int & index, std::string & reply);
+
+    /// Get existing database files with rows from _t0_ to _t1_ [us] of table.
+    std::vector<std::string> Files(SQLite *db, int64_t t0, int64_t t1);
+
+    /// Open read-only connection, the main file connection is kept open.
+    sqlite3 *Open(const std::string & file);
+
+    /// Close connection unless it is the one to main file.
+    void Release(sqlite3 *conn);
+
+    /// Prepare statement and bind name and times, return nullptr on failure.
+    sqlite3_stmt *Prepare(sqlite3 *conn, const std::string & sql, const std::string & name, int64_t t0, int64_t t1);
+
+    /// Append rows of value _column_ from _t0_ to _t1_ [us] from database.
+    void Select(SQLite *db, const std::string & name, const std::string & column, int64_t t0, int64_t t1, std::vector<int64_t> & ts, std::vector<double> & values);
+
+    /// Add raw rows from _t0_ to before _t1_ [us] to summary.
+    void SelectSummary(SQLite *db, const std::string & name, const std::string & column, int64_t t0, int64_t t1, RecentStats & s);
+
+    /// Add aggregate buckets of level _l_ from _t0_ to before _t1_ [us] to summary.
+    void SelectRollup(Rollup *rollup, int l, const std::string & name, const std::string & column, int64_t t0, int64_t t1, RecentStats & s);
+
+    /// Add result of count, minimum, maximum and sum query to summary.
+    static void Merge(RecentStats & s, sqlite3_stmt *stmt);
+
+  public:
+    /// Construct QueryServer on socket _path_ with recent samples.
+    QueryServer(std::string path, Recent *recent);
+
+    virtual ~QueryServer();
+
+    /// Allow queries of table, call before Start().
+    void AddTable(SQLite *db) { tables[ db->GetTable() ] = db; }
+
+    /// Use aggregate tables for queries, call before Start().
+    void AddRollup(Rollup *rollup) { rollups[ rollup->GetSource()->GetTable() ] = rollup; }
+
+    /// Get number of requests served.
+    uint64_t GetRequests() { return requests; }
+
+    /// Create socket and start query thread, return true in success.
+    bool Start(int & error);
+
+    /// Stop query thread and remove socket.
+    void Stop();
+};
+
+#endif
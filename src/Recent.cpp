@@ -0,0 +1,285 @@
+/**************************************************************************
+ *
+ * Recent class member functions for samples kept in memory.
+ *
+ * Copyright (C) 2026 Jaakko Koivuniemi.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************
+ *
+ * Sun Oct 18 01:10:36 CDT 2026
+ * Edit: Sun Oct 18 19:20:48 CDT 2026
+ *
+ * Jaakko Koivuniemi
+ **/
+
+
+#include "Recent.hpp"
+#include <algorithm>
+
+using namespace std;
+
+/// Recent constructor.
+Recent::Recent(size_t capacity, size_t maxbytes)
+{
+  this->capacity = 2;
+  while( this->capacity < capacity ) this->capacity *= 2;
+
+  this->maxbytes = maxbytes;
+  bytes = 0;
+  refused = 0;
+  index = new Index();
+}
+
+Recent::~Recent()
+{
+  delete index.load();
+  for(auto & i : retired) delete i;
+
+  for(auto & r : rings)
+  {
+    delete [] r.second->ts;
+    delete [] r.second->values;
+    delete r.second;
+  }
+}
+
+/// Rings and index copies are never removed while running, so a found
+/// ring can be used without the lock.
+Recent::Ring *Recent::Find(const std::string & key)
+{
+  const Index *i = index.load( std::memory_order_acquire );
+
+  auto it = i->find( key );
+
+  return ( it == i->end() ) ? nullptr : it->second;
+}
+
+/// Rings are registered when the chips are configured, so the index is
+/// copied only a few times.
+Recent::Ring *Recent::Register(const std::string & table, const std::string & name, int N)
+{
+  std::string key = table + "." + name;
+  std::lock_guard<std::mutex> guard( lock );
+
+  auto it = rings.find( key );
+  if( it != rings.end() ) return it->second;
+
+  size_t size = capacity * ( sizeof( int64_t ) + N * sizeof( double ) );
+
+  if( bytes + size > maxbytes )
+  {
+    if( refused++ == 0 ) fprintf(stderr, SD_WARNING "recent samples of %s not kept, memory limit %llu bytes\n", key.c_str(), (unsigned long long)maxbytes);
+    return nullptr;
+  }
+
+  Ring *r = new Ring;
+  r->N = N;
+  r->head = 0;
+  r->claim = 0;
+  r->ts = new std::atomic<int64_t>[ capacity ]();
+  r->values = new std::atomic<double>[ capacity * r->N ]();
+  rings[ key ] = r;
+  bytes += size;
+
+  retired.push_back( index.load( std::memory_order_relaxed ) );
+  index.store( new Index( rings ), std::memory_order_release );
+
+  return r;
+}
+
+/// Values beyond the ring width are ignored.
+void Recent::Add(Ring *r, int64_t ts, int Nd, const double *dbl_array, int Ni, const int *int_array)
+{
+  if( !r ) return;
+
+  std::lock_guard<std::mutex> guard( r->write );
+
+  uint64_t h = r->head.load( std::memory_order_relaxed );
+  size_t i = h & ( capacity - 1 );
+
+  // readers of the overwritten sample see the claim before the new values
+  r->claim.store( h + 1, std::memory_order_relaxed );
+  std::atomic_thread_fence( std::memory_order_release );
+
+  r->ts[ i ].store( ts, std::memory_order_relaxed );
+  for(int c = 0; c < Nd && c < r->N; c++) r->values[ c * capacity + i ].store( dbl_array[ c ], std::memory_order_relaxed );
+  for(int c = 0; c < Ni && Nd + c < r->N; c++) r->values[ ( Nd + c ) * capacity + i ].store( int_array[ c ], std::memory_order_relaxed );
+
+  r->head.store( h + 1, std::memory_order_release );
+}
+
+/// Samples are in time order, so the window is found with binary search.
+void Recent::Window(Ring *r, uint64_t head, int64_t t0, int64_t t1, uint64_t & first, uint64_t & last)
+{
+  uint64_t lo = ( head > capacity ) ? head - capacity : 0, hi = head;
+
+  while( lo < hi )
+  {
+    uint64_t mid = lo + ( hi - lo ) / 2;
+
+    if( r->ts[ mid & ( capacity - 1 ) ].load( std::memory_order_relaxed ) < t0 ) lo = mid + 1;
+    else hi = mid;
+  }
+  first = lo;
+
+  hi = head;
+  while( lo < hi )
+  {
+    uint64_t mid = lo + ( hi - lo ) / 2;
+
+    if( r->ts[ mid & ( capacity - 1 ) ].load( std::memory_order_relaxed ) <= t1 ) lo = mid + 1;
+    else hi = mid;
+  }
+  last = lo;
+}
+
+/// The sample claimed by the writer may be half written, so samples up to
+/// capacity before the claim are valid.
+bool Recent::Valid(Ring *r, uint64_t first)
+{
+  std::atomic_thread_fence( std::memory_order_acquire );
+
+  uint64_t claim = r->claim.load( std::memory_order_relaxed );
+
+  return ( claim <= capacity || first >= claim - capacity );
+}
+
+/// Recent member function to read newest sample.
+bool Recent::Latest(const std::string & key, int column, int64_t & ts, double & value)
+{
+  Ring *r = Find( key );
+  if( !r || column < 0 || column >= r->N ) return false;
+
+  while( true )
+  {
+    uint64_t h = r->head.load( std::memory_order_acquire );
+    if( h == 0 ) return false;
+
+    size_t i = ( h - 1 ) & ( capacity - 1 );
+    ts = r->ts[ i ].load( std::memory_order_relaxed );
+    value = r->values[ column * capacity + i ].load( std::memory_order_relaxed );
+
+    if( Valid(r, h - 1) ) return true;
+  }
+}
+
+/// Recent member function to read time of oldest sample.
+int64_t Recent::GetOldest(const std::string & key)
+{
+  Ring *r = Find( key );
+  if( !r ) return -1;
+
+  while( true )
+  {
+    uint64_t h = r->head.load( std::memory_order_acquire );
+    if( h == 0 ) return -1;
+
+    uint64_t first = ( h > capacity ) ? h - capacity : 0;
+    int64_t ts = r->ts[ first & ( capacity - 1 ) ].load( std::memory_order_relaxed );
+
+    if( Valid(r, first) ) return ts;
+  }
+}
+
+/// Samples overwritten while copied are copied again from a new window.
+size_t Recent::Range(const std::string & key, int column, int64_t t0, int64_t t1, std::vector<int64_t> & ts, std::vector<double> & values)
+{
+  Ring *r = Find( key );
+  if( !r || column < 0 || column >= r->N ) return 0;
+
+  size_t size = ts.size();
+
+  while( true )
+  {
+    uint64_t first, last;
+    uint64_t h = r->head.load( std::memory_order_acquire );
+
+    Window(r, h, t0, t1, first, last);
+
+    for(uint64_t k = first; k < last; k++)
+    {
+      size_t i = k & ( capacity - 1 );
+
+      ts.push_back( r->ts[ i ].load( std::memory_order_relaxed ) );
+      values.push_back( r->values[ column * capacity + i ].load( std::memory_order_relaxed ) );
+    }
+
+    if( Valid(r, first) ) return ts.size() - size;
+
+    ts.resize( size );
+    values.resize( size );
+  }
+}
+
+/// Statistics are computed in place without copying the window.
+bool Recent::Stats(const std::string & key, int column, int64_t t0, int64_t t1, RecentStats & stats)
+{
+  Ring *r = Find( key );
+  if( !r || column < 0 || column >= r->N ) return false;
+
+  while( true )
+  {
+    uint64_t first, last;
+    uint64_t h = r->head.load( std::memory_order_acquire );
+    const std::atomic<double> *v = r->values + column * capacity;
+    RecentStats s;
+
+    Window(r, h, t0, t1, first, last);
+
+    for(uint64_t k = first; k < last; k++)
+    {
+      double x = v[ k & ( capacity - 1 ) ].load( std::memory_order_relaxed );
+
+      if( s.count == 0 || x < s.min ) s.min = x;
+      if( s.count == 0 || x > s.max ) s.max = x;
+      s.sum += x;
+      s.count++;
+    }
+
+    if( Valid(r, first) )
+    {
+      stats = s;
+      return true;
+    }
+  }
+}
+
+/// Recent member function to list chips.
+std::vector<std::string> Recent::GetKeys()
+{
+  std::lock_guard<std::mutex> guard( lock );
+  std::vector<std::string> keys;
+
+  for(auto & r : rings) keys.push_back( r.first );
+
+  return keys;
+}
+
+/// Recent member function to get memory used.
+size_t Recent::GetBytes()
+{
+  std::lock_guard<std::mutex> guard( lock );
+
+  return bytes;
+}
+
+/// Recent member function to get number of refused rings.
+uint64_t Recent::GetRefused()
+{
+  std::lock_guard<std::mutex> guard( lock );
+
+  return refused;
+}
@@ -0,0 +1,139 @@
+/**************************************************************************
+ *
+ * Recent class definitions and constructor.
+ *
+ * Copyright (C) 2026 Jaakko Koivuniemi.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************
+ *
+ * Sun Oct 18 01:10:36 CDT 2026
+ * Edit: Sun Oct 18 19:20:48 CDT 2026
+ *
+ * Jaakko Koivuniemi
+ **/
+
+
+#ifndef _RECENT_HPP
+#define _RECENT_HPP
+
+#include <systemd/sd-daemon.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <stdint.h>
+
+/// Count, minimum, maximum and sum of values in a time window.
+struct RecentStats
+{
+  uint64_t count = 0;            ///< number of values
+  double min = 0;                ///< minimum value
+  double max = 0;                ///< maximum value
+  double sum = 0;                ///< sum of values
+};
+
+/// Recent samples of all chips kept in memory.
+
+/// Each chip of each table, named _table.name_, has a ring of the last
+/// samples with timestamp and all values, integers stored as doubles.
+/// The ring capacity is rounded up to a power of two. Timestamps and each
+/// value column are in their own arrays, so a window of one column is read
+/// from consecutive memory. Samples are added by the reading tasks when
+/// they are queued for the database, so the newest values are available
+/// before commit.
+///
+/// Readers do not lock the ring. The writer marks the slot it overwrites
+/// before writing and publishes the sample after it, and a reader checks
+/// after copying that none of the samples it used was overwritten, and
+/// tries again if one was. The ring of each chip is registered once and
+/// the writer keeps it as a handle. Readers find rings from an index that
+/// is copied and replaced when a ring is registered, so neither samples
+/// nor queries take the lock of the ring map. New rings are not created
+/// when they would exceed the memory limit.
+class Recent
+{
+  public:
+    /// Ring of samples of one chip, used as handle by the writer.
+    struct Ring
+    {
+      int N;                       ///< values per sample
+      std::mutex write;            ///< serialize writers of ring
+      std::atomic<uint64_t> head;  ///< number of samples written
+      std::atomic<uint64_t> claim; ///< number of samples claimed by writer
+      std::atomic<int64_t> *ts;    ///< sample times [us]
+      std::atomic<double> *values; ///< values column after column
+    };
+
+  private:
+    typedef std::map<std::string, Ring *> Index; ///< rings by table.name
+
+    size_t capacity;               ///< samples per ring, power of two
+    size_t maxbytes;               ///< memory limit for rings
+    size_t bytes;                  ///< memory used by rings
+    uint64_t refused;              ///< rings not created because of memory limit
+    Index rings;                   ///< rings by table.name, guarded by lock
+    std::atomic<const Index *> index; ///< copy of rings for readers
+    std::vector<const Index *> retired; ///< replaced copies still used by readers
+    std::mutex lock;               ///< lock for ring map
+
+    /// Find ring of chip _key_ without lock, nullptr if none.
+    Ring *Find(const std::string & key);
+
+    /// Find window of samples from _t0_ to _t1_ [us] as sample numbers _first_ to before _last_.
+    void Window(Ring *r, uint64_t head, int64_t t0, int64_t t1, uint64_t & first, uint64_t & last);
+
+    /// Check that samples from _first_ were not overwritten while read.
+    bool Valid(Ring *r, uint64_t first);
+
+  public:
+    /// Construct Recent with _capacity_ samples for each chip and memory limit _maxbytes_.
+    Recent(size_t capacity, size_t maxbytes);
+
+    virtual ~Recent();
+
+    /// Find or create ring of chip _name_ in _table_ with N values per sample, nullptr over memory limit.
+    Ring *Register(const std::string & table, const std::string & name, int N);
+
+    /// Add sample to _ring_ with timestamp [us], Nd doubles and Ni integers, nullptr ring is ignored.
+    void Add(Ring *ring, int64_t ts, int Nd, const double *dbl_array, int Ni, const int *int_array);
+
+    /// Get newest sample time [us] and value _column_ of chip _key_, return false if none.
+    bool Latest(const std::string & key, int column, int64_t & ts, double & value);
+
+    /// Get oldest sample time [us] in ring of chip _key_, -1 if none.
+    int64_t GetOldest(const std::string & key);
+
+    /// Append samples from _t0_ to _t1_ [us] of value _column_ of chip _key_, return number of samples.
+    size_t Range(const std::string & key, int column, int64_t t0, int64_t t1, std::vector<int64_t> & ts, std::vector<double> & values);
+
+    /// Get statistics of value _column_ of chip _key_ from _t0_ to _t1_ [us], return false if chip unknown.
+    bool Stats(const std::string & key, int column, int64_t t0, int64_t t1, RecentStats & stats);
+
+    /// Get names table.name of registered chips.
+    std::vector<std::string> GetKeys();
+
+    /// Get samples per ring.
+    size_t GetCapacity() { return capacity; }
+
+    /// Get memory used by rings [bytes].
+    size_t GetBytes();
+
+    /// Get number of rings not created because of memory limit.
+    uint64_t GetRefused();
+};
+
+#endif
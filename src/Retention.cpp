@@ -0,0 +1,169 @@
+/**************************************************************************
+ *
+ * Retention class member functions for deleting old rows.
+ *
+ * Copyright (C) 2026 Jaakko Koivuniemi.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************
+ *
+ * Sat Oct 17 20:31:40 CDT 2026
+ * Edit: Sat Oct 17 21:14:26 CDT 2026
+ *
+ * Jaakko Koivuniemi
+ **/
+
+
+#include "Retention.hpp"
+#include <set>
+#include <dirent.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+
+using namespace std;
+
+/// Retention constructor.
+Retention::Retention(int batch, int pages)
+{
+  if( batch < 1 ) batch = 1;
+  if( pages < 1 ) pages = 1;
+
+  this->batch = batch;
+  this->pages = pages;
+  deleted = 0;
+}
+
+Retention::~Retention()
+{
+}
+
+/// Tables without age limit are not added.
+void Retention::Add(SQLite *db, double days)
+{
+  Policy policy;
+
+  if( days <= 0 ) return;
+
+  policy.db = db;
+  policy.age = (int64_t)( days * 86400e6 );
+  policies.push_back( policy );
+
+  fprintf(stderr, SD_DEBUG "%s rows kept %g days\n", db->GetTable().c_str(), days);
+}
+
+/// Tables sharing the same partition files need to be added only once.
+void Retention::AddPartitions(SQLite *db, double days)
+{
+  Policy policy;
+
+  if( days <= 0 ) return;
+
+  policy.db = db;
+  policy.age = (int64_t)( days * 86400e6 );
+  partitions.push_back( policy );
+
+  fprintf(stderr, SD_DEBUG "%s partitions kept %g days\n", db->GetFile().c_str(), days);
+}
+
+/// Retention member function to remove old partition files.
+
+/// Partition files have the same name as the partition of the cut-off
+/// time except for the date, so older files sort before it. Files still
+/// open by a table not written since are left for a later step. The WAL
+/// and shared memory files are removed with them if they were left behind.
+bool Retention::Unlink(SQLite *db, int64_t before, int & error)
+{
+  std::string cutoff = db->GetFileAt( before );
+  std::string dir = ".", last = cutoff;
+  std::vector<std::string> old;
+
+  size_t slash = cutoff.rfind( '/' );
+  if( slash != std::string::npos )
+  {
+    dir = cutoff.substr(0, slash);
+    last = cutoff.substr(slash + 1);
+  }
+
+  // date and .db suffix after prefix
+  if( last.length() < 13 ) return true;
+  std::string prefix = last.substr(0, last.length() - 13);
+
+  DIR *d = opendir( dir.c_str() );
+  if( !d )
+  {
+    fprintf(stderr, SD_ERR "can not read directory %s: %s\n", dir.c_str(), strerror( errno ));
+    error = errno;
+    return false;
+  }
+
+  struct dirent *entry;
+  while( ( entry = readdir( d ) ) != nullptr )
+  {
+    std::string name = entry->d_name;
+
+    if( name.length() != last.length() || name.compare(0, prefix.length(), prefix) != 0 ) continue;
+    if( name.compare(name.length() - 3, 3, ".db") != 0 || name[ prefix.length() + 4 ] != '-' || name[ prefix.length() + 7 ] != '-' ) continue;
+    if( name < last && !SQLite::IsOpen( dir + "/" + name ) ) old.push_back( dir + "/" + name );
+  }
+
+  closedir( d );
+
+  for(auto & f : old)
+  {
+    fprintf(stderr, SD_INFO "remove old partition %s\n", f.c_str());
+
+    if( unlink( f.c_str() ) < 0 )
+    {
+      fprintf(stderr, SD_ERR "can not remove %s: %s\n", f.c_str(), strerror( errno ));
+      error = errno;
+      return false;
+    }
+    unlink( ( f + "-wal" ).c_str() );
+    unlink( ( f + "-shm" ).c_str() );
+  }
+
+  return true;
+}
+
+/// Retention member function to delete one batch of old rows from each table.
+
+/// The free pages are vacuumed once per database file after the deletes.
+bool Retention::Step(int & error)
+{
+  std::set<std::string> files;
+  int64_t now = SQLite::TimeStamp();
+  bool ok = true;
+
+  for(auto & p : policies)
+  {
+    int n = p.db->Prune(now - p.age, batch, error);
+
+    if( n < 0 ) ok = false;
+    else deleted += n;
+  }
+
+  for(auto & p : partitions)
+  {
+    if( !Unlink(p.db, now - p.age, error) ) ok = false;
+  }
+
+  for(auto & p : policies)
+  {
+    if( files.insert( p.db->GetFile() ).second && !p.db->IncrementalVacuum( pages, error ) ) ok = false;
+  }
+
+  return ok;
+}
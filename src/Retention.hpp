@@ -0,0 +1,89 @@
+/**************************************************************************
+ *
+ * Retention class definitions and constructor.
+ *
+ * Copyright (C) 2026 Jaakko Koivuniemi.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************
+ *
+ * Sat Oct 17 20:31:40 CDT 2026
+ * Edit: Sat Oct 17 21:14:26 CDT 2026
+ *
+ * Jaakko Koivuniemi
+ **/
+
+
+#ifndef _RETENTION_HPP
+#define _RETENTION_HPP
+
+#include <systemd/sd-daemon.h>
+#include "SQLite.hpp"
+#include <string>
+#include <vector>
+#include <atomic>
+#include <stdint.h>
+
+/// Retention policy for database tables.
+
+/// Each table has its own age after which rows are deleted, for example
+/// raw rows after 30 days and hourly aggregates after ten years. Step()
+/// deletes at most _batch_ old rows from each table, each batch in its own
+/// short transaction, and then returns at most _pages_ free pages of each
+/// database file to the file system with incremental vacuum. Calling it
+/// periodically removes a large backlog of old rows gradually without
+/// blocking the inserts. With day partitions whole files older than
+/// their age limit are removed instead.
+class Retention
+{
+    /// Age limit of one table.
+    struct Policy
+    {
+      SQLite *db;                  ///< table to prune
+      int64_t age;                 ///< maximum age of rows [us]
+    };
+
+    std::vector<Policy> policies;  ///< tables with age limit
+    std::vector<Policy> partitions; ///< partitioned tables with age limit
+    int batch;                     ///< maximum rows deleted per table and step
+    int pages;                     ///< maximum pages vacuumed per file and step
+    std::atomic<uint64_t> deleted; ///< total number of deleted rows
+
+    /// Remove partition files of table with date before _before_ [us], return true in success.
+    bool Unlink(SQLite *db, int64_t before, int & error);
+
+  public:
+    /// Construct Retention with rows per delete batch and pages per vacuum.
+    Retention(int batch, int pages);
+
+    virtual ~Retention();
+
+    /// Delete rows older than _days_ from table, zero or negative keeps all rows.
+    void Add(SQLite *db, double days);
+
+    /// Remove partition files older than _days_ of partitioned table, zero or negative keeps all files.
+    void AddPartitions(SQLite *db, double days);
+
+    /// Get number of tables and partitioned tables with age limit.
+    int GetPolicies() { return policies.size() + partitions.size(); }
+
+    /// Get total number of deleted rows.
+    uint64_t GetDeleted() { return deleted; }
+
+    /// Delete one batch of old rows from each table and vacuum, return false if any step failed.
+    bool Step(int & error);
+};
+
+#endif
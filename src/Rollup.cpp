@@ -0,0 +1,174 @@
+/**************************************************************************
+ *
+ * Rollup class member functions for aggregate tables.
+ *
+ * Copyright (C) 2026 Jaakko Koivuniemi.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************
+ *
+ * Sat Oct 17 19:48:02 CDT 2026
+ * Edit: Sat Oct 17 22:05:18 CDT 2026
+ *
+ * Jaakko Koivuniemi
+ **/
+
+
+#include "Rollup.hpp"
+
+using namespace std;
+
+/// Rollup constructor reads column names from insert statement of raw table.
+Rollup::Rollup(SQLite *source, int Nd)
+{
+  std::string table = source->GetTable();
+  std::vector<std::string> all = source->GetColumns();
+
+  this->source = source;
+
+  for(int i = 0; i < Nd && i < (int)all.size(); i++) columns.push_back( all[ i ] );
+
+  const std::string suffix[ 3 ] = {"_1m", "_1h", "_1d"};
+  const int64_t width[ 3 ] = {60000000LL, 3600000000LL, 86400000000LL};
+
+  for(int l = 0; l < 3; l++)
+  {
+    std::string insert = "insert into " + table + suffix[ l ] + " (name";
+    std::string values = "(?";
+    std::string update = "";
+
+    for(auto & c : columns)
+    {
+      insert += "," + c + "_min," + c + "_max," + c + "_mean";
+      values += ",?,?,?";
+      update += c + "_min=min(" + c + "_min,excluded." + c + "_min),";
+      update += c + "_max=max(" + c + "_max,excluded." + c + "_max),";
+      update += c + "_mean=(" + c + "_mean*count+excluded." + c + "_mean*excluded.count)/(count+excluded.count),";
+    }
+    insert += ",count,ts) values " + values + ",?,:ts) on conflict(name,ts) do update set " + update + "count=count+excluded.count";
+
+    Level level;
+    level.suffix = suffix[ l ];
+    level.width = width[ l ];
+    level.db = new SQLite(source->GetFile(), table + suffix[ l ], insert);
+    levels.push_back( level );
+  }
+}
+
+Rollup::~Rollup()
+{
+  for(auto & l : levels) delete l.db;
+}
+
+/// Aggregate tables use (name, ts) as primary key so that a bucket has one row.
+bool Rollup::Create(int & error)
+{
+  bool ok = true;
+
+  for(auto & l : levels)
+  {
+    std::string sql = "create table if not exists " + l.db->GetTable() + "(name varchar(20), ts integer, count integer";
+
+    for(auto & c : columns) sql += ", " + c + "_min real, " + c + "_max real, " + c + "_mean real";
+    sql += ", primary key(name, ts))";
+
+    if( !l.db->Exec(sql, error) ) ok = false;
+  }
+
+  return ok;
+}
+
+/// Rollup member function to write bucket as one row of aggregate table.
+bool Rollup::Write(const std::string & name, Level & level, Bucket & bucket, int & error)
+{
+  std::vector<double> values;
+  int count = bucket.count;
+
+  for(size_t i = 0; i < columns.size(); i++)
+  {
+    values.push_back( bucket.min[ i ] );
+    values.push_back( bucket.max[ i ] );
+    values.push_back( bucket.sum[ i ] / bucket.count );
+  }
+
+  bool ok = level.db->InsertAt(name, bucket.start, values.size(), values.data(), 1, &count, error);
+
+  bucket.start = -1;
+  bucket.count = 0;
+
+  return ok;
+}
+
+/// Rollup member function to update open buckets of all levels with one sample.
+
+/// A sample with timestamp before the open bucket, for example after a clock
+/// step, is added to the open bucket.
+bool Rollup::Add(const std::string & name, int64_t ts, int Nd, const double *dbl_array, int & error)
+{
+  bool ok = true;
+  size_t N = columns.size();
+
+  if( Nd < (int)N ) N = Nd;
+
+  std::vector<Bucket> & open = buckets[ name ];
+  if( open.empty() ) open.resize( levels.size() );
+
+  for(size_t l = 0; l < levels.size(); l++)
+  {
+    Bucket & b = open[ l ];
+    int64_t start = ts - ts % levels[ l ].width;
+
+    if( b.start >= 0 && start > b.start )
+    {
+      if( !Write(name, levels[ l ], b, error) ) ok = false;
+    }
+
+    if( b.start < 0 )
+    {
+      b.start = start;
+      b.count = 0;
+      b.min.assign( columns.size(), 0 );
+      b.max.assign( columns.size(), 0 );
+      b.sum.assign( columns.size(), 0 );
+    }
+
+    for(size_t i = 0; i < N; i++)
+    {
+      if( b.count == 0 || dbl_array[ i ] < b.min[ i ] ) b.min[ i ] = dbl_array[ i ];
+      if( b.count == 0 || dbl_array[ i ] > b.max[ i ] ) b.max[ i ] = dbl_array[ i ];
+      b.sum[ i ] += dbl_array[ i ];
+    }
+    b.count++;
+  }
+
+  return ok;
+}
+
+/// Open buckets are written partially filled, later samples of the same
+/// bucket are merged into the row.
+bool Rollup::Flush(int & error)
+{
+  bool ok = true;
+
+  for(auto & n : buckets)
+  {
+    for(size_t l = 0; l < n.second.size(); l++)
+    {
+      if( n.second[ l ].start >= 0 && !Write(n.first, levels[ l ], n.second[ l ], error) ) ok = false;
+    }
+  }
+
+  return ok;
+}
@@ -0,0 +1,107 @@
+/**************************************************************************
+ *
+ * Rollup class definitions and constructor.
+ *
+ * Copyright (C) 2026 Jaakko Koivuniemi.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************
+ *
+ * Sat Oct 17 19:48:02 CDT 2026
+ * Edit: Sun Oct 18 01:58:40 CDT 2026
+ *
+ * Jaakko Koivuniemi
+ **/
+
+
+#ifndef _ROLLUP_HPP
+#define _ROLLUP_HPP
+
+#include <systemd/sd-daemon.h>
+#include "SQLite.hpp"
+#include <string>
+#include <vector>
+#include <map>
+#include <stdint.h>
+
+/// Aggregate tables with minimum, maximum and mean of raw table values.
+
+/// For a raw table such as _tmp102_ the tables _tmp102_1m_, _tmp102_1h_
+/// and _tmp102_1d_ hold one row per chip name and minute, hour or day
+/// with columns _count_ and _min_, _max_ and _mean_ for each double value.
+/// Each sample updates open buckets kept in memory, so the cost per sample
+/// does not depend on table size. A bucket is written when a sample from
+/// a later bucket arrives or at Flush(). Rows for an existing bucket, for
+/// example after restart, are merged into it.
+class Rollup
+{
+    /// Aggregate level with its bucket width and table.
+    struct Level
+    {
+      std::string suffix;          ///< table name suffix
+      int64_t width;               ///< bucket width [us]
+      SQLite *db;                  ///< insert into aggregate table
+    };
+
+    /// Open bucket of one chip name on one level.
+    struct Bucket
+    {
+      int64_t start = -1;          ///< bucket start time [us], -1 if empty
+      int count = 0;               ///< number of samples
+      std::vector<double> min;     ///< minimum of each value
+      std::vector<double> max;     ///< maximum of each value
+      std::vector<double> sum;     ///< sum of each value
+    };
+
+    SQLite *source;                ///< raw table
+    std::vector<std::string> columns; ///< names of double columns
+    std::vector<Level> levels;     ///< aggregate levels
+    std::map<std::string, std::vector<Bucket> > buckets; ///< open buckets by name and level
+
+    /// Write bucket to aggregate table and empty it.
+    bool Write(const std::string & name, Level & level, Bucket & bucket, int & error);
+
+  public:
+    /// Construct Rollup for raw table with _Nd_ double columns after name in insert statement.
+    Rollup(SQLite *source, int Nd);
+
+    virtual ~Rollup();
+
+    /// Get raw table.
+    SQLite *GetSource() { return source; }
+
+    /// Get number of aggregate levels.
+    int GetLevels() { return levels.size(); }
+
+    /// Get aggregate table of level _l_.
+    SQLite *GetLevel(int l) { return levels[ l ].db; }
+
+    /// Get bucket width of level _l_ [us].
+    int64_t GetWidth(int l) { return levels[ l ].width; }
+
+    /// Get number of double columns with aggregates.
+    int GetColumns() { return columns.size(); }
+
+    /// Create aggregate tables if they do not exist, return true in success.
+    bool Create(int & error);
+
+    /// Add sample with timestamp [us] and Nd doubles, return false if writing bucket failed.
+    bool Add(const std::string & name, int64_t ts, int Nd, const double *dbl_array, int & error);
+
+    /// Write all open buckets, return false if any write failed.
+    bool Flush(int & error);
+};
+
+#endif
@@ -2,7 +2,7 @@
  * 
  * SQLite class member functions. 
  *       
- * Copyright (C) 2020 - 2022 Jaakko Koivuniemi.
+ * Copyright (C) 2020 - 2026 Jaakko Koivuniemi.
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -20,36 +20,58 @@
  ****************************************************************************
  *
  * Tue Jul 14 13:30:25 CDT 2020
- * Edit: Sun Apr 24 15:14:57 CDT 2022
+ * Edit: Sun Oct 18 20:06:29 CDT 2026
  *
  * Jaakko Koivuniemi
  **/
 
+
 #include "SQLite.hpp"
+#include <time.h>
 
 using namespace std;
 
+std::map<std::string, SQLiteConnection *> SQLite::connections;
+std::mutex SQLite::connections_lock;
+int SQLite::durability = SQLITE_DURABILITY_NORMAL;
+int SQLite::autocheckpoint = 1000;
+long long SQLite::mmapsize = 0;
+
 /// SQLite constructor to initialize all parameters.
 SQLite::SQLite(std::string file, std::string table, std::string insert_stmt)
 {
   this->file = file;
   this->table = table;
   this->insert_stmt = insert_stmt;
+  this->textts = false;
+  this->partition = false;
+  this->conn = nullptr;
+  this->stmt = nullptr;
 }
 
-SQLite::~SQLite() { };
+SQLite::~SQLite() { Close(); };
 
-/// SQLite member function to open database connection and execute _select datetime()_.
-std::string SQLite::GetDateTime(int & error)
+/// SQLite member function to open database file or share already open connection.
+
+/// A missing file is created only if _create_ is true.
+SQLiteConnection *SQLite::Connect(std::string file, bool create, int & error)
 {
-  sqlite3 *db;
-  sqlite3_stmt *stmt;
-  const char query[ 200 ] = "select datetime()";
+  std::lock_guard<std::mutex> guard( connections_lock );
+
+  auto it = connections.find( file );
+  if( it != connections.end() )
+  {
+    it->second->users++;
+    return it->second;
+  }
 
   char message[ 500 ] = "";
-  char dtime[ 500 ] = "";
 
-  int rc = sqlite3_open_v2(file.c_str(), &db, SQLITE_OPEN_READONLY, NULL);
+  sprintf(message, "Open database: %s\n", file.c_str() );
+  fprintf(stderr, SD_DEBUG "%s", message);
+
+  sqlite3 *db = nullptr;
+  int rc = sqlite3_open_v2(file.c_str(), &db, SQLITE_OPEN_READWRITE | ( create ? SQLITE_OPEN_CREATE : 0 ) | SQLITE_OPEN_FULLMUTEX, NULL);
 
   if( rc != SQLITE_OK )
   {
@@ -58,399 +80,809 @@ std::string SQLite::GetDateTime(int & error)
     error = rc;
     sqlite3_close( db );
 
-    return "";
+    return nullptr;
   }
 
-  rc = sqlite3_prepare_v2(db, query, 200, &stmt, 0);
+  Configure( db, file );
 
-  if( rc != SQLITE_OK )
+  SQLiteConnection *conn = new SQLiteConnection();
+  conn->db = db;
+  conn->users = 1;
+  connections[ file ] = conn;
+
+  return conn;
+}
+
+/// SQLite member function to set pragmas on new connection.
+
+/// Write-ahead logging lets readers such as plotting scripts work while
+/// rows are written. The durability level selects how often the database
+/// is synced to flash storage. The auto_vacuum mode takes effect only on
+/// a new database file before its first table. Failures are logged but the
+/// connection is still used with SQLite defaults.
+void SQLite::Configure(sqlite3 *db, std::string file)
+{
+  const char *sync = "normal";
+  char *errmsg = nullptr;
+
+  if( durability == SQLITE_DURABILITY_FAST ) sync = "off";
+  else if( durability == SQLITE_DURABILITY_FULL ) sync = "full";
+
+  sqlite3_busy_timeout( db, 1000 );
+
+  const std::string pragmas[ 5 ] = {
+    "pragma auto_vacuum=incremental",
+    "pragma journal_mode=wal",
+    std::string("pragma synchronous=") + sync,
+    "pragma wal_autocheckpoint=" + std::to_string( autocheckpoint ),
+    "pragma mmap_size=" + std::to_string( mmapsize ) };
+
+  for(auto & p : pragmas)
   {
-    sprintf(message, "Statement prepare failed: %s\n", sqlite3_errmsg( db ) );
-    fprintf(stderr, SD_ERR "%s", message);
-    error = rc;
-    sqlite3_close( db );
+    fprintf(stderr, SD_DEBUG "%s: %s\n", file.c_str(), p.c_str());
 
-    return "";
+    if( sqlite3_exec(db, p.c_str(), NULL, NULL, &errmsg) != SQLITE_OK )
+    {
+      fprintf(stderr, SD_ERR "%s: %s failed: %s\n", file.c_str(), p.c_str(), errmsg ? errmsg : sqlite3_errmsg( db ));
+      sqlite3_free( errmsg );
+      errmsg = nullptr;
+    }
   }
-  else
+}
+
+/// SQLite member function to close database file when last user releases connection.
+void SQLite::Disconnect(std::string file, SQLiteConnection *conn)
+{
+  std::lock_guard<std::mutex> guard( connections_lock );
+
+  conn->users--;
+  if( conn->users > 0 ) return;
+
+  fprintf(stderr, SD_DEBUG "Close database: %s\n", file.c_str() );
+
+  sqlite3_close( conn->db );
+  connections.erase( file );
+  delete conn;
+}
+
+/// SQLite member function to finalize statement and release connection.
+void SQLite::Close()
+{
+  if( conn )
   {
-    if( stmt != NULL )
     {
-      rc = sqlite3_step( stmt );
-      if( rc != SQLITE_ROW )
-      {
-        sprintf(message, "Statement failed: %s\n", sqlite3_errmsg( db ) );
-        fprintf(stderr, SD_ERR "%s", message);
-        error = rc;
+      std::lock_guard<std::mutex> guard( conn->lock );
+      if( stmt ) sqlite3_finalize( stmt );
+      for(auto & b : bulk) if( b ) sqlite3_finalize( b );
+    }
+    Disconnect( connfile, conn );
+  }
 
-        rc = sqlite3_finalize( stmt );
-        sqlite3_close( db );
+  stmt = nullptr;
+  bulk.clear();
+  conn = nullptr;
+  connfile = "";
+}
 
-	return "";
-      }
-      else
-      {
-        sprintf(dtime, "%s\n", sqlite3_column_text(stmt, 0) );
-        fprintf(stderr, SD_DEBUG "SQLite: %s", dtime);
-        error = SQLITE_OK;
-      }
-    }
+/// SQLite member function to list value columns of insert statement.
+
+/// The columns are read between the first parentheses of the statement,
+/// the first one is _name_ and the last one _ts_ if the statement has it.
+std::vector<std::string> SQLite::GetColumns()
+{
+  std::vector<std::string> columns;
+  size_t begin = insert_stmt.find( '(' );
+  size_t end = insert_stmt.find( ')', begin );
+
+  if( begin == std::string::npos || end == std::string::npos ) return columns;
+
+  std::string list = insert_stmt.substr(begin + 1, end - begin - 1);
+  size_t pos = 0, next = 0;
+
+  while( next != std::string::npos )
+  {
+    next = list.find( ',', pos );
+    columns.push_back( list.substr(pos, next == std::string::npos ? std::string::npos : next - pos) );
+    pos = next + 1;
   }
 
-  rc = sqlite3_finalize( stmt );
-  sqlite3_close( db );
+  if( !columns.empty() && columns.back() == "ts" ) columns.pop_back();
+  if( !columns.empty() ) columns.erase( columns.begin() );
 
-  return dtime;
+  return columns;
 }
 
-/// SQLite member function to open connection and execute insert statement on database table.
-bool SQLite::Insert(std::string name, int N, int *data, int & error)
+/// SQLite member function to find database file for sample time.
+
+/// With day partitions the file name gets the UTC date of the sample, for
+/// example i2chipd.db becomes i2chipd-2026-10-17.db.
+std::string SQLite::GetFileAt(int64_t ts)
 {
-  sqlite3 *db;
-  sqlite3_stmt *stmt;
+  if( !partition ) return file;
 
-  char message[ 500 ] = "";
+  char date[ 16 ] = "";
+  struct tm utc;
+  time_t sec = ts / 1000000;
+  std::string stem = file;
 
-  sprintf(message, "Open database: %s\n", file.c_str() );
-  fprintf(stderr, SD_DEBUG "%s", message);
+  gmtime_r(&sec, &utc);
+  strftime(date, sizeof( date ), "%Y-%m-%d", &utc);
 
-  int rc = sqlite3_open_v2(file.c_str(), &db, SQLITE_OPEN_READWRITE, NULL);
+  if( stem.length() > 3 && stem.compare(stem.length() - 3, 3, ".db") == 0 ) stem.erase( stem.length() - 3 );
 
-  if( rc != SQLITE_OK )
-  {
-    sprintf(message, "Can not open database: %s\n", sqlite3_errmsg( db ) );
-    fprintf(stderr, SD_ERR "%s", message);
-    error = rc;
-    sqlite3_close( db );
+  return stem + "-" + date + ".db";
+}
 
-    return false;
-  }
+/// Connections are looked up under the lock of connections map.
+bool SQLite::IsOpen(std::string file)
+{
+  std::lock_guard<std::mutex> guard( connections_lock );
 
-  int i, j;
+  return connections.find( file ) != connections.end();
+}
 
-  sprintf(message, "Prepare statement: %s\n", insert_stmt.c_str() );
-  fprintf(stderr, SD_DEBUG "%s", message);
+/// SQLite member function to connect to given database file.
 
-  rc = sqlite3_prepare_v2(db, insert_stmt.c_str(), 200, &stmt, 0);
+/// The connection is kept if it is already to the same file, otherwise
+/// the old connection is released and the insert statement prepared again
+/// on next insert. A new partition file is created with the table and
+/// index definitions of the same table in the main file.
+bool SQLite::Open(std::string name, int & error)
+{
+  if( conn && connfile == name ) return true;
 
-  if( rc != SQLITE_OK )
+  Close();
+
+  conn = Connect( name, partition, error );
+  if( !conn ) return false;
+  connfile = name;
+
+  if( partition && !CopySchema( error ) )
   {
-    sprintf(message, "Statement prepare failed: %s\n", sqlite3_errmsg( db ) );
-    fprintf(stderr, SD_ERR "%s", message);
-    error = rc;
-    sqlite3_close( db );
-  
+    Close();
     return false;
   }
-  else
-  {
-    sprintf(message, "Bind text: %s\n", name.c_str() );
-    fprintf(stderr, SD_DEBUG "%s", message);
 
-    rc = sqlite3_bind_text(stmt, 1, name.c_str(), name.length(), SQLITE_STATIC);
+  return true;
+}
+
+/// SQLite member function to create table in partition file.
+
+/// The definitions are read from the main file, which is created with
+/// table/sqlite-init as without partitions.
+bool SQLite::CopySchema(int & error)
+{
+  sqlite3_stmt *schema;
+  std::vector<std::string> sql;
+  bool found = false;
+
+  {
+    std::lock_guard<std::mutex> guard( conn->lock );
 
+    int rc = sqlite3_prepare_v2(conn->db, "select 1 from sqlite_master where type='table' and name=?", -1, &schema, 0);
     if( rc != SQLITE_OK )
     {
-      sprintf(message, "Binding failed: %s\n", sqlite3_errmsg( db ) );
-      fprintf(stderr, SD_ERR "%s", message);
+      fprintf(stderr, SD_ERR "Statement prepare failed: %s\n", sqlite3_errmsg( conn->db ) );
       error = rc;
-
-      rc = sqlite3_finalize( stmt );
-      sqlite3_close( db );
-      
       return false;
     }
-    else
-    {
-      for( i = 1; i <= N; i++)
-      {
-        sprintf(message, "Bind integer %d to position %d\n", data[ i - 1], i+1 );
-        fprintf(stderr, SD_DEBUG "%s", message);
 
-      	rc = sqlite3_bind_int(stmt, i + 1, data[ i - 1 ]);
-	
-    	if( rc != SQLITE_OK )
-        {
-          sprintf(message, "Binding failed: %s\n", sqlite3_errmsg( db ) );
-          fprintf(stderr, SD_ERR "%s", message);
-          error = rc;
-	
-          rc = sqlite3_finalize( stmt );
-          sqlite3_close( db );
-        } 
-      }
-    }
-  }     
+    sqlite3_bind_text(schema, 1, table.c_str(), -1, SQLITE_TRANSIENT);
+    found = ( sqlite3_step( schema ) == SQLITE_ROW );
+    sqlite3_finalize( schema );
+  }
+
+  if( found ) return true;
 
-  rc = sqlite3_step( stmt );
+  SQLiteConnection *mainconn = Connect( file, false, error );
+  if( !mainconn ) return false;
 
-  if( rc == SQLITE_BUSY )
   {
-    j = 0;
-    while( rc == SQLITE_BUSY && j < 10 )
+    std::lock_guard<std::mutex> guard( mainconn->lock );
+
+    int rc = sqlite3_prepare_v2(mainconn->db, "select sql from sqlite_master where tbl_name=? and sql not null order by type desc", -1, &schema, 0);
+    if( rc != SQLITE_OK )
+    {
+      fprintf(stderr, SD_ERR "Statement prepare failed: %s\n", sqlite3_errmsg( mainconn->db ) );
+      error = rc;
+    }
+    else
     {
-      fprintf(stderr, SD_WARNING "SQLite database busy, wait 1 s.\n");
-      sleep( 1 ); // sleep 1 s
-      rc = sqlite3_step( stmt );
+      sqlite3_bind_text(schema, 1, table.c_str(), -1, SQLITE_TRANSIENT);
+      while( sqlite3_step( schema ) == SQLITE_ROW ) sql.push_back( (const char *)sqlite3_column_text(schema, 0) );
+      sqlite3_finalize( schema );
     }
   }
 
-  if( rc != SQLITE_DONE )
-  {
-    sprintf(message, "Statement failed: %s\n", sqlite3_errmsg( db ) );
-    fprintf(stderr, SD_ERR "%s", message);
-    error = rc;
-  
-    rc = sqlite3_finalize( stmt );
-    sqlite3_close( db );
+  Disconnect( file, mainconn );
 
+  if( sql.empty() )
+  {
+    fprintf(stderr, SD_ERR "%s has no table %s to copy to %s\n", file.c_str(), table.c_str(), connfile.c_str());
+    error = SQLITE_ERROR;
     return false;
-  } 
-    
-  rc = sqlite3_finalize( stmt );
-  sqlite3_close( db );
+  }
+
+  fprintf(stderr, SD_INFO "create %s in %s\n", table.c_str(), connfile.c_str());
+
+  for(auto & s : sql)
+  {
+    if( !Exec( s, error ) ) return false;
+  }
 
   return true;
 }
-    
-/// SQLite member function to open connection and execute insert statement on database table.
-bool SQLite::Insert(std::string name, int N, double *data, int & error)
-{
-  sqlite3 *db;
-  sqlite3_stmt *stmt;
 
+/// SQLite member function to prepare insert statement once for the shared connection.
+
+/// Called with connection locked. A failed open or prepare is tried again on
+/// next insert.
+bool SQLite::Prepare(int & error)
+{
   char message[ 500 ] = "";
 
-  sprintf(message, "Open database: %s\n", file.c_str() );
+  if( stmt ) return true;
+
+  snprintf(message, sizeof( message ), "Prepare statement: %s\n", insert_stmt.c_str() );
   fprintf(stderr, SD_DEBUG "%s", message);
 
-  int rc = sqlite3_open_v2(file.c_str(), &db, SQLITE_OPEN_READWRITE, NULL);
+  int rc = sqlite3_prepare_v2(conn->db, insert_stmt.c_str(), -1, &stmt, 0);
 
   if( rc != SQLITE_OK )
   {
-    sprintf(message, "Can not open database: %s\n", sqlite3_errmsg( db ) );
+    sprintf(message, "Statement prepare failed: %s\n", sqlite3_errmsg( conn->db ) );
     fprintf(stderr, SD_ERR "%s", message);
     error = rc;
-    sqlite3_close( db );
+    stmt = nullptr;
 
     return false;
   }
 
-  int i, j;
+  return true;
+}
 
-  sprintf(message, "Prepare statement: %s\n", insert_stmt.c_str() );
-  fprintf(stderr, SD_DEBUG "%s", message);
+/// SQLite member function to prepare multi-row insert statement.
+
+/// Called with connection locked. The statement repeats the parameters of
+/// one row after _values_ of the insert statement for each row, with the
+/// timestamp as last parameter of the row. Statements are kept for reuse.
+sqlite3_stmt *SQLite::PrepareRows(int rows, int columns, int & error)
+{
+  if( (int)bulk.size() <= rows ) bulk.resize( rows + 1, nullptr );
+  if( bulk[ rows ] ) return bulk[ rows ];
+
+  std::string row = "(?";
+  for(int i = 0; i <= columns; i++) row += ",?";
+  row += ")";
+
+  std::string sql = insert_stmt.substr(0, insert_stmt.find( " values" )) + " values " + row;
+  for(int r = 1; r < rows; r++) sql += "," + row;
+
+  fprintf(stderr, SD_DEBUG "Prepare statement for %d rows of %s\n", rows, table.c_str());
+
+  int rc = sqlite3_prepare_v2(conn->db, sql.c_str(), -1, &bulk[ rows ], 0);
+
+  if( rc != SQLITE_OK )
+  {
+    fprintf(stderr, SD_ERR "Statement prepare failed: %s\n", sqlite3_errmsg( conn->db ) );
+    error = rc;
+    bulk[ rows ] = nullptr;
+  }
+
+  return bulk[ rows ];
+}
+
+/// SQLite member function to bind sample time.
+int SQLite::BindTimeStamp(sqlite3_stmt *s, int pos, int64_t ts)
+{
+  if( textts )
+  {
+    char tstext[ 32 ] = "";
+    struct tm utc;
+    time_t sec = ts / 1000000;
+
+    gmtime_r(&sec, &utc);
+    strftime(tstext, sizeof( tstext ), "%Y-%m-%d %H:%M:%S", &utc);
+
+    return sqlite3_bind_text(s, pos, tstext, -1, SQLITE_TRANSIENT);
+  }
+
+  return sqlite3_bind_int64(s, pos, ts);
+}
 
-  rc = sqlite3_prepare_v2(db, insert_stmt.c_str(), 200, &stmt, 0);
+/// SQLite member function to execute bound insert statement.
+
+/// Called with connection locked. The statement is reset and its bindings
+/// cleared so that it is ready for next insert. A busy database is waited
+/// only for the busy timeout of the connection, SQLITE_BUSY is then
+/// returned in _error_ so that the caller can retry later without holding
+/// the connection.
+bool SQLite::Step(sqlite3_stmt *s, int & error)
+{
+  char message[ 500 ] = "";
+
+  int rc = sqlite3_step( s );
+
+  if( rc != SQLITE_DONE )
+  {
+    sprintf(message, "Statement failed: %s\n", sqlite3_errmsg( conn->db ) );
+    fprintf(stderr, SD_ERR "%s", message);
+    error = rc;
+  }
+
+  sqlite3_reset( s );
+  sqlite3_clear_bindings( s );
+
+  return ( rc == SQLITE_DONE );
+}
+
+/// SQLite member function to execute _select datetime()_ on shared connection.
+std::string SQLite::GetDateTime(int & error)
+{
+  sqlite3_stmt *dstmt;
+  const char query[ 200 ] = "select datetime()";
+
+  char message[ 500 ] = "";
+  char dtime[ 500 ] = "";
+
+  if( !conn && !Open( GetFileAt( TimeStamp() ), error ) ) return "";
+
+  std::lock_guard<std::mutex> guard( conn->lock );
+
+  int rc = sqlite3_prepare_v2(conn->db, query, -1, &dstmt, 0);
 
   if( rc != SQLITE_OK )
   {
-    sprintf(message, "Statement prepare failed: %s\n", sqlite3_errmsg( db ) );
+    sprintf(message, "Statement prepare failed: %s\n", sqlite3_errmsg( conn->db ) );
     fprintf(stderr, SD_ERR "%s", message);
     error = rc;
-    sqlite3_close( db );
 
-    return false;
+    return "";
   }
-  else
+
+  rc = sqlite3_step( dstmt );
+  if( rc != SQLITE_ROW )
   {
-    sprintf(message, "Bind text: %s\n", name.c_str() );
-    fprintf(stderr, SD_DEBUG "%s", message);
+    sprintf(message, "Statement failed: %s\n", sqlite3_errmsg( conn->db ) );
+    fprintf(stderr, SD_ERR "%s", message);
+    error = rc;
+
+    sqlite3_finalize( dstmt );
+
+    return "";
+  }
+
+  sprintf(dtime, "%s\n", sqlite3_column_text(dstmt, 0) );
+  fprintf(stderr, SD_DEBUG "SQLite: %s", dtime);
+  error = SQLITE_OK;
+
+  sqlite3_finalize( dstmt );
 
-    rc = sqlite3_bind_text(stmt, 1, name.c_str(), name.length(), SQLITE_STATIC);
+  return dtime;
+}
+
+/// SQLite member function to check for index used by time range queries.
+
+/// Queries select one chip with _name_ and a time range with _ts_, so an
+/// index starting with columns (name, ts) is needed to avoid scanning the
+/// whole table. A missing index is created, which can take long on a large
+/// table.
+bool SQLite::CheckIndex(int & error)
+{
+  sqlite3_stmt *list, *info;
+  std::string sql;
+  bool found = false;
+  int rc;
+
+  if( !conn && !Open( GetFileAt( TimeStamp() ), error ) ) return false;
 
+  {
+    std::lock_guard<std::mutex> guard( conn->lock );
+
+    sql = "pragma index_list(" + table + ")";
+    rc = sqlite3_prepare_v2(conn->db, sql.c_str(), -1, &list, 0);
     if( rc != SQLITE_OK )
     {
-      sprintf(message, "Binding failed: %s\n", sqlite3_errmsg( db ) );
-      fprintf(stderr, SD_ERR "%s", message);
+      fprintf(stderr, SD_ERR "Statement prepare failed: %s\n", sqlite3_errmsg( conn->db ) );
       error = rc;
-
-      rc = sqlite3_finalize( stmt );
-      sqlite3_close( db );
-      
       return false;
     }
-    else
-    {
-      for( i = 1; i <= N; i++)
-      {
-        sprintf(message, "Bind double %f to position %d\n", data[ i - 1], i+1 );
-        fprintf(stderr, SD_DEBUG "%s", message);
 
-      	rc = sqlite3_bind_double(stmt, i + 1, data[ i - 1 ]);
+    while( !found && sqlite3_step( list ) == SQLITE_ROW )
+    {
+      std::string index = (const char *)sqlite3_column_text(list, 1);
+      std::string columns = "";
 
-    	if( rc != SQLITE_OK )
+      sql = "pragma index_info(" + index + ")";
+      if( sqlite3_prepare_v2(conn->db, sql.c_str(), -1, &info, 0) == SQLITE_OK )
+      {
+        while( sqlite3_step( info ) == SQLITE_ROW )
         {
-          sprintf(message, "Binding failed: %s\n", sqlite3_errmsg( db ) );
-          fprintf(stderr, SD_ERR "%s", message);
-          error = rc;
+          if( sqlite3_column_text(info, 2) ) columns += std::string( (const char *)sqlite3_column_text(info, 2) ) + ",";
+        }
+        sqlite3_finalize( info );
+      }
 
-          rc = sqlite3_finalize( stmt );
-          sqlite3_close( db );
-        } 
+      if( columns.compare(0, 8, "name,ts,") == 0 )
+      {
+        fprintf(stderr, SD_DEBUG "%s index %s on (%s)\n", table.c_str(), index.c_str(), columns.c_str());
+        found = true;
       }
     }
-  }     
 
-  rc = sqlite3_step( stmt );
+    sqlite3_finalize( list );
+  }
+
+  if( found ) return true;
+
+  fprintf(stderr, SD_WARNING "%s has no index on (name, ts), create it now\n", table.c_str());
+
+  return Exec("create index if not exists " + table + "_name_ts on " + table + "(name,ts)", error);
+}
+
+/// SQLite member function to copy WAL content to database file.
 
-  if( rc == SQLITE_BUSY )
+/// A passive checkpoint does not wait for readers. With _truncate_ the
+/// checkpoint waits for readers and resets the WAL file to zero size.
+bool SQLite::Checkpoint(bool truncate, int & error)
+{
+  int logframes = 0, checkpointed = 0;
+
+  if( !conn && !Open( GetFileAt( TimeStamp() ), error ) ) return false;
+
+  std::lock_guard<std::mutex> guard( conn->lock );
+
+  int rc = sqlite3_wal_checkpoint_v2(conn->db, NULL, truncate ? SQLITE_CHECKPOINT_TRUNCATE : SQLITE_CHECKPOINT_PASSIVE, &logframes, &checkpointed);
+
+  if( rc != SQLITE_OK )
   {
-    j = 0;
-    while( rc == SQLITE_BUSY && j < 10 )
-    {
-      fprintf(stderr, SD_WARNING "SQLite database busy, wait 1 s.\n");
-      sleep( 1 ); // sleep 1 s
-      rc = sqlite3_step( stmt );
-    }
+    fprintf(stderr, SD_WARNING "%s checkpoint failed: %s\n", file.c_str(), sqlite3_errmsg( conn->db ) );
+    error = rc;
+
+    return false;
   }
 
-  if( rc != SQLITE_DONE )
+  fprintf(stderr, SD_DEBUG "%s checkpoint %d of %d WAL frames\n", file.c_str(), checkpointed, logframes);
+
+  return true;
+}
+
+/// SQLite member function to delete old rows in small batches.
+
+/// Only the _limit_ oldest rows in rowid order, which is the order they
+/// were written, are candidates and of them the rows with timestamp before
+/// _before_ are deleted. The candidates are read from the start of the
+/// table b-tree, so a step costs the same whether or not there are old
+/// rows and the connection is locked only shortly. A row written out of
+/// time order can delay the deletes behind it until it is old itself.
+/// Returns number of deleted rows or -1 on failure.
+int SQLite::Prune(int64_t before, int limit, int & error)
+{
+  char *errmsg = nullptr;
+  std::string bound = std::to_string( before );
+
+  if( !conn && !Open( GetFileAt( TimeStamp() ), error ) ) return -1;
+
+  if( textts ) bound = "strftime('%Y-%m-%d %H:%M:%S'," + std::to_string( before / 1000000 ) + ",'unixepoch')";
+
+  std::string sql = "delete from " + table + " where rowid in (select rowid from " + table + " order by rowid limit " + std::to_string( limit ) + ") and ts<" + bound;
+
+  std::lock_guard<std::mutex> guard( conn->lock );
+
+  int rc = sqlite3_exec(conn->db, sql.c_str(), NULL, NULL, &errmsg);
+
+  if( rc != SQLITE_OK )
   {
-    sprintf(message, "Statement failed: %s\n", sqlite3_errmsg( db ) );
-    fprintf(stderr, SD_ERR "%s", message);
+    fprintf(stderr, SD_ERR "Statement %s failed: %s\n", sql.c_str(), errmsg ? errmsg : sqlite3_errmsg( conn->db ) );
+    sqlite3_free( errmsg );
     error = rc;
 
-    rc = sqlite3_finalize( stmt );
-    sqlite3_close( db );
+    return -1;
+  }
+
+  int deleted = sqlite3_changes( conn->db );
+  if( deleted > 0 ) fprintf(stderr, SD_DEBUG "%s %d old rows deleted\n", table.c_str(), deleted);
+
+  return deleted;
+}
+
+/// SQLite member function to return free pages to file system.
+
+/// With auto_vacuum=INCREMENTAL pages freed by deletes stay in the free
+/// list until _incremental_vacuum_ moves at most _pages_ of them to the
+/// end of the file and truncates it. A full VACUUM would lock the whole
+/// database while it rewrites it.
+bool SQLite::IncrementalVacuum(int pages, int & error)
+{
+  return Exec("pragma incremental_vacuum(" + std::to_string( pages ) + ")", error);
+}
 
+/// SQLite member function to check that free pages can be returned incrementally.
+
+/// New database files get auto_vacuum=INCREMENTAL when the connection is
+/// opened. An existing file keeps its mode until one full VACUUM, which
+/// is left to the user since it locks the database for a long time.
+bool SQLite::CheckAutoVacuum(int & error)
+{
+  sqlite3_stmt *info;
+  int mode = 0;
+
+  if( !conn && !Open( GetFileAt( TimeStamp() ), error ) ) return false;
+
+  std::lock_guard<std::mutex> guard( conn->lock );
+
+  int rc = sqlite3_prepare_v2(conn->db, "pragma auto_vacuum", -1, &info, 0);
+  if( rc != SQLITE_OK )
+  {
+    fprintf(stderr, SD_ERR "Statement prepare failed: %s\n", sqlite3_errmsg( conn->db ) );
+    error = rc;
     return false;
-  } 
+  }
+
+  if( sqlite3_step( info ) == SQLITE_ROW ) mode = sqlite3_column_int(info, 0);
+
+  sqlite3_finalize( info );
 
-  rc = sqlite3_finalize( stmt );
-  sqlite3_close( db );
+  if( mode != 2 ) fprintf(stderr, SD_WARNING "%s has auto_vacuum=%d, deleted rows do not shrink file until 'pragma auto_vacuum=incremental; vacuum;'\n", file.c_str(), mode);
 
   return true;
 }
 
-/// SQLite member function to open connection and execute insert statement on database table.
-bool SQLite::Insert(std::string name, int Nd, double *dbl_array, int Ni, int *int_array, int & error)
+/// SQLite member function to execute statement such as _begin_ or _commit_ on shared connection.
+bool SQLite::Exec(std::string sql, int & error)
 {
-  sqlite3 *db;
-  sqlite3_stmt *stmt;
-
   char message[ 500 ] = "";
+  char *errmsg = nullptr;
 
-  sprintf(message, "Open database: %s\n", file.c_str() );
+  if( !conn && !Open( GetFileAt( TimeStamp() ), error ) ) return false;
+
+  std::lock_guard<std::mutex> guard( conn->lock );
+
+  snprintf(message, sizeof( message ), "Execute: %s\n", sql.c_str() );
   fprintf(stderr, SD_DEBUG "%s", message);
 
-  int rc = sqlite3_open_v2(file.c_str(), &db, SQLITE_OPEN_READWRITE, NULL);
+  int rc = sqlite3_exec(conn->db, sql.c_str(), NULL, NULL, &errmsg);
 
   if( rc != SQLITE_OK )
   {
-    sprintf(message, "Can not open database: %s\n", sqlite3_errmsg( db ) );
-    fprintf(stderr, SD_ERR "%s", message);
+    fprintf(stderr, SD_ERR "Statement %s failed: %s\n", sql.c_str(), errmsg ? errmsg : sqlite3_errmsg( conn->db ) );
+    sqlite3_free( errmsg );
     error = rc;
-    sqlite3_close( db );
 
     return false;
   }
 
-  int i, j;
+  return true;
+}
+
+/// SQLite member function to execute insert statement with integers on database table.
+bool SQLite::Insert(std::string name, int N, int *data, int & error)
+{
+  return Insert(name, 0, nullptr, N, data, error);
+}
 
+/// SQLite member function to execute insert statement with doubles on database table.
+bool SQLite::Insert(std::string name, int N, double *data, int & error)
+{
+  return Insert(name, N, data, 0, nullptr, error);
+}
 
-  sprintf(message, "Prepare statement: %s\n", insert_stmt.c_str() );
+/// SQLite member function to execute insert statement with current time on database table.
+bool SQLite::Insert(std::string name, int Nd, double *dbl_array, int Ni, int *int_array, int & error)
+{
+  return InsertAt(name, TimeStamp(), Nd, dbl_array, Ni, int_array, error);
+}
+
+/// SQLite function to read wall clock time when sample is taken.
+int64_t SQLite::TimeStamp()
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_REALTIME, &now);
+
+  return (int64_t)now.tv_sec * 1000000LL + now.tv_nsec / 1000;
+}
+
+/// SQLite member function to check if table still has text timestamps.
+
+/// Tables created before integer timestamps declare _ts_ as timestamp
+/// with text values. Until they are converted with table/migrate-ts
+/// the sample time is written as UTC text to keep the column consistent.
+bool SQLite::CheckTimeStamp(int & error)
+{
+  sqlite3_stmt *info;
+  std::string sql = "pragma table_info(" + table + ")";
+
+  if( !conn && !Open( GetFileAt( TimeStamp() ), error ) ) return false;
+
+  std::lock_guard<std::mutex> guard( conn->lock );
+
+  int rc = sqlite3_prepare_v2(conn->db, sql.c_str(), -1, &info, 0);
+  if( rc != SQLITE_OK )
+  {
+    fprintf(stderr, SD_ERR "Statement prepare failed: %s\n", sqlite3_errmsg( conn->db ) );
+    error = rc;
+    return false;
+  }
+
+  textts = false;
+  while( sqlite3_step( info ) == SQLITE_ROW )
+  {
+    std::string column = (const char *)sqlite3_column_text(info, 1);
+    std::string type = sqlite3_column_text(info, 2) ? (const char *)sqlite3_column_text(info, 2) : "";
+
+    if( column == "ts" && sqlite3_stricmp(type.c_str(), "integer") != 0 ) textts = true;
+  }
+
+  sqlite3_finalize( info );
+
+  if( textts ) fprintf(stderr, SD_WARNING "%s has text timestamps, convert with table/migrate-ts\n", table.c_str());
+
+  return true;
+}
+
+/// SQLite member function to execute insert statement on database table.
+
+/// The name is bound to first position, followed by _Nd_ doubles and _Ni_
+/// integers. The timestamp _ts_ is bound to named parameter _:ts_ placed
+/// after them.
+bool SQLite::InsertAt(std::string name, int64_t ts, int Nd, double *dbl_array, int Ni, int *int_array, int & error)
+{
+  char message[ 500 ] = "";
+  int i;
+
+  if( !Open( GetFileAt( ts ), error ) ) return false;
+
+  std::lock_guard<std::mutex> guard( conn->lock );
+
+  if( !Prepare( error ) ) return false;
+
+  sprintf(message, "Bind text: %s\n", name.c_str() );
   fprintf(stderr, SD_DEBUG "%s", message);
 
-  rc = sqlite3_prepare_v2(db, insert_stmt.c_str(), 200, &stmt, 0);
+  int rc = sqlite3_bind_text(stmt, 1, name.c_str(), name.length(), SQLITE_TRANSIENT);
 
   if( rc != SQLITE_OK )
   {
-    sprintf(message, "Statement prepare failed: %s\n", sqlite3_errmsg( db ) );
+    sprintf(message, "Binding text failed: %s\n", sqlite3_errmsg( conn->db ) );
     fprintf(stderr, SD_ERR "%s", message);
     error = rc;
-    sqlite3_close( db );
+    sqlite3_clear_bindings( stmt );
 
     return false;
   }
-  else
-  {
 
-    sprintf(message, "Bind text: %s\n", name.c_str() );
+  for( i = 1; i <= Nd; i++)
+  {
+    sprintf(message, "Bind double %f to position %d\n", dbl_array[ i - 1], i+1 );
     fprintf(stderr, SD_DEBUG "%s", message);
 
-    rc = sqlite3_bind_text(stmt, 1, name.c_str(), name.length(), SQLITE_STATIC);
+    rc = sqlite3_bind_double(stmt, i + 1, dbl_array[ i - 1 ]);
 
     if( rc != SQLITE_OK )
     {
-      sprintf(message, "Binding text failed: %s\n", sqlite3_errmsg( db ) );
+      sprintf(message, "Binding double failed: %s\n", sqlite3_errmsg( conn->db ) );
       fprintf(stderr, SD_ERR "%s", message);
       error = rc;
+      sqlite3_clear_bindings( stmt );
 
-      rc = sqlite3_finalize( stmt );
-      sqlite3_close( db );
-      
       return false;
-    }
-    else
-    {
-      for( i = 1; i <= Nd; i++)
-      {
+    } 
+  }
 
-        sprintf(message, "Bind double %f to position %d\n", dbl_array[ i - 1], i+1 );
-        fprintf(stderr, SD_DEBUG "%s", message);
+  for( i = 0; i < Ni; i++)
+  {
+    sprintf(message, "Bind integer %d to position %d\n", int_array[ i ], i+Nd+2 );
+    fprintf(stderr, SD_DEBUG "%s", message);
 
-      	rc = sqlite3_bind_double(stmt, i + 1, dbl_array[ i - 1 ]);
+    rc = sqlite3_bind_int(stmt, i + Nd + 2, int_array[ i ]);
 
-    	if( rc != SQLITE_OK )
-        {
-          sprintf(message, "Binding double failed: %s\n", sqlite3_errmsg( db ) );
-          fprintf(stderr, SD_ERR "%s", message);
-          error = rc;
+    if( rc != SQLITE_OK )
+    {
+      sprintf(message, "Binding int failed: %s\n", sqlite3_errmsg( conn->db ) );
+      fprintf(stderr, SD_ERR "%s", message);
+      error = rc;
+      sqlite3_clear_bindings( stmt );
 
-          rc = sqlite3_finalize( stmt );
-	  sqlite3_close( db );
-        } 
-      }
+      return false;
+    } 
+  }
 
-      for( i = 0; i < Ni; i++)
-      {
-        sprintf(message, "Bind integer %d to position %d\n", int_array[ i ], i+Nd+2 );
-        fprintf(stderr, SD_DEBUG "%s", message);
+  i = sqlite3_bind_parameter_index(stmt, ":ts");
+  if( i > 0 )
+  {
+    rc = BindTimeStamp(stmt, i, ts);
 
-	rc = sqlite3_bind_int(stmt, i + Nd + 2, int_array[ i ]);
+    if( rc != SQLITE_OK )
+    {
+      sprintf(message, "Binding timestamp failed: %s\n", sqlite3_errmsg( conn->db ) );
+      fprintf(stderr, SD_ERR "%s", message);
+      error = rc;
+      sqlite3_clear_bindings( stmt );
 
-	if( rc != SQLITE_OK )
-        {
-          sprintf(message, "Binding int failed: %s\n", sqlite3_errmsg( db ) );
-          fprintf(stderr, SD_ERR "%s", message);
-          error = rc;
+      return false;
+    } 
+  }
 
-          rc = sqlite3_finalize( stmt );
-	  sqlite3_close( db );
-        } 
-      }
-    }
-  }     
-  
-  rc = sqlite3_step( stmt );
+  return Step(stmt, error);
+}
+
+/// SQLite member function to insert many rows with one statement.
 
-  if( rc == SQLITE_BUSY )
+/// The rows must go to the same database file. Up to SQLITE_BULK_ROWS rows
+/// are bound by column to one multi-row statement, so that each statement
+/// is stepped once for many rows. If a statement fails all its rows are
+/// lost. Statements without _:ts_ or with an upsert clause are executed
+/// row by row.
+bool SQLite::InsertRows(const std::vector<SQLiteRow> & rows, int & error)
+{
+  if( rows.empty() ) return true;
+
+  if( insert_stmt.find( ":ts" ) == std::string::npos || insert_stmt.find( " values" ) == std::string::npos || insert_stmt.find( "on conflict" ) != std::string::npos )
   {
-    j = 0;
-    while( rc == SQLITE_BUSY && j < 10 )
+    bool ok = true;
+
+    for(auto & r : rows)
     {
-      fprintf(stderr, SD_WARNING "SQLite database busy, wait 1 s.\n");
-      sleep( 1 ); // sleep 1 s
-      rc = sqlite3_step( stmt );
+      if( !InsertAt(*r.name, r.ts, r.Nd, r.dbl_array, r.Ni, r.int_array, error) ) ok = false;
     }
+
+    return ok;
   }
 
-  if( rc != SQLITE_DONE )
+  if( !Open( GetFileAt( rows[ 0 ].ts ), error ) ) return false;
+
+  int columns = GetColumns().size();
+  int chunk = SQLITE_BULK_VARIABLES / ( columns + 2 );
+  if( chunk > SQLITE_BULK_ROWS ) chunk = SQLITE_BULK_ROWS;
+  if( chunk < 1 ) chunk = 1;
+
+  std::lock_guard<std::mutex> guard( conn->lock );
+
+  for(size_t done = 0; done < rows.size(); )
   {
-    sprintf(message, "Statement failed: %s\n", sqlite3_errmsg( db ) );
-    fprintf(stderr, SD_ERR "%s", message);
-    error = rc;
+    int n = rows.size() - done;
+    if( n > chunk ) n = chunk;
 
-    rc = sqlite3_finalize( stmt );
-    sqlite3_close( db );
+    sqlite3_stmt *s = PrepareRows(n, columns, error);
+    if( !s ) return false;
 
-    return false;
-  } 
+    int rc = SQLITE_OK;
+    for(int k = 0; k < n; k++)
+    {
+      const SQLiteRow & r = rows[ done + k ];
+      int pos = k * ( columns + 2 ) + 1;
+
+      if( r.Nd + r.Ni > columns )
+      {
+        fprintf(stderr, SD_ERR "%s %d values for %d columns of %s\n", r.name->c_str(), r.Nd + r.Ni, columns, table.c_str());
+        rc = SQLITE_RANGE;
+        break;
+      }
+
+      // columns missing from row, for example from spool written before
+      // a schema change, are NULL
+      rc = sqlite3_bind_text(s, pos, r.name->c_str(), r.name->length(), SQLITE_STATIC);
+      for(int i = 0; i < r.Nd && rc == SQLITE_OK; i++) rc = sqlite3_bind_double(s, pos + 1 + i, r.dbl_array[ i ]);
+      for(int i = 0; i < r.Ni && rc == SQLITE_OK; i++) rc = sqlite3_bind_int(s, pos + 1 + r.Nd + i, r.int_array[ i ]);
+      for(int i = r.Nd + r.Ni; i < columns && rc == SQLITE_OK; i++) rc = sqlite3_bind_null(s, pos + 1 + i);
+      if( rc == SQLITE_OK ) rc = BindTimeStamp(s, pos + 1 + columns, r.ts);
+      if( rc != SQLITE_OK ) break;
+    }
 
-  rc = sqlite3_finalize( stmt );
-  sqlite3_close( db );
+    if( rc != SQLITE_OK )
+    {
+      fprintf(stderr, SD_ERR "Binding %d rows failed: %s\n", n, sqlite3_errstr( rc ) );
+      error = rc;
+      sqlite3_clear_bindings( s );
+
+      return false;
+    }
+
+    if( !Step(s, error) ) return false;
+
+    done += n;
+  }
 
   return true;
 }
-
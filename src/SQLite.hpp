@@ -2,7 +2,7 @@
  * 
  * SQLite database class definitions and constructor. 
  *       
- * Copyright (C) 2020 - 2022 Jaakko Koivuniemi.
+ * Copyright (C) 2020 - 2026 Jaakko Koivuniemi.
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -20,7 +20,7 @@
  ****************************************************************************
  *
  * Tue Jul 14 10:58:25 CDT 2020
- * Edit: Sun Apr 24 15:15:44 CDT 2022
+ * Edit: Sun Oct 18 00:52:14 CDT 2026
  *
  * Jaakko Koivuniemi
  **/
@@ -32,17 +32,93 @@
 #include <string>
 #include <sqlite3.h>
 #include <unistd.h>
+#include <stdint.h>
+#include <vector>
+#include <map>
+#include <mutex>
+
+#define SQLITE_DURABILITY_FAST 0   ///< WAL, no sync, may lose last commits on power loss
+#define SQLITE_DURABILITY_NORMAL 1 ///< WAL, sync at checkpoints only
+#define SQLITE_DURABILITY_FULL 2   ///< WAL, sync at every commit
+#define SQLITE_BULK_ROWS 32        ///< maximum rows in one multi-row insert
+#define SQLITE_BULK_VARIABLES 999  ///< maximum parameters in one statement
+
+/// Database connection shared by all SQLite objects using the same file.
+struct SQLiteConnection
+{
+  sqlite3 *db = nullptr;     ///< open database handle
+  int users = 0;             ///< number of SQLite objects using connection
+  std::mutex lock;           ///< serialize statements on connection
+};
+
+/// One row for bulk insert, the values are not copied.
+struct SQLiteRow
+{
+  const std::string *name = nullptr; ///< name tag of chip
+  int64_t ts = 0;                    ///< sample time [us since epoch]
+  int Nd = 0;                        ///< number of doubles
+  double *dbl_array = nullptr;       ///< double values
+  int Ni = 0;                        ///< number of integers
+  int *int_array = nullptr;          ///< integer values
+};
 
 /// Class for SQLite database functions. 
 
 /// The constructor _SQLite_ sets SQLite database file name, table and insert 
-/// query for data storage.
+/// query for data storage. The database is opened once for each file and
+/// the connection is shared with other SQLite objects. The insert
+/// statement is prepared on first use and reused for later inserts.
+/// With day partitions each sample is written to a file of its own UTC
+/// date, so that old data can be dropped by removing files.
 class SQLite 
 {
     std::string file;         ///< SQLite database file name
     std::string table;        ///< SQLite database table
     std::string insert_stmt;  ///< SQLite insert statement 
 
+    bool textts;              ///< table has old text timestamp column
+    bool partition;           ///< write to day partition files
+    std::string connfile;     ///< file of open connection
+    SQLiteConnection *conn;   ///< shared database connection
+    sqlite3_stmt *stmt;       ///< prepared insert statement
+    std::vector<sqlite3_stmt *> bulk; ///< prepared multi-row inserts by row count
+
+    static std::map<std::string, SQLiteConnection *> connections; ///< open connections by file
+    static std::mutex connections_lock; ///< lock for connections map
+    static int durability;    ///< durability level for new connections
+    static int autocheckpoint; ///< WAL pages before automatic checkpoint
+    static long long mmapsize; ///< memory mapped I/O size [bytes]
+
+    /// Set pragmas for auto vacuum, journal mode, synchronization and memory mapping.
+    static void Configure(sqlite3 *db, std::string file);
+
+    /// Open or share connection to database file, return nullptr on failure.
+    static SQLiteConnection *Connect(std::string file, bool create, int & error);
+
+    /// Release connection and close it when last user is gone.
+    static void Disconnect(std::string file, SQLiteConnection *conn);
+
+    /// Finalize prepared statement and release connection.
+    void Close();
+
+    /// Connect to database file unless already connected to it, return true in success.
+    bool Open(std::string name, int & error);
+
+    /// Create table and its indexes in new partition file from main file, return true in success.
+    bool CopySchema(int & error);
+
+    /// Open connection and prepare insert statement if not done yet.
+    bool Prepare(int & error);
+
+    /// Prepare insert statement for _rows_ rows of _columns_ value columns if not done yet, return nullptr on failure.
+    sqlite3_stmt *PrepareRows(int rows, int columns, int & error);
+
+    /// Bind timestamp [us] as integer or as UTC text for old tables.
+    int BindTimeStamp(sqlite3_stmt *s, int pos, int64_t ts);
+
+    /// Step prepared insert statement and reset it for next insert.
+    bool Step(sqlite3_stmt *s, int & error);
+
    public:
     /// Construct Database object. 
     SQLite();
@@ -61,17 +137,68 @@ class SQLite
     /// Get insert query.
     std::string GetInsert() { return insert_stmt; }
 
+    /// Get value columns of insert statement after name and before ts.
+    std::vector<std::string> GetColumns();
+
     /// Get return string from datetime() query.
     std::string GetDateTime(int & error);
 
     /// Set database file name.
-    void SetFile(std::string file) { this->file = file; }
+    void SetFile(std::string file) { Close(); this->file = file; }
 
     /// Set database table name.
     void SetTable(std::string table) { this->table = table; }
 
+    /// Write to day partition files of main file if _partition_ is true.
+    void SetPartition(bool partition) { Close(); this->partition = partition; }
+
+    /// Get true if day partition files are used.
+    bool GetPartition() { return partition; }
+
+    /// Get database file for sample time [us], the main file without partitions.
+    std::string GetFileAt(int64_t ts);
+
+    /// Get true if database file has open connection.
+    static bool IsOpen(std::string file);
+
+    /// Connect to database file for sample time [us], return true in success.
+    bool OpenAt(int64_t ts, int & error) { return Open( GetFileAt( ts ), error ); }
+
     /// Set database insert query.
-    void SetInsert(std::string insert_stmt) { this->insert_stmt = insert_stmt; }
+    void SetInsert(std::string insert_stmt) { Close(); this->insert_stmt = insert_stmt; }
+
+    /// Set durability level used when database connection is opened.
+    static void SetDurability(int durability) { SQLite::durability = durability; }
+
+    /// Set number of WAL pages before automatic checkpoint, 0 to disable.
+    static void SetAutoCheckpoint(int pages) { SQLite::autocheckpoint = pages; }
+
+    /// Set memory mapped I/O size in bytes, 0 to disable.
+    static void SetMmapSize(long long size) { SQLite::mmapsize = size; }
+
+    /// Run WAL checkpoint, truncate WAL file if _truncate_ is true, return true in success.
+    bool Checkpoint(bool truncate, int & error);
+
+    /// Delete at most _limit_ rows with timestamp before _before_ [us], return number of deleted rows or -1.
+    int Prune(int64_t before, int limit, int & error);
+
+    /// Return at most _pages_ free pages to file system, return true in success.
+    bool IncrementalVacuum(int pages, int & error);
+
+    /// Check that database file has auto_vacuum=INCREMENTAL, return true in success.
+    bool CheckAutoVacuum(int & error);
+
+    /// Check that table has index on (name, ts) and create it if missing, return true in success.
+    bool CheckIndex(int & error);
+
+    /// Check type of _ts_ column, old text timestamps are written as UTC text, return true in success.
+    bool CheckTimeStamp(int & error);
+
+    /// Get CLOCK_REALTIME timestamp in microseconds since epoch.
+    static int64_t TimeStamp();
+
+    /// Execute SQL statement without results on shared connection, return true in success.
+    bool Exec(std::string sql, int & error);
 
     /// Insert name and N integers to database table and return true in success.
     bool Insert(std::string name, int N, int *data, int & error);
@@ -82,6 +209,14 @@ class SQLite
     /// Insert name, Nd doubles and Ni integers to database table and return true in success.
     bool Insert(std::string name, int Nd, double *dbl_array, int Ni, int *int_array, int & error);
 
+    /// Insert name, timestamp [us], Nd doubles and Ni integers to database table and return true in success.
+
+    /// The timestamp is bound to parameter _:ts_ if the insert statement has it.
+    bool InsertAt(std::string name, int64_t ts, int Nd, double *dbl_array, int Ni, int *int_array, int & error);
+
+    /// Insert rows of one database file with multi-row statements and return true in success.
+    bool InsertRows(const std::vector<SQLiteRow> & rows, int & error);
+
 };
 
 #endif
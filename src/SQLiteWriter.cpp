@@ -0,0 +1,557 @@
+/**************************************************************************
+ *
+ * SQLiteWriter class member functions for batched database inserts.
+ *
+ * Copyright (C) 2026 Jaakko Koivuniemi.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************
+ *
+ * Sat Oct 17 17:31:27 CDT 2026
+ * Edit: Sun Oct 18 19:20:48 CDT 2026
+ *
+ * Jaakko Koivuniemi
+ **/
+
+
+#include "SQLiteWriter.hpp"
+#include <chrono>
+#include <set>
+#include <string.h>
+
+using namespace std;
+
+/// SQLiteWriter constructor.
+SQLiteWriter::SQLiteWriter(int size, int batch, int interval)
+{
+  if( size < 1 ) size = 1;
+  if( batch < 1 ) batch = 1;
+
+  queue.resize( size );
+  head = 0;
+  count = 0;
+  this->batch = batch;
+  this->interval = interval;
+  dropped = 0;
+  commits = 0;
+  running = false;
+  spool = nullptr;
+  recent = nullptr;
+  spooled = 0;
+  draining = false;
+}
+
+SQLiteWriter::~SQLiteWriter()
+{
+  SQLiteWriter::Stop();
+}
+
+/// Dropped rows are counted under the queue lock.
+uint64_t SQLiteWriter::GetDropped()
+{
+  std::lock_guard<std::mutex> guard( lock );
+
+  return dropped;
+}
+
+/// Values are copied to queue so the caller can reuse its arrays at once.
+/// Recent samples are updated also when the queue is full, through the
+/// ring registered for the chip so that the ring map is not searched.
+bool SQLiteWriter::Insert(SQLite *db, Recent::Ring *ring, std::string name, int64_t ts, int Nd, double *dbl_array, int Ni, int *int_array, int & error)
+{
+  if( Nd > SQLITEWRITER_MAX_DBL || Ni > SQLITEWRITER_MAX_INT )
+  {
+    fprintf(stderr, SD_ERR "%s too many values for SQLite writer\n", name.c_str());
+    error = SQLITE_TOOBIG;
+    return false;
+  }
+
+  if( recent ) recent->Add(ring, ts, Nd, dbl_array, Ni, int_array);
+
+  bool notify = false;
+  {
+    std::lock_guard<std::mutex> guard( lock );
+
+    if( count == queue.size() )
+    {
+      dropped++;
+      error = SQLITE_FULL;
+      return false;
+    }
+
+    SQLiteRecord & rec = queue[ ( head + count ) % queue.size() ];
+    rec.db = db;
+    rec.name = name;
+    rec.ts = ts;
+    rec.Nd = Nd;
+    rec.Ni = Ni;
+    for(int i = 0; i < Nd; i++) rec.dbl_array[ i ] = dbl_array[ i ];
+    for(int i = 0; i < Ni; i++) rec.int_array[ i ] = int_array[ i ];
+    count++;
+
+    // wake writer on first row to start interval and on full batch
+    notify = ( count == 1 || count >= (size_t)batch );
+  }
+
+  if( notify ) wakeup.notify_one();
+
+  return true;
+}
+
+/// Both threads are woken, the one that commits rows runs the job.
+void SQLiteWriter::Maintain(std::function<void()> job)
+{
+  {
+    std::lock_guard<std::mutex> guard( lock );
+
+    jobs.push_back( job );
+  }
+
+  wakeup.notify_one();
+  replaywakeup.notify_one();
+}
+
+/// Jobs are taken from the list under lock and run without it, so that
+/// reading threads can queue rows meanwhile.
+void SQLiteWriter::RunJobs()
+{
+  std::vector<std::function<void()>> waiting;
+
+  {
+    std::lock_guard<std::mutex> guard( lock );
+
+    waiting.swap( jobs );
+  }
+
+  for(auto & j : waiting) j();
+}
+
+/// Start writer thread and replay thread if spool is set.
+void SQLiteWriter::Start()
+{
+  running = true;
+  draining = false;
+  thread = std::thread(&SQLiteWriter::Run, this);
+  if( spool ) replayer = std::thread(&SQLiteWriter::Replay, this);
+}
+
+/// Waiting rows are written before the thread exits. With spool the rows
+/// are replayed before exit unless the database is unavailable. The flag
+/// is cleared under the queue lock so that the writer can not miss the
+/// wakeup between checking it and starting to wait.
+void SQLiteWriter::Stop()
+{
+  {
+    std::lock_guard<std::mutex> guard( lock );
+
+    running = false;
+  }
+  wakeup.notify_one();
+
+  if( thread.joinable() ) thread.join();
+  if( replayer.joinable() ) replayer.join();
+}
+
+/// Errors after which the same rows can be written later.
+static bool Unavailable(int error)
+{
+  switch( error & 0xff )
+  {
+    case SQLITE_BUSY:
+    case SQLITE_LOCKED:
+    case SQLITE_NOMEM:
+    case SQLITE_READONLY:
+    case SQLITE_IOERR:
+    case SQLITE_FULL:
+    case SQLITE_CANTOPEN:
+    case SQLITE_PROTOCOL:
+      return true;
+  }
+
+  return false;
+}
+
+/// Spool record has table and name with one byte length, timestamp,
+/// counts of doubles and integers and the values in host byte order.
+void SQLiteWriter::Encode(const SQLiteRecord & rec, std::string & record)
+{
+  std::string table = rec.db->GetTable();
+  uint8_t n;
+
+  record.clear();
+  n = table.size();
+  record.append( (const char *)&n, 1 );
+  record.append( table, 0, n );
+  n = rec.name.size();
+  record.append( (const char *)&n, 1 );
+  record.append( rec.name, 0, n );
+  record.append( (const char *)&rec.ts, sizeof( rec.ts ) );
+  n = rec.Nd;
+  record.append( (const char *)&n, 1 );
+  n = rec.Ni;
+  record.append( (const char *)&n, 1 );
+  record.append( (const char *)rec.dbl_array, rec.Nd * sizeof( double ) );
+  record.append( (const char *)rec.int_array, rec.Ni * sizeof( int ) );
+}
+
+/// SQLiteWriter member function to decode spool record.
+bool SQLiteWriter::Decode(const std::string & record, SQLiteRecord & rec)
+{
+  const char *p = record.data(), *end = p + record.size();
+  std::string table;
+
+  if( p < end && p + 1 + (uint8_t)*p <= end )
+  {
+    table.assign( p + 1, (uint8_t)*p );
+    p += 1 + (uint8_t)*p;
+  }
+  else p = end;
+
+  if( p < end && p + 1 + (uint8_t)*p <= end )
+  {
+    rec.name.assign( p + 1, (uint8_t)*p );
+    p += 1 + (uint8_t)*p;
+  }
+  else p = end;
+
+  if( p + sizeof( rec.ts ) + 2 > end )
+  {
+    fprintf(stderr, SD_ERR "short spool record of %d bytes\n", (int)record.size());
+    return false;
+  }
+
+  memcpy( &rec.ts, p, sizeof( rec.ts ) );
+  p += sizeof( rec.ts );
+  rec.Nd = (uint8_t)p[ 0 ];
+  rec.Ni = (uint8_t)p[ 1 ];
+  p += 2;
+
+  if( rec.Nd > SQLITEWRITER_MAX_DBL || rec.Ni > SQLITEWRITER_MAX_INT || p + rec.Nd * sizeof( double ) + rec.Ni * sizeof( int ) != end )
+  {
+    fprintf(stderr, SD_ERR "bad spool record for %s %s\n", table.c_str(), rec.name.c_str());
+    return false;
+  }
+
+  memcpy( rec.dbl_array, p, rec.Nd * sizeof( double ) );
+  p += rec.Nd * sizeof( double );
+  memcpy( rec.int_array, p, rec.Ni * sizeof( int ) );
+
+  auto t = tables.find( table );
+  if( t == tables.end() )
+  {
+    fprintf(stderr, SD_WARNING "spool record for unknown table %s skipped\n", table.c_str());
+    return false;
+  }
+  rec.db = t->second;
+
+  return true;
+}
+
+/// Rows not fitting to the spool are counted as dropped.
+bool SQLiteWriter::Append(std::vector<SQLiteRecord> & rows)
+{
+  std::string record;
+  int error = 0;
+
+  for(size_t i = 0; i < rows.size(); i++)
+  {
+    Encode( rows[ i ], record );
+
+    if( !spool->Append( record, error ) )
+    {
+      fprintf(stderr, SD_ERR "error writing %d rows to spool: %d\n", (int)( rows.size() - i ), error);
+
+      std::lock_guard<std::mutex> guard( lock );
+      dropped += rows.size() - i;
+      spooled += i;
+      return false;
+    }
+  }
+
+  spooled += rows.size();
+
+  return spool->Sync( error );
+}
+
+/// SQLiteWriter member function to write all rows of one batch.
+
+/// A transaction is opened on each database file in the batch, so the
+/// rows are synced to disk once per batch instead of once per row. With
+/// day partitions a batch over midnight has rows for two files. Each
+/// transaction is held with its own SQLite object so that the file stays
+/// open when a table moves to the next partition. Rows of each table and
+/// file are inserted with multi-row statements. If the database is busy,
+/// read-only or full the uncommitted files are rolled back and false
+/// returned with only their rows left in _rows_ so that they can be
+/// written again, other failed rows are lost. A file committed before the
+/// failure, for example yesterday's partition, is not written twice since
+/// the raw tables have no unique key against duplicates. Rows of tables with
+/// a time series store are appended to it instead, and aggregate tables are
+/// updated only after the commit so that a retried batch is counted once.
+bool SQLiteWriter::Commit(std::vector<SQLiteRecord> & rows)
+{
+  std::map<std::string, SQLite *> files;
+  int error = 0, failed = 0;
+  bool available = true;
+
+  std::map<std::pair<SQLite *, std::string>, std::vector<SQLiteRow>> groups;
+  std::set<std::pair<SQLite *, std::string>> written; // groups not to retry
+
+  for(auto & rec : rows)
+  {
+    if( stores.find( rec.db ) != stores.end() ) continue;
+
+    SQLiteRow row;
+    row.name = &rec.name;
+    row.ts = rec.ts;
+    row.Nd = rec.Nd;
+    row.dbl_array = rec.dbl_array;
+    row.Ni = rec.Ni;
+    row.int_array = rec.int_array;
+    groups[ std::make_pair(rec.db, rec.db->GetFileAt( rec.ts )) ].push_back( row );
+  }
+
+  for(auto & g : groups)
+  {
+    SQLite *db = g.first.first;
+    const std::string & file = g.first.second;
+
+    if( files.find( file ) == files.end() )
+    {
+      SQLite *txn = new SQLite(file, "", "");
+
+      // new partition file is created by table before transaction
+      if( db->OpenAt( g.second[ 0 ].ts, error ) && txn->Exec( "begin", error ) ) files[ file ] = txn;
+      else delete txn;
+    }
+
+    if( !db->InsertRows(g.second, error) )
+    {
+      failed += g.second.size();
+      if( Unavailable( error ) )
+      {
+        available = false;
+        break;
+      }
+    }
+    else if( files.find( file ) == files.end() ) written.insert( g.first ); // without transaction
+  }
+
+  for(auto & f : files)
+  {
+    if( available && !f.second->Exec( "commit", error ) )
+    {
+      fprintf(stderr, SD_ERR "error committing %d rows to %s: %d\n", (int)rows.size(), f.first.c_str(), error);
+      if( Unavailable( error ) ) available = false;
+      f.second->Exec( "rollback", error );
+    }
+    else if( !available ) f.second->Exec( "rollback", error );
+    else
+    {
+      for(auto & g : groups)
+      {
+        if( g.first.second == f.first ) written.insert( g.first );
+      }
+    }
+    delete f.second;
+  }
+
+  if( !available )
+  {
+    size_t kept = 0;
+
+    for(auto & rec : rows)
+    {
+      if( written.find( std::make_pair(rec.db, rec.db->GetFileAt( rec.ts )) ) == written.end() ) rows[ kept++ ] = rec;
+      else
+      {
+        auto r = rollups.find( rec.db );
+        if( r != rollups.end() ) r->second->Add(rec.name, rec.ts, rec.Nd, rec.dbl_array, error);
+      }
+    }
+
+    if( kept < rows.size() ) fprintf(stderr, SD_NOTICE "%d rows committed before failure are not retried\n", (int)( rows.size() - kept ));
+    rows.resize( kept );
+
+    fprintf(stderr, SD_WARNING "SQLite database unavailable, %d rows not written: %d\n", (int)rows.size(), error);
+    return false;
+  }
+
+  for(auto & rec : rows)
+  {
+    auto st = stores.find( rec.db );
+    if( st != stores.end() && !st->second->Append(rec.name, rec.ts, rec.Nd, rec.dbl_array, rec.Ni, rec.int_array, error) ) failed++;
+
+    auto r = rollups.find( rec.db );
+    if( r != rollups.end() && !r->second->Add(rec.name, rec.ts, rec.Nd, rec.dbl_array, error) ) failed++;
+  }
+
+  for(auto & st : stores) st.second->Sync();
+
+  commits++;
+
+  if( failed > 0 ) fprintf(stderr, SD_ERR "error writing %d of %d rows to SQLite database: %d\n", failed, (int)rows.size(), error);
+  else fprintf(stderr, SD_DEBUG "%d rows written to SQLite database\n", (int)rows.size());
+
+  return true;
+}
+
+/// SQLiteWriter member function running the writer thread.
+
+/// Rows are taken from the queue when batch is full, interval has passed
+/// from the oldest row or Stop() is called. With spool the rows are only
+/// appended to it and the replay thread is woken, otherwise maintenance
+/// jobs are run after the rows are committed.
+void SQLiteWriter::Run()
+{
+  std::vector<SQLiteRecord> rows;
+  uint64_t lastdropped = 0;
+
+  while( true )
+  {
+    {
+      std::unique_lock<std::mutex> guard( lock );
+
+      wakeup.wait( guard, [this] { return count > 0 || ( !spool && !jobs.empty() ) || !running; } );
+
+      if( count > 0 && count < (size_t)batch && running )
+      {
+        wakeup.wait_for( guard, std::chrono::milliseconds( interval ), [this] { return count >= (size_t)batch || !running; } );
+      }
+
+      if( count == 0 && !running ) break;
+
+      rows.clear();
+      while( count > 0 )
+      {
+        rows.push_back( queue[ head ] );
+        head = ( head + 1 ) % queue.size();
+        count--;
+      }
+
+      if( dropped > lastdropped )
+      {
+        fprintf(stderr, SD_WARNING "SQLite writer queue full, %llu rows dropped\n", (unsigned long long)( dropped - lastdropped ));
+        lastdropped = dropped;
+      }
+    }
+
+    if( spool )
+    {
+      if( !rows.empty() ) Append( rows );
+      replaywakeup.notify_one();
+    }
+    else
+    {
+      if( !rows.empty() ) Commit( rows );
+      RunJobs();
+    }
+  }
+
+  if( spool )
+  {
+    draining = true;
+    replaywakeup.notify_one();
+  }
+  else Finish();
+}
+
+/// SQLiteWriter member function running the replay thread.
+
+/// Rows are read from the spool in batches and the replay offset is saved
+/// after each committed batch. A crash between the commit and the offset
+/// write replays the batch again. While the database is unavailable the
+/// rows of the batch not yet committed are retried with back-off from 1 s
+/// to 60 s. When the writer thread has exited the spool is replayed to
+/// end, or the rows not committed are appended to the spool for the next
+/// start if the database is unavailable. Maintenance jobs are run before each batch.
+void SQLiteWriter::Replay()
+{
+  std::vector<SQLiteRecord> rows;
+  std::string record;
+  int error = 0, wait = 1;
+  bool retry = false;
+
+  while( true )
+  {
+    int n = 0;
+    SQLiteRecord rec;
+
+    RunJobs();
+
+    // a failed batch is retried from memory without the rows committed
+    if( !retry )
+    {
+      rows.clear();
+      while( n < batch && spool->Read( record ) )
+      {
+        n++;
+        if( Decode( record, rec ) ) rows.push_back( rec );
+      }
+
+      if( n == 0 )
+      {
+        if( draining ) break;
+
+        std::unique_lock<std::mutex> guard( replaylock );
+        replaywakeup.wait_for( guard, std::chrono::milliseconds( interval > 0 ? interval : 100 ) );
+        continue;
+      }
+    }
+
+    if( rows.empty() || Commit( rows ) )
+    {
+      if( !spool->Commit( error ) ) fprintf(stderr, SD_ERR "error saving spool offset: %d\n", error);
+      wait = 1;
+      retry = false;
+    }
+    else
+    {
+      retry = true;
+
+      // writer thread has exited, so the spool can be appended from here
+      if( draining )
+      {
+        if( Append( rows ) && spool->Commit( error ) ) fprintf(stderr, SD_NOTICE "%d rows left in spool for next start\n", (int)rows.size());
+        else spool->Rewind();
+        break;
+      }
+
+      fprintf(stderr, SD_NOTICE "%llu bytes in spool, retry in %d s\n", (unsigned long long)spool->GetBacklog(), wait);
+
+      std::unique_lock<std::mutex> guard( replaylock );
+      replaywakeup.wait_for( guard, std::chrono::seconds( wait ), [this] { return (bool)draining; } );
+      if( wait < 60 ) wait = ( 2 * wait < 60 ) ? 2 * wait : 60;
+    }
+  }
+
+  Finish();
+}
+
+/// Partially filled aggregate buckets are merged after restart.
+void SQLiteWriter::Finish()
+{
+  int error = 0;
+  for(auto & r : rollups)
+  {
+    SQLite txn(r.second->GetLevel( 0 )->GetFile(), "", "");
+
+    txn.Exec( "begin", error );
+    if( !r.second->Flush( error ) ) fprintf(stderr, SD_ERR "error writing %s aggregates: %d\n", r.first->GetTable().c_str(), error);
+    txn.Exec( "commit", error );
+  }
+
+  for(auto & st : stores) st.second->Close();
+}
@@ -0,0 +1,206 @@
+/**************************************************************************
+ *
+ * SQLiteWriter class definitions and constructor.
+ *
+ * Copyright (C) 2026 Jaakko Koivuniemi.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************
+ *
+ * Sat Oct 17 17:31:27 CDT 2026
+ * Edit: Sun Oct 18 19:20:48 CDT 2026
+ *
+ * Jaakko Koivuniemi
+ **/
+
+
+#ifndef _SQLITEWRITER_HPP
+#define _SQLITEWRITER_HPP
+
+#include <systemd/sd-daemon.h>
+#include "SQLite.hpp"
+#include "Rollup.hpp"
+#include "TimeSeriesStore.hpp"
+#include "Spool.hpp"
+#include "Schema.hpp"
+#include "Recent.hpp"
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <map>
+#include <atomic>
+#include <functional>
+#include <stdint.h>
+
+#define SQLITEWRITER_MAX_DBL 12 ///< maximum number of doubles in record
+#define SQLITEWRITER_MAX_INT 10 ///< maximum number of integers in record
+
+/// One row waiting to be inserted.
+struct SQLiteRecord
+{
+  SQLite *db = nullptr;                 ///< table to insert to
+  std::string name;                     ///< name tag of chip
+  int64_t ts = 0;                       ///< sample time [us since epoch]
+  int Nd = 0;                           ///< number of doubles
+  int Ni = 0;                           ///< number of integers
+  double dbl_array[ SQLITEWRITER_MAX_DBL ]; ///< double values
+  int int_array[ SQLITEWRITER_MAX_INT ];    ///< integer values
+};
+
+/// Writer thread for SQLite inserts with group commit.
+
+/// Reading threads only copy the values to a bounded queue and never wait
+/// for the database. The writer thread inserts the queued rows inside one
+/// transaction when _batch_ rows are waiting or _interval_ ms has passed
+/// from the first waiting row, whichever comes first. When the queue is
+/// full new rows are dropped and counted. Aggregate tables are updated
+/// after the raw rows are committed.
+///
+/// With a spool the writer thread only appends the rows to the spool and
+/// a replay thread inserts them from there. If the database is locked,
+/// read-only or the disk is full the rows stay in the spool and the
+/// replay is retried later, so samples are not lost while the database
+/// is unavailable.
+///
+/// Maintenance jobs such as checkpoints and deletes of old rows use the
+/// same shared connections as the inserts. They are run by the thread
+/// that commits the rows, between the batches, so that they are never
+/// part of an open insert transaction.
+class SQLiteWriter
+{
+    std::vector<SQLiteRecord> queue; ///< ring buffer of waiting rows
+    size_t head;                  ///< index of oldest waiting row
+    size_t count;                 ///< number of waiting rows
+    int batch;                    ///< rows to trigger commit
+    int interval;                 ///< maximum wait before commit [ms]
+    uint64_t dropped;             ///< rows dropped with full queue
+    std::atomic<uint64_t> commits; ///< number of committed transactions
+    std::mutex lock;              ///< lock for queue
+    std::condition_variable wakeup; ///< signal writer thread
+    std::thread thread;           ///< writer thread
+    std::atomic<bool> running;    ///< writer runs while true
+    std::map<SQLite *, Rollup *> rollups; ///< aggregate tables by raw table
+    std::map<SQLite *, TimeSeriesStore *> stores; ///< time series stores by replaced table
+    Spool *spool;                 ///< spool for rows or nullptr
+    Recent *recent;               ///< recent samples in memory or nullptr
+    std::map<std::string, SQLite *> tables; ///< tables by name for rows read from spool
+    std::thread replayer;         ///< replay thread when spool is used
+    std::mutex replaylock;        ///< lock for replay wakeup
+    std::condition_variable replaywakeup; ///< signal replay thread
+    std::atomic<uint64_t> spooled; ///< rows appended to spool
+    std::atomic<bool> draining;   ///< writer thread has exited
+    std::vector<std::function<void()>> jobs; ///< maintenance jobs waiting, guarded by lock
+
+    /// Run waiting maintenance jobs.
+    void RunJobs();
+
+    /// Replay rows from spool to database until Stop() is called.
+    void Replay();
+
+    /// Write rows to spool and sync it.
+    bool Append(std::vector<SQLiteRecord> & rows);
+
+    /// Flush aggregate buckets and close time series stores.
+    void Finish();
+
+    /// Encode row to spool record.
+    static void Encode(const SQLiteRecord & rec, std::string & record);
+
+    /// Decode spool record to row, return false if the table is not known.
+    bool Decode(const std::string & record, SQLiteRecord & rec);
+
+    /// Write waiting rows until Stop() is called.
+    void Run();
+
+    /// Insert rows inside one transaction for each database file, return false if database is unavailable.
+    bool Commit(std::vector<SQLiteRecord> & rows);
+
+  public:
+    /// Construct SQLiteWriter with queue size, commit batch size and interval [ms].
+    SQLiteWriter(int size, int batch, int interval);
+
+    virtual ~SQLiteWriter();
+
+    /// Get number of rows dropped because of full queue.
+    uint64_t GetDropped();
+
+    /// Get number of committed transactions.
+    uint64_t GetCommits() { return commits; }
+
+    /// Set number of rows to trigger commit.
+    void SetBatch(int batch) { this->batch = batch; }
+
+    /// Set maximum time rows wait before commit [ms].
+    void SetInterval(int interval) { this->interval = interval; }
+
+    /// Get recent samples ring of chip _name_ in table for record of chip type, nullptr without recent samples.
+    template<class R> Recent::Ring *Register(SQLite *db, const std::string & name)
+    {
+      return recent ? recent->Register(db->GetTable(), name, Schema<R>::Nd + Schema<R>::Ni) : nullptr;
+    }
+
+    /// Queue name, timestamp [us], Nd doubles and Ni integers for insert and add them to _ring_, return false if queue full.
+    bool Insert(SQLite *db, Recent::Ring *ring, std::string name, int64_t ts, int Nd, double *dbl_array, int Ni, int *int_array, int & error);
+
+    /// Queue name, timestamp [us] and N doubles for insert, return false if queue full.
+    bool Insert(SQLite *db, Recent::Ring *ring, std::string name, int64_t ts, int N, double *data, int & error) { return Insert(db, ring, name, ts, N, data, 0, nullptr, error); }
+
+    /// Queue name, timestamp [us] and N integers for insert, return false if queue full.
+    bool Insert(SQLite *db, Recent::Ring *ring, std::string name, int64_t ts, int N, int *data, int & error) { return Insert(db, ring, name, ts, 0, nullptr, N, data, error); }
+
+    /// Queue name, timestamp [us] and record of chip type for insert, return false if queue full.
+    template<class R> bool Insert(SQLite *db, Recent::Ring *ring, std::string name, int64_t ts, const R & record, int & error)
+    {
+      static_assert( Schema<R>::Nd <= SQLITEWRITER_MAX_DBL && Schema<R>::Ni <= SQLITEWRITER_MAX_INT, "too many values for SQLite writer" );
+
+      double dbl_array[ Schema<R>::Nd + 1 ];
+      int int_array[ Schema<R>::Ni + 1 ];
+
+      Schema<R>::Pack(record, dbl_array, int_array);
+
+      return Insert(db, ring, name, ts, Schema<R>::Nd, dbl_array, Schema<R>::Ni, int_array, error);
+    }
+
+    /// Update aggregate tables of raw table when its rows are written, call before Start().
+    void AddRollup(Rollup *rollup) { rollups[ rollup->GetSource() ] = rollup; }
+
+    /// Store rows of table to time series store instead of database, call before Start().
+    void AddStore(TimeSeriesStore *store) { stores[ store->GetSource() ] = store; }
+
+    /// Write rows through spool, call before Start().
+    void SetSpool(Spool *spool) { this->spool = spool; }
+
+    /// Get number of rows written to spool.
+    uint64_t GetSpooled() { return spooled; }
+
+    /// Keep queued rows also in memory, call before Register().
+    void SetRecent(Recent *recent) { this->recent = recent; }
+
+    /// Allow replay of rows to table, call before Start().
+    void AddTable(SQLite *db) { tables[ db->GetTable() ] = db; }
+
+    /// Run maintenance job on the thread that commits rows between batches.
+    void Maintain(std::function<void()> job);
+
+    /// Start writer thread.
+    void Start();
+
+    /// Stop writer thread after writing all waiting rows.
+    void Stop();
+};
+
+#endif
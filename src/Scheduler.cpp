@@ -0,0 +1,385 @@
+/**************************************************************************
+ *
+ * Scheduler class member functions for periodic chip readings.
+ *
+ * Copyright (C) 2026 Jaakko Koivuniemi.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************
+ *
+ * Sat Oct 17 15:40:12 CDT 2026
+ * Edit: Sun Oct 18 16:27:44 CDT 2026
+ *
+ * Jaakko Koivuniemi
+ **/
+
+#include "Scheduler.hpp"
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <queue>
+
+using namespace std;
+
+/// Nanoseconds since epoch of CLOCK_MONOTONIC.
+static int64_t Nanoseconds(const struct timespec & t)
+{
+  return (int64_t)t.tv_sec * 1000000000LL + t.tv_nsec;
+}
+
+/// Convert nanoseconds back to timespec.
+static struct timespec Timespec(int64_t ns)
+{
+  struct timespec t;
+
+  t.tv_sec = ns / 1000000000LL;
+  t.tv_nsec = ns % 1000000000LL;
+
+  return t;
+}
+
+/// Scheduler constructor.
+Scheduler::Scheduler()
+{
+  running = false;
+  policy = SCHEDULER_SKIP;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+}
+
+Scheduler::~Scheduler()
+{
+  Scheduler::Stop();
+  for(auto & b : buses) delete b.second;
+}
+
+/// Tasks are kept per bus so that each bus gets its own thread.
+void Scheduler::Add(std::string bus, std::string name, double period, double phase, long latency, std::function<void()> trigger, std::function<void()> collect)
+{
+  Task task;
+  Stage stage;
+
+  if( buses.find( bus ) == buses.end() )
+  {
+    buses[ bus ] = new Bus();
+    buses[ bus ]->name = bus;
+  }
+
+  if( period <= 0 ) period = 1;
+  if( phase < 0 ) phase = 0;
+
+  task.name = name;
+  task.period = period;
+  task.phase = phase;
+  stage.latency = latency;
+  stage.trigger = trigger;
+  stage.collect = collect;
+  stage.poll = 0;
+  task.stages.push_back( stage );
+  task.stats.name = name;
+
+  buses[ bus ]->tasks.push_back( task );
+
+  fprintf(stderr, SD_INFO "%s on %s every %g s, phase %g s, latency %ld us\n", name.c_str(), bus.c_str(), period, phase, latency);
+}
+
+/// Tasks are searched when added, not while running.
+Scheduler::Task *Scheduler::Find(std::string bus, std::string name)
+{
+  if( buses.find( bus ) == buses.end() ) return nullptr;
+
+  for(auto & t : buses[ bus ]->tasks)
+  {
+    if( t.name == name ) return &t;
+  }
+
+  return nullptr;
+}
+
+/// The stages of one task share its deadline and statistics.
+void Scheduler::AddStage(std::string bus, std::string name, long latency, std::function<void()> trigger, std::function<void()> collect)
+{
+  Task *task = Find(bus, name);
+  Stage stage;
+
+  if( !task )
+  {
+    fprintf(stderr, SD_ERR "%s not found on %s\n", name.c_str(), bus.c_str());
+    return;
+  }
+
+  stage.latency = latency;
+  stage.trigger = trigger;
+  stage.collect = collect;
+  stage.poll = 0;
+  task->stages.push_back( stage );
+
+  fprintf(stderr, SD_INFO "%s on %s stage %d latency %ld us\n", name.c_str(), bus.c_str(), (int)task->stages.size(), latency);
+}
+
+/// The poll interval is at least 100 us.
+void Scheduler::SetReady(std::string bus, std::string name, long poll, std::function<bool()> ready)
+{
+  Task *task = Find(bus, name);
+
+  if( !task )
+  {
+    fprintf(stderr, SD_ERR "%s not found on %s\n", name.c_str(), bus.c_str());
+    return;
+  }
+
+  if( poll < 100 ) poll = 100;
+
+  task->stages.back().ready = ready;
+  task->stages.back().poll = poll;
+
+  fprintf(stderr, SD_INFO "%s on %s polled every %ld us\n", name.c_str(), bus.c_str(), poll);
+}
+
+/// Count tasks over all buses.
+int Scheduler::GetTasks()
+{
+  int N = 0;
+
+  for(auto & b : buses) N += b.second->tasks.size();
+
+  return N;
+}
+
+/// Called before Start(), the task lists are not locked.
+double Scheduler::GetMinPeriod()
+{
+  double min = 0;
+
+  for(auto & b : buses)
+  {
+    for(auto & t : b.second->tasks)
+    {
+      if( min == 0 || t.period < min ) min = t.period;
+    }
+  }
+
+  return min;
+}
+
+/// Statistics are copied under lock of each bus.
+std::vector<SchedulerStats> Scheduler::GetStats()
+{
+  std::vector<SchedulerStats> stats;
+
+  GetStats( stats );
+
+  return stats;
+}
+
+/// Names are assigned to the existing strings so that repeated calls do
+/// not allocate once the vector has its size.
+void Scheduler::GetStats(std::vector<SchedulerStats> & stats)
+{
+  size_t n = 0;
+
+  for(auto & b : buses)
+  {
+    std::lock_guard<std::mutex> lock( b.second->statsmutex );
+    for(auto & t : b.second->tasks)
+    {
+      if( n == stats.size() ) stats.push_back( t.stats );
+      else stats[ n ] = t.stats;
+      n++;
+    }
+  }
+
+  stats.resize( n );
+}
+
+/// The phases of all tasks are counted from the same start time.
+void Scheduler::Start()
+{
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  running = true;
+
+  for(auto & b : buses)
+  {
+    b.second->thread = std::thread(&Scheduler::Run, this, b.second);
+  }
+}
+
+/// Threads notice the stop request within one second.
+void Scheduler::Stop()
+{
+  running = false;
+
+  for(auto & b : buses)
+  {
+    if( b.second->thread.joinable() ) b.second->thread.join();
+  }
+}
+
+/// Scheduler member function running all tasks of one bus.
+
+/// Events are kept in a min-heap ordered by time. A trigger event calls
+/// the trigger function and queues the collect event after the latency,
+/// so other tasks on the same bus can run while the chip converts. A
+/// collect event reads the result and queues the next trigger one period
+/// after the previous deadline, or triggers the next stage of the task and
+/// queues its collect. A collect waiting for data ready is queued again
+/// after the poll interval until the next deadline, after which the
+/// reading is skipped. Deadlines missed completely are skipped
+/// with SCHEDULER_SKIP policy or run late one after another with
+/// SCHEDULER_CATCHUP policy, up to SCHEDULER_CATCHUP_MAX periods.
+void Scheduler::Run(Bus *bus)
+{
+  struct Event
+  {
+    int64_t at;         ///< time to run event [ns]
+    int64_t deadline;   ///< trigger deadline this event belongs to [ns]
+    int64_t exec;       ///< time spent in trigger [ns]
+    size_t task;        ///< index to task
+    size_t stage;       ///< index to stage of task
+    bool collect;       ///< collect instead of trigger
+
+    bool operator>(const Event & other) const { return at > other.at; }
+  };
+
+  priority_queue<Event, vector<Event>, greater<Event> > heap;
+  struct itimerspec its = { };
+  struct timespec now;
+  uint64_t expirations = 0;
+  int64_t t0 = Nanoseconds( start ), tnow = 0, tend = 0, period = 0, missed = 0;
+  bool ready = true;
+  Event ev;
+
+  int tfd = timerfd_create(CLOCK_MONOTONIC, 0);
+  if( tfd < 0 )
+  {
+    fprintf(stderr, SD_ERR "%s failed to create timer\n", bus->name.c_str());
+    return;
+  }
+
+  for(size_t i = 0; i < bus->tasks.size(); i++)
+  {
+    ev.deadline = t0 + (int64_t)( 1e9 * bus->tasks[ i ].phase );
+    ev.at = ev.deadline;
+    ev.exec = 0;
+    ev.task = i;
+    ev.stage = 0;
+    ev.collect = false;
+    heap.push( ev );
+  }
+
+  while( running && !heap.empty() )
+  {
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    tnow = Nanoseconds( now );
+
+    if( heap.top().at > tnow )
+    {
+      // wake up at least once a second to notice Stop()
+      if( heap.top().at - tnow > 1000000000LL ) its.it_value = Timespec( tnow + 1000000000LL );
+      else its.it_value = Timespec( heap.top().at );
+
+      timerfd_settime(tfd, TFD_TIMER_ABSTIME, &its, nullptr);
+      if( read(tfd, &expirations, sizeof( expirations )) < 0 ) usleep( 1000 );
+      continue;
+    }
+
+    ev = heap.top();
+    heap.pop();
+    Task & task = bus->tasks[ ev.task ];
+
+    if( !ev.collect )
+    {
+      {
+        std::lock_guard<std::mutex> lock( bus->statsmutex );
+        task.stats.jitter = ( tnow - ev.deadline ) / 1000;
+        if( task.stats.jitter > task.stats.jittermax ) task.stats.jittermax = task.stats.jitter;
+      }
+
+      if( task.stages[ 0 ].trigger ) task.stages[ 0 ].trigger();
+
+      clock_gettime(CLOCK_MONOTONIC, &now);
+      tend = Nanoseconds( now );
+
+      ev.exec = tend - tnow;
+      ev.collect = true;
+      ev.at = tnow + 1000LL * task.stages[ 0 ].latency;
+      heap.push( ev );
+    }
+    else
+    {
+      Stage & stage = task.stages[ ev.stage ];
+      period = (int64_t)( 1e9 * task.period );
+
+      ready = !stage.ready || stage.ready();
+
+      if( !ready && tnow + 1000LL * stage.poll < ev.deadline + period )
+      {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        ev.exec += Nanoseconds( now ) - tnow;
+        ev.at = tnow + 1000LL * stage.poll;
+        heap.push( ev );
+        continue;
+      }
+
+      if( ready ) stage.collect();
+      else fprintf(stderr, SD_NOTICE "%s no data before next deadline\n", task.name.c_str());
+
+      clock_gettime(CLOCK_MONOTONIC, &now);
+      tend = Nanoseconds( now );
+
+      if( ready && ev.stage + 1 < task.stages.size() )
+      {
+        ev.stage++;
+        if( task.stages[ ev.stage ].trigger ) task.stages[ ev.stage ].trigger();
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        tend = Nanoseconds( now );
+
+        ev.exec += tend - tnow;
+        ev.at = tend + 1000LL * task.stages[ ev.stage ].latency;
+        heap.push( ev );
+        continue;
+      }
+
+      ev.deadline += period;
+      missed = 0;
+      if( ev.deadline <= tend ) missed = ( tend - ev.deadline ) / period + 1;
+
+      {
+        std::lock_guard<std::mutex> lock( bus->statsmutex );
+        task.stats.cycles++;
+        task.stats.jittermean += ( task.stats.jitter - task.stats.jittermean ) / task.stats.cycles;
+        task.stats.exectime = ( ev.exec + tend - tnow ) / 1000;
+        if( task.stats.exectime > task.stats.exectimemax ) task.stats.exectimemax = task.stats.exectime;
+        if( missed > 0 ) task.stats.overruns++;
+        if( !ready ) task.stats.skipped++;
+        if( missed > 0 && ( policy == SCHEDULER_SKIP || missed > SCHEDULER_CATCHUP_MAX ) ) task.stats.skipped += missed;
+      }
+
+      if( missed > 0 && ( policy == SCHEDULER_SKIP || missed > SCHEDULER_CATCHUP_MAX ) )
+      {
+        fprintf(stderr, SD_NOTICE "%s skip %lld missed periods\n", task.name.c_str(), (long long)missed);
+        ev.deadline += missed * period;
+      }
+      ev.at = ev.deadline;
+      ev.exec = 0;
+      ev.stage = 0;
+      ev.collect = false;
+      heap.push( ev );
+    }
+  }
+
+  close( tfd );
+}
@@ -0,0 +1,161 @@
+/**************************************************************************
+ *
+ * Scheduler class definitions and constructor.
+ *
+ * Copyright (C) 2026 Jaakko Koivuniemi.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************
+ *
+ * Sat Oct 17 15:40:12 CDT 2026
+ * Edit: Sun Oct 18 16:27:44 CDT 2026
+ *
+ * Jaakko Koivuniemi
+ **/
+
+#ifndef _SCHEDULER_HPP
+#define _SCHEDULER_HPP
+
+#include <systemd/sd-daemon.h>
+#include <time.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <mutex>
+
+#define SCHEDULER_SKIP 0       ///< skip deadlines missed completely
+#define SCHEDULER_CATCHUP 1    ///< run missed deadlines late one by one
+#define SCHEDULER_CATCHUP_MAX 10 ///< skip anyway if more periods missed
+
+/// Timing statistics of one scheduled task.
+struct SchedulerStats
+{
+  std::string name;              ///< name tag of task
+  uint64_t cycles = 0;           ///< completed trigger and collect cycles
+  uint64_t overruns = 0;         ///< cycles finished after next deadline
+  uint64_t skipped = 0;          ///< deadlines skipped without reading
+  long jitter = 0;               ///< last start delay from deadline [us]
+  long jittermax = 0;            ///< maximum start delay [us]
+  double jittermean = 0;         ///< mean start delay [us]
+  long exectime = 0;             ///< last trigger and collect time [us]
+  long exectimemax = 0;          ///< maximum execution time [us]
+};
+
+/// Deadline scheduler for periodic chip readings.
+
+/// Each task has its own period, phase offset and conversion latency.
+/// At each deadline the _trigger_ function starts a conversion and after
+/// the latency the _collect_ function reads and stores the result.
+/// Tasks on the same bus run one at a time in one thread ordered with
+/// a min-heap on CLOCK_MONOTONIC, tasks on different buses run in
+/// parallel threads. Each thread sleeps with _timerfd_ until the next
+/// absolute deadline so the readings stay on a fixed time grid. Start
+/// jitter, execution time and overruns are recorded for each task.
+///
+/// A task can have further conversions, for example humidity after
+/// temperature, which are triggered after the previous collect. A collect
+/// can wait for a data ready flag, which is polled between the events of
+/// other tasks until the next deadline of the task.
+class Scheduler
+{
+    /// One conversion of a task.
+    struct Stage
+    {
+      long latency;                  ///< conversion time [us]
+      std::function<void()> trigger; ///< start conversion, may be empty
+      std::function<void()> collect; ///< read and store result
+      std::function<bool()> ready;   ///< data ready check, may be empty
+      long poll;                     ///< data ready poll interval [us]
+    };
+
+    /// One periodic reading task.
+    struct Task
+    {
+      std::string name;              ///< name tag for log messages
+      double period;                 ///< period [s]
+      double phase;                  ///< offset of first deadline [s]
+      std::vector<Stage> stages;     ///< conversions in order
+      SchedulerStats stats;          ///< timing statistics
+    };
+
+    /// Tasks sharing one bus and the thread running them.
+    struct Bus
+    {
+      std::string name;              ///< bus device name
+      std::vector<Task> tasks;       ///< tasks on this bus
+      std::thread thread;            ///< thread running the tasks
+      std::mutex statsmutex;         ///< lock for task statistics
+    };
+
+    std::map<std::string, Bus *> buses; ///< buses by device name
+    std::atomic<bool> running;       ///< threads keep running while true
+    int policy;                      ///< policy for missed deadlines
+    struct timespec start;           ///< common time origin for phases
+
+    /// Run tasks of one bus until Stop() is called.
+    void Run(Bus *bus);
+
+    /// Find task by bus and name, return nullptr if not added.
+    Task *Find(std::string bus, std::string name);
+
+  public:
+    /// Construct empty Scheduler object.
+    Scheduler();
+
+    virtual ~Scheduler();
+
+    /// Add periodic task on bus.
+
+    /// The first deadline is _phase_ seconds after Start() and the
+    /// following ones _period_ seconds apart. The _collect_ function is
+    /// called _latency_ microseconds after _trigger_.
+    void Add(std::string bus, std::string name, double period, double phase, long latency, std::function<void()> trigger, std::function<void()> collect);
+
+    /// Add further conversion to task, triggered after the previous collect.
+    void AddStage(std::string bus, std::string name, long latency, std::function<void()> trigger, std::function<void()> collect);
+
+    /// Collect last conversion of task only when _ready_ returns true, polled every _poll_ microseconds until next deadline.
+    void SetReady(std::string bus, std::string name, long poll, std::function<bool()> ready);
+
+    /// Get number of tasks on all buses.
+    int GetTasks();
+
+    /// Get shortest period of tasks added so far [s], 0 without tasks.
+    double GetMinPeriod();
+
+    /// Set policy for missed deadlines, SCHEDULER_SKIP or SCHEDULER_CATCHUP.
+    void SetPolicy(int policy) { this->policy = policy; }
+
+    /// Get policy for missed deadlines.
+    int GetPolicy() { return policy; }
+
+    /// Get copy of timing statistics of all tasks.
+    std::vector<SchedulerStats> GetStats();
+
+    /// Copy timing statistics of all tasks to _stats_, reusing its memory.
+    void GetStats(std::vector<SchedulerStats> & stats);
+
+    /// Start one thread for each bus.
+    void Start();
+
+    /// Stop and join all threads.
+    void Stop();
+};
+
+#endif
@@ -0,0 +1,254 @@
+/**************************************************************************
+ *
+ * Channel schemas of chip types for inserts, aggregates and DIM formats.
+ *
+ * Copyright (C) 2026 Jaakko Koivuniemi.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************
+ *
+ * Sun Oct 18 00:04:51 CDT 2026
+ * Edit: Sun Oct 18 16:44:37 CDT 2026
+ *
+ * Jaakko Koivuniemi
+ **/
+
+
+#ifndef _SCHEMA_HPP
+#define _SCHEMA_HPP
+
+#include <string>
+
+/// Channel schema of a chip type, specialized for each record struct.
+
+/// A specialization has the table name, the number of double columns _Nd_
+/// and integer columns _Ni_, the column names with doubles first and
+/// Pack() to copy a record to value arrays in column order. Insert
+/// statements, aggregate columns and DIM formats are generated from it so
+/// that they can not disagree with the values written.
+template<class R> struct Schema;
+
+/// Get insert statement of record table with name, columns and :ts.
+template<class R> std::string SchemaInsert()
+{
+  std::string insert = std::string( "insert into " ) + Schema<R>::Table() + " (name";
+  std::string values = "(?";
+
+  for(int i = 0; i < Schema<R>::Nd + Schema<R>::Ni; i++)
+  {
+    insert += std::string( "," ) + Schema<R>::Columns()[ i ];
+    values += ",?";
+  }
+
+  return insert + ",ts) values " + values + ",:ts)";
+}
+
+/// Get DIM format of _Nd_ doubles followed by _Ni_ integers, for example D:9;I:4.
+inline std::string SchemaFormat(int Nd, int Ni)
+{
+  std::string format = "";
+
+  if( Nd > 0 ) format = "D:" + std::to_string( Nd );
+  if( Nd > 0 && Ni > 0 ) format += ";";
+  if( Ni > 0 ) format += "I:" + std::to_string( Ni );
+
+  return format;
+}
+
+/// Get DIM format of record.
+template<class R> std::string SchemaFormat() { return SchemaFormat(Schema<R>::Nd, Schema<R>::Ni); }
+
+/// Tmp102 temperature [C].
+struct Tmp102Record
+{
+  double temperature;
+};
+
+template<> struct Schema<Tmp102Record>
+{
+  enum { Nd = 1, Ni = 0 };
+  static const char *Table() { return "tmp102"; }
+  static const char * const *Columns() { static const char * const c[] = {"temperature"}; return c; }
+  static void Pack(const Tmp102Record & r, double *d, int *) { d[ 0 ] = r.temperature; }
+};
+
+/// Htu21d temperature [C] and relative humidity [%].
+struct Htu21dRecord
+{
+  double temperature;
+  double humidity;
+};
+
+template<> struct Schema<Htu21dRecord>
+{
+  enum { Nd = 2, Ni = 0 };
+  static const char *Table() { return "htu21d"; }
+  static const char * const *Columns() { static const char * const c[] = {"temperature", "humidity"}; return c; }
+  static void Pack(const Htu21dRecord & r, double *d, int *) { d[ 0 ] = r.temperature; d[ 1 ] = r.humidity; }
+};
+
+/// Bmp280 temperature [C] and pressure [Pa].
+struct Bmp280Record
+{
+  double temperature;
+  double pressure;
+};
+
+template<> struct Schema<Bmp280Record>
+{
+  enum { Nd = 2, Ni = 0 };
+  static const char *Table() { return "bmp280"; }
+  static const char * const *Columns() { static const char * const c[] = {"temperature", "pressure"}; return c; }
+  static void Pack(const Bmp280Record & r, double *d, int *) { d[ 0 ] = r.temperature; d[ 1 ] = r.pressure; }
+};
+
+/// Bme680 temperature [C], humidity [%], pressure [Pa], gas resistance [ohm] and status flags.
+struct Bme680Record
+{
+  double temperature;
+  double humidity;
+  double pressure;
+  double resistance;
+  int gasvalid;
+  int stable;
+};
+
+template<> struct Schema<Bme680Record>
+{
+  enum { Nd = 4, Ni = 2 };
+  static const char *Table() { return "bme680"; }
+  static const char * const *Columns() { static const char * const c[] = {"temperature", "humidity", "pressure", "resistance", "gasvalid", "stable"}; return c; }
+  static void Pack(const Bme680Record & r, double *d, int *i)
+  {
+    d[ 0 ] = r.temperature;
+    d[ 1 ] = r.humidity;
+    d[ 2 ] = r.pressure;
+    d[ 3 ] = r.resistance;
+    i[ 0 ] = r.gasvalid;
+    i[ 1 ] = r.stable;
+  }
+};
+
+/// Bh1750fvi illuminance [lx].
+struct Bh1750fviRecord
+{
+  double illuminance;
+};
+
+template<> struct Schema<Bh1750fviRecord>
+{
+  enum { Nd = 1, Ni = 0 };
+  static const char *Table() { return "bh1750fvi"; }
+  static const char * const *Columns() { static const char * const c[] = {"illuminance"}; return c; }
+  static void Pack(const Bh1750fviRecord & r, double *d, int *) { d[ 0 ] = r.illuminance; }
+};
+
+/// Lis3dh minimum, mean and maximum acceleration [g] of each axis, ADC inputs and data rate.
+struct Lis3dhRecord
+{
+  double gxmin, gx, gxmax;
+  double gymin, gy, gymax;
+  double gzmin, gz, gzmax;
+  int adc1, adc2, adc3;
+  int odr;
+};
+
+template<> struct Schema<Lis3dhRecord>
+{
+  enum { Nd = 9, Ni = 4 };
+  static const char *Table() { return "lis3dh"; }
+  static const char * const *Columns() { static const char * const c[] = {"gxmin", "gx", "gxmax", "gymin", "gy", "gymax", "gzmin", "gz", "gzmax", "adc1", "adc2", "adc3", "odr"}; return c; }
+  static void Pack(const Lis3dhRecord & r, double *d, int *i)
+  {
+    d[ 0 ] = r.gxmin;
+    d[ 1 ] = r.gx;
+    d[ 2 ] = r.gxmax;
+    d[ 3 ] = r.gymin;
+    d[ 4 ] = r.gy;
+    d[ 5 ] = r.gymax;
+    d[ 6 ] = r.gzmin;
+    d[ 7 ] = r.gz;
+    d[ 8 ] = r.gzmax;
+    i[ 0 ] = r.adc1;
+    i[ 1 ] = r.adc2;
+    i[ 2 ] = r.adc3;
+    i[ 3 ] = r.odr;
+  }
+};
+
+/// Lis2mdl magnetic field [uT] and temperature [C].
+struct Lis2mdlRecord
+{
+  double Bx, By, Bz;
+  double temperature;
+};
+
+template<> struct Schema<Lis2mdlRecord>
+{
+  enum { Nd = 4, Ni = 0 };
+  static const char *Table() { return "lis2mdl"; }
+  static const char * const *Columns() { static const char * const c[] = {"Bx", "By", "Bz", "temperature"}; return c; }
+  static void Pack(const Lis2mdlRecord & r, double *d, int *) { d[ 0 ] = r.Bx; d[ 1 ] = r.By; d[ 2 ] = r.Bz; d[ 3 ] = r.temperature; }
+};
+
+/// Lis3mdl magnetic field [uT] and temperature [C].
+struct Lis3mdlRecord
+{
+  double Bx, By, Bz;
+  double temperature;
+};
+
+template<> struct Schema<Lis3mdlRecord>
+{
+  enum { Nd = 4, Ni = 0 };
+  static const char *Table() { return "lis3mdl"; }
+  static const char * const *Columns() { static const char * const c[] = {"Bx", "By", "Bz", "temperature"}; return c; }
+  static void Pack(const Lis3mdlRecord & r, double *d, int *) { d[ 0 ] = r.Bx; d[ 1 ] = r.By; d[ 2 ] = r.Bz; d[ 3 ] = r.temperature; }
+};
+
+/// Max31865 temperature [C], resistance [ohm] and fault status byte.
+struct Max31865Record
+{
+  double temperature;
+  double resistance;
+  int fault;
+};
+
+template<> struct Schema<Max31865Record>
+{
+  enum { Nd = 2, Ni = 1 };
+  static const char *Table() { return "max31865"; }
+  static const char * const *Columns() { static const char * const c[] = {"temperature", "resistance", "fault"}; return c; }
+  static void Pack(const Max31865Record & r, double *d, int *i) { d[ 0 ] = r.temperature; d[ 1 ] = r.resistance; i[ 0 ] = r.fault; }
+};
+
+/// Pca9535 input, output, polarity inversion and configuration registers.
+struct Pca9535Record
+{
+  int inputs;
+  int outputs;
+  int inversions;
+  int portconfigs;
+};
+
+template<> struct Schema<Pca9535Record>
+{
+  enum { Nd = 0, Ni = 4 };
+  static const char *Table() { return "pca9535"; }
+  static const char * const *Columns() { static const char * const c[] = {"inputs", "outputs", "inversions", "portconfigs"}; return c; }
+  static void Pack(const Pca9535Record & r, double *, int *i) { i[ 0 ] = r.inputs; i[ 1 ] = r.outputs; i[ 2 ] = r.inversions; i[ 3 ] = r.portconfigs; }
+};
+
+#endif
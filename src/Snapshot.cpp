@@ -0,0 +1,208 @@
+/**************************************************************************
+ *
+ * Snapshot class member functions for shared memory of latest values.
+ *
+ * Copyright (C) 2026 Jaakko Koivuniemi.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************
+ *
+ * Sun Oct 18 10:02:51 CDT 2026
+ * Edit: Sun Oct 18 12:34:09 CDT 2026
+ *
+ * Jaakko Koivuniemi
+ **/
+
+
+
+#include "Snapshot.hpp"
+#include <errno.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+
+using namespace std;
+
+/// Snapshot constructor to initialize all parameters.
+Snapshot::Snapshot(std::string shm)
+{
+  this->shm = shm;
+  this->header = nullptr;
+  this->channels = nullptr;
+  this->size = 0;
+}
+
+Snapshot::~Snapshot()
+{
+  Close();
+}
+
+/// Names longer than the channel name field are truncated.
+int Snapshot::Add(std::string name)
+{
+  if( header ) return -1;
+
+  if( name.length() >= I2CHIPD_SNAPSHOT_NAME ) name.resize( I2CHIPD_SNAPSHOT_NAME - 1 );
+  names.push_back( name );
+
+  return names.size() - 1;
+}
+
+/// Snapshot member function to create shared memory segment.
+
+/// A segment left from an earlier run is marked closed and removed so that
+/// its readers open the new one, readers which still have it mapped are not
+/// affected by the new size. The magic number is written last.
+bool Snapshot::Open(int & error)
+{
+  int fd = shm_open(shm.c_str(), O_RDWR, 0);
+  if( fd >= 0 )
+  {
+    struct stat st;
+    if( fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof( struct i2chipd_snapshot_header ) )
+    {
+      void *old = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      if( old != MAP_FAILED )
+      {
+        __atomic_store_n(&( (struct i2chipd_snapshot_header *)old )->closed, 1, __ATOMIC_RELEASE);
+        munmap(old, st.st_size);
+      }
+    }
+    close( fd );
+    shm_unlink( shm.c_str() );
+  }
+
+  size = sizeof( struct i2chipd_snapshot_header ) + names.size() * sizeof( struct i2chipd_snapshot_channel );
+
+  fd = shm_open(shm.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+  if( fd < 0 )
+  {
+    fprintf(stderr, SD_ERR "can not create shared memory %s: %s\n", shm.c_str(), strerror( errno ));
+    error = errno;
+    return false;
+  }
+
+  if( ftruncate(fd, size) < 0 )
+  {
+    fprintf(stderr, SD_ERR "can not resize shared memory %s: %s\n", shm.c_str(), strerror( errno ));
+    error = errno;
+    close( fd );
+    shm_unlink( shm.c_str() );
+    return false;
+  }
+
+  void *map = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close( fd );
+  if( map == MAP_FAILED )
+  {
+    fprintf(stderr, SD_ERR "can not map shared memory %s: %s\n", shm.c_str(), strerror( errno ));
+    error = errno;
+    shm_unlink( shm.c_str() );
+    return false;
+  }
+
+  struct i2chipd_snapshot_header *h = (struct i2chipd_snapshot_header *)map;
+  struct i2chipd_snapshot_channel *c = (struct i2chipd_snapshot_channel *)( h + 1 );
+
+  for(size_t i = 0; i < names.size(); i++)
+  {
+    strncpy(c[ i ].name, names[ i ].c_str(), I2CHIPD_SNAPSHOT_NAME - 1);
+    c[ i ].ts = 0;
+    c[ i ].value = 0;
+  }
+
+  h->version = I2CHIPD_SNAPSHOT_VERSION;
+  h->size = size;
+  h->channels = names.size();
+  h->channelsize = sizeof( struct i2chipd_snapshot_channel );
+  h->closed = 0;
+  h->seq = 0;
+  h->updated = 0;
+  h->writes = 0;
+  __atomic_store_n(&h->magic, I2CHIPD_SNAPSHOT_MAGIC, __ATOMIC_RELEASE);
+
+  lock.lock();
+  header = h;
+  channels = c;
+  lock.unlock();
+
+  return true;
+}
+
+/// The sequence number is odd while the channel is written.
+void Snapshot::Set(int channel, double value)
+{
+  struct timespec now;
+
+  if( channel < 0 ) return;
+
+  clock_gettime(CLOCK_REALTIME, &now);
+  int64_t ts = (int64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+
+  std::lock_guard<std::mutex> guard( lock );
+
+  if( !header || channel >= (int)header->channels ) return;
+
+  uint64_t seq = header->seq;
+  __atomic_store_n(&header->seq, seq + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence( __ATOMIC_RELEASE );
+
+  channels[ channel ].value = value;
+  channels[ channel ].ts = ts;
+  header->updated = ts;
+  header->writes++;
+
+  __atomic_store_n(&header->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+/// Readers in the same process use the header without the writer lock,
+/// so they must stop before Close().
+uint64_t Snapshot::GetSeq()
+{
+  return header ? __atomic_load_n(&header->seq, __ATOMIC_ACQUIRE) : 0;
+}
+
+uint64_t Snapshot::Read(std::vector<struct i2chipd_snapshot_channel> & copy)
+{
+  uint64_t seq = 0;
+
+  if( !header ) return 0;
+
+  copy.resize( header->channels );
+  i2chipd_snapshot_read(header, copy.data(), copy.size(), &seq);
+
+  return seq;
+}
+
+uint64_t Snapshot::GetWrites()
+{
+  std::lock_guard<std::mutex> guard( lock );
+
+  return header ? header->writes : 0;
+}
+
+void Snapshot::Close()
+{
+  std::lock_guard<std::mutex> guard( lock );
+
+  if( !header ) return;
+
+  __atomic_store_n(&header->closed, 1, __ATOMIC_RELEASE);
+  munmap(header, size);
+  shm_unlink( shm.c_str() );
+
+  header = nullptr;
+  channels = nullptr;
+}
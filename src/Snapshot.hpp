@@ -0,0 +1,90 @@
+/**************************************************************************
+ *
+ * Snapshot class definitions and constructor.
+ *
+ * Copyright (C) 2026 Jaakko Koivuniemi.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************
+ *
+ * Sun Oct 18 10:02:51 CDT 2026
+ * Edit: Sun Oct 18 12:34:09 CDT 2026
+ *
+ * Jaakko Koivuniemi
+ **/
+
+
+
+#ifndef _SNAPSHOT_HPP
+#define _SNAPSHOT_HPP
+
+#include <systemd/sd-daemon.h>
+#include "i2chipd_snapshot.h"
+#include <string>
+#include <vector>
+#include <mutex>
+#include <stdint.h>
+
+/// Latest values of all channels in one shared memory segment.
+
+/// Channels are added before Open() creates the segment, the layout is
+/// defined in _i2chipd_snapshot.h_ together with the functions readers
+/// use. Writers of different threads are serialized with a mutex and the
+/// sequence number in the header lets readers copy all channels without
+/// locking.
+class Snapshot
+{
+    std::string shm;              ///< shared memory name
+    std::vector<std::string> names; ///< channel names
+    struct i2chipd_snapshot_header *header; ///< mapped segment or nullptr
+    struct i2chipd_snapshot_channel *channels; ///< channels after header
+    size_t size;                  ///< segment size [bytes]
+    std::mutex lock;              ///< lock for writers
+
+  public:
+    /// Construct Snapshot with shared memory name.
+    Snapshot(std::string shm);
+
+    virtual ~Snapshot();
+
+    /// Add channel before Open() and return its index, -1 if already open.
+    int Add(std::string name);
+
+    /// Create shared memory segment with all channels.
+    bool Open(int & error);
+
+    /// Write value of channel with current time.
+    void Set(int channel, double value);
+
+    /// Mark segment closed for readers and remove it.
+    void Close();
+
+    /// Get sequence number, changes with every write.
+    uint64_t GetSeq();
+
+    /// Copy all channels, reusing memory of _copy_, and return sequence number of the copy.
+    uint64_t Read(std::vector<struct i2chipd_snapshot_channel> & copy);
+
+    /// Get name of channel.
+    std::string GetName(int channel) { return names[ channel ]; }
+
+    /// Get number of channels.
+    size_t GetChannels() { return names.size(); }
+
+    /// Get number of values written.
+    uint64_t GetWrites();
+};
+
+#endif
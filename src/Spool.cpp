@@ -0,0 +1,385 @@
+/**************************************************************************
+ *
+ * Spool class member functions for append-only sample log.
+ *
+ * Copyright (C) 2026 Jaakko Koivuniemi.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************
+ *
+ * Sat Oct 17 23:02:37 CDT 2026
+ * Edit: Sat Oct 17 23:02:37 CDT 2026
+ *
+ * Jaakko Koivuniemi
+ **/
+
+
+#include "Spool.hpp"
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <errno.h>
+#include <string.h>
+#include <stdio.h>
+#include <fstream>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+/// CRC-32 of data, same polynomial as zlib.
+static uint32_t Crc32(const char *data, size_t length)
+{
+  static uint32_t table[ 256 ] = { 0 };
+
+  if( table[ 1 ] == 0 )
+  {
+    for(uint32_t i = 0; i < 256; i++)
+    {
+      uint32_t c = i;
+      for(int k = 0; k < 8; k++) c = ( c & 1 ) ? 0xEDB88320 ^ ( c >> 1 ) : c >> 1;
+      table[ i ] = c;
+    }
+  }
+
+  uint32_t crc = 0xFFFFFFFF;
+  for(size_t i = 0; i < length; i++) crc = table[ ( crc ^ (uint8_t)data[ i ] ) & 0xFF ] ^ ( crc >> 8 );
+
+  return crc ^ 0xFFFFFFFF;
+}
+
+/// Spool constructor.
+Spool::Spool(std::string dir, uint64_t maxsize)
+{
+  this->dir = dir;
+  this->maxsize = maxsize;
+  wfd = -1;
+  wseq = 1;
+  wsize = 0;
+  total = 0;
+  rfd = -1;
+  rseq = 1;
+  roff = 0;
+  pseq = 1;
+  poff = 0;
+}
+
+Spool::~Spool()
+{
+  if( wfd >= 0 )
+  {
+    fdatasync( wfd );
+    close( wfd );
+  }
+  if( rfd >= 0 ) close( rfd );
+}
+
+/// Sequence number is printed with fixed width so that files sort in order.
+std::string Spool::GetFile(uint64_t seq)
+{
+  char name[ 32 ] = "";
+
+  snprintf(name, sizeof( name ), "spool-%016llu.log", (unsigned long long)seq);
+
+  return dir + "/" + name;
+}
+
+/// The directory is synced so that the new file survives a power loss.
+bool Spool::NewSegment(int & error)
+{
+  std::string file = GetFile( wseq );
+
+  wfd = open(file.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+  if( wfd < 0 )
+  {
+    fprintf(stderr, SD_ERR "can not create %s: %s\n", file.c_str(), strerror( errno ));
+    error = errno;
+    return false;
+  }
+
+  int dfd = open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+  if( dfd >= 0 )
+  {
+    fsync( dfd );
+    close( dfd );
+  }
+
+  wsize = 0;
+  fprintf(stderr, SD_DEBUG "spool segment %s\n", file.c_str());
+
+  return true;
+}
+
+/// Spool member function to find segments left from earlier runs.
+
+/// Reading starts from the saved replay offset, or from the first segment
+/// if there is no offset, so records spooled before a crash or stop are
+/// replayed first. A missing segment is skipped when read.
+bool Spool::Open(int & error)
+{
+  std::vector<uint64_t> seqs;
+  struct stat st;
+
+  if( mkdir(dir.c_str(), 0755) < 0 && errno != EEXIST )
+  {
+    fprintf(stderr, SD_ERR "can not create %s: %s\n", dir.c_str(), strerror( errno ));
+    error = errno;
+    return false;
+  }
+
+  DIR *d = opendir( dir.c_str() );
+  if( !d )
+  {
+    fprintf(stderr, SD_ERR "can not read directory %s: %s\n", dir.c_str(), strerror( errno ));
+    error = errno;
+    return false;
+  }
+
+  struct dirent *entry;
+  unsigned long long seq = 0;
+  while( ( entry = readdir( d ) ) != nullptr )
+  {
+    std::string name = entry->d_name;
+
+    if( name.length() == 26 && sscanf(name.c_str(), "spool-%16llu.log", &seq) == 1 )
+    {
+      seqs.push_back( seq );
+      if( stat(( dir + "/" + name ).c_str(), &st) == 0 ) total += st.st_size;
+    }
+  }
+
+  closedir( d );
+
+  std::sort(seqs.begin(), seqs.end());
+
+  unsigned long long s = 0, o = 0;
+  ifstream offset( dir + "/spool.offset" );
+  if( offset >> s >> o )
+  {
+    pseq = s;
+    poff = o;
+  }
+  else if( !seqs.empty() )
+  {
+    pseq = seqs.front();
+    poff = 0;
+  }
+
+  wseq = seqs.empty() ? pseq : seqs.back() + 1;
+  if( wseq < pseq ) wseq = pseq;
+  if( !seqs.empty() && seqs.back() >= pseq && wseq == seqs.back() ) wseq++;
+
+  rseq = pseq;
+  roff = poff;
+
+  if( total > 0 ) fprintf(stderr, SD_NOTICE "spool has %llu bytes to replay\n", (unsigned long long)GetBacklog());
+
+  return NewSegment( error );
+}
+
+/// Records are written with one write() call after a header with length and CRC-32.
+bool Spool::Append(const std::string & record, int & error)
+{
+  uint32_t header[ 2 ] = {(uint32_t)record.size(), Crc32(record.data(), record.size())};
+  std::string buf( (const char *)header, sizeof( header ) );
+  buf += record;
+
+  {
+    std::lock_guard<std::mutex> guard( lock );
+
+    if( total + buf.size() > maxsize )
+    {
+      error = ENOSPC;
+      return false;
+    }
+  }
+
+  if( wfd >= 0 && wsize >= SPOOL_SEGMENT_SIZE )
+  {
+    fdatasync( wfd );
+    close( wfd );
+    wfd = -1;
+
+    std::lock_guard<std::mutex> guard( lock );
+    wseq++;
+    if( !NewSegment( error ) ) return false;
+  }
+
+  if( wfd < 0 )
+  {
+    error = EBADF;
+    return false;
+  }
+
+  size_t done = 0;
+  while( done < buf.size() )
+  {
+    ssize_t n = write(wfd, buf.data() + done, buf.size() - done);
+
+    if( n < 0 && errno == EINTR ) continue;
+    if( n <= 0 )
+    {
+      fprintf(stderr, SD_ERR "spool write failed: %s\n", strerror( errno ));
+      error = errno;
+      return false;
+    }
+    done += n;
+  }
+
+  std::lock_guard<std::mutex> guard( lock );
+  wsize += buf.size();
+  total += buf.size();
+
+  return true;
+}
+
+/// Only data is synced, file size changes are written with it.
+bool Spool::Sync(int & error)
+{
+  if( wfd < 0 ) return false;
+
+  if( fdatasync( wfd ) < 0 )
+  {
+    fprintf(stderr, SD_ERR "spool sync failed: %s\n", strerror( errno ));
+    error = errno;
+    return false;
+  }
+
+  return true;
+}
+
+/// Spool member function to read next record.
+
+/// The segment being written is read only up to its last complete record.
+/// In older segments a record failing the length or CRC check, for example
+/// torn by a crash, ends the segment.
+bool Spool::Read(std::string & record)
+{
+  while( true )
+  {
+    uint64_t ws, wz;
+    {
+      std::lock_guard<std::mutex> guard( lock );
+      ws = wseq;
+      wz = wsize;
+    }
+
+    if( rseq > ws ) return false;
+
+    uint64_t end = ( rseq == ws ) ? wz : UINT64_MAX;
+
+    if( rfd < 0 )
+    {
+      rfd = open(GetFile( rseq ).c_str(), O_RDONLY);
+      if( rfd < 0 )
+      {
+        if( rseq == ws ) return false;
+        rseq++;
+        roff = 0;
+        continue;
+      }
+    }
+
+    uint32_t header[ 2 ];
+    if( roff + sizeof( header ) <= end && pread(rfd, header, sizeof( header ), roff) == sizeof( header ) )
+    {
+      if( header[ 0 ] <= SPOOL_SEGMENT_SIZE && roff + sizeof( header ) + header[ 0 ] <= end )
+      {
+        record.resize( header[ 0 ] );
+        if( pread(rfd, &record[ 0 ], header[ 0 ], roff + sizeof( header )) == (ssize_t)header[ 0 ] && Crc32(record.data(), record.size()) == header[ 1 ] )
+        {
+          roff += sizeof( header ) + header[ 0 ];
+          return true;
+        }
+      }
+
+      if( rseq == ws ) return false;
+      fprintf(stderr, SD_WARNING "spool segment %s damaged at %llu, rest skipped\n", GetFile( rseq ).c_str(), (unsigned long long)roff);
+    }
+
+    if( rseq == ws ) return false;
+
+    close( rfd );
+    rfd = -1;
+    rseq++;
+    roff = 0;
+  }
+}
+
+/// Records after the saved offset are read again.
+void Spool::Rewind()
+{
+  if( rfd >= 0 && rseq != pseq )
+  {
+    close( rfd );
+    rfd = -1;
+  }
+
+  rseq = pseq;
+  roff = poff;
+}
+
+/// Spool member function to save replay offset.
+
+/// The offset file is replaced with rename. Without sync a power loss can
+/// bring back an older offset, and some records are replayed twice.
+bool Spool::Commit(int & error)
+{
+  std::string file = dir + "/spool.offset";
+  FILE *f = fopen(( file + ".tmp" ).c_str(), "w");
+
+  if( !f )
+  {
+    fprintf(stderr, SD_ERR "can not write %s.tmp: %s\n", file.c_str(), strerror( errno ));
+    error = errno;
+    return false;
+  }
+
+  fprintf(f, "%llu %llu\n", (unsigned long long)rseq, (unsigned long long)roff);
+  fclose( f );
+
+  if( rename(( file + ".tmp" ).c_str(), file.c_str()) < 0 )
+  {
+    fprintf(stderr, SD_ERR "can not rename %s.tmp: %s\n", file.c_str(), strerror( errno ));
+    error = errno;
+    return false;
+  }
+
+  for(uint64_t s = pseq; s < rseq; s++)
+  {
+    struct stat st;
+    std::string old = GetFile( s );
+
+    if( stat(old.c_str(), &st) == 0 && unlink( old.c_str() ) == 0 )
+    {
+      std::lock_guard<std::mutex> guard( lock );
+      total -= st.st_size;
+    }
+  }
+
+  pseq = rseq;
+  poff = roff;
+
+  return true;
+}
+
+/// Bytes before the offset in the first segment are counted as replayed.
+uint64_t Spool::GetBacklog()
+{
+  std::lock_guard<std::mutex> guard( lock );
+
+  return total > poff ? total - poff : 0;
+}
@@ -0,0 +1,99 @@
+/**************************************************************************
+ *
+ * Spool class definitions and constructor.
+ *
+ * Copyright (C) 2026 Jaakko Koivuniemi.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************
+ *
+ * Sat Oct 17 23:02:37 CDT 2026
+ * Edit: Sat Oct 17 23:02:37 CDT 2026
+ *
+ * Jaakko Koivuniemi
+ **/
+
+
+#ifndef _SPOOL_HPP
+#define _SPOOL_HPP
+
+#include <systemd/sd-daemon.h>
+#include <string>
+#include <mutex>
+#include <stdint.h>
+
+#define SPOOL_SEGMENT_SIZE 4194304 ///< size to start new segment file [bytes]
+
+/// Append-only spool of records on local disk.
+
+/// Records are appended to segment files _dir/spool-seq.log_ with their
+/// length and CRC-32, and synced to disk once per batch with Sync(). A
+/// reader takes the records in order with Read() and marks them done
+/// with Commit(), which saves the replay offset to _dir/spool.offset_ and
+/// removes fully replayed segments. After a failure Rewind() returns to
+/// the saved offset so the records are read again. A record torn by a
+/// crash fails its CRC check and ends its segment, and writing continues
+/// in a new segment after restart. Append() and Sync() are called from
+/// one thread and Read(), Rewind() and Commit() from another.
+class Spool
+{
+    std::string dir;           ///< directory of segment files
+    uint64_t maxsize;          ///< maximum total size of segments [bytes]
+    std::mutex lock;           ///< lock for write position and size
+    int wfd;                   ///< segment file open for writing or -1
+    uint64_t wseq;             ///< sequence number of write segment
+    uint64_t wsize;            ///< bytes in write segment
+    uint64_t total;            ///< bytes in all segments
+    int rfd;                   ///< segment file open for reading or -1
+    uint64_t rseq;             ///< sequence number of read segment
+    uint64_t roff;             ///< read offset in read segment
+    uint64_t pseq;             ///< sequence number of replay offset
+    uint64_t poff;             ///< saved replay offset
+
+    /// Get segment file name of sequence number.
+    std::string GetFile(uint64_t seq);
+
+    /// Open new segment for writing, return true in success.
+    bool NewSegment(int & error);
+
+  public:
+    /// Construct Spool in directory with maximum total size [bytes].
+    Spool(std::string dir, uint64_t maxsize);
+
+    virtual ~Spool();
+
+    /// Create directory, read replay offset and start new segment, return true in success.
+    bool Open(int & error);
+
+    /// Append record, return false if write failed or spool is full.
+    bool Append(const std::string & record, int & error);
+
+    /// Sync appended records to disk, return true in success.
+    bool Sync(int & error);
+
+    /// Read next record to _record_, return false if there is none.
+    bool Read(std::string & record);
+
+    /// Return to saved replay offset.
+    void Rewind();
+
+    /// Save read position as replay offset and remove replayed segments, return true in success.
+    bool Commit(int & error);
+
+    /// Get bytes in segments not yet replayed.
+    uint64_t GetBacklog();
+};
+
+#endif
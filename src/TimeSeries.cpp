@@ -0,0 +1,301 @@
+/**************************************************************************
+ *
+ * TimeSeries class member functions for compressed segment files.
+ *
+ * Copyright (C) 2026 Jaakko Koivuniemi.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************
+ *
+ * Sat Oct 17 22:05:18 CDT 2026
+ * Edit: Sat Oct 17 22:05:18 CDT 2026
+ *
+ * Jaakko Koivuniemi
+ **/
+
+
+#include "TimeSeries.hpp"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <errno.h>
+#include <string.h>
+#include <stdio.h>
+
+using namespace std;
+
+/// TimeSeries constructor, segment is opened on first point.
+TimeSeries::TimeSeries(std::string dir, std::string channel)
+{
+  this->dir = dir;
+  this->channel = channel;
+  fd = -1;
+  map = nullptr;
+  segment = nullptr;
+  block = nullptr;
+  bits.data = nullptr;
+  bits.pos = 0;
+  delta = 0;
+  value = 0;
+  leading = -1;
+  trailing = 0;
+}
+
+TimeSeries::~TimeSeries()
+{
+  TimeSeries::Close();
+}
+
+/// Timestamp is printed with fixed width so that file names sort in time order.
+std::string TimeSeries::GetFile(std::string dir, std::string channel, int64_t first)
+{
+  char stamp[ 24 ] = "";
+
+  snprintf(stamp, sizeof( stamp ), "%016lld", (long long)first);
+
+  return dir + "/" + channel + "-" + stamp + ".tss";
+}
+
+/// TimeSeries member function to map segment file.
+
+/// A new file is created sparse with the maximum size, so only the used
+/// pages take space on disk. Bytes after the used size of an old segment
+/// are cleared since the bit stream is written by setting bits.
+bool TimeSeries::Map(std::string file, bool create, int & error)
+{
+  fd = open(file.c_str(), create ? O_RDWR | O_CREAT | O_EXCL : O_RDWR, 0644);
+  if( fd < 0 )
+  {
+    fprintf(stderr, SD_ERR "can not open %s: %s\n", file.c_str(), strerror( errno ));
+    error = errno;
+    return false;
+  }
+
+  struct stat st;
+  if( fstat(fd, &st) < 0 || ( !create && st.st_size < (off_t)sizeof( TimeSeriesSegment ) ) || ftruncate(fd, TIMESERIES_SEGMENT_SIZE) < 0 )
+  {
+    fprintf(stderr, SD_ERR "can not size %s: %s\n", file.c_str(), strerror( errno ));
+    error = errno ? errno : EINVAL;
+    close( fd );
+    fd = -1;
+    return false;
+  }
+
+  void *m = mmap(nullptr, TIMESERIES_SEGMENT_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if( m == MAP_FAILED )
+  {
+    fprintf(stderr, SD_ERR "can not map %s: %s\n", file.c_str(), strerror( errno ));
+    error = errno;
+    close( fd );
+    fd = -1;
+    return false;
+  }
+
+  map = (uint8_t *)m;
+  segment = (TimeSeriesSegment *)map;
+  block = nullptr;
+
+  if( !create ) memset(map + segment->size, 0, TIMESERIES_SEGMENT_SIZE - segment->size);
+
+  fprintf(stderr, SD_DEBUG "%s segment %s at %u bytes\n", channel.c_str(), file.c_str(), segment->size);
+
+  return true;
+}
+
+/// TimeSeries member function to open segment for new points.
+
+/// The latest segment of the channel is continued with a new block if it
+/// has space, for example after restart. Otherwise a new segment starting
+/// at _ts_ is created.
+bool TimeSeries::OpenSegment(int64_t ts, int & error)
+{
+  std::string prefix = channel + "-", latest = "";
+
+  DIR *d = opendir( dir.c_str() );
+  if( !d )
+  {
+    fprintf(stderr, SD_ERR "can not read directory %s: %s\n", dir.c_str(), strerror( errno ));
+    error = errno;
+    return false;
+  }
+
+  struct dirent *entry;
+  while( ( entry = readdir( d ) ) != nullptr )
+  {
+    std::string name = entry->d_name;
+
+    if( name.length() != prefix.length() + 20 || name.compare(0, prefix.length(), prefix) != 0 ) continue;
+    if( name.compare(name.length() - 4, 4, ".tss") != 0 ) continue;
+    if( name > latest ) latest = name;
+  }
+
+  closedir( d );
+
+  if( latest != "" )
+  {
+    int fdold = open(( dir + "/" + latest ).c_str(), O_RDONLY);
+    TimeSeriesSegment head;
+    bool space = false;
+
+    if( fdold >= 0 )
+    {
+      if( read(fdold, &head, sizeof( head )) == sizeof( head ) && head.magic == TIMESERIES_MAGIC && head.version == TIMESERIES_VERSION )
+      {
+        space = ( head.size + 8 + sizeof( TimeSeriesBlock ) + TIMESERIES_POINT_MAX <= TIMESERIES_SEGMENT_SIZE );
+      }
+      close( fdold );
+    }
+
+    if( space ) return Map(dir + "/" + latest, false, error);
+  }
+
+  if( !Map(GetFile(dir, channel, ts), true, error) ) return false;
+
+  segment->magic = TIMESERIES_MAGIC;
+  segment->version = TIMESERIES_VERSION;
+  segment->size = sizeof( TimeSeriesSegment );
+  segment->blocks = 0;
+  segment->first = ts;
+  segment->last = ts;
+
+  return true;
+}
+
+/// Blocks start at 8 byte boundary for aligned access to their headers.
+void TimeSeries::StartBlock(int64_t ts, double v)
+{
+  segment->size = ( segment->size + 7 ) & ~7U;
+
+  block = (TimeSeriesBlock *)( map + segment->size );
+  block->count = 1;
+  block->bits = 0;
+  block->first = ts;
+  block->last = ts;
+  block->value = v;
+
+  bits.data = (uint8_t *)( block + 1 );
+  bits.pos = 0;
+  delta = 0;
+  memcpy(&value, &v, sizeof( value ));
+  leading = -1;
+  trailing = 0;
+
+  segment->size += sizeof( TimeSeriesBlock );
+  segment->blocks++;
+  segment->last = ts;
+}
+
+/// TimeSeries member function to encode one point.
+
+/// The difference of successive timestamp differences is written with a
+/// prefix selecting its bit length, 0 for a point exactly one period after
+/// the previous. The value is XORed with the previous value and only the
+/// bits between leading and trailing zeros are written, reusing the
+/// previous bit window when the new bits fit in it.
+bool TimeSeries::Append(int64_t ts, double v, int & error)
+{
+  if( !map && !OpenSegment(ts, error) ) return false;
+
+  if( !block || block->count >= TIMESERIES_BLOCK_POINTS || segment->size + TIMESERIES_POINT_MAX > TIMESERIES_SEGMENT_SIZE )
+  {
+    if( segment->size + 8 + sizeof( TimeSeriesBlock ) + TIMESERIES_POINT_MAX > TIMESERIES_SEGMENT_SIZE )
+    {
+      Close();
+      if( !OpenSegment(ts, error) ) return false;
+    }
+
+    StartBlock(ts, v);
+
+    return true;
+  }
+
+  int64_t d = ts - block->last;
+  int64_t dod = d - delta;
+  delta = d;
+
+  if( dod == 0 ) bits.Put(0, 1);
+  else if( dod >= -64 && dod <= 63 ) { bits.Put(2, 2); bits.Put(dod, 7); }
+  else if( dod >= -256 && dod <= 255 ) { bits.Put(6, 3); bits.Put(dod, 9); }
+  else if( dod >= -2048 && dod <= 2047 ) { bits.Put(14, 4); bits.Put(dod, 12); }
+  else if( dod >= -524288 && dod <= 524287 ) { bits.Put(30, 5); bits.Put(dod, 20); }
+  else { bits.Put(31, 5); bits.Put(dod, 64); }
+
+  uint64_t next;
+  memcpy(&next, &v, sizeof( next ));
+  uint64_t x = next ^ value;
+
+  if( x == 0 ) bits.Put(0, 1);
+  else
+  {
+    int lead = __builtin_clzll( x );
+    int trail = __builtin_ctzll( x );
+
+    if( lead > 31 ) lead = 31;
+
+    if( leading >= 0 && lead >= leading && trail >= trailing )
+    {
+      bits.Put(2, 2);
+      bits.Put(x >> trailing, 64 - leading - trailing);
+    }
+    else
+    {
+      int significant = 64 - lead - trail;
+
+      bits.Put(3, 2);
+      bits.Put(lead, 5);
+      bits.Put(significant & 63, 6);
+      bits.Put(x >> trail, significant);
+      leading = lead;
+      trailing = trail;
+    }
+  }
+  value = next;
+
+  block->count++;
+  block->bits = bits.pos;
+  block->last = ts;
+  segment->size = ( bits.data - map ) + ( bits.pos + 7 ) / 8;
+  segment->last = ts;
+
+  return true;
+}
+
+/// Without waiting the kernel writes the pages in background.
+void TimeSeries::Sync(bool wait)
+{
+  if( !map ) return;
+
+  msync(map, segment->size, wait ? MS_SYNC : MS_ASYNC);
+}
+
+/// The segment is continued with a new block when opened again.
+void TimeSeries::Close()
+{
+  if( !map ) return;
+
+  uint32_t size = segment->size;
+
+  msync(map, size, MS_SYNC);
+  munmap(map, TIMESERIES_SEGMENT_SIZE);
+  if( ftruncate(fd, size) < 0 ) fprintf(stderr, SD_WARNING "%s segment not truncated: %s\n", channel.c_str(), strerror( errno ));
+  close( fd );
+
+  fd = -1;
+  map = nullptr;
+  segment = nullptr;
+  block = nullptr;
+}
@@ -0,0 +1,163 @@
+/**************************************************************************
+ *
+ * TimeSeries class definitions and constructor.
+ *
+ * Copyright (C) 2026 Jaakko Koivuniemi.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************
+ *
+ * Sat Oct 17 22:05:18 CDT 2026
+ * Edit: Sat Oct 17 22:05:18 CDT 2026
+ *
+ * Jaakko Koivuniemi
+ **/
+
+
+#ifndef _TIMESERIES_HPP
+#define _TIMESERIES_HPP
+
+#include <systemd/sd-daemon.h>
+#include <string>
+#include <stdint.h>
+
+#define TIMESERIES_MAGIC 0x53543249      ///< "I2TS" at start of segment file
+#define TIMESERIES_VERSION 1             ///< segment format version
+#define TIMESERIES_SEGMENT_SIZE 1048576  ///< maximum size of segment file [bytes]
+#define TIMESERIES_BLOCK_POINTS 1024     ///< maximum points in one block
+#define TIMESERIES_POINT_MAX 20          ///< maximum encoded size of one point [bytes]
+
+/// Header at start of segment file.
+struct TimeSeriesSegment
+{
+  uint32_t magic;      ///< TIMESERIES_MAGIC
+  uint32_t version;    ///< TIMESERIES_VERSION
+  uint32_t size;       ///< bytes used including this header
+  uint32_t blocks;     ///< number of blocks
+  int64_t first;       ///< first timestamp [us]
+  int64_t last;        ///< last timestamp [us]
+};
+
+/// Header of one block, followed by the encoded bit stream.
+
+/// The block headers form a sparse index of the segment. Blocks are
+/// independent of each other, so a reader can start decoding at any block
+/// and a writer can continue a segment with a new block after restart.
+struct TimeSeriesBlock
+{
+  uint32_t count;      ///< number of points
+  uint32_t bits;       ///< length of bit stream [bits]
+  int64_t first;       ///< timestamp of first point [us]
+  int64_t last;        ///< timestamp of last point [us]
+  double value;        ///< value of first point
+};
+
+/// Writer of bits to zeroed memory, most significant bit first.
+struct TimeSeriesBits
+{
+  uint8_t *data;       ///< start of bit stream
+  uint32_t pos;        ///< next bit to write or read
+
+  /// Write _n_ lowest bits of _value_.
+  void Put(uint64_t value, int n)
+  {
+    while( n > 0 )
+    {
+      int free = 8 - ( pos & 7 );
+      int take = n < free ? n : free;
+
+      data[ pos >> 3 ] |= ( ( value >> ( n - take ) ) & ( ( 1U << take ) - 1 ) ) << ( free - take );
+      pos += take;
+      n -= take;
+    }
+  }
+
+  /// Read _n_ bits.
+  uint64_t Get(int n)
+  {
+    uint64_t value = 0;
+
+    while( n > 0 )
+    {
+      int free = 8 - ( pos & 7 );
+      int take = n < free ? n : free;
+
+      value = ( value << take ) | ( ( data[ pos >> 3 ] >> ( free - take ) ) & ( ( 1U << take ) - 1 ) );
+      pos += take;
+      n -= take;
+    }
+
+    return value;
+  }
+};
+
+/// Append-only compressed time series of one channel.
+
+/// Each channel is stored in segment files _dir/channel-first.tss_ where
+/// _first_ is the first timestamp in microseconds. A segment is memory
+/// mapped with its maximum size and truncated to the used size when
+/// closed. Points are stored in blocks of at most TIMESERIES_BLOCK_POINTS
+/// points. Inside a block the timestamps are stored as delta-of-delta
+/// and the values as XOR with the previous value, so a sensor read at a
+/// fixed period with slowly changing value needs only a few bits per
+/// point. The headers are updated after each point so a reader sees all
+/// complete points and a crash loses at most the point being written.
+/// Timestamps are expected to increase.
+class TimeSeries
+{
+    std::string dir;         ///< directory of segment files
+    std::string channel;     ///< channel name
+    int fd;                  ///< open segment file or -1
+    uint8_t *map;            ///< mapped segment
+    TimeSeriesSegment *segment; ///< header of mapped segment
+    TimeSeriesBlock *block;  ///< header of open block or nullptr
+    TimeSeriesBits bits;     ///< bit stream of open block
+    int64_t delta;           ///< previous timestamp difference [us]
+    uint64_t value;          ///< previous value bits
+    int leading;             ///< leading zeros of previous XOR window
+    int trailing;            ///< trailing zeros of previous XOR window
+
+    /// Map segment file with its maximum size, return true in success.
+    bool Map(std::string file, bool create, int & error);
+
+    /// Continue last segment of channel if it has space or create new, return true in success.
+    bool OpenSegment(int64_t ts, int & error);
+
+    /// Start new block with first point.
+    void StartBlock(int64_t ts, double v);
+
+  public:
+    /// Construct TimeSeries for channel in directory.
+    TimeSeries(std::string dir, std::string channel);
+
+    virtual ~TimeSeries();
+
+    /// Get channel name.
+    std::string GetChannel() { return channel; }
+
+    /// Get segment file name for channel and first timestamp [us].
+    static std::string GetFile(std::string dir, std::string channel, int64_t first);
+
+    /// Append point with timestamp [us] and value, return true in success.
+    bool Append(int64_t ts, double v, int & error);
+
+    /// Schedule write of mapped segment to disk, wait if _wait_ is true.
+    void Sync(bool wait);
+
+    /// Sync and unmap segment and truncate it to used size.
+    void Close();
+};
+
+#endif
@@ -0,0 +1,252 @@
+/**************************************************************************
+ *
+ * TimeSeriesReader class member functions for reading segment files.
+ *
+ * Copyright (C) 2026 Jaakko Koivuniemi.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************
+ *
+ * Sat Oct 17 22:05:18 CDT 2026
+ * Edit: Sat Oct 17 22:05:18 CDT 2026
+ *
+ * Jaakko Koivuniemi
+ **/
+
+
+#include "TimeSeriesReader.hpp"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <errno.h>
+#include <string.h>
+#include <stdio.h>
+#include <algorithm>
+#include <set>
+
+using namespace std;
+
+/// TimeSeriesReader constructor.
+TimeSeriesReader::TimeSeriesReader(std::string dir, std::string channel)
+{
+  this->dir = dir;
+  this->channel = channel;
+  points = 0;
+  bytes = 0;
+}
+
+TimeSeriesReader::~TimeSeriesReader()
+{
+  TimeSeriesReader::Close();
+}
+
+/// Channel name is the segment file name without first timestamp and suffix.
+std::vector<std::string> TimeSeriesReader::GetChannels(std::string dir)
+{
+  std::set<std::string> names;
+
+  DIR *d = opendir( dir.c_str() );
+  if( !d ) return std::vector<std::string>();
+
+  struct dirent *entry;
+  while( ( entry = readdir( d ) ) != nullptr )
+  {
+    std::string name = entry->d_name;
+
+    if( name.length() > 21 && name.compare(name.length() - 4, 4, ".tss") == 0 && name[ name.length() - 21 ] == '-' )
+    {
+      names.insert( name.substr(0, name.length() - 21) );
+    }
+  }
+
+  closedir( d );
+
+  return std::vector<std::string>(names.begin(), names.end());
+}
+
+/// TimeSeriesReader member function to map segments of channel.
+
+/// The used size is taken from the segment header, so a segment still
+/// mapped with its maximum size by the writer is read to its last point.
+bool TimeSeriesReader::Open(int & error)
+{
+  std::vector<std::string> files;
+  std::string prefix = channel + "-";
+
+  Close();
+
+  DIR *d = opendir( dir.c_str() );
+  if( !d )
+  {
+    fprintf(stderr, SD_ERR "can not read directory %s: %s\n", dir.c_str(), strerror( errno ));
+    error = errno;
+    return false;
+  }
+
+  struct dirent *entry;
+  while( ( entry = readdir( d ) ) != nullptr )
+  {
+    std::string name = entry->d_name;
+
+    if( name.length() != prefix.length() + 20 || name.compare(0, prefix.length(), prefix) != 0 ) continue;
+    if( name.compare(name.length() - 4, 4, ".tss") == 0 ) files.push_back( dir + "/" + name );
+  }
+
+  closedir( d );
+
+  std::sort(files.begin(), files.end());
+
+  for(auto & f : files)
+  {
+    int fd = open(f.c_str(), O_RDONLY);
+    struct stat st;
+
+    if( fd < 0 || fstat(fd, &st) < 0 || st.st_size < (off_t)sizeof( TimeSeriesSegment ) )
+    {
+      if( fd >= 0 ) close( fd );
+      fprintf(stderr, SD_WARNING "skip segment %s\n", f.c_str());
+      continue;
+    }
+
+    void *m = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close( fd );
+
+    if( m == MAP_FAILED )
+    {
+      fprintf(stderr, SD_ERR "can not map %s: %s\n", f.c_str(), strerror( errno ));
+      error = errno;
+      continue;
+    }
+
+    Segment seg;
+    seg.map = (uint8_t *)m;
+    seg.length = st.st_size;
+    segments.push_back( seg );
+
+    const TimeSeriesSegment *head = (const TimeSeriesSegment *)seg.map;
+    if( head->magic != TIMESERIES_MAGIC || head->version != TIMESERIES_VERSION || head->size > seg.length )
+    {
+      fprintf(stderr, SD_WARNING "skip segment %s with bad header\n", f.c_str());
+      continue;
+    }
+
+    size_t pos = sizeof( TimeSeriesSegment );
+    for(uint32_t b = 0; b < head->blocks; b++)
+    {
+      pos = ( pos + 7 ) & ~(size_t)7;
+      if( pos + sizeof( TimeSeriesBlock ) > head->size ) break;
+
+      const TimeSeriesBlock *block = (const TimeSeriesBlock *)( seg.map + pos );
+      pos += sizeof( TimeSeriesBlock ) + ( block->bits + 7 ) / 8;
+      if( pos > head->size ) break;
+
+      blocks.push_back( block );
+      points += block->count;
+    }
+
+    bytes += head->size;
+  }
+
+  return true;
+}
+
+/// Unmap all segments and clear index.
+void TimeSeriesReader::Close()
+{
+  for(auto & s : segments) munmap(s.map, s.length);
+
+  segments.clear();
+  blocks.clear();
+  points = 0;
+  bytes = 0;
+}
+
+/// Decoding mirrors TimeSeries::Append().
+void TimeSeriesReader::Decode(const TimeSeriesBlock *block, int64_t from, int64_t to, std::vector<int64_t> & ts, std::vector<double> & values)
+{
+  TimeSeriesBits bits;
+  int64_t t = block->first, delta = 0;
+  uint64_t value, x;
+  int leading = 0, trailing = 0;
+  double v = block->value;
+
+  bits.data = (uint8_t *)( block + 1 );
+  bits.pos = 0;
+  memcpy(&value, &v, sizeof( value ));
+
+  for(uint32_t i = 0; i < block->count; i++)
+  {
+    if( i > 0 )
+    {
+      int64_t dod = 0;
+      int n = 0;
+
+      if( bits.Get( 1 ) == 0 ) n = 0;
+      else if( bits.Get( 1 ) == 0 ) n = 7;
+      else if( bits.Get( 1 ) == 0 ) n = 9;
+      else if( bits.Get( 1 ) == 0 ) n = 12;
+      else if( bits.Get( 1 ) == 0 ) n = 20;
+      else n = 64;
+
+      if( n > 0 )
+      {
+        uint64_t u = bits.Get( n );
+
+        if( n < 64 && ( u >> ( n - 1 ) ) & 1 ) u |= ~0ULL << n;
+        dod = (int64_t)u;
+      }
+
+      delta += dod;
+      t += delta;
+
+      if( bits.Get( 1 ) == 1 )
+      {
+        if( bits.Get( 1 ) == 1 )
+        {
+          leading = bits.Get( 5 );
+          int significant = bits.Get( 6 );
+          if( significant == 0 ) significant = 64;
+          trailing = 64 - leading - significant;
+        }
+
+        x = bits.Get( 64 - leading - trailing ) << trailing;
+        value ^= x;
+        memcpy(&v, &value, sizeof( v ));
+      }
+    }
+
+    if( t >= to ) break;
+    if( t >= from )
+    {
+      ts.push_back( t );
+      values.push_back( v );
+    }
+  }
+}
+
+/// Blocks are in time order, so the first block ending at or after
+/// _from_ is found with binary search.
+size_t TimeSeriesReader::Read(int64_t from, int64_t to, std::vector<int64_t> & ts, std::vector<double> & values)
+{
+  size_t N = ts.size();
+
+  auto it = std::lower_bound(blocks.begin(), blocks.end(), from, [](const TimeSeriesBlock *b, int64_t t) { return b->last < t; });
+
+  for(; it != blocks.end() && (*it)->first < to; it++) Decode(*it, from, to, ts, values);
+
+  return ts.size() - N;
+}
@@ -0,0 +1,98 @@
+/**************************************************************************
+ *
+ * TimeSeriesReader class definitions and constructor.
+ *
+ * Copyright (C) 2026 Jaakko Koivuniemi.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************
+ *
+ * Sat Oct 17 22:05:18 CDT 2026
+ * Edit: Sat Oct 17 22:05:18 CDT 2026
+ *
+ * Jaakko Koivuniemi
+ **/
+
+
+#ifndef _TIMESERIESREADER_HPP
+#define _TIMESERIESREADER_HPP
+
+#include <systemd/sd-daemon.h>
+#include "TimeSeries.hpp"
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+/// Reader of compressed time series segments of one channel.
+
+/// Open() maps all segment files of the channel read only and collects
+/// their block headers to an index. Read() finds the first block that
+/// can hold the start of the time range with binary search and decodes
+/// blocks from it until the end of the range. Segments written at the
+/// same time are read up to the last complete point.
+class TimeSeriesReader
+{
+    /// Mapped segment file.
+    struct Segment
+    {
+      uint8_t *map;            ///< mapped file
+      size_t length;           ///< mapped length [bytes]
+    };
+
+    std::string dir;           ///< directory of segment files
+    std::string channel;       ///< channel name
+    std::vector<Segment> segments; ///< mapped segment files
+    std::vector<const TimeSeriesBlock *> blocks; ///< index of all blocks in time order
+    uint64_t points;           ///< number of points
+    uint64_t bytes;            ///< used bytes in segment files
+
+    /// Decode block and append points within [from, to) to vectors.
+    void Decode(const TimeSeriesBlock *block, int64_t from, int64_t to, std::vector<int64_t> & ts, std::vector<double> & values);
+
+  public:
+    /// Construct TimeSeriesReader for channel in directory.
+    TimeSeriesReader(std::string dir, std::string channel);
+
+    virtual ~TimeSeriesReader();
+
+    /// List channel names with segment files in directory.
+    static std::vector<std::string> GetChannels(std::string dir);
+
+    /// Map segment files and build block index, return true in success.
+    bool Open(int & error);
+
+    /// Unmap segment files.
+    void Close();
+
+    /// Get number of points.
+    uint64_t GetPoints() { return points; }
+
+    /// Get used bytes in segment files.
+    uint64_t GetBytes() { return bytes; }
+
+    /// Get number of blocks.
+    size_t GetBlocks() { return blocks.size(); }
+
+    /// Get first timestamp [us] or 0 if no points.
+    int64_t GetFirst() { return blocks.empty() ? 0 : blocks.front()->first; }
+
+    /// Get last timestamp [us] or 0 if no points.
+    int64_t GetLast() { return blocks.empty() ? 0 : blocks.back()->last; }
+
+    /// Append points with timestamp [us] in [from, to) to vectors, return number of points.
+    size_t Read(int64_t from, int64_t to, std::vector<int64_t> & ts, std::vector<double> & values);
+};
+
+#endif
@@ -0,0 +1,95 @@
+/**************************************************************************
+ *
+ * TimeSeriesStore class member functions for storing table rows.
+ *
+ * Copyright (C) 2026 Jaakko Koivuniemi.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************
+ *
+ * Sat Oct 17 22:05:18 CDT 2026
+ * Edit: Sat Oct 17 22:05:18 CDT 2026
+ *
+ * Jaakko Koivuniemi
+ **/
+
+
+#include "TimeSeriesStore.hpp"
+#include <sys/stat.h>
+#include <errno.h>
+#include <string.h>
+#include <stdio.h>
+
+using namespace std;
+
+/// TimeSeriesStore constructor creates the directory if it is missing.
+TimeSeriesStore::TimeSeriesStore(std::string dir, SQLite *source)
+{
+  this->dir = dir;
+  this->source = source;
+  columns = source->GetColumns();
+
+  if( mkdir(dir.c_str(), 0755) < 0 && errno != EEXIST ) fprintf(stderr, SD_ERR "can not create %s: %s\n", dir.c_str(), strerror( errno ));
+}
+
+TimeSeriesStore::~TimeSeriesStore()
+{
+  TimeSeriesStore::Close();
+
+  for(auto & c : channels)
+  {
+    for(auto & ts : c.second) delete ts;
+  }
+}
+
+/// Channels of a new chip name are created on its first row. Integers are
+/// stored as doubles after the doubles in column order.
+bool TimeSeriesStore::Append(const std::string & name, int64_t ts, int Nd, const double *dbl_array, int Ni, const int *int_array, int & error)
+{
+  std::vector<TimeSeries *> & series = channels[ name ];
+  bool ok = true;
+
+  if( series.empty() )
+  {
+    for(auto & c : columns) series.push_back( new TimeSeries(dir, source->GetTable() + "." + name + "." + c) );
+  }
+
+  for(int i = 0; i < Nd + Ni && i < (int)series.size(); i++)
+  {
+    double v = ( i < Nd ) ? dbl_array[ i ] : int_array[ i - Nd ];
+
+    if( !series[ i ]->Append(ts, v, error) ) ok = false;
+  }
+
+  return ok;
+}
+
+/// Pages are written in background.
+void TimeSeriesStore::Sync()
+{
+  for(auto & c : channels)
+  {
+    for(auto & ts : c.second) ts->Sync( false );
+  }
+}
+
+/// Segments are truncated to used size.
+void TimeSeriesStore::Close()
+{
+  for(auto & c : channels)
+  {
+    for(auto & ts : c.second) ts->Close();
+  }
+}
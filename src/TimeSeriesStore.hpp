@@ -0,0 +1,72 @@
+/**************************************************************************
+ *
+ * TimeSeriesStore class definitions and constructor.
+ *
+ * Copyright (C) 2026 Jaakko Koivuniemi.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************
+ *
+ * Sat Oct 17 22:05:18 CDT 2026
+ * Edit: Sat Oct 17 22:05:18 CDT 2026
+ *
+ * Jaakko Koivuniemi
+ **/
+
+
+#ifndef _TIMESERIESSTORE_HPP
+#define _TIMESERIESSTORE_HPP
+
+#include <systemd/sd-daemon.h>
+#include "SQLite.hpp"
+#include "TimeSeries.hpp"
+#include <string>
+#include <vector>
+#include <map>
+#include <stdint.h>
+
+/// Compressed time series store for rows of one database table.
+
+/// Rows given for the table are stored as one channel for each chip name
+/// and value column, named _table.name.column_, in place of inserting them
+/// to SQLite. The columns are read from the insert statement of the table.
+/// The store is used from one thread only, normally the SQLite writer.
+class TimeSeriesStore
+{
+    std::string dir;                 ///< directory of segment files
+    SQLite *source;                  ///< table replaced by store
+    std::vector<std::string> columns; ///< value columns of table
+    std::map<std::string, std::vector<TimeSeries *> > channels; ///< channels by chip name
+
+  public:
+    /// Construct TimeSeriesStore in directory for table.
+    TimeSeriesStore(std::string dir, SQLite *source);
+
+    virtual ~TimeSeriesStore();
+
+    /// Get table replaced by store.
+    SQLite *GetSource() { return source; }
+
+    /// Append row with timestamp [us], Nd doubles and Ni integers, return true in success.
+    bool Append(const std::string & name, int64_t ts, int Nd, const double *dbl_array, int Ni, const int *int_array, int & error);
+
+    /// Schedule write of all channels to disk.
+    void Sync();
+
+    /// Close all channels.
+    void Close();
+};
+
+#endif
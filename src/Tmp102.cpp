@@ -2,7 +2,7 @@
  * 
  * Tmp102 class member functions for configuration and reading with I2C. 
  *       
- * Copyright (C) 2020 Jaakko Koivuniemi.
+ * Copyright (C) 2020 - 2026 Jaakko Koivuniemi.
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -20,7 +20,7 @@
  ****************************************************************************
  *
  * Sat Jul  4 15:13:58 CDT 2020
- * Edit: Mon Jul  6 16:27:21 CDT 2020
+ * Edit: Sat Oct 17 12:14:09 CDT 2026
  *
  * Jaakko Koivuniemi
  **/
@@ -37,8 +37,7 @@ uint16_t Tmp102::GetHighLimit()
 {
   uint16_t HighLimit = 0;
 
-  I2Chip::I2cWriteUInt8(TMP102_TEMP_HIGH_REG, address, buffer, error);
-  HighLimit = I2Chip::I2cReadUInt16(address, buffer, error);
+  HighLimit = I2Chip::I2cReadRegisterUInt16(TMP102_TEMP_HIGH_REG, address, buffer, error);
 
   return HighLimit;
 }
@@ -49,8 +48,7 @@ uint16_t Tmp102::GetLowLimit()
 {
   uint16_t LowLimit = 0;
 
-  I2Chip::I2cWriteUInt8(TMP102_TEMP_LOW_REG, address, buffer, error);
-  LowLimit = I2Chip::I2cReadUInt16(address, buffer, error);
+  LowLimit = I2Chip::I2cReadRegisterUInt16(TMP102_TEMP_LOW_REG, address, buffer, error);
 
   return LowLimit;
 } 
@@ -61,8 +59,7 @@ uint16_t Tmp102::GetConfig()
 {
   uint16_t Config = 0;
 
-  I2Chip::I2cWriteUInt8(TMP102_CONFIG_REG, address, buffer, error);
-  Config = I2Chip::I2cReadUInt16(address, buffer, error);
+  Config = I2Chip::I2cReadRegisterUInt16(TMP102_CONFIG_REG, address, buffer, error);
 
   return Config;
 } 
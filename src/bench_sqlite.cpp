@@ -0,0 +1,127 @@
+/**************************************************************************
+ * 
+ * Benchmark SQLite time range queries with and without (name, ts) index. 
+ *       
+ * Copyright (C) 2026 Jaakko Koivuniemi.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************
+ *
+ * Sat Oct 17 18:40:13 CDT 2026
+ * Edit: Sat Oct 17 19:12:40 CDT 2026
+ *
+ * Jaakko Koivuniemi
+ **/
+
+#include <sqlite3.h>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <time.h>
+#include <unistd.h>
+
+using namespace std;
+
+void printusage()
+{
+  std::cout << "Usage: bench_sqlite dbfile [maxrows]" << std::endl;
+}
+
+/// Time from _start_ to now in milliseconds.
+double Elapsed(const struct timespec & start)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return 1e3 * ( now.tv_sec - start.tv_sec ) + 1e-6 * ( now.tv_nsec - start.tv_nsec );
+}
+
+/// Average time of one day range query for one name [ms].
+double QueryTime(sqlite3 *db, int repeat)
+{
+  sqlite3_stmt *stmt;
+  struct timespec start;
+  const char *query = "select count(*),avg(temperature) from tmp102 where name='T1' and ts>=? and ts<?";
+  const long long day = 86400000000LL, t0 = 1577836800000000LL; // 2020-01-01 [us]
+
+  sqlite3_prepare_v2(db, query, -1, &stmt, 0);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for(int i = 0; i < repeat; i++)
+  {
+    sqlite3_bind_int64(stmt, 1, t0 + i * day);
+    sqlite3_bind_int64(stmt, 2, t0 + ( i + 1 ) * day);
+    while( sqlite3_step( stmt ) == SQLITE_ROW );
+    sqlite3_reset( stmt );
+  }
+  double t = Elapsed( start ) / repeat;
+
+  sqlite3_finalize( stmt );
+
+  return t;
+}
+
+/// benchmark time range queries on tmp102 table
+
+/// The table is filled with rows from ten chips, one row per minute for
+/// each chip, and the one day query time of one chip is measured with and
+/// without index on (name, ts). The database file is overwritten.
+int main(int argc, char **argv)
+{
+  sqlite3 *db;
+  struct timespec start;
+  int maxrows = 1000000, rows = 0;
+
+  if( argc < 2 )
+  {
+    printusage();
+    return 0;
+  }
+
+  if( argc > 2 ) maxrows = atoi( argv[ 2 ] );
+
+  unlink( argv[ 1 ] );
+  if( sqlite3_open( argv[ 1 ], &db ) != SQLITE_OK )
+  {
+    cout << "-- can not open " << argv[ 1 ] << "\n";
+    return -1;
+  }
+
+  sqlite3_exec(db, "pragma journal_mode=wal; create table tmp102(no integer primary key, ts integer, name varchar(20), temperature real);", NULL, NULL, NULL);
+
+  cout << "rows        no index [ms]    index [ms]\n";
+
+  for(int N = 10000; N <= maxrows; N *= 10)
+  {
+    string fill = "with recursive k(i) as (select " + to_string( rows ) + " union all select i+1 from k where i<" + to_string( N - 1 ) + ") insert into tmp102(ts,name,temperature) select 1577836800000000+(i/10)*60000000, 'T' || (i%10), 20+(i%100)/10.0 from k";
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    sqlite3_exec(db, fill.c_str(), NULL, NULL, NULL);
+    rows = N;
+
+    sqlite3_exec(db, "drop index if exists tmp102_name_ts", NULL, NULL, NULL);
+    double noindex = QueryTime( db, 5 );
+
+    sqlite3_exec(db, "create index tmp102_name_ts on tmp102(name,ts)", NULL, NULL, NULL);
+    double index = QueryTime( db, 100 );
+
+    cout << left << setw( 12 ) << N << setw( 17 ) << noindex << index << "\n";
+  }
+
+  sqlite3_close( db );
+
+  return 0;
+};
@@ -0,0 +1,212 @@
+/**************************************************************************
+ * 
+ * Benchmark bytes per row and insert rate of SQLite and time series store. 
+ *       
+ * Copyright (C) 2026 Jaakko Koivuniemi.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************
+ *
+ * Sat Oct 17 22:05:18 CDT 2026
+ * Edit: Sat Oct 17 22:05:18 CDT 2026
+ *
+ * Jaakko Koivuniemi
+ **/
+
+
+#include "SQLite.hpp"
+#include "TimeSeries.hpp"
+#include "TimeSeriesReader.hpp"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <math.h>
+#include <time.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+void printusage()
+{
+  std::cout << "Usage: bench_store dir [rows]" << std::endl;
+}
+
+/// Time from _start_ to now in milliseconds.
+double Elapsed(const struct timespec & start)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return 1e3 * ( now.tv_sec - start.tv_sec ) + 1e-6 * ( now.tv_nsec - start.tv_nsec );
+}
+
+/// Sum of file sizes in directory with given suffix.
+long long DirSize(std::string dir, std::string suffix)
+{
+  long long size = 0;
+  struct stat st;
+  DIR *d = opendir( dir.c_str() );
+
+  if( !d ) return 0;
+
+  struct dirent *entry;
+  while( ( entry = readdir( d ) ) != nullptr )
+  {
+    std::string name = entry->d_name;
+
+    if( name.length() < suffix.length() || name.compare(name.length() - suffix.length(), suffix.length(), suffix) != 0 ) continue;
+    if( stat(( dir + "/" + name ).c_str(), &st) == 0 ) size += st.st_size;
+  }
+
+  closedir( d );
+
+  return size;
+}
+
+/// Remove files in directory with given suffix.
+void DirClean(std::string dir, std::string suffix)
+{
+  DIR *d = opendir( dir.c_str() );
+
+  if( !d ) return;
+
+  struct dirent *entry;
+  while( ( entry = readdir( d ) ) != nullptr )
+  {
+    std::string name = entry->d_name;
+
+    if( name.length() >= suffix.length() && name.compare(name.length() - suffix.length(), suffix.length(), suffix) == 0 ) unlink(( dir + "/" + name ).c_str());
+  }
+
+  closedir( d );
+}
+
+/// benchmark storage of three axis acceleration rows
+
+/// Rows of LIS3DH at 25 Hz with timing jitter and values in 1 mg steps
+/// are written with SQLite class inserts committed every 100 rows as the
+/// SQLite writer does, and to three time series channels. The log
+/// messages of SQLite class go to /dev/null but their formatting is
+/// included in the time. The time series are read back and compared.
+int main(int argc, char **argv)
+{
+  struct timespec start;
+  int rows = 100000, error = 0;
+  const int64_t t0 = 1792281600000000LL; // 2026-10-17 [us]
+
+  if( argc < 2 )
+  {
+    printusage();
+    return 0;
+  }
+
+  if( argc > 2 ) rows = atoi( argv[ 2 ] );
+
+  std::string dir = argv[ 1 ];
+  std::string dbfile = dir + "/bench_store.db";
+
+  std::mt19937 gen( 1 );
+  std::normal_distribution<double> noise(0, 3);
+  std::uniform_int_distribution<int> jitter(-200, 200);
+  std::vector<int64_t> ts( rows );
+  std::vector<double> g( 3 * rows );
+
+  for(int i = 0; i < rows; i++)
+  {
+    ts[ i ] = t0 + i * 40000LL + jitter( gen );
+    g[ 3 * i ] = 0.001 * round( 20 * sin( i * 0.01 ) + noise( gen ) );
+    g[ 3 * i + 1 ] = 0.001 * round( -15 + noise( gen ) );
+    g[ 3 * i + 2 ] = 0.001 * round( 1000 + noise( gen ) );
+  }
+
+  if( !freopen("/dev/null", "w", stderr) ) return -1;
+
+  // SQLite path
+  unlink( dbfile.c_str() );
+  unlink( ( dbfile + "-wal" ).c_str() );
+  unlink( ( dbfile + "-shm" ).c_str() );
+
+  sqlite3 *init;
+  sqlite3_open( dbfile.c_str(), &init );
+  sqlite3_exec(init, "pragma journal_mode=wal; create table lis3dh(no integer primary key, ts integer, name varchar(20), gx real, gy real, gz real); create index lis3dh_name_ts on lis3dh(name,ts);", NULL, NULL, NULL);
+  sqlite3_close( init );
+
+  double sqlitetime = 0;
+  {
+    SQLite db(dbfile, "lis3dh", "insert into lis3dh (name,gx,gy,gz,ts) values (?,?,?,?,:ts)");
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for(int i = 0; i < rows; i++)
+    {
+      if( i % 100 == 0 ) db.Exec( "begin", error );
+      db.InsertAt("XYZ1", ts[ i ], 3, &g[ 3 * i ], 0, nullptr, error);
+      if( i % 100 == 99 || i == rows - 1 ) db.Exec( "commit", error );
+    }
+    sqlitetime = Elapsed( start );
+
+    db.Checkpoint( true, error );
+  }
+  long long sqlitebytes = DirSize(dir, ".db") + DirSize(dir, ".db-wal");
+
+  // time series path
+  DirClean(dir, ".tss");
+
+  TimeSeries *axis[ 3 ] = {new TimeSeries(dir, "lis3dh.XYZ1.gx"), new TimeSeries(dir, "lis3dh.XYZ1.gy"), new TimeSeries(dir, "lis3dh.XYZ1.gz")};
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for(int i = 0; i < rows; i++)
+  {
+    for(int a = 0; a < 3; a++) axis[ a ]->Append(ts[ i ], g[ 3 * i + a ], error);
+    if( i % 100 == 99 ) for(int a = 0; a < 3; a++) axis[ a ]->Sync( false );
+  }
+  double tstime = Elapsed( start );
+
+  for(int a = 0; a < 3; a++) delete axis[ a ];
+  long long tsbytes = DirSize(dir, ".tss");
+
+  // read back
+  const char *names[ 3 ] = {"lis3dh.XYZ1.gx", "lis3dh.XYZ1.gy", "lis3dh.XYZ1.gz"};
+  int mismatch = 0;
+  double readtime = 0;
+
+  for(int a = 0; a < 3; a++)
+  {
+    TimeSeriesReader reader(dir, names[ a ]);
+    std::vector<int64_t> rts;
+    std::vector<double> rv;
+
+    reader.Open( error );
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    reader.Read(t0 - 1000000, t0 + rows * 40000LL + 1000000, rts, rv);
+    readtime += Elapsed( start );
+
+    if( (int)rts.size() != rows ) mismatch++;
+    else for(int i = 0; i < rows; i++) if( rts[ i ] != ts[ i ] || rv[ i ] != g[ 3 * i + a ] ) mismatch++;
+  }
+
+  cout << "rows " << rows << ", read back mismatches " << mismatch << "\n";
+  cout << "store         bytes/row   rows/s\n";
+  cout << left << fixed << setprecision( 1 );
+  cout << setw( 14 ) << "SQLite" << setw( 12 ) << (double)sqlitebytes / rows << setprecision( 0 ) << 1e3 * rows / sqlitetime << "\n";
+  cout << setprecision( 1 ) << setw( 14 ) << "time series" << setw( 12 ) << (double)tsbytes / rows << setprecision( 0 ) << 1e3 * rows / tstime << "\n";
+  cout << "time series read " << setprecision( 0 ) << 3e3 * rows / readtime << " points/s\n";
+
+  return 0;
+};
@@ -2,7 +2,7 @@
  * 
  * Read chips with I2C interface. 
  *       
- * Copyright (C) 2020 - 2023 Jaakko Koivuniemi.
+ * Copyright (C) 2020 - 2026 Jaakko Koivuniemi.
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -20,7 +20,7 @@
  ****************************************************************************
  *
  * Fri Jul  3 20:16:26 CDT 2020
- * Edit: Fri  3 Nov 17:22:47 CDT 2023
+ * Edit: Sun Oct 18 19:48:03 CDT 2026
  *
  * Jaakko Koivuniemi
  **/
@@ -31,11 +31,15 @@
 #include <unistd.h>
 #include <iostream>
 #include <iomanip>
+#include <sstream>
 #include <string>
+#include <map>
+#include <set>
+#include <vector>
 #include <algorithm>
 
 #ifdef USE_DIM_LIBS
-#include <dis.hxx>
+#include "DimServices.hpp"
 #endif
 
 using namespace std;
@@ -53,15 +57,27 @@ void reload(int sig)
   fprintf(stderr, SD_WARNING "SIGHUP received (to implement: reload configuration)\n");
 }
 
+/// Get chip setting from configuration or default value if not set.
+double Setting(const map<string, double> & settings, const string & tag, double defval)
+{
+  auto it = settings.find( tag );
+
+  if( it == settings.end() ) return defval;
+
+  return it->second;
+}
+
 
 /// i2chipd program to read I2C chips at regular intervals 
 
+/// Each chip is read with its own period and phase given after the chip
+/// tag in configuration file, default is READINT period with zero phase.
 /// Run the program with `i2chipd 2> /dev/null` on shell. Printing
 /// to standard error stream is for _systemd_ logging with _systemd-journald_
 /// and includes different log levels defined in `sd-daemon.h`.
 int main()
 {
-  const int version = 20231103; // program version
+  const int version = 20261017; // program version
   
   string i2cdev = "/dev/i2c-1";
 
@@ -73,12 +89,44 @@ int main()
   string spidev05 = "/dev/spidev0.5";
   string spidev06 = "/dev/spidev0.6";
   string spidev07 = "/dev/spidev0.7";
+  string spidev = "/dev/spidev0"; // SPI bus shared by all chip selects
 
   string datadir = "/tmp/";
   string sqlitedb = "/var/lib/i2chipd/i2chipd.db";
   string dimserver = "";
   string dimdns = "localhost";
   int readinterval = 120;
+  int schedpolicy = SCHEDULER_SKIP;
+  int sqlitebatch = 100;   // rows in one transaction
+  int sqlitecommit = 5000; // maximum delay before commit [ms]
+  int durability = SQLITE_DURABILITY_NORMAL;
+  int walcheckpoint = 1000; // WAL pages before automatic checkpoint
+  long long mmapsize = 0;   // memory mapped I/O [bytes]
+  double checkpointint = 3600; // interval of truncating checkpoint [s]
+  map<string, double> retain; // days rows are kept by table or *suffix
+  int retainbatch = 500;    // rows deleted per table and step
+  int vacuumpages = 100;    // free pages returned per step
+  double retainint = 60;    // interval of deleting old rows [s]
+  bool partition = false;   // raw rows to day partition files
+  string tsdir = "/var/lib/i2chipd/ts"; // compressed time series
+  set<string> tstables;     // tables stored as time series
+  string spooldir = "";     // spool for rows while database unavailable
+  double spoolmax = 512;    // maximum spool size [MB]
+  string querysocket = "";  // Unix socket of query service
+  int recentsamples = 3600; // samples of each chip kept in memory
+  double recentmax = 16;    // memory limit of recent samples [MB]
+  double filedeadband = 0;  // change needed to rewrite data file
+  double filerefresh = 600; // maximum age of unchanged data file [s]
+  string snapshotshm = I2CHIPD_SNAPSHOT_SHM; // shared memory of latest values
+  string mqttbroker = "";   // MQTT broker host:port
+  string mqtttopic = "computer/sensors/"; // prefix of MQTT topics
+  string mqttclient = "i2chipd"; // MQTT client identifier
+  string mqttuser = "";     // MQTT user name
+  string mqttpasswd = "";   // MQTT password
+  int mqttqos = 0;          // MQTT quality of service
+  bool mqttretain = false;  // broker keeps last value
+  int mqttbuffer = 10000;   // messages kept while broker not connected
+  string metricsaddr = "";  // address of Prometheus exporter
   int sqlite_err = 0;
 
   signal(SIGTERM, &shutdown);
@@ -116,6 +164,21 @@ int main()
   bool pca9535x24 = false, pca9535x25 = false;
   bool pca9535x26 = false, pca9535x27 = false;
 
+  // configuration tags of chips
+  const string tmp102_tag[ 4 ] = {"TMP102_x48", "TMP102_x49", "TMP102_x4A", "TMP102_x4B"};
+  const string bmp280_tag[ 2 ] = {"BMP280_x76", "BMP280_x77"};
+  const string bme680_tag[ 2 ] = {"BME680_x76", "BME680_x77"};
+  const string bh1750fvi_tag[ 2 ] = {"BH1750FVI_x23", "BH1750FVI_x5C"};
+  const string lis3mdl_tag[ 2 ] = {"LIS3MDL_x1C", "LIS3MDL_x1E"};
+  const string lis3dh_tag[ 2 ] = {"LIS3DH_x18", "LIS3DH_x19"};
+  const string max31865_tag[ 8 ] = {"MAX31865_00", "MAX31865_01", "MAX31865_02", "MAX31865_03", "MAX31865_04", "MAX31865_05", "MAX31865_06", "MAX31865_07"};
+  const string pca9535_tag[ 8 ] = {"PCA9535_x20", "PCA9535_x21", "PCA9535_x22", "PCA9535_x23", "PCA9535_x24", "PCA9535_x25", "PCA9535_x26", "PCA9535_x27"};
+
+  // optional reading period and phase [s] after chip tag
+  map<string, double> period, phase;
+  string tag;
+  double value = 0;
+
   std::size_t pos;
   std::string line ("");
   ifstream confile;
@@ -166,6 +229,246 @@ int main()
           if( line.find("PCA9535_x26") != std::string::npos ) pca9535x26 = true;
           if( line.find("PCA9535_x27") != std::string::npos ) pca9535x27 = true;
 
+          istringstream settings( line );
+          if( settings >> tag >> value )
+          {
+            period[ tag ] = value;
+            if( settings >> value ) phase[ tag ] = value;
+          }
+
+          pos = line.find("POLICY");
+          if( pos != std::string::npos )
+          {
+            if( line.find("CATCHUP", pos + 6) != std::string::npos ) schedpolicy = SCHEDULER_CATCHUP;
+            else schedpolicy = SCHEDULER_SKIP;
+            fprintf(stderr, SD_INFO "missed deadline policy %d\n", schedpolicy );
+          }
+
+          pos = line.find("SQLITEBATCH");
+          if( pos != std::string::npos )
+          {
+            sqlitebatch = atoi( line.substr(pos+11, line.length() - pos - 11 ).c_str() );
+            fprintf(stderr, SD_INFO "SQLite commit after %d rows\n", sqlitebatch );
+          }
+
+          pos = line.find("SQLITECOMMIT");
+          if( pos != std::string::npos )
+          {
+            sqlitecommit = atoi( line.substr(pos+12, line.length() - pos - 12 ).c_str() );
+            fprintf(stderr, SD_INFO "SQLite commit within %d ms\n", sqlitecommit );
+          }
+
+          pos = line.find("DURABILITY");
+          if( pos != std::string::npos )
+          {
+            if( line.find("FAST", pos + 10) != std::string::npos ) durability = SQLITE_DURABILITY_FAST;
+            else if( line.find("FULL", pos + 10) != std::string::npos ) durability = SQLITE_DURABILITY_FULL;
+            else durability = SQLITE_DURABILITY_NORMAL;
+            fprintf(stderr, SD_INFO "SQLite durability level %d\n", durability );
+          }
+
+          pos = line.find("WALCHECKPOINT");
+          if( pos != std::string::npos )
+          {
+            walcheckpoint = atoi( line.substr(pos+13, line.length() - pos - 13 ).c_str() );
+            fprintf(stderr, SD_INFO "SQLite WAL autocheckpoint %d pages\n", walcheckpoint );
+          }
+
+          pos = line.find("MMAPSIZE");
+          if( pos != std::string::npos )
+          {
+            mmapsize = atoll( line.substr(pos+8, line.length() - pos - 8 ).c_str() );
+            fprintf(stderr, SD_INFO "SQLite mmap size %lld bytes\n", mmapsize );
+          }
+
+          pos = line.find("CHECKPOINTINT");
+          if( pos != std::string::npos )
+          {
+            checkpointint = atof( line.substr(pos+13, line.length() - pos - 13 ).c_str() );
+            fprintf(stderr, SD_INFO "SQLite checkpoint every %g s\n", checkpointint );
+          }
+
+          pos = line.find("PARTITION");
+          if( pos != std::string::npos )
+          {
+            partition = ( line.find("DAY", pos + 9) != std::string::npos );
+            fprintf(stderr, SD_INFO "SQLite day partitions %s\n", partition ? "on" : "off" );
+          }
+
+          pos = line.find("TSDIR");
+          if( pos != std::string::npos )
+          {
+            istringstream dir( line.substr(pos + 5) );
+            dir >> tsdir;
+            fprintf(stderr, SD_INFO "time series directory %s\n", tsdir.c_str() );
+          }
+
+          pos = line.find("SPOOLDIR");
+          if( pos != std::string::npos )
+          {
+            istringstream dir( line.substr(pos + 8) );
+            dir >> spooldir;
+            fprintf(stderr, SD_INFO "spool directory %s\n", spooldir.c_str() );
+          }
+
+          pos = line.find("SPOOLMAX");
+          if( pos != std::string::npos )
+          {
+            spoolmax = atof( line.substr(pos + 8).c_str() );
+            fprintf(stderr, SD_INFO "spool maximum %.0f MB\n", spoolmax );
+          }
+
+          pos = line.find("QUERYSOCKET");
+          if( pos != std::string::npos )
+          {
+            istringstream sock( line.substr(pos + 11) );
+            sock >> querysocket;
+            fprintf(stderr, SD_INFO "query socket %s\n", querysocket.c_str() );
+          }
+
+          pos = line.find("RECENTMAX");
+          if( pos != std::string::npos )
+          {
+            recentmax = atof( line.substr(pos + 9).c_str() );
+            fprintf(stderr, SD_INFO "recent samples limited to %.1f MB\n", recentmax );
+          }
+          else if( ( pos = line.find("RECENT") ) != std::string::npos )
+          {
+            recentsamples = atoi( line.substr(pos + 6).c_str() );
+            fprintf(stderr, SD_INFO "%d recent samples of each chip in memory\n", recentsamples );
+          }
+
+          pos = line.find("FILEDEADBAND");
+          if( pos != std::string::npos )
+          {
+            filedeadband = atof( line.substr(pos + 12).c_str() );
+            fprintf(stderr, SD_INFO "data files written when value changes more than %g\n", filedeadband );
+          }
+
+          pos = line.find("FILEREFRESH");
+          if( pos != std::string::npos )
+          {
+            filerefresh = atof( line.substr(pos + 11).c_str() );
+            fprintf(stderr, SD_INFO "unchanged data files rewritten after %.0f s\n", filerefresh );
+          }
+
+          pos = line.find("SNAPSHOT");
+          if( pos != std::string::npos )
+          {
+            istringstream shm( line.substr(pos + 8) );
+            shm >> snapshotshm;
+            if( snapshotshm == "none" ) snapshotshm = "";
+            fprintf(stderr, SD_INFO "latest values to shared memory %s\n", snapshotshm.c_str() );
+          }
+
+          pos = line.find("MQTTBROKER");
+          if( pos != std::string::npos )
+          {
+            istringstream broker( line.substr(pos + 10) );
+            broker >> mqttbroker;
+            fprintf(stderr, SD_INFO "MQTT broker %s\n", mqttbroker.c_str() );
+          }
+
+          pos = line.find("MQTTTOPIC");
+          if( pos != std::string::npos )
+          {
+            istringstream topic( line.substr(pos + 9) );
+            topic >> mqtttopic;
+            fprintf(stderr, SD_INFO "MQTT topic %s\n", mqtttopic.c_str() );
+          }
+
+          pos = line.find("MQTTCLIENT");
+          if( pos != std::string::npos )
+          {
+            istringstream client( line.substr(pos + 10) );
+            client >> mqttclient;
+            fprintf(stderr, SD_INFO "MQTT client %s\n", mqttclient.c_str() );
+          }
+
+          pos = line.find("MQTTUSER");
+          if( pos != std::string::npos )
+          {
+            istringstream user( line.substr(pos + 8) );
+            user >> mqttuser;
+            fprintf(stderr, SD_INFO "MQTT user %s\n", mqttuser.c_str() );
+          }
+
+          pos = line.find("MQTTPASSWD");
+          if( pos != std::string::npos )
+          {
+            istringstream passwd( line.substr(pos + 10) );
+            passwd >> mqttpasswd;
+          }
+
+          pos = line.find("MQTTQOS");
+          if( pos != std::string::npos )
+          {
+            mqttqos = atoi( line.substr(pos + 7).c_str() );
+            fprintf(stderr, SD_INFO "MQTT QoS %d\n", mqttqos );
+          }
+
+          pos = line.find("MQTTRETAIN");
+          if( pos != std::string::npos )
+          {
+            mqttretain = ( atoi( line.substr(pos + 10).c_str() ) != 0 );
+            fprintf(stderr, SD_INFO "MQTT retain %d\n", mqttretain );
+          }
+
+          pos = line.find("MQTTBUFFER");
+          if( pos != std::string::npos )
+          {
+            mqttbuffer = atoi( line.substr(pos + 10).c_str() );
+            fprintf(stderr, SD_INFO "%d MQTT messages buffered\n", mqttbuffer );
+          }
+
+          pos = line.find("METRICS");
+          if( pos != std::string::npos )
+          {
+            istringstream addr( line.substr(pos + 7) );
+            addr >> metricsaddr;
+            fprintf(stderr, SD_INFO "Prometheus metrics on %s\n", metricsaddr.c_str() );
+          }
+
+          pos = line.find("TSTABLES");
+          if( pos != std::string::npos )
+          {
+            istringstream tables( line.substr(pos + 8) );
+            while( tables >> tag )
+            {
+              tstables.insert( tag );
+              fprintf(stderr, SD_INFO "%s stored as time series\n", tag.c_str() );
+            }
+          }
+
+          istringstream retention( line );
+          string key, table;
+          if( retention >> key >> table >> value && key == "RETAIN" )
+          {
+            retain[ table ] = value;
+            fprintf(stderr, SD_INFO "%s rows kept %g days\n", table.c_str(), value );
+          }
+
+          pos = line.find("RETAINBATCH");
+          if( pos != std::string::npos )
+          {
+            retainbatch = atoi( line.substr(pos+11, line.length() - pos - 11 ).c_str() );
+            fprintf(stderr, SD_INFO "delete at most %d old rows per table\n", retainbatch );
+          }
+
+          pos = line.find("VACUUMPAGES");
+          if( pos != std::string::npos )
+          {
+            vacuumpages = atoi( line.substr(pos+11, line.length() - pos - 11 ).c_str() );
+            fprintf(stderr, SD_INFO "vacuum at most %d pages\n", vacuumpages );
+          }
+
+          pos = line.find("RETAININT");
+          if( pos != std::string::npos )
+          {
+            retainint = atof( line.substr(pos+9, line.length() - pos - 9 ).c_str() );
+            fprintf(stderr, SD_INFO "delete old rows every %g s\n", retainint );
+          }
+
           pos = line.find("READINT");
           if( pos != std::string::npos ) 
           {
@@ -260,6 +563,28 @@ int main()
 
   // data files to write most recent value
   File *tmp102_file[ 4 ];
+  File::SetDeadband( filedeadband );
+  File::SetRefresh( filerefresh );
+
+  // latest values of all data files also in one shared memory segment
+  Snapshot *snapshot = nullptr;
+  if( snapshotshm != "" )
+  {
+    snapshot = new Snapshot( snapshotshm );
+    File::SetSnapshot( snapshot );
+  }
+
+  // numbers written to data files also published to MQTT broker
+  Mqtt *mqtt = nullptr;
+  if( mqttbroker != "" )
+  {
+    mqtt = new Mqtt(mqttbroker, mqtttopic, mqttclient, mqttbuffer);
+    mqtt->SetLogin(mqttuser, mqttpasswd);
+    mqtt->SetQos( mqttqos );
+    mqtt->SetRetain( mqttretain );
+    File::SetMqtt( mqtt );
+  }
+
   tmp102_file[ 0 ] = new File(datadir, "tmp102_x48");
   tmp102_file[ 1 ] = new File(datadir, "tmp102_x49");
   tmp102_file[ 2 ] = new File(datadir, "tmp102_x4A");
@@ -390,528 +715,232 @@ int main()
   pca9535_inversions_file[ 7 ] = new File(datadir, "pca9535x27_inversions");
   pca9535_port_configs_file[ 7 ] = new File(datadir, "pca9535x27_port_configs");
 
-  // SQLite objects to store values in database table
-  SQLite *tmp102_db  = new SQLite(sqlitedb, "tmp102", "insert into tmp102 (name,temperature) values (?,?)");
-  SQLite *htu21d_db = new SQLite(sqlitedb, "htu21d", "insert into htu21d (name,temperature,humidity) values (?,?,?)");
-  SQLite *bmp280_db  = new SQLite(sqlitedb, "bmp280", "insert into bmp280 (name,temperature,pressure) values (?,?,?)");
-  SQLite *bme680_db  = new SQLite(sqlitedb, "bme680", "insert into bme680 (name,temperature,humidity,pressure,resistance,gasvalid,stable) values (?,?,?,?,?,?,?)");
-  SQLite *bh1750fvi_db  = new SQLite(sqlitedb, "bh1750fvi", "insert into bh1750fvi (name,illuminance) values (?,?)");
-  SQLite *lis3dh_db  = new SQLite(sqlitedb, "lis3dh", "insert into lis3dh(name,gxmin,gx,gxmax,gymin,gy,gymax,gzmin,gz,gzmax,adc1,adc2,adc3,odr) values (?,?,?,?,?,?,?,?,?,?,?,?,?,?)");
-  SQLite *lis2mdl_db  = new SQLite(sqlitedb, "lis2mdl", "insert into lis2mdl(name,Bx,By,Bz,temperature) values (?,?,?,?,?)");
-  SQLite *lis3mdl_db  = new SQLite(sqlitedb, "lis3mdl", "insert into lis3mdl(name,Bx,By,Bz,temperature) values (?,?,?,?,?)");
-  SQLite *max31865_db  = new SQLite(sqlitedb, "max31865", "insert into max31865 (name,temperature,resistance,fault) values (?,?,?,?)");
-
-  SQLite *pca9535_db = new SQLite(sqlitedb, "pca9535", "insert into pca9535 (name,inputs,outputs,inversions,portconfigs) values (?,?,?,?,?)");
-
-// DIM services
-#ifdef USE_DIM_LIBS
-  struct bme680d
-  {
-    double T = 0;
-    double RH = 0;
-    double p = 0;
-    double R = 0;
-  };
+  if( snapshot && !snapshot->Open( sqlite_err ) ) fprintf(stderr, SD_ERR "snapshot %s error %d, values only in files\n", snapshotshm.c_str(), sqlite_err);
+  if( mqtt ) mqtt->Start();
 
-  bme680d bme680x76data, bme680x77data;
-  DimService *bme680x76Dim, *bme680x77Dim;
+  // SQLite objects to store values in database table
+  SQLite::SetDurability( durability );
+  SQLite::SetAutoCheckpoint( walcheckpoint );
+  SQLite::SetMmapSize( mmapsize );
 
-  struct bmp280d
-  {
-    double T = 0;
-    double p = 0;
-  };
+  SQLite *tmp102_db = new SQLite(sqlitedb, Schema<Tmp102Record>::Table(), SchemaInsert<Tmp102Record>());
+  SQLite *htu21d_db = new SQLite(sqlitedb, Schema<Htu21dRecord>::Table(), SchemaInsert<Htu21dRecord>());
+  SQLite *bmp280_db = new SQLite(sqlitedb, Schema<Bmp280Record>::Table(), SchemaInsert<Bmp280Record>());
+  SQLite *bme680_db = new SQLite(sqlitedb, Schema<Bme680Record>::Table(), SchemaInsert<Bme680Record>());
+  SQLite *bh1750fvi_db = new SQLite(sqlitedb, Schema<Bh1750fviRecord>::Table(), SchemaInsert<Bh1750fviRecord>());
+  SQLite *lis3dh_db = new SQLite(sqlitedb, Schema<Lis3dhRecord>::Table(), SchemaInsert<Lis3dhRecord>());
+  SQLite *lis2mdl_db = new SQLite(sqlitedb, Schema<Lis2mdlRecord>::Table(), SchemaInsert<Lis2mdlRecord>());
+  SQLite *lis3mdl_db = new SQLite(sqlitedb, Schema<Lis3mdlRecord>::Table(), SchemaInsert<Lis3mdlRecord>());
+  SQLite *max31865_db = new SQLite(sqlitedb, Schema<Max31865Record>::Table(), SchemaInsert<Max31865Record>());
 
-  bmp280d bmp280x76data, bmp280x77data;
-  DimService *bmp280x76Dim, *bmp280x77Dim;
+  SQLite *pca9535_db = new SQLite(sqlitedb, Schema<Pca9535Record>::Table(), SchemaInsert<Pca9535Record>());
 
-  struct bh1750fvid
+  // time range queries need index on (name, ts) in each table and
+  // samples are stored with integer timestamps unless table is old, with
+  // day partitions the tables of today are created here from main file
+  SQLite *all_db[ 10 ] = {tmp102_db, htu21d_db, bmp280_db, bme680_db, bh1750fvi_db, lis3dh_db, lis2mdl_db, lis3mdl_db, max31865_db, pca9535_db};
+  for(int i = 0; i < 10; i++)
   {
-    double Ev = 0;
-  };
+    all_db[ i ]->SetPartition( partition );
+    if( !all_db[ i ]->CheckIndex( sqlite_err ) ) fprintf(stderr, SD_ERR "%s index check error %d\n", all_db[ i ]->GetTable().c_str(), sqlite_err);
+    if( !all_db[ i ]->CheckTimeStamp( sqlite_err ) ) fprintf(stderr, SD_ERR "%s timestamp check error %d\n", all_db[ i ]->GetTable().c_str(), sqlite_err);
+  }
 
-  bh1750fvid bh1750fvix23data, bh1750fvix5Cdata;
-  DimService *bh1750fvix23Dim, *bh1750fvix5CDim;
+  // rows are queued for writer thread and committed in batches
+  SQLiteWriter dbwriter(4096, sqlitebatch, sqlitecommit);
+  for(int i = 0; i < 10; i++) dbwriter.AddTable( all_db[ i ] );
 
-  struct htu21dd
+  // rows spooled to local log and replayed when database is available
+  Spool *spool = nullptr;
+  if( spooldir != "" )
   {
-    double T = 0;
-    double RH = 0;
-  };
-
-  htu21dd htu21data;
-  DimService *htu21Dim;
+    spool = new Spool(spooldir, (uint64_t)( spoolmax * 1048576 ));
+    if( spool->Open( sqlite_err ) ) dbwriter.SetSpool( spool );
+    else fprintf(stderr, SD_ERR "spool %s error %d, rows written directly\n", spooldir.c_str(), sqlite_err);
+  }
 
-  struct lis2mdld
+  // minute, hour and day aggregates of double values updated with each row
+  Rollup *rollup[ 9 ] = {new Rollup(tmp102_db, Schema<Tmp102Record>::Nd), new Rollup(htu21d_db, Schema<Htu21dRecord>::Nd), new Rollup(bmp280_db, Schema<Bmp280Record>::Nd), new Rollup(bme680_db, Schema<Bme680Record>::Nd), new Rollup(bh1750fvi_db, Schema<Bh1750fviRecord>::Nd), new Rollup(lis3dh_db, Schema<Lis3dhRecord>::Nd), new Rollup(lis2mdl_db, Schema<Lis2mdlRecord>::Nd), new Rollup(lis3mdl_db, Schema<Lis3mdlRecord>::Nd), new Rollup(max31865_db, Schema<Max31865Record>::Nd)};
+  for(int i = 0; i < 9; i++)
   {
-    double Bx = 0;
-    double By = 0;
-    double Bz = 0;
-    double T = 0;
-  };
+    if( rollup[ i ]->Create( sqlite_err ) ) dbwriter.AddRollup( rollup[ i ] );
+    else fprintf(stderr, SD_ERR "%s aggregate tables error %d\n", rollup[ i ]->GetSource()->GetTable().c_str(), sqlite_err);
+  }
 
-  lis2mdld lis2mdlx1Edata;
-  DimService *lis2mdlx1EDim;
+  // recent samples of every chip in memory for windowed statistics
+  Recent *recent = new Recent(recentsamples, (size_t)( recentmax * 1048576 ));
+  dbwriter.SetRecent( recent );
 
-  struct lis3mdld
+  // recent samples from memory and older from database for local clients
+  QueryServer *query = nullptr;
+  if( querysocket != "" )
   {
-    double Bx = 0;
-    double By = 0;
-    double Bz = 0;
-    double T = 0;
-  };
-
-  lis3mdld lis3mdlx1Cdata, lis3mdlx1Edata;
-  DimService *lis3mdlx1CDim, *lis3mdlx1EDim;
+    query = new QueryServer(querysocket, recent);
+    for(int i = 0; i < 10; i++) query->AddTable( all_db[ i ] );
+    for(int i = 0; i < 9; i++) query->AddRollup( rollup[ i ] );
+  }
 
-  struct lis3dhd
+  // high rate tables stored as compressed time series instead of rows
+  vector<TimeSeriesStore *> tsstore;
+  for(int i = 0; i < 10; i++)
   {
-    double gxmin = 0;
-    double gx = 0;
-    double gxmax = 0;
-    double gymin = 0;
-    double gy = 0;
-    double gymax = 0;
-    double gzmin = 0;
-    double gz = 0;
-    double gzmax = 0;
-    int adc1 = 0;
-    int adc2 = 0;
-    int adc3 = 0;
-    int odr = 0;
-  };
+    if( tstables.find( all_db[ i ]->GetTable() ) == tstables.end() ) continue;
 
-  lis3dhd lis3dhx18data, lis3dhx19data;
-  DimService *lis3dhx18Dim, *lis3dhx19Dim;
+    tsstore.push_back( new TimeSeriesStore(tsdir, all_db[ i ]) );
+    dbwriter.AddStore( tsstore.back() );
+  }
 
-  struct max31865d
+  // age limit of table from its own RETAIN line or from line for all
+  // tables with the same suffix, for example *_1h for hourly aggregates
+  auto retaindays = [&](SQLite *db, string suffix)
   {
-    double T = 0;
-    double R = 0;
-    int F = 0;
+    if( retain.find( db->GetTable() ) != retain.end() ) return retain[ db->GetTable() ];
+    if( retain.find( "*" + suffix ) != retain.end() ) return retain[ "*" + suffix ];
+    return 0.0;
   };
 
-  max31865d max31865d00data, max31865d01data, max31865d02data, max31865d03data, max31865d04data, max31865d05data, max31865d06data, max31865d07data;
-  DimService *max31865d00Dim, *max31865d01Dim, *max31865d02Dim, *max31865d03Dim, *max31865d04Dim, *max31865d05Dim, *max31865d06Dim, *max31865d07Dim;
-
-  struct tmp102d
+  // whole partition files are removed instead of deleting raw rows
+  Retention retention(retainbatch, vacuumpages);
+  if( partition )
   {
-    double T = 0;
-  };
-
-  tmp102d tmp102x48data, tmp102x49data, tmp102x4Adata, tmp102x4Bdata;
-  DimService *tmp102x48Dim, *tmp102x49Dim, *tmp102x4ADim, *tmp102x4BDim;
-
-  struct pca9535d
+    retention.AddPartitions(tmp102_db, retain.find( "*" ) != retain.end() ? retain[ "*" ] : 0);
+    for(int i = 0; i < 10; i++)
+    {
+      if( retain.find( all_db[ i ]->GetTable() ) != retain.end() ) fprintf(stderr, SD_WARNING "RETAIN %s ignored with day partitions, only RETAIN * is used for raw tables\n", all_db[ i ]->GetTable().c_str() );
+    }
+  }
+  else for(int i = 0; i < 10; i++) retention.Add(all_db[ i ], retaindays(all_db[ i ], ""));
+  for(int i = 0; i < 9; i++)
   {
-    int inputs = 0;
-    int outputs = 0;
-    int inversions = 0;
-    int portconfigs = 0;
-  };
+    string raw = rollup[ i ]->GetSource()->GetTable();
 
-  pca9535d pca9535x20data, pca9535x21data, pca9535x22data, pca9535x23data, pca9535x24data, pca9535x25data, pca9535x26data, pca9535x27data;
-  DimService *pca9535x20Dim, *pca9535x21Dim, *pca9535x22Dim, *pca9535x23Dim, *pca9535x24Dim, *pca9535x25Dim, *pca9535x26Dim, *pca9535x27Dim;
+    for(int l = 0; l < rollup[ i ]->GetLevels(); l++)
+    {
+      SQLite *level = rollup[ i ]->GetLevel( l );
+      retention.Add(level, retaindays(level, level->GetTable().substr( raw.length() )));
+    }
+  }
+  // main file for checks at start and checkpoints between insert batches
+  SQLite *main_db = new SQLite(sqlitedb, "", "");
+  if( retention.GetPolicies() > 0 && !main_db->CheckAutoVacuum( sqlite_err ) ) fprintf(stderr, SD_ERR "auto vacuum check error %d\n", sqlite_err);
 
+// DIM services
+#ifdef USE_DIM_LIBS
+  // one service for each configured chip with layout from its channel
+  // schema, bme680 services have only the doubles
+  DimServices dim( dimserver );
+  int tmp102_dim[ 4 ], htu21d_dim = -1, bmp280_dim[ 2 ], bme680_dim[ 2 ], bh1750fvi_dim[ 2 ];
+  int lis2mdl_dim = -1, lis3mdl_dim[ 2 ], lis3dh_dim[ 2 ], max31865_dim[ 8 ], pca9535_dim[ 8 ];
+
+  const char *tmp102_svc[ 4 ] = {"tmp102x48", "tmp102x49", "tmp102x4A", "tmp102x4B"};
+  const char *bmp280_svc[ 2 ] = {"bmp280x76", "bmp280x77"};
+  const char *bme680_svc[ 2 ] = {"bme680x76", "bme680x77"};
+  const char *bh1750fvi_svc[ 2 ] = {"bh1750fvix23", "bh1750fvix5C"};
+  const char *lis3mdl_svc[ 2 ] = {"lis3mdlx1C", "lis3mdlx1E"};
+  const char *lis3dh_svc[ 2 ] = {"lis3dhx18", "lis3dhx19"};
+  char max31865_svc[ 8 ][ 16 ], pca9535_svc[ 8 ][ 16 ];
+
+  for(int i = 0; i < 8; i++)
+  {
+    snprintf(max31865_svc[ i ], 16, "max31865d%02d", i);
+    snprintf(pca9535_svc[ i ], 16, "pca9535x%02X", 0x20 + i);
+  }
+
+  bool dimon = ( dimserver != "" );
+  for(int i = 0; i < 4; i++) tmp102_dim[ i ] = ( dimon && tmp102[ i ] ) ? dim.Add<Tmp102Record>( tmp102_svc[ i ] ) : -1;
+  if( dimon && htu21d ) htu21d_dim = dim.Add<Htu21dRecord>( "htu21dx" );
+  for(int i = 0; i < 2; i++) bmp280_dim[ i ] = ( dimon && bmp280[ i ] ) ? dim.Add<Bmp280Record>( bmp280_svc[ i ] ) : -1;
+  for(int i = 0; i < 2; i++) bme680_dim[ i ] = ( dimon && bme680[ i ] ) ? dim.Add<Bme680Record>(bme680_svc[ i ], 0) : -1;
+  for(int i = 0; i < 2; i++) bh1750fvi_dim[ i ] = ( dimon && bh1750fvi[ i ] ) ? dim.Add<Bh1750fviRecord>( bh1750fvi_svc[ i ] ) : -1;
+  if( dimon && lis2mdl ) lis2mdl_dim = dim.Add<Lis2mdlRecord>( "lis2mdlx1E" );
+  for(int i = 0; i < 2; i++) lis3mdl_dim[ i ] = ( dimon && lis3mdl[ i ] ) ? dim.Add<Lis3mdlRecord>( lis3mdl_svc[ i ] ) : -1;
+  for(int i = 0; i < 2; i++) lis3dh_dim[ i ] = ( dimon && lis3dh[ i ] ) ? dim.Add<Lis3dhRecord>( lis3dh_svc[ i ] ) : -1;
+  for(int i = 0; i < 8; i++) max31865_dim[ i ] = ( dimon && max31865[ i ] ) ? dim.Add<Max31865Record>( max31865_svc[ i ] ) : -1;
+  for(int i = 0; i < 8; i++) pca9535_dim[ i ] = ( dimon && pca9535[ i ] ) ? dim.Add<Pca9535Record>( pca9535_svc[ i ] ) : -1;
+
+  fprintf(stderr, SD_DEBUG "%zu DIM services\n", dim.GetServices());
 
-  if( bmp280x76 )
-  {
-    fprintf(stderr, SD_DEBUG "Create DIM service bmp280x76\n");
-    bmp280x76Dim = new DimService( (dimserver + "/bmp280x76").c_str(), "D:2", &bmp280x76data, sizeof( bmp280x76data ) );
-  }
-  else
+  // start DIM server
+  if( dimon )
   {
-    bmp280x76Dim = nullptr; 
+    DimServer::setDnsNode( dimdns.c_str() );
+    DimServer::start( dimserver.c_str() );
   }
+#endif
 
-  if( bmp280x77 )
-  {
-    fprintf(stderr, SD_DEBUG "Create DIM service bmp280x77\n");
-    bmp280x77Dim = new DimService( (dimserver + "/bmp280x77").c_str(), "D:2", &bmp280x77data, sizeof( bmp280x77data ) );
-  }
-  else
-  {
-    bmp280x77Dim = nullptr; 
-  }
+  // chip initializations, hold the I2C bus lock over all register writes
+  I2CBus *i2cbus = I2CBus::Get( i2cdev );
+  int i2cbus_err = 0;
+  bool i2cbus_locked = i2cbus->Lock( i2cbus_err );
+  if( !i2cbus_locked ) fprintf(stderr, SD_WARNING "could not lock %s for chip initialization: %d\n", i2cdev.c_str(), i2cbus_err);
 
-  if( bme680x76 )
-  {
-    fprintf(stderr, SD_DEBUG "Create DIM service bme680x76\n");
-    bme680x76Dim = new DimService( (dimserver + "/bme680x76").c_str(), "D:4", &bme680x76data, sizeof( bme680x76data ) );
-  }
-  else
+  for( int i = 0; i < 4; i++)
   {
-    bme680x76Dim = nullptr; 
-  }
+    if( tmp102[ i ] )
+    {
+      switch( i )
+      {
+        case 0:
+          tmp102[ 0 ]->SetAddress0x48();
+	  break;
+	case 1:
+          tmp102[ 1 ]->SetAddress0x49();
+	  break;
+	case 2:
+          tmp102[ 2 ]->SetAddress0x4A();
+	  break;
+        case 3:
+          tmp102[ 3 ]->SetAddress0x4B();
+	  break;
+	default:
+          cout << "-- program bug\n";
+          return -1;
+      }
 
-  if( bme680x77 )
-  {
-    fprintf(stderr, SD_DEBUG "Create DIM service bme680x77\n");
-    bme680x77Dim = new DimService( (dimserver + "/bme680x77").c_str(), "D:4", &bme680x77data, sizeof( bme680x77data ) );
-  }
-  else
-  {
-    bme680x77Dim = nullptr; 
-  }
+      fprintf(stderr, SD_INFO "%s %s %d\n", tmp102[ i ]->GetName().c_str(), tmp102[ i ]->GetDevice().c_str(), tmp102[ i ]->GetAddress() );
 
-  if( bh1750fvix23 )
-  {
-    fprintf(stderr, SD_DEBUG "Create DIM service bh1750fvix23\n");
-    bh1750fvix23Dim = new DimService( (dimserver + "/bh1750fvix23").c_str(), "D:1", &bh1750fvix23data, sizeof( bh1750fvix23data ) );
-  }
-  else
-  {
-    bh1750fvix23Dim = nullptr;
+      tmp102[ i ]->SetPointer(TMP102_TEMP_REG);
+  
+      fprintf(stderr, SD_DEBUG "SQLite file: %s\n", tmp102_db->GetFile().c_str() );
+      fprintf(stderr, SD_DEBUG "SQLite table: %s\n", tmp102_db->GetTable().c_str() );
+      fprintf(stderr, SD_DEBUG "SQLite datetime(): %s\n", tmp102_db->GetDateTime( sqlite_err ).c_str() );
+      fprintf(stderr, SD_DEBUG "SQLite error: %d\n", sqlite_err );
+    }
   }
 
-  if( bh1750fvix5C )
-  {
-    fprintf(stderr, SD_DEBUG "Create DIM service bh1750fvix5C\n");
-    bh1750fvix5CDim = new DimService( (dimserver + "/bh1750fvix5C").c_str(), "D:1", &bh1750fvix5Cdata, sizeof( bh1750fvix5Cdata ) );
-  }
-  else
+  if( htu21d )
   {
-    bh1750fvix5CDim = nullptr;
-  }
+    fprintf(stderr, SD_INFO "%s %s\n", htu21d->GetName().c_str(), htu21d->GetDevice().c_str() );
+    fprintf(stderr, SD_DEBUG "SQLite table: %s\n", htu21d_db->GetTable().c_str() );
 
-  if( htu21dx )
-  {
-    fprintf(stderr, SD_DEBUG "Create DIM service htu21dx\n");
-    htu21Dim = new DimService( (dimserver + "/htu21dx").c_str(), "D:2", &htu21data, sizeof( htu21data ) );
-  }
-  else
-  {
-    htu21Dim = nullptr;
   }
 
-  if( lis2mdlx1E )
-  {
-    fprintf(stderr, SD_DEBUG "Create DIM service lis2mdlx1E\n");
-    lis2mdlx1EDim = new DimService( (dimserver + "/lis2mdlx1E").c_str(), "D:4", &lis2mdlx1Edata, sizeof( lis2mdlx1Edata ) );
-  }
-  else
+  for( int i = 0; i < 2; i++)
   {
-    lis2mdlx1EDim = nullptr;
-  }
+    if( bmp280[ i ] )
+    {
+      if( i == 0 ) bmp280[ i ]->SetAddress0x76(); 
+      else bmp280[ i ]->SetAddress0x77();
 
-  if( lis3mdlx1C )
-  {
-    fprintf(stderr, SD_DEBUG "Create DIM service lis3mdlx1C\n");
-    lis3mdlx1CDim = new DimService( (dimserver + "/lis3mdlx1C").c_str(), "D:4", &lis3mdlx1Cdata, sizeof( lis3mdlx1Cdata ) );
-  }
-  else
-  {
-    lis3mdlx1CDim = nullptr;
-  }
+      fprintf(stderr, SD_INFO "%s %s %d\n", bmp280[ i ]->GetName().c_str(), bmp280[ i ]->GetDevice().c_str(), bmp280[ i ]->GetAddress() );
 
-  if( lis3mdlx1E )
-  {
-    fprintf(stderr, SD_DEBUG "Create DIM service lis3mdlx1E\n");
-    lis3mdlx1EDim = new DimService( (dimserver + "/lis3mdlx1E").c_str(), "D:4", &lis3mdlx1Edata, sizeof( lis3mdlx1Edata ) );
-  }
-  else
-  {
-    lis3mdlx1EDim = nullptr;
-  }
+      fprintf(stderr, SD_DEBUG "read BMP280 calibration data\n");
+      if( !bmp280[ i ]->GetCalibration() )
+      {
+        fprintf(stderr, SD_ERR "problem reading BMP280 calibration data, quit now\n");
+        return -1;
+      }
 
-  if( lis3dhx18 )
-  {
-    fprintf(stderr, SD_DEBUG "Create DIM service lis3dhx18\n");
-    lis3dhx18Dim = new DimService( (dimserver + "/lis3dhx18").c_str(), "D:9;I:4", &lis3dhx18data, sizeof( lis3dhx18data ) );
-  }
-  else
-  {
-    lis3dhx18Dim = nullptr;
-  }
+      fprintf(stderr, SD_INFO "%d T and %d p oversampling\n", bmp280_TOverSample[ i ], bmp280_POverSample[ i ]);
+      bmp280[ i ]->SetTOverSample( bmp280_TOverSample[ i ] );
+      bmp280[ i ]->SetPOverSample( bmp280_POverSample[ i ] );
 
-  if( lis3dhx19 )
-  {
-    fprintf(stderr, SD_DEBUG "Create DIM service lis3dhx19\n");
-    lis3dhx19Dim = new DimService( (dimserver + "/lis3dhx19").c_str(), "D:9;I:4", &lis3dhx19data, sizeof( lis3dhx19data ) );
-  }
-  else
-  {
-    lis3dhx19Dim = nullptr;
-  }
+      fprintf(stderr, SD_DEBUG "SQLite table: %s\n", bmp280_db->GetTable().c_str() );
 
-  if( max31865_00 )
-  {
-    fprintf(stderr, SD_DEBUG "Create DIM service max31865d00\n");
-    max31865d00Dim = new DimService( (dimserver + "/max31865d00").c_str(), "D:2;I:1", &max31865d00data, sizeof( max31865d00data ) );
-  }
-  else
-  {
-    max31865d00Dim = nullptr;
+    }
   }
 
-  if( max31865_01 )
-  {
-    fprintf(stderr, SD_DEBUG "Create DIM service max31865d01\n");
-    max31865d01Dim = new DimService( (dimserver + "/max31865d01").c_str(), "D:2;I:1", &max31865d01data, sizeof( max31865d01data ) );
-  }
-  else
-  {
-    max31865d01Dim = nullptr;
-  }
-
-  if( max31865_02 )
-  {
-    fprintf(stderr, SD_DEBUG "Create DIM service max31865d02\n");
-    max31865d02Dim = new DimService( (dimserver + "/max31865d02").c_str(), "D:2;I:1", &max31865d02data, sizeof( max31865d02data ) );
-  }
-  else
-  {
-    max31865d02Dim = nullptr;
-  }
-
-  if( max31865_03 )
-  {
-    fprintf(stderr, SD_DEBUG "Create DIM service max31865d03\n");
-    max31865d03Dim = new DimService( (dimserver + "/max31865d03").c_str(), "D:2;I:1", &max31865d03data, sizeof( max31865d03data ) );
-  }
-  else
-  {
-    max31865d03Dim = nullptr;
-  }
-
-  if( max31865_04 )
-  {
-    fprintf(stderr, SD_DEBUG "Create DIM service max31865d04\n");
-    max31865d04Dim = new DimService( (dimserver + "/max31865d04").c_str(), "D:2;I:1", &max31865d04data, sizeof( max31865d04data ) );
-  }
-  else
-  {
-    max31865d04Dim = nullptr;
-  }
-
-  if( max31865_05 )
-  {
-    fprintf(stderr, SD_DEBUG "Create DIM service max31865d05\n");
-    max31865d05Dim = new DimService( (dimserver + "/max31865d05").c_str(), "D:2;I:1", &max31865d05data, sizeof( max31865d05data ) );
-  }
-  else
-  {
-    max31865d05Dim = nullptr;
-  }
-
-  if( max31865_06 )
-  {
-    fprintf(stderr, SD_DEBUG "Create DIM service max31865d06\n");
-    max31865d06Dim = new DimService( (dimserver + "/max31865d06").c_str(), "D:2;I:1", &max31865d06data, sizeof( max31865d06data ) );
-  }
-  else
-  {
-    max31865d06Dim = nullptr;
-  }
-
-  if( max31865_07 )
-  {
-    fprintf(stderr, SD_DEBUG "Create DIM service max31865d07\n");
-    max31865d07Dim = new DimService( (dimserver + "/max31865d07").c_str(), "D:2;I:1", &max31865d07data, sizeof( max31865d07data ) );
-  }
-  else
-  {
-    max31865d07Dim = nullptr;
-  }
-
-  if( tmp102x48 )
-  {
-    fprintf(stderr, SD_DEBUG "Create DIM service tmp102x48\n");
-    tmp102x48Dim = new DimService( (dimserver + "/tmp102x48").c_str(), "D:1", &tmp102x48data, sizeof( tmp102x48data ) );
-  }
-  else
-  {
-    tmp102x48Dim = nullptr;
-  }
-
-  if( tmp102x49 )
-  {
-    fprintf(stderr, SD_DEBUG "Create DIM service tmp102x49\n");
-    tmp102x49Dim = new DimService( (dimserver + "/tmp102x49").c_str(), "D:1", &tmp102x49data, sizeof( tmp102x49data ) );
-  }
-  else
-  {
-    tmp102x49Dim = nullptr;
-  }
-
-  if( tmp102x4A )
-  {
-    fprintf(stderr, SD_DEBUG "Create DIM service tmp102x4A\n");
-    tmp102x4ADim = new DimService( (dimserver + "/tmp102x4A").c_str(), "D:1", &tmp102x4Adata, sizeof( tmp102x4Adata ) );
-  }
-  else
-  {
-    tmp102x4ADim = nullptr;
-  }
-
-  if( tmp102x4B )
-  {
-    fprintf(stderr, SD_DEBUG "Create DIM service tmp102x4B\n");
-    tmp102x4BDim = new DimService( (dimserver + "/tmp102x4B").c_str(), "D:1", &tmp102x4Bdata, sizeof( tmp102x4Bdata ) );
-  }
-  else
-  {
-    tmp102x4BDim = nullptr;
-  }
-
-  if( pca9535x20 )
-  {
-    fprintf(stderr, SD_DEBUG "Create DIM service pca9535x20\n");
-    pca9535x20Dim = new DimService( (dimserver + "/pca9535x20").c_str(), "I:4", &pca9535x20data, sizeof( pca9535x20data ) );
-  }
-  else
-  {
-    pca9535x20Dim = nullptr;
-  }
-
-  if( pca9535x21 )
-  {
-    fprintf(stderr, SD_DEBUG "Create DIM service pca9535x21\n");
-    pca9535x21Dim = new DimService( (dimserver + "/pca9535x21").c_str(), "I:4", &pca9535x21data, sizeof( pca9535x21data ) );
-  }
-  else
-  {
-    pca9535x21Dim = nullptr;
-  }
-
-  if( pca9535x22 )
-  {
-    fprintf(stderr, SD_DEBUG "Create DIM service pca9535x22\n");
-    pca9535x22Dim = new DimService( (dimserver + "/pca9535x22").c_str(), "I:4", &pca9535x22data, sizeof( pca9535x22data ) );
-  }
-  else
-  {
-    pca9535x22Dim = nullptr;
-  }
-
-  if( pca9535x23 )
-  {
-    fprintf(stderr, SD_DEBUG "Create DIM service pca9535x23\n");
-    pca9535x23Dim = new DimService( (dimserver + "/pca9535x23").c_str(), "I:4", &pca9535x23data, sizeof( pca9535x23data ) );
-  }
-  else
-  {
-    pca9535x23Dim = nullptr;
-  }
-
-  if( pca9535x24 )
-  {
-    fprintf(stderr, SD_DEBUG "Create DIM service pca9535x24\n");
-    pca9535x24Dim = new DimService( (dimserver + "/pca9535x24").c_str(), "I:4", &pca9535x24data, sizeof( pca9535x24data ) );
-  }
-  else
-  {
-    pca9535x24Dim = nullptr;
-  }
-
-  if( pca9535x25 )
-  {
-    fprintf(stderr, SD_DEBUG "Create DIM service pca9535x25\n");
-    pca9535x25Dim = new DimService( (dimserver + "/pca9535x25").c_str(), "I:4", &pca9535x25data, sizeof( pca9535x25data ) );
-  }
-  else
-  {
-    pca9535x25Dim = nullptr;
-  }
-
-  if( pca9535x26 )
-  {
-    fprintf(stderr, SD_DEBUG "Create DIM service pca9535x26\n");
-    pca9535x26Dim = new DimService( (dimserver + "/pca9535x26").c_str(), "I:4", &pca9535x26data, sizeof( pca9535x26data ) );
-  }
-  else
-  {
-    pca9535x26Dim = nullptr;
-  }
-
-  if( pca9535x27 )
-  {
-    fprintf(stderr, SD_DEBUG "Create DIM service pca9535x27\n");
-    pca9535x27Dim = new DimService( (dimserver + "/pca9535x27").c_str(), "I:4", &pca9535x27data, sizeof( pca9535x27data ) );
-  }
-  else
-  {
-    pca9535x27Dim = nullptr;
-  }
-
-  // start DIM server
-  bool dimruns = false;
-  if( dimserver != "" )
-  {
-    DimServer::setDnsNode( dimdns.c_str() );
-    DimServer::start( dimserver.c_str() );
-    dimruns = true;
-  }
-#endif
-
-  // chip initializations
-  for( int i = 0; i < 4; i++)
-  {
-    if( tmp102[ i ] )
-    {
-      switch( i )
-      {
-        case 0:
-          tmp102[ 0 ]->SetAddress0x48();
-	  break;
-	case 1:
-          tmp102[ 1 ]->SetAddress0x49();
-	  break;
-	case 2:
-          tmp102[ 2 ]->SetAddress0x4A();
-	  break;
-        case 3:
-          tmp102[ 3 ]->SetAddress0x4B();
-	  break;
-	default:
-          cout << "-- program bug\n";
-          return -1;
-      }
-
-      fprintf(stderr, SD_INFO "%s %s %d\n", tmp102[ i ]->GetName().c_str(), tmp102[ i ]->GetDevice().c_str(), tmp102[ i ]->GetAddress() );
-
-      tmp102[ i ]->SetPointer(TMP102_TEMP_REG);
-  
-      fprintf(stderr, SD_DEBUG "SQLite file: %s\n", tmp102_db->GetFile().c_str() );
-      fprintf(stderr, SD_DEBUG "SQLite table: %s\n", tmp102_db->GetTable().c_str() );
-      fprintf(stderr, SD_DEBUG "SQLite datetime(): %s\n", tmp102_db->GetDateTime( sqlite_err ).c_str() );
-      fprintf(stderr, SD_DEBUG "SQLite error: %d\n", sqlite_err );
-    }
-  }
-
-  if( htu21d )
-  {
-    fprintf(stderr, SD_INFO "%s %s\n", htu21d->GetName().c_str(), htu21d->GetDevice().c_str() );
-    fprintf(stderr, SD_DEBUG "SQLite table: %s\n", htu21d_db->GetTable().c_str() );
-
-  }
-
-  for( int i = 0; i < 2; i++)
-  {
-    if( bmp280[ i ] )
-    {
-      if( i == 0 ) bmp280[ i ]->SetAddress0x76(); 
-      else bmp280[ i ]->SetAddress0x77();
-
-      fprintf(stderr, SD_INFO "%s %s %d\n", bmp280[ i ]->GetName().c_str(), bmp280[ i ]->GetDevice().c_str(), bmp280[ i ]->GetAddress() );
-
-      fprintf(stderr, SD_DEBUG "read BMP280 calibration data\n");
-      if( !bmp280[ i ]->GetCalibration() )
-      {
-        fprintf(stderr, SD_ERR "problem reading BMP280 calibration data, quit now\n");
-        return -1;
-      }
-
-      fprintf(stderr, SD_INFO "%d T and %d p oversampling\n", bmp280_TOverSample[ i ], bmp280_POverSample[ i ]);
-      bmp280[ i ]->SetTOverSample( bmp280_TOverSample[ i ] );
-      bmp280[ i ]->SetPOverSample( bmp280_POverSample[ i ] );
-
-      fprintf(stderr, SD_DEBUG "SQLite table: %s\n", bmp280_db->GetTable().c_str() );
-
-    }
-  }
-
-  for( int i = 0; i < 2; i++)
+  for( int i = 0; i < 2; i++)
   {
     if( bme680[ i ] )
     {
@@ -927,18 +956,21 @@ int main()
         return -1;
       }
 
-      fprintf(stderr, SD_INFO "%d H, %d T and %d p oversampling\n", bme680_HOverSample[ i ], bme680_TOverSample[ i ], bme680_POverSample[ i ] );
-      bme680[ i ]->SetOverSample( bme680_HOverSample[ i ], bme680_TOverSample[ i ], bme680_POverSample[ i ] );
+      Bme680Profile profile;
+      profile.HOverSample = bme680_HOverSample[ i ];
+      profile.TOverSample = bme680_TOverSample[ i ];
+      profile.POverSample = bme680_POverSample[ i ];
+      profile.Filter = bme680_Filter[ i ];
+      profile.Tamb = Tamb;
+      profile.HeatTemperature[ 0 ] = bme680_T0[ i ];
+      profile.GasWaitTime[ 0 ] = bme680_GasWaitTime[ i ];
+      profile.RunGas = true;
+      profile.HeaterProfile = 0;
 
+      fprintf(stderr, SD_INFO "%d H, %d T and %d p oversampling\n", bme680_HOverSample[ i ], bme680_TOverSample[ i ], bme680_POverSample[ i ] );
       fprintf(stderr, SD_INFO "filter %d\n", bme680_Filter[ i ] );
-      bme680[ i ]->SetFilter( bme680_Filter[ i ] );
-
       fprintf(stderr, SD_INFO "profile 0: 0x%02x pulse, ambient %d C, target %d C\n", bme680_GasWaitTime[ i ], Tamb, bme680_T0[ i ]);
-      bme680[ i ]->SetGasWaitTime(0, bme680_GasWaitTime[ i ]); 
-      bme680[ i ]->SetGasHeatTemperature(0, Tamb, bme680_T0[ i ]); // 
-      bme680[ i ]->RunGas();
-      bme680[ i ]->HeaterOn();
-      bme680[ i ]->SetHeaterProfile( 0 );
+      if( !bme680[ i ]->ApplyProfile( profile ) ) fprintf(stderr, SD_ERR "%s configuration write error %d\n", bme680[ i ]->GetName().c_str(), bme680[ i ]->GetError() );
 
       fprintf(stderr, SD_DEBUG "SQLite table: %s\n", bme680_db->GetTable().c_str() );
     }
@@ -972,33 +1004,19 @@ int main()
         lis3dh[ i ]->Boot( );
         usleep( 10000 );
 
-        lis3dh[ i ]->SetDataRate( 0 );
-
-        fprintf(stderr, SD_INFO "Enable X, Y and Z\n");
-        lis3dh[ i ]->XEnable();
-        lis3dh[ i ]->YEnable();
-        lis3dh[ i ]->ZEnable();
-
-        fprintf(stderr, SD_INFO "Set data rate 25 Hz\n");
-        lis3dh[ i ]->SetDataRate( 3 );
-
-        fprintf(stderr, SD_INFO "Set block data update\n");
-        lis3dh[ i ]->BlockDataEnable();
-
-        fprintf(stderr, SD_INFO "Start normal mode\n");
-        lis3dh[ i ]->NormalMode();
-
-        fprintf(stderr, SD_INFO "Enable ADC\n");
-        lis3dh[ i ]->ADCEnable();
-
-        fprintf(stderr, SD_INFO "Enable temperature measurement\n");
-        lis3dh[ i ]->TempEnable();
-
-        fprintf(stderr, SD_INFO "Enable FIFO\n");
-        lis3dh[ i ]->FifoEnable();
-
-	fprintf(stderr, SD_INFO "Set FIFO mode 2 Stream\n");
-        lis3dh[ i ]->SetFifoMode( 2 );
+        Lis3dhProfile profile;
+        profile.DataRate = 3;
+        profile.Mode = 1;
+        profile.BlockData = true;
+        profile.ADCEnable = true;
+        profile.TempEnable = true;
+        profile.FifoEnable = true;
+        profile.FifoMode = 2;
+
+        fprintf(stderr, SD_INFO "Enable X, Y and Z with data rate 25 Hz in normal mode\n");
+        fprintf(stderr, SD_INFO "Set block data update, enable ADC and temperature measurement\n");
+        fprintf(stderr, SD_INFO "Enable FIFO in mode 2 Stream\n");
+        if( !lis3dh[ i ]->ApplyProfile( profile ) ) fprintf(stderr, SD_ERR "%s configuration write error %d\n", lis3dh[ i ]->GetName().c_str(), lis3dh[ i ]->GetError() );
       }
       else
       {
@@ -1012,10 +1030,12 @@ int main()
   {
     if( lis2mdl->WhoAmI() )
     {
-      fprintf(stderr, SD_INFO "Enable temperature compensation\n");
-      lis2mdl->TempCompEnable();
-      fprintf(stderr, SD_INFO "Enable block data\n");
-      lis2mdl->BlockDataEnable();
+      Lis2mdlProfile profile;
+      profile.TempComp = true;
+      profile.BlockData = true;
+
+      fprintf(stderr, SD_INFO "Enable temperature compensation and block data\n");
+      if( !lis2mdl->ApplyProfile( profile ) ) fprintf(stderr, SD_ERR "%s configuration write error %d\n", lis2mdl->GetName().c_str(), lis2mdl->GetError() );
 
       fprintf(stderr, SD_INFO "%s %s %d\n", lis2mdl->GetName().c_str(), lis2mdl->GetDevice().c_str(), lis2mdl->GetAddress() );
       fprintf(stderr, SD_DEBUG "SQLite table: %s\n", lis2mdl_db->GetTable().c_str() );
@@ -1041,11 +1061,14 @@ int main()
 
       if( lis3mdl[ i ]->WhoAmI() )
       {
-        lis3mdl[ i ]->SetXYOpMode( 3 );
-        lis3mdl[ i ]->SetZOpMode( 3 );
-        lis3mdl[ i ]->SetFullScale( 0 );
-        lis3mdl[ i ]->FastReadEnable();
-        lis3mdl[ i ]->TempEnable();
+        Lis3mdlProfile profile;
+        profile.XYOpMode = 3;
+        profile.ZOpMode = 3;
+        profile.FullScale = 0;
+        profile.FastRead = true;
+        profile.TempEnable = true;
+
+        if( !lis3mdl[ i ]->ApplyProfile( profile ) ) fprintf(stderr, SD_ERR "%s configuration write error %d\n", lis3mdl[ i ]->GetName().c_str(), lis3mdl[ i ]->GetError() );
 
         fprintf(stderr, SD_INFO "%s %s %d\n", lis3mdl[ i ]->GetName().c_str(), lis3mdl[ i ]->GetDevice().c_str(), lis3mdl[ i ]->GetAddress() );
         fprintf(stderr, SD_DEBUG "SQLite table: %s\n", lis3mdl_db->GetTable().c_str() );
@@ -1086,115 +1109,99 @@ int main()
     }
   }
 
-  int inputs = 0, outputs = 0, inversions = 0, portconfigs = 0;
-  double T = 0, TF = 0, RH = 0, p = 0, R = 0, Ev = 0;
-  double Bx = 0, By = 0, Bz = 0;
-  double gx = 0, gy = 0, gz = 0;
-  double gxmin = 0, gymin = 0, gzmin = 0;
-  double gxmax = 0, gymax = 0, gzmax = 0;
-  int adc1 = 0, adc2 = 0, adc3 = 0;
-  uint8_t samples = 0;
-  int16_t *fifoX = new int16_t[ 32 ]; 
-  int16_t *fifoY = new int16_t[ 32 ]; 
-  int16_t *fifoZ = new int16_t[ 32 ]; 
-  int16_t xmedian = 0, xmin = 0, xmax = 0, ymedian = 0, ymin = 0, ymax =0, zmedian = 0, zmin = 0, zmax =0;
-  uint8_t ODR = 0;
-  char Valid = 'N', Stable = 'N';
-  int F = 0;
-  double dbl_array[ 12 ];
-  int int_array[ 10 ];
-  int j = 0;
-  while( cont )
+  if( i2cbus_locked ) i2cbus->Unlock();
+
+  // each chip is read by its own periodic task, tasks on one bus are run
+  // one at a time and different buses in parallel; the recent samples ring
+  // of each chip is registered here and kept by its task
+  Scheduler sched;
+  sched.SetPolicy( schedpolicy );
+
+  for(int i = 0; i < 4; i++)
   {
-    for(int i = 0; i < 4; i++)
+    if( tmp102[ i ] )
     {
-      if( tmp102[ i ] )
-      {	      
+      Recent::Ring *ring = dbwriter.Register<Tmp102Record>(tmp102_db, tmp102[ i ]->GetName());
+      sched.Add(i2cdev, tmp102_tag[ i ], Setting( period, tmp102_tag[ i ], readinterval ), Setting( phase, tmp102_tag[ i ], 0 ), 0, nullptr, [&, i, ring]()
+      {
+        double T = 0;
+        int64_t ts = 0;
+        int sqlite_err = 0;
+
         tmp102[ i ]->ReadTemperature();
+        ts = SQLite::TimeStamp();
         T = tmp102[ i ]->GetTemperature();
 
         fprintf(stderr, SD_INFO "%s = %f C\n", tmp102[ i ]->GetName().c_str(), T);
 	tmp102_file[ i ]->Write( T );
-        dbl_array[ 0 ] = T;
-        tmp102_db->Insert(tmp102[ i ]->GetName(), 1, dbl_array, sqlite_err );
+        Tmp102Record record = {T};
+        dbwriter.Insert(tmp102_db, ring, tmp102[ i ]->GetName(), ts, record, sqlite_err);
         if( sqlite_err != SQLITE_OK ) fprintf(stderr, SD_ERR "error writing SQLite database: %d\n", sqlite_err);
 
 #ifdef USE_DIM_LIBS
-	if( dimruns )
-        {
-          if( i == 0 )
-          {
-            fprintf(stderr, SD_DEBUG "Update DIM service tmp102x48\n");
-            tmp102x48data.T = T;
-            tmp102x48Dim->updateService();
-          }
-          else if( i == 1 )
-          {
-            fprintf(stderr, SD_DEBUG "Update DIM service tmp102x49\n");
-            tmp102x49data.T = T;
-            tmp102x49Dim->updateService();
-          }
-          else if( i == 2 )
-          {
-            fprintf(stderr, SD_DEBUG "Update DIM service tmp102x4A\n");
-            tmp102x4Adata.T = T;
-            tmp102x4ADim->updateService();
-          }
-          else if( i == 3 )
-          {
-            fprintf(stderr, SD_DEBUG "Update DIM service tmp102x4B\n");
-            tmp102x4Bdata.T = T;
-            tmp102x4BDim->updateService();
-          }
-	}
+        dim.Set(tmp102_dim[ i ], record);
 #endif
-      }
+      });
     }
+  }
 
-    if( htu21d )
+  // humidity conversion is its own stage after temperature so that other
+  // chips on the bus are read while it converts
+  double htu21d_T = 0;
+  int64_t htu21d_ts = 0;
+  bool htu21d_ok = false;
+
+  if( htu21d )
+  {
+    Recent::Ring *ring = dbwriter.Register<Htu21dRecord>(htu21d_db, htu21d->GetName());
+    sched.Add(i2cdev, "HTU21D", Setting( period, "HTU21D", readinterval ), Setting( phase, "HTU21D", 0 ), 50000, [&]() { htu21d->TriggerTemperature(); }, [&]()
     {
-      htu21d->TriggerTemperature();
-      usleep( 50000 ); // 50 ms delay
-      if( htu21d->ReadTemperature() )
-      {
-        T = htu21d->GetTemperature();
-        htu21d_T_file->Write( T );
+      htu21d_ok = htu21d->ReadTemperature();
 
-        htu21d->TriggerHumidity();
-        usleep( 50000 ); // 50 ms delay
+      if( htu21d_ok )
+      {
+        htu21d_ts = SQLite::TimeStamp();
+        htu21d_T = htu21d->GetTemperature();
+        htu21d_T_file->Write( htu21d_T );
+      }
+    });
 
-        if( htu21d->ReadHumidity() )
-        {
-          RH = htu21d->GetHumidity();
-          fprintf(stderr, SD_INFO "%s = %f C, %f %%\n", htu21d->GetName().c_str(), T, RH);
+    sched.AddStage(i2cdev, "HTU21D", 50000, [&]() { if( htu21d_ok ) htu21d->TriggerHumidity(); }, [&, ring]()
+    {
+      double RH = 0;
+      int sqlite_err = 0;
 
-	  htu21d_RH_file->Write( RH );
+      if( htu21d_ok && htu21d->ReadHumidity() )
+      {
+        RH = htu21d->GetHumidity();
+        fprintf(stderr, SD_INFO "%s = %f C, %f %%\n", htu21d->GetName().c_str(), htu21d_T, RH);
 
-          dbl_array[ 0 ] = T;
-          dbl_array[ 1 ] = RH;
+        htu21d_RH_file->Write( RH );
 
-          htu21d_db->Insert(htu21d->GetName(), 2, dbl_array, sqlite_err );
-          if( sqlite_err != SQLITE_OK ) fprintf(stderr, SD_ERR "error writing SQLite database: %d\n", sqlite_err);
+        Htu21dRecord record = {htu21d_T, RH};
+        dbwriter.Insert(htu21d_db, ring, htu21d->GetName(), htu21d_ts, record, sqlite_err);
+        if( sqlite_err != SQLITE_OK ) fprintf(stderr, SD_ERR "error writing SQLite database: %d\n", sqlite_err);
 
 #ifdef USE_DIM_LIBS
-          if( dimruns )
-          {
-            htu21data.T = T;
-            htu21data.RH = RH;
-            htu21Dim->updateService();
-          }
+        dim.Set(htu21d_dim, record);
 #endif
-	}
       }
-    }
+    });
+  }
 
-    for(int i = 0; i < 2; i++)
+  for(int i = 0; i < 2; i++)
+  {
+    if( bmp280[ i ] )
     {
-      if( bmp280[ i ] )
+      Recent::Ring *ring = dbwriter.Register<Bmp280Record>(bmp280_db, bmp280[ i ]->GetName());
+      sched.Add(i2cdev, bmp280_tag[ i ], Setting( period, bmp280_tag[ i ], readinterval ), Setting( phase, bmp280_tag[ i ], 0 ), 10000, [&, i]() { bmp280[ i ]->Forced(); }, [&, i, ring]()
       {
-        bmp280[ i ]->Forced();
-        usleep( 10000 ); // 10 ms
+        double T = 0, p = 0;
+        int64_t ts = 0;
+        int sqlite_err = 0;
+
         bmp280[ i ]->Measure();
+        ts = SQLite::TimeStamp();
 
 	T = bmp280[ i ]->GetTemperature();
 	p = bmp280[ i ]->GetPressure();
@@ -1204,39 +1211,75 @@ int main()
         bmp280_T_file[ i ]->Write( T );
         bmp280_p_file[ i ]->Write( p );
 
-        dbl_array[ 0 ] = T;
-        dbl_array[ 1 ] = p;
+        Bmp280Record record = {T, p};
+        dbwriter.Insert(bmp280_db, ring, bmp280[ i ]->GetName(), ts, record, sqlite_err);
+        if( sqlite_err != SQLITE_OK ) fprintf(stderr, SD_ERR "error writing SQLite database: %d\n", sqlite_err);
 
-        bmp280_db->Insert(bmp280[ i ]->GetName(), 2, dbl_array, sqlite_err);
+#ifdef USE_DIM_LIBS
+        dim.Set(bmp280_dim[ i ], record);
+#endif
+      });
+    }
+  }
+
+  for(int i = 0; i < 8; i++)
+  {
+    if( max31865[ i ] )
+    {
+      Recent::Ring *ring = dbwriter.Register<Max31865Record>(max31865_db, max31865[ i ]->GetName());
+      sched.Add(spidev, max31865_tag[ i ], Setting( period, max31865_tag[ i ], readinterval ), Setting( phase, max31865_tag[ i ], 0 ), 100000, [&, i]() { max31865[ i ]->OneShot(); }, [&, i, ring]()
+      {
+        double T = 0, R = 0;
+        int F = 0;
+        int64_t ts = 0;
+        int sqlite_err = 0;
+
+
+	max31865[ i ]->FaultDetection();
+        usleep( 1000 ); // 1 ms
+
+	max31865[ i ]->ReadResistance();
+        ts = SQLite::TimeStamp();
+	max31865[ i ]->CalcTemperature();
+
+        T = max31865[ i ]->GetTemperature();
+        R = max31865[ i ]->GetResistance();
+        F = 0;
+        if( max31865[ i ]->IsFault() ) F = (int)max31865[ i ]->GetFaultStatusByte();
+
+	fprintf(stderr, SD_INFO "%s = %f C, %f ohm", max31865[ i ]->GetName().c_str(), T, R);
+        if( F != 0 ) fprintf(stderr, ", fault = %d", F);
+        fprintf(stderr, "\n");
+
+	max31865_T_file[ i ]->Write( T );
+	max31865_R_file[ i ]->Write( R );
+	max31865_F_file[ i ]->Write( F );
+
+        Max31865Record record = {T, R, F};
+        dbwriter.Insert(max31865_db, ring, max31865[ i ]->GetName(), ts, record, sqlite_err);
         if( sqlite_err != SQLITE_OK ) fprintf(stderr, SD_ERR "error writing SQLite database: %d\n", sqlite_err);
 
 #ifdef USE_DIM_LIBS
-	if( dimruns )
-        {
-          if( i == 0 )
-          {
-            bmp280x76data.T = T;
-            bmp280x76data.p = p;
-            bmp280x76Dim->updateService();
-          }
-          else
-	  {
-            bmp280x77data.T = T;
-            bmp280x77data.p = p;
-            bmp280x77Dim->updateService();
-          }
-        }
+        dim.Set(max31865_dim[ i ], record);
 #endif
-      }
+      });
     }
+  }
 
-    for(int i = 0; i < 2; i++)
+  for(int i = 0; i < 2; i++)
+  {
+    if( bme680[ i ] )
     {
-      if( bme680[ i ] )
+      Recent::Ring *ring = dbwriter.Register<Bme680Record>(bme680_db, bme680[ i ]->GetName());
+      sched.Add(i2cdev, bme680_tag[ i ], Setting( period, bme680_tag[ i ], readinterval ), Setting( phase, bme680_tag[ i ], 0 ), 200000, [&, i]() { bme680[ i ]->Forced(); }, [&, i, ring]()
       {
-        bme680[ i ]->Forced();
-        usleep( 200000 ); // 200 ms
+        double T = 0, TF = 0, RH = 0, p = 0, R = 0;
+        char Valid = 'N', Stable = 'N';
+        int64_t ts = 0;
+        int sqlite_err = 0;
+
         bme680[ i ]->GetTPHG();
+        ts = SQLite::TimeStamp();
 
         T = bme680[ i ]->GetTemperature();
         TF = 9.0 * T / 5.0 + 32.0;
@@ -1255,493 +1298,300 @@ int main()
         bme680_p_file[ i ]->Write( p );
         bme680_R_file[ i ]->Write( R );
 
-        dbl_array[ 0 ] = T;
-        dbl_array[ 1 ] = RH;
-        dbl_array[ 2 ] = p;
-        dbl_array[ 3 ] = R;
-        int_array[ 0 ] = (int)bme680[ i ]->GasValid();
-        int_array[ 1 ] = (int)bme680[ i ]->HeaterStable();
-
-        bme680_db->Insert(bme680[ i ]->GetName(), 4, dbl_array, 2, int_array, sqlite_err);
+        Bme680Record record = {T, RH, p, R, (int)bme680[ i ]->GasValid(), (int)bme680[ i ]->HeaterStable()};
+        dbwriter.Insert(bme680_db, ring, bme680[ i ]->GetName(), ts, record, sqlite_err);
         if( sqlite_err != SQLITE_OK ) fprintf(stderr, SD_ERR "error writing SQLite database: %d\n", sqlite_err);
 
 #ifdef USE_DIM_LIBS
-	if( i == 0 && dimruns )
-        {
-          fprintf(stderr, SD_DEBUG "Update DIM service bme680x76\n");
-          bme680x76data.T = T;
-          bme680x76data.RH = RH;
-          bme680x76data.p = p;
-          bme680x76data.R = R;
-          bme680x76Dim->updateService();
-        }
-	else if( dimruns )
-        {
-          fprintf(stderr, SD_DEBUG "Update DIM service bme680x77\n");
-          bme680x77data.T = T;
-          bme680x77data.RH = RH;
-          bme680x77data.p = p;
-          bme680x77data.R = R;
-          bme680x77Dim->updateService();
-        }
+        dim.Set(bme680_dim[ i ], record);
 #endif
         Tamb = (int8_t)T;
 
         fprintf(stderr, SD_INFO "profile 0: 0x%02x pulse, ambient %d C, target %d C\n", bme680_GasWaitTime[ i ], Tamb, bme680_T0[ i ]);
         bme680[ i ]->SetGasHeatTemperature(0, Tamb, bme680_T0[ i ]); // adjust ambient temperature 
-      }
+      });
     }
+  }
 
-    for(int i = 0; i < 2; i++)
+  for(int i = 0; i < 2; i++)
+  {
+    if( lis3dh[ i ] )
     {
-      if( bh1750fvi[ i ] )
+      Recent::Ring *ring = dbwriter.Register<Lis3dhRecord>(lis3dh_db, lis3dh[ i ]->GetName());
+      sched.Add(i2cdev, lis3dh_tag[ i ], Setting( period, lis3dh_tag[ i ], readinterval ), Setting( phase, lis3dh_tag[ i ], 0 ), 0, nullptr, [&, i, ring]()
       {
-        bh1750fvi[ i ]->OneTimeHighResMode();
-        usleep( 700000 ); // 700 ms
-
-        if( bh1750fvi[ i ]->ReadIlluminance() )
+        double gx = 0, gy = 0, gz = 0;
+        double gxmin = 0, gymin = 0, gzmin = 0;
+        double gxmax = 0, gymax = 0, gzmax = 0;
+        int adc1 = 0, adc2 = 0, adc3 = 0;
+        uint8_t samples = 0;
+        int16_t *fifoX = lis3dh[ i ]->GetFifoX();
+        int16_t *fifoY = lis3dh[ i ]->GetFifoY();
+        int16_t *fifoZ = lis3dh[ i ]->GetFifoZ();
+        int16_t xmedian = 0, xmin = 0, xmax = 0, ymedian = 0, ymin = 0, ymax =0, zmedian = 0, zmin = 0, zmax =0;
+        uint8_t ODR = 0;
+        int64_t ts = 0;
+        int sqlite_err = 0;
+
+        samples = lis3dh[ i ]->ReadFifo();
+        ts = SQLite::TimeStamp();
+        fprintf(stderr, SD_INFO "%s FIFO has %d samples\n", lis3dh[ i ]->GetName().c_str(), samples );
+        ODR = lis3dh[ i ]->GetDataRate();	    
+
+        if( samples > 0 )
         {
-          Ev = bh1750fvi[ i ]->GetIlluminance();
-
-          fprintf(stderr, SD_INFO "%s = %f lx\n", bh1750fvi[ i ]->GetName().c_str(), Ev);
-
-          bh1750fvi_Ev_file[ i ]->Write( Ev );
-
-          dbl_array[ 0 ] = Ev;
-
-          bh1750fvi_db->Insert(bh1750fvi[ i ]->GetName(), 1, dbl_array, sqlite_err);
-          if( sqlite_err != SQLITE_OK ) fprintf(stderr, SD_ERR "error writing SQLite database: %d\n", sqlite_err);
-
-#ifdef USE_DIM_LIBS
-	  if( i == 0 && dimruns )
-          {
-            bh1750fvix23data.Ev = Ev;
-            bh1750fvix23Dim->updateService();
-	  }
-	  else if( dimruns )
-          {
-            bh1750fvix5Cdata.Ev = Ev;
-            bh1750fvix5CDim->updateService();
-          }
-#endif
-	}
-      }
-    }
-
-    for(int i = 0; i < 2; i++)
-    {
-      if( lis3dh[ i ] )
-      {
-        j = 0;
-        while( !lis3dh[ i ]->NewDataXYZ() && j < 2000 )
-	{
-          usleep( 1000 ); // sleep 1 ms
-          j++;
-        }
+          gxmin = 0;
+          gymin = 0;
+          gzmin = 0;
     
-        if( j < 2000 )
-        {
-          samples = lis3dh[ i ]->ReadFifo();
-          fprintf(stderr, SD_INFO "%s FIFO has %d samples\n", lis3dh[ i ]->GetName().c_str(), samples );
-          ODR = lis3dh[ i ]->GetDataRate();	    
+          gxmax = 0;
+          gymax = 0;
+          gzmax = 0;
 
-          if( samples > 0 )
+	  if( samples == 32 )
           {
-            gxmin = 0;
-            gymin = 0;
-            gzmin = 0;
-      
-            gxmax = 0;
-            gymax = 0;
-            gzmax = 0;
-
-	    if( samples == 32 )
-            {
-              fifoX = lis3dh[ i ]->GetFifoX();
-              fifoY = lis3dh[ i ]->GetFifoY();
-              fifoZ = lis3dh[ i ]->GetFifoZ();
+            fifoX = lis3dh[ i ]->GetFifoX();
+            fifoY = lis3dh[ i ]->GetFifoY();
+            fifoZ = lis3dh[ i ]->GetFifoZ();
 
-              sort( fifoX, fifoX + samples );
-              sort( fifoY, fifoY + samples );
-              sort( fifoZ, fifoZ + samples );
+            sort( fifoX, fifoX + samples );
+            sort( fifoY, fifoY + samples );
+            sort( fifoZ, fifoZ + samples );
 
-              xmedian = ( fifoX[ 15 ] + fifoX[ 16 ] ) / 2.0;
-              xmin = fifoX[ 0 ];
-              xmax = fifoX[ 31 ];
+            xmedian = ( fifoX[ 15 ] + fifoX[ 16 ] ) / 2.0;
+            xmin = fifoX[ 0 ];
+            xmax = fifoX[ 31 ];
 
-              ymedian = ( fifoY[ 15 ] + fifoY[ 16 ] ) / 2.0;
-              ymin = fifoY[ 0 ];
-              ymax = fifoY[ 31 ];
+            ymedian = ( fifoY[ 15 ] + fifoY[ 16 ] ) / 2.0;
+            ymin = fifoY[ 0 ];
+            ymax = fifoY[ 31 ];
 
-              zmedian = ( fifoZ[ 15 ] + fifoZ[ 16 ] ) / 2.0;
-              zmin = fifoZ[ 0 ];
-              zmax = fifoZ[ 31 ];
+            zmedian = ( fifoZ[ 15 ] + fifoZ[ 16 ] ) / 2.0;
+            zmin = fifoZ[ 0 ];
+            zmax = fifoZ[ 31 ];
 
-              fprintf(stderr, SD_INFO "xmin, xmed, xmax = [%d, %d, %d]\n", xmin, xmedian, xmax);
-              fprintf(stderr, SD_INFO "ymin, ymed, ymax = [%d, %d, %d]\n", ymin, ymedian, ymax);
-              fprintf(stderr, SD_INFO "zmin, zmed, zmax = [%d, %d, %d]\n", zmin, zmedian, zmax);
+            fprintf(stderr, SD_INFO "xmin, xmed, xmax = [%d, %d, %d]\n", xmin, xmedian, xmax);
+            fprintf(stderr, SD_INFO "ymin, ymed, ymax = [%d, %d, %d]\n", ymin, ymedian, ymax);
+            fprintf(stderr, SD_INFO "zmin, zmed, zmax = [%d, %d, %d]\n", zmin, zmedian, zmax);
 
-              gx = lis3dh[ i ]->GetFS() * (double)xmedian / 32768.0;
-              gy = lis3dh[ i ]->GetFS() * (double)ymedian / 32768.0;
-              gz = lis3dh[ i ]->GetFS() * (double)zmedian / 32768.0;
+            gx = lis3dh[ i ]->GetFS() * (double)xmedian / 32768.0;
+            gy = lis3dh[ i ]->GetFS() * (double)ymedian / 32768.0;
+            gz = lis3dh[ i ]->GetFS() * (double)zmedian / 32768.0;
 
-              gxmin = lis3dh[ i ]->GetFS() * (double)xmin / 32768.0;
-              gymin = lis3dh[ i ]->GetFS() * (double)ymin / 32768.0;
-              gzmin = lis3dh[ i ]->GetFS() * (double)zmin / 32768.0;
+            gxmin = lis3dh[ i ]->GetFS() * (double)xmin / 32768.0;
+            gymin = lis3dh[ i ]->GetFS() * (double)ymin / 32768.0;
+            gzmin = lis3dh[ i ]->GetFS() * (double)zmin / 32768.0;
 
-	      gxmax = lis3dh[ i ]->GetFS() * (double)xmax / 32768.0;
-              gymax = lis3dh[ i ]->GetFS() * (double)ymax / 32768.0;
-              gzmax = lis3dh[ i ]->GetFS() * (double)zmax / 32768.0;
+	    gxmax = lis3dh[ i ]->GetFS() * (double)xmax / 32768.0;
+            gymax = lis3dh[ i ]->GetFS() * (double)ymax / 32768.0;
+            gzmax = lis3dh[ i ]->GetFS() * (double)zmax / 32768.0;
 
-              fprintf(stderr, SD_INFO "%s median gx = %f, gy = %f, gz = %f with ODR %d\n", lis3dh[ i ]->GetName().c_str(), gx, gy, gz, ODR);
-	    }
-	    else 
-            {
-              gx = lis3dh[ i ]->GetFS() * (double)fifoX[ 0 ] / 32768.0;
-              gy = lis3dh[ i ]->GetFS() * (double)fifoY[ 0 ] / 32768.0;
-              gz = lis3dh[ i ]->GetFS() * (double)fifoZ[ 0 ] / 32768.0;
-          
-              fprintf(stderr, SD_INFO "%s gx = %f, gy = %f, gz = %f\n", lis3dh[ i ]->GetName().c_str(), gx, gy, gz);
-            }  
-
-	    lis3dh_gx_file[ i ]->Write( gx );
-            lis3dh_gy_file[ i ]->Write( gy );
-            lis3dh_gz_file[ i ]->Write( gz );
-
-            if( lis3dh[ i ]->ReadAdc() )
-            {
-              adc1 = lis3dh[ i ]->GetAdc1();
-              adc2 = lis3dh[ i ]->GetAdc2();
-              adc3 = lis3dh[ i ]->GetAdc3();
-
-              fprintf(stderr, SD_INFO "%s adc1 = %d, adc2 = %d, adc3 = %d\n", lis3dh[ i ]->GetName().c_str(), adc1, adc2, adc3);
-
-              lis3dh_adc1_file[ i ]->Write( adc1 );
-              lis3dh_adc2_file[ i ]->Write( adc2 );
-              lis3dh_adc3_file[ i ]->Write( adc3 );
-	    }
-
-            dbl_array[ 0 ] = gxmin;
-            dbl_array[ 1 ] = gx;
-            dbl_array[ 2 ] = gxmax;
-
-	    dbl_array[ 3 ] = gymin;
-            dbl_array[ 4 ] = gy;
-            dbl_array[ 5 ] = gymax;
-
-	    dbl_array[ 6 ] = gzmin;
-            dbl_array[ 7 ] = gz;
-            dbl_array[ 8 ] = gzmax;
+            fprintf(stderr, SD_INFO "%s median gx = %f, gy = %f, gz = %f with ODR %d\n", lis3dh[ i ]->GetName().c_str(), gx, gy, gz, ODR);
+	  }
+	  else 
+          {
+            gx = lis3dh[ i ]->GetFS() * (double)fifoX[ 0 ] / 32768.0;
+            gy = lis3dh[ i ]->GetFS() * (double)fifoY[ 0 ] / 32768.0;
+            gz = lis3dh[ i ]->GetFS() * (double)fifoZ[ 0 ] / 32768.0;
+        
+            fprintf(stderr, SD_INFO "%s gx = %f, gy = %f, gz = %f\n", lis3dh[ i ]->GetName().c_str(), gx, gy, gz);
+          }  
+
+	  lis3dh_gx_file[ i ]->Write( gx );
+          lis3dh_gy_file[ i ]->Write( gy );
+          lis3dh_gz_file[ i ]->Write( gz );
+
+          if( lis3dh[ i ]->ReadAdc() )
+          {
+            adc1 = lis3dh[ i ]->GetAdc1();
+            adc2 = lis3dh[ i ]->GetAdc2();
+            adc3 = lis3dh[ i ]->GetAdc3();
 
-	    int_array[ 0 ] = adc1;
-            int_array[ 1 ] = adc2;
-            int_array[ 2 ] = adc3;
+            fprintf(stderr, SD_INFO "%s adc1 = %d, adc2 = %d, adc3 = %d\n", lis3dh[ i ]->GetName().c_str(), adc1, adc2, adc3);
 
-	    int_array[ 3 ] = ODR;
+            lis3dh_adc1_file[ i ]->Write( adc1 );
+            lis3dh_adc2_file[ i ]->Write( adc2 );
+            lis3dh_adc3_file[ i ]->Write( adc3 );
+	  }
 
-            lis3dh_db->Insert(lis3dh[ i ]->GetName(), 9, dbl_array, 4, int_array, sqlite_err);
-            if( sqlite_err != SQLITE_OK ) fprintf(stderr, SD_ERR "error writing SQLite database: %d\n", sqlite_err);
+          Lis3dhRecord record = {gxmin, gx, gxmax, gymin, gy, gymax, gzmin, gz, gzmax, adc1, adc2, adc3, ODR};
+          dbwriter.Insert(lis3dh_db, ring, lis3dh[ i ]->GetName(), ts, record, sqlite_err);
+          if( sqlite_err != SQLITE_OK ) fprintf(stderr, SD_ERR "error writing SQLite database: %d\n", sqlite_err);
 
 #ifdef USE_DIM_LIBS
-	     if( i == 0 && dimruns )
-             {
-               lis3dhx18data.gxmin = gxmin;
-               lis3dhx18data.gx = gx;
-               lis3dhx18data.gxmax = gxmax;
-               lis3dhx18data.gymin = gymin;
-               lis3dhx18data.gy = gy;
-               lis3dhx18data.gymax = gymax;
-               lis3dhx18data.gzmin = gzmin;
-               lis3dhx18data.gz = gz;
-               lis3dhx18data.gzmax = gzmax;
-
-	       lis3dhx18data.adc1 = adc1;
-               lis3dhx18data.adc2 = adc2;
-               lis3dhx18data.adc3 = adc3;
-               lis3dhx18data.odr = ODR;
-
-	       lis3dhx18Dim->updateService();
-             }
-             else if( dimruns )
-	     {
-               lis3dhx19data.gxmin = gxmin;
-               lis3dhx19data.gx = gx;
-               lis3dhx19data.gxmax = gxmax;
-               lis3dhx19data.gymin = gymin;
-               lis3dhx19data.gy = gy;
-               lis3dhx19data.gymax = gymax;
-               lis3dhx19data.gzmin = gzmin;
-               lis3dhx19data.gz = gz;
-               lis3dhx19data.gzmax = gzmax;
-
-	       lis3dhx19data.adc1 = adc1;
-               lis3dhx19data.adc2 = adc2;
-               lis3dhx19data.adc3 = adc3;
-               lis3dhx19data.odr = ODR;
-
-	       lis3dhx19Dim->updateService();
-	     }
+          dim.Set(lis3dh_dim[ i ], record);
 #endif
-	  }
-          else
-          {
-            fprintf(stderr, SD_NOTICE "%s error reading g-force %d\n", lis3dh[ i ]->GetName().c_str(), lis3dh[ i ]->GetError() );
-          }
-        }
+	}
         else
         {
-          fprintf(stderr, SD_NOTICE "%s reading timeout\n", lis3dh[ i ]->GetName().c_str());
+          fprintf(stderr, SD_NOTICE "%s error reading g-force %d\n", lis3dh[ i ]->GetName().c_str(), lis3dh[ i ]->GetError() );
         }
-      }	
+      });
+
+      // FIFO is read when new data is ready, polled between other readings
+      sched.SetReady(i2cdev, lis3dh_tag[ i ], 1000, [&, i]() { return lis3dh[ i ]->NewDataXYZ(); });
     }
-    
-    if( lis2mdl )
+  }
+
+  if( lis2mdl )
+  {
+    Recent::Ring *ring = dbwriter.Register<Lis2mdlRecord>(lis2mdl_db, lis2mdl->GetName());
+    sched.Add(i2cdev, "LIS2MDL_x1E", Setting( period, "LIS2MDL_x1E", readinterval ), Setting( phase, "LIS2MDL_x1E", 0 ), 0, [&]()
     {
       fprintf(stderr, SD_INFO "%s start single measurement mode\n", lis2mdl->GetName().c_str() );
       lis2mdl->SingleMode();
+    }, [&, ring]()
+    {
+      double Bx = 0, By = 0, Bz = 0, T = 0;
+      int64_t ts = 0;
+      int sqlite_err = 0;
 
-      j = 0;
-      while( !lis2mdl->NewDataXYZ() && j < 1000 )
+      if( lis2mdl->OverRunXYZ() )
       {
-        usleep( 100 ); // 100 us
-	j++;
+        fprintf(stderr, SD_NOTICE "%s reading overrun\n", lis2mdl->GetName().c_str());
       }
-  
-      if( lis2mdl->NewDataXYZ() )
+      else
       {
-        if( lis2mdl->OverRunXYZ() )
-        {
-          fprintf(stderr, SD_NOTICE "%s reading overrun\n", lis2mdl->GetName().c_str());
-        }
-	else
+        if( lis2mdl->ReadB() )
         {
-          if( lis2mdl->ReadB() )
-          {
-            Bx = lis2mdl->GetBx();
-            By = lis2mdl->GetBy();
-            Bz = lis2mdl->GetBz();
-            T = lis2mdl->GetT();
-
-            fprintf(stderr, SD_INFO "%s Bx = %f uT, By = %f uT, Bz = %f uT , T = %f C\n", lis2mdl->GetName().c_str(), Bx, By, Bz, T);
+          ts = SQLite::TimeStamp();
+          Bx = lis2mdl->GetBx();
+          By = lis2mdl->GetBy();
+          Bz = lis2mdl->GetBz();
+          T = lis2mdl->GetT();
 
-            lis2mdl_Bx_file->Write( Bx );
-            lis2mdl_By_file->Write( By );
-            lis2mdl_Bz_file->Write( Bz );
-            lis2mdl_T_file->Write( T );
+          fprintf(stderr, SD_INFO "%s Bx = %f uT, By = %f uT, Bz = %f uT , T = %f C\n", lis2mdl->GetName().c_str(), Bx, By, Bz, T);
 
-            dbl_array[ 0 ] = Bx;
-            dbl_array[ 1 ] = By;
-            dbl_array[ 2 ] = Bz;
-            dbl_array[ 3 ] = T;
+          lis2mdl_Bx_file->Write( Bx );
+          lis2mdl_By_file->Write( By );
+          lis2mdl_Bz_file->Write( Bz );
+          lis2mdl_T_file->Write( T );
 
-            lis2mdl_db->Insert(lis2mdl->GetName(), 4, dbl_array, sqlite_err);
+          Lis2mdlRecord record = {Bx, By, Bz, T};
+          dbwriter.Insert(lis2mdl_db, ring, lis2mdl->GetName(), ts, record, sqlite_err);
 
-            if( sqlite_err != SQLITE_OK ) fprintf(stderr, SD_ERR "error writing SQLite database: %d\n", sqlite_err);
+          if( sqlite_err != SQLITE_OK ) fprintf(stderr, SD_ERR "error writing SQLite database: %d\n", sqlite_err);
 
 #ifdef USE_DIM_LIBS
-	    if( dimruns )
-	    {
-              lis2mdlx1Edata.Bx = Bx;
-              lis2mdlx1Edata.By = By;
-	      lis2mdlx1Edata.Bz = Bz;
-	      lis2mdlx1Edata.T = T;
-              lis2mdlx1EDim->updateService();
-	    }
+          dim.Set(lis2mdl_dim, record);
 #endif
-	  }
-          else
-          {
-            fprintf(stderr, SD_NOTICE "%s error reading magnetic field %d\n", lis2mdl->GetName().c_str(), lis2mdl->GetError() );
-          }
+        }
+        else
+        {
+          fprintf(stderr, SD_NOTICE "%s error reading magnetic field %d\n", lis2mdl->GetName().c_str(), lis2mdl->GetError() );
         }
       }
-      else
-      {
-        fprintf(stderr, SD_NOTICE "%s reading timeout\n", lis2mdl->GetName().c_str());
-      }
-    }
+    });
+
+    // magnetic field is read when new data is ready, polled between other readings
+    sched.SetReady(i2cdev, "LIS2MDL_x1E", 1000, [&]() { return lis2mdl->NewDataXYZ(); });
+  }
 
-    for(int i = 0; i < 2; i++)
+  for(int i = 0; i < 2; i++)
+  {
+    if( lis3mdl[ i ] )
     {
-      if( lis3mdl[ i ] )
+      Recent::Ring *ring = dbwriter.Register<Lis3mdlRecord>(lis3mdl_db, lis3mdl[ i ]->GetName());
+      sched.Add(i2cdev, lis3mdl_tag[ i ], Setting( period, lis3mdl_tag[ i ], readinterval ), Setting( phase, lis3mdl_tag[ i ], 0 ), 0, [&, i]()
       {
         lis3mdl[ i ]->ReadB();
         lis3mdl[ i ]->ContinuousMode();
 //	lis3mdl[ i ]->SingleConversionMode();
+      }, [&, i, ring]()
+      {
+        double Bx = 0, By = 0, Bz = 0, T = 0;
+        int64_t ts = 0;
+        int sqlite_err = 0;
 
-        j = 0;
-        while( !lis3mdl[ i ]->NewDataXYZ() && j < 1000 )
+        if( lis3mdl[ i ]->OverRunXYZ() )
         {
-          usleep( 100 ); // 100 us
-          j++;
+          fprintf(stderr, SD_NOTICE "%s reading overrun\n", lis3mdl[ i ]->GetName().c_str());
         }
-
-        if( lis3mdl[ i ]->NewDataXYZ() )
+        else
         {
-          if( lis3mdl[ i ]->OverRunXYZ() )
+          if( lis3mdl[ i ]->ReadB() )
           {
-            fprintf(stderr, SD_NOTICE "%s reading overrun\n", lis3mdl[ i ]->GetName().c_str());
-          }
-          else
-          {
-            if( lis3mdl[ i ]->ReadB() )
-            {
-              Bx = lis3mdl[ i ]->GetBx();
-              By = lis3mdl[ i ]->GetBy();
-              Bz = lis3mdl[ i ]->GetBz();
-              T = lis3mdl[ i ]->GetT();
+            ts = SQLite::TimeStamp();
+            Bx = lis3mdl[ i ]->GetBx();
+            By = lis3mdl[ i ]->GetBy();
+            Bz = lis3mdl[ i ]->GetBz();
+            T = lis3mdl[ i ]->GetT();
 
-              fprintf(stderr, SD_INFO "%s Bx = %f uT, By = %f uT, Bz = %f uT , T = %f C\n", lis3mdl[ i ]->GetName().c_str(), Bx, By, Bz, T);
+            fprintf(stderr, SD_INFO "%s Bx = %f uT, By = %f uT, Bz = %f uT , T = %f C\n", lis3mdl[ i ]->GetName().c_str(), Bx, By, Bz, T);
 
-              lis3mdl_Bx_file[ i ]->Write( Bx );
-              lis3mdl_By_file[ i ]->Write( By );
-              lis3mdl_Bz_file[ i ]->Write( Bz );
-              lis3mdl_T_file[ i ]->Write( T );
+            lis3mdl_Bx_file[ i ]->Write( Bx );
+            lis3mdl_By_file[ i ]->Write( By );
+            lis3mdl_Bz_file[ i ]->Write( Bz );
+            lis3mdl_T_file[ i ]->Write( T );
 
-              dbl_array[ 0 ] = Bx;
-              dbl_array[ 1 ] = By;
-              dbl_array[ 2 ] = Bz;
-              dbl_array[ 3 ] = T;
-
-              lis3mdl_db->Insert(lis3mdl[ i ]->GetName(), 4, dbl_array, sqlite_err);
-              if( sqlite_err != SQLITE_OK ) fprintf(stderr, SD_ERR "error writing SQLite database: %d\n", sqlite_err);
+            Lis3mdlRecord record = {Bx, By, Bz, T};
+            dbwriter.Insert(lis3mdl_db, ring, lis3mdl[ i ]->GetName(), ts, record, sqlite_err);
+            if( sqlite_err != SQLITE_OK ) fprintf(stderr, SD_ERR "error writing SQLite database: %d\n", sqlite_err);
 
 #ifdef USE_DIM_LIBS
-	      if( dimruns && lis3mdlx1C )
-  	      {
-                lis3mdlx1Cdata.Bx = Bx;
-                lis3mdlx1Cdata.By = By;
-                lis3mdlx1Cdata.Bz = Bz;
-	        lis3mdlx1Cdata.T = T;
-                lis3mdlx1CDim->updateService();
-              }
-              else if( dimruns )
-	      {
-                lis3mdlx1Edata.Bx = Bx;
-                lis3mdlx1Edata.By = By;
-                lis3mdlx1Edata.Bz = Bz;
-	        lis3mdlx1Edata.T = T;
-                lis3mdlx1EDim->updateService();
-              }
+            dim.Set(lis3mdl_dim[ i ], record);
 #endif
-	    }
-            else
-            {
-              fprintf(stderr, SD_NOTICE "%s error reading magnetic field %d\n", lis3mdl[ i ]->GetName().c_str(), lis3mdl[ i ]->GetError() );
-            }
           }
-	}
-	else
-        {
-          fprintf(stderr, SD_NOTICE "%s reading timeout\n", lis3mdl[ i ]->GetName().c_str());
-	}
+          else
+          {
+            fprintf(stderr, SD_NOTICE "%s error reading magnetic field %d\n", lis3mdl[ i ]->GetName().c_str(), lis3mdl[ i ]->GetError() );
+          }
+        }
         lis3mdl[ i ]->PowerDown();
         lis3mdl[ i ]->ReadB();
-      }
+      });
+
+      // magnetic field is read when new data is ready, polled between other readings
+      sched.SetReady(i2cdev, lis3mdl_tag[ i ], 1000, [&, i]() { return lis3mdl[ i ]->NewDataXYZ(); });
     }
+  }
 
-    for(int i = 0; i < 8; i++)
+  for(int i = 0; i < 2; i++)
+  {
+    if( bh1750fvi[ i ] )
     {
-      if( max31865[ i ] )
+      Recent::Ring *ring = dbwriter.Register<Bh1750fviRecord>(bh1750fvi_db, bh1750fvi[ i ]->GetName());
+      sched.Add(i2cdev, bh1750fvi_tag[ i ], Setting( period, bh1750fvi_tag[ i ], readinterval ), Setting( phase, bh1750fvi_tag[ i ], 0 ), 700000, [&, i]() { bh1750fvi[ i ]->OneTimeHighResMode(); }, [&, i, ring]()
       {
-        max31865[ i ]->OneShot();
-        usleep( 100000 ); // 100 ms
+        double Ev = 0;
+        int64_t ts = 0;
+        int sqlite_err = 0;
 
-	max31865[ i ]->FaultDetection();
-        usleep( 1000 ); // 1 ms
 
-	max31865[ i ]->ReadResistance();
-	max31865[ i ]->CalcTemperature();
-
-        T = max31865[ i ]->GetTemperature();
-        R = max31865[ i ]->GetResistance();
-        F = 0;
-        if( max31865[ i ]->IsFault() ) F = (int)max31865[ i ]->GetFaultStatusByte();
-
-	fprintf(stderr, SD_INFO "%s = %f C, %f ohm", max31865[ i ]->GetName().c_str(), T, R);
-        if( F != 0 ) fprintf(stderr, ", fault = %d", F);
-        fprintf(stderr, "\n");
+        if( bh1750fvi[ i ]->ReadIlluminance() )
+        {
+          ts = SQLite::TimeStamp();
+          Ev = bh1750fvi[ i ]->GetIlluminance();
 
-	max31865_T_file[ i ]->Write( T );
-	max31865_R_file[ i ]->Write( R );
-	max31865_F_file[ i ]->Write( F );
+          fprintf(stderr, SD_INFO "%s = %f lx\n", bh1750fvi[ i ]->GetName().c_str(), Ev);
 
-        dbl_array[ 0 ] = T;
-        dbl_array[ 1 ] = R;
-        int_array[ 0 ] = F;
+          bh1750fvi_Ev_file[ i ]->Write( Ev );
 
-        max31865_db->Insert(max31865[ i ]->GetName(), 2, dbl_array, 1, int_array, sqlite_err);
-        if( sqlite_err != SQLITE_OK ) fprintf(stderr, SD_ERR "error writing SQLite database: %d\n", sqlite_err);
+          Bh1750fviRecord record = {Ev};
+          dbwriter.Insert(bh1750fvi_db, ring, bh1750fvi[ i ]->GetName(), ts, record, sqlite_err);
+          if( sqlite_err != SQLITE_OK ) fprintf(stderr, SD_ERR "error writing SQLite database: %d\n", sqlite_err);
 
 #ifdef USE_DIM_LIBS
-	if( dimruns )
-        {
-          if( i == 0 )
-          {
-            max31865d00data.T = T;
-            max31865d00data.R = R;
-            max31865d00data.F = F;
-            max31865d00Dim->updateService();
-	  }
-          else if( i == 1 )
-	  {
-            max31865d01data.T = T;
-            max31865d01data.R = R;
-            max31865d01data.F = F;
-            max31865d01Dim->updateService();
-	  }
-          else if( i == 2 )
-	  {
-            max31865d02data.T = T;
-            max31865d02data.R = R;
-            max31865d02data.F = F;
-            max31865d02Dim->updateService();
-	  }
-          else if( i == 3 )
-	  {
-            max31865d03data.T = T;
-            max31865d03data.R = R;
-            max31865d03data.F = F;
-            max31865d03Dim->updateService();
-	  }
-          else if( i == 4 )
-	  {
-            max31865d04data.T = T;
-            max31865d04data.R = R;
-            max31865d04data.F = F;
-            max31865d04Dim->updateService();
-	  }
-          else if( i == 5 )
-	  {
-            max31865d05data.T = T;
-            max31865d05data.R = R;
-            max31865d05data.F = F;
-            max31865d05Dim->updateService();
-	  }
-          else if( i == 6 )
-	  {
-            max31865d06data.T = T;
-            max31865d06data.R = R;
-            max31865d06data.F = F;
-            max31865d06Dim->updateService();
-	  }
-          else if( i == 7 )
-	  {
-            max31865d07data.T = T;
-            max31865d07data.R = R;
-            max31865d07data.F = F;
-            max31865d07Dim->updateService();
-	  }
-	}
+          dim.Set(bh1750fvi_dim[ i ], record);
 #endif
-      }
+	}
+      });
     }
+  }
 
-    for(int i = 0; i < 8; i++)
+  for(int i = 0; i < 8; i++)
+  {
+    if( pca9535[ i ] )
     {
-      if( pca9535[ i ] )
+      Recent::Ring *ring = dbwriter.Register<Pca9535Record>(pca9535_db, pca9535[ i ]->GetName());
+      sched.Add(i2cdev, pca9535_tag[ i ], Setting( period, pca9535_tag[ i ], readinterval ), Setting( phase, pca9535_tag[ i ], 0 ), 0, nullptr, [&, i, ring]()
       {
+        int inputs = 0, outputs = 0, inversions = 0, portconfigs = 0;
+        int64_t ts = 0;
+        int sqlite_err = 0;
+
         inputs = pca9535[ i ]->GetInputs();
+        ts = SQLite::TimeStamp();
         outputs = pca9535[ i ]->GetOutputs();
 	inversions = pca9535[ i ]->GetPolInversions();
 	portconfigs = pca9535[ i ]->GetPortConfigs();
@@ -1753,88 +1603,133 @@ int main()
         pca9535_inversions_file[ i ]->Write( inversions );
         pca9535_port_configs_file[ i ]->Write( portconfigs );
 
-        int_array[ 0 ] = inputs;
-        int_array[ 1 ] = outputs;
-        int_array[ 2 ] = inversions;
-        int_array[ 3 ] = portconfigs;
-
-	pca9535_db->Insert(pca9535[ i ]->GetName(), 4, int_array, sqlite_err);
+	Pca9535Record record = {inputs, outputs, inversions, portconfigs};
+	dbwriter.Insert(pca9535_db, ring, pca9535[ i ]->GetName(), ts, record, sqlite_err);
         if( sqlite_err != SQLITE_OK ) fprintf(stderr, SD_ERR "error writing SQLite database: %d\n", sqlite_err);
 
 #ifdef USE_DIM_LIBS
-	if( dimruns )
-        {
-          if( i == 0 )
-          {
-            pca9535x20data.inputs = inputs;
-            pca9535x20data.outputs = outputs;
-            pca9535x20data.inversions = inversions;
-            pca9535x20data.portconfigs = portconfigs;
-	    pca9535x20Dim->updateService();
-	  }
-          else if( i == 1 )
-          {
-            pca9535x21data.inputs = inputs;
-            pca9535x21data.outputs = outputs;
-            pca9535x21data.inversions = inversions;
-            pca9535x21data.portconfigs = portconfigs;
-	    pca9535x21Dim->updateService();
-	  }
-          else if( i == 2 )
-          {
-            pca9535x22data.inputs = inputs;
-            pca9535x22data.outputs = outputs;
-            pca9535x22data.inversions = inversions;
-            pca9535x22data.portconfigs = portconfigs;
-	    pca9535x22Dim->updateService();
-	  }
-          else if( i == 3 )
-          {
-            pca9535x23data.inputs = inputs;
-            pca9535x23data.outputs = outputs;
-            pca9535x23data.inversions = inversions;
-            pca9535x23data.portconfigs = portconfigs;
-	    pca9535x23Dim->updateService();
-	  }
-          else if( i == 4 )
-          {
-            pca9535x24data.inputs = inputs;
-            pca9535x24data.outputs = outputs;
-            pca9535x24data.inversions = inversions;
-            pca9535x24data.portconfigs = portconfigs;
-	    pca9535x24Dim->updateService();
-	  }
-          else if( i == 5 )
-          {
-            pca9535x25data.inputs = inputs;
-            pca9535x25data.outputs = outputs;
-            pca9535x25data.inversions = inversions;
-            pca9535x25data.portconfigs = portconfigs;
-	    pca9535x25Dim->updateService();
-	  }
-          else if( i == 6 )
-          {
-            pca9535x26data.inputs = inputs;
-            pca9535x26data.outputs = outputs;
-            pca9535x26data.inversions = inversions;
-            pca9535x26data.portconfigs = portconfigs;
-	    pca9535x26Dim->updateService();
-	  }
-          else if( i == 7 )
-          {
-            pca9535x27data.inputs = inputs;
-            pca9535x27data.outputs = outputs;
-            pca9535x27data.inversions = inversions;
-            pca9535x27data.portconfigs = portconfigs;
-	    pca9535x27Dim->updateService();
-	  }
-        }
+        dim.Set(pca9535_dim[ i ], record);
 #endif
-      }
+      });
     }
+  }
 
-    sleep( readinterval );
+  // run tasks and database writer in own threads with SIGTERM and SIGHUP blocked so that
+  // the signals are handled in main thread waiting in sigsuspend()
+  sigset_t sigs, oldsigs;
+  sigemptyset( &sigs );
+  sigaddset( &sigs, SIGTERM );
+  sigaddset( &sigs, SIGHUP );
+  pthread_sigmask( SIG_BLOCK, &sigs, &oldsigs );
+
+  // latest values from snapshot and internal counters for Prometheus
+  Metrics *metrics = nullptr;
+  if( metricsaddr != "" && !snapshot ) fprintf(stderr, SD_ERR "Prometheus metrics need SNAPSHOT\n");
+  else if( metricsaddr != "" )
+  {
+    metrics = new Metrics(metricsaddr, snapshot, &sched);
+    metrics->AddCounter("i2chipd_sqlite_commits_total", "Committed SQLite transactions.", [&]() { return dbwriter.GetCommits(); });
+    metrics->AddCounter("i2chipd_sqlite_dropped_total", "Rows dropped with full SQLite writer queue.", [&]() { return dbwriter.GetDropped(); });
+    metrics->AddCounter("i2chipd_file_writes_total", "Data files written.", []() { return File::GetWrites(); });
+    metrics->AddCounter("i2chipd_file_unchanged_total", "Data file writes skipped within deadband.", []() { return File::GetSkipped(); });
+    if( spool ) metrics->AddCounter("i2chipd_spool_rows_total", "Rows written to spool.", [&]() { return dbwriter.GetSpooled(); });
+    if( query ) metrics->AddCounter("i2chipd_query_requests_total", "Requests to query service.", [&]() { return query->GetRequests(); });
+    if( mqtt ) metrics->AddCounter("i2chipd_mqtt_published_total", "Messages sent to MQTT broker.", [&]() { return mqtt->GetPublished(); });
+    if( mqtt ) metrics->AddCounter("i2chipd_mqtt_dropped_total", "Messages dropped with full MQTT queue.", [&]() { return mqtt->GetDropped(); });
+  }
+
+#ifdef USE_DIM_LIBS
+  // DIM services with changed values updated together once per cycle,
+  // by default as often as the fastest chip is read
+  if( dim.GetServices() > 0 )
+  {
+    double dimperiod = sched.GetMinPeriod() > 0 ? sched.GetMinPeriod() : readinterval;
+
+    sched.Add("dim", "DIM", Setting( period, "DIM", dimperiod ), Setting( phase, "DIM", dimperiod / 2.0 ), 0, nullptr, [&]() { dim.Update(); });
   }
+#endif
+
+  // timing statistics of reading tasks to log and data files
+  File *sched_file = new File(datadir, "i2chipd_timing");
+  sched.Add("timing", "TIMING", readinterval, readinterval / 2.0, 0, nullptr, [&]()
+  {
+    ostringstream timing;
+
+    for(auto & st : sched.GetStats())
+    {
+      if( st.name == "TIMING" ) continue;
+
+      fprintf(stderr, SD_DEBUG "%s cycles %llu, jitter %ld us (max %ld, mean %.0f), exec %ld us (max %ld), overruns %llu, skipped %llu\n", st.name.c_str(), (unsigned long long)st.cycles, st.jitter, st.jittermax, st.jittermean, st.exectime, st.exectimemax, (unsigned long long)st.overruns, (unsigned long long)st.skipped);
+      if( st.overruns > 0 ) fprintf(stderr, SD_NOTICE "%s %llu overruns, %llu skipped\n", st.name.c_str(), (unsigned long long)st.overruns, (unsigned long long)st.skipped);
+
+      timing << st.name << " " << st.cycles << " " << st.jitter << " " << st.jittermax << " " << (long)st.jittermean << " " << st.exectime << " " << st.exectimemax << " " << st.overruns << " " << st.skipped << "\n";
+    }
+
+    fprintf(stderr, SD_DEBUG "SQLite writer %llu commits, %llu rows dropped\n", (unsigned long long)dbwriter.GetCommits(), (unsigned long long)dbwriter.GetDropped());
+    fprintf(stderr, SD_DEBUG "recent samples %llu bytes of %.1f MB\n", (unsigned long long)recent->GetBytes(), recentmax);
+    fprintf(stderr, SD_DEBUG "data files %llu written, %llu unchanged\n", (unsigned long long)File::GetWrites(), (unsigned long long)File::GetSkipped());
+    if( snapshot ) fprintf(stderr, SD_DEBUG "snapshot %zu channels, %llu values\n", snapshot->GetChannels(), (unsigned long long)snapshot->GetWrites());
+    if( mqtt ) fprintf(stderr, SD_DEBUG "MQTT %s, %llu published, %zu queued, %llu dropped, %llu connects\n", mqtt->IsConnected() ? "connected" : "disconnected", (unsigned long long)mqtt->GetPublished(), mqtt->GetQueued(), (unsigned long long)mqtt->GetDropped(), (unsigned long long)mqtt->GetConnects());
+#ifdef USE_DIM_LIBS
+    fprintf(stderr, SD_DEBUG "DIM %llu updates, %llu unchanged\n", (unsigned long long)dim.GetUpdates(), (unsigned long long)dim.GetUnchanged());
+#endif
+    if( metrics ) fprintf(stderr, SD_DEBUG "Prometheus metrics %llu scrapes\n", (unsigned long long)metrics->GetScrapes());
+    if( query ) fprintf(stderr, SD_DEBUG "query service %llu requests\n", (unsigned long long)query->GetRequests());
+    if( spool ) fprintf(stderr, SD_DEBUG "spool %llu rows, %llu bytes to replay\n", (unsigned long long)dbwriter.GetSpooled(), (unsigned long long)spool->GetBacklog());
+
+    sched_file->Write( timing.str() );
+  });
+
+  // truncating WAL checkpoint at controlled times, the automatic passive
+  // checkpoints are done by the writer thread and day partition files are
+  // checkpointed when closed after midnight; run by the thread committing
+  // rows between batches since the connection is shared with it
+  if( checkpointint > 0 )
+  {
+    sched.Add("sqlite", "CHECKPOINT", checkpointint, checkpointint, 0, nullptr, [&]()
+    {
+      dbwriter.Maintain( [&]()
+      {
+        int sqlite_err = 0;
+
+        if( !main_db->Checkpoint( true, sqlite_err ) ) fprintf(stderr, SD_NOTICE "SQLite checkpoint error %d\n", sqlite_err);
+      });
+    });
+  }
+
+  // old rows deleted in small batches between the insert batches
+  if( retention.GetPolicies() > 0 && retainint > 0 )
+  {
+    sched.Add("sqlite", "RETENTION", retainint, retainint / 2.0, 0, nullptr, [&]()
+    {
+      dbwriter.Maintain( [&]()
+      {
+        int sqlite_err = 0;
+
+        if( !retention.Step( sqlite_err ) ) fprintf(stderr, SD_NOTICE "SQLite retention error %d\n", sqlite_err);
+        fprintf(stderr, SD_DEBUG "SQLite retention %llu rows deleted\n", (unsigned long long)retention.GetDeleted());
+      });
+    });
+  }
+
+  fprintf(stderr, SD_INFO "start %d reading tasks\n", sched.GetTasks() );
+  dbwriter.Start();
+  if( query && !query->Start( sqlite_err ) ) fprintf(stderr, SD_ERR "query service error %d\n", sqlite_err);
+  if( metrics && !metrics->Start( sqlite_err ) ) fprintf(stderr, SD_ERR "Prometheus metrics error %d\n", sqlite_err);
+  sched.Start();
+
+  while( cont ) sigsuspend( &oldsigs );
+
+  sched.Stop();
+  delete metrics;
+  delete mqtt;
+  delete query;
+  dbwriter.Stop();
+  for(int i = 0; i < 9; i++) delete rollup[ i ];
+  for(auto & st : tsstore) delete st;
+  delete spool;
+  delete recent;
+  delete snapshot;
 
   return 0;
 };
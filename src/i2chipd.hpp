@@ -2,7 +2,7 @@
  * 
  * Read chips with I2C interface. 
  *       
- * Copyright (C) 2020 - 2022 Jaakko Koivuniemi.
+ * Copyright (C) 2020 - 2026 Jaakko Koivuniemi.
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -20,7 +20,7 @@
  ****************************************************************************
  *
  * Fri Jul  3 20:18:46 CDT 2020
- * Edit: Wed Apr 20 20:35:46 CDT 2022
+ * Edit: Sun Oct 18 12:34:09 CDT 2026
  *
  * Jaakko Koivuniemi
  **/
@@ -43,5 +43,14 @@
 #include "Lis3dh.hpp"
 #include "Lis2mdl.hpp"
 #include "Pca9535.hpp"
+#include "Scheduler.hpp"
+#include "Rollup.hpp"
+#include "Retention.hpp"
+#include "TimeSeriesStore.hpp"
+#include "SQLiteWriter.hpp"
+#include "QueryServer.hpp"
+#include "Snapshot.hpp"
+#include "Mqtt.hpp"
+#include "Metrics.hpp"
 
 #endif
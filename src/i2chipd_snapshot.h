@@ -0,0 +1,177 @@
+/**************************************************************************
+ * 
+ * Layout of shared memory snapshot and functions for readers.
+ *       
+ * Copyright (C) 2026 Jaakko Koivuniemi.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************
+ *
+ * Sun Oct 18 10:02:51 CDT 2026
+ * Edit: Sun Oct 18 12:34:09 CDT 2026
+ *
+ * Jaakko Koivuniemi
+ **/
+
+
+
+#ifndef _I2CHIPD_SNAPSHOT_H
+#define _I2CHIPD_SNAPSHOT_H
+
+/* The latest value of every data file is kept in one POSIX shared memory
+ * segment. A reader maps the segment read-only and copies the channels
+ * without system calls. The header sequence number is odd while a value
+ * is written and changes with every write, so a copy is coherent when
+ * the number was even and did not change during the copy.
+ *
+ * The segment is replaced when i2chipd restarts, _closed_ is set in the
+ * old segment and readers should open the segment again.
+ *
+ * Usable from C and C++, needs GCC or Clang atomic builtins. Link with
+ * -lrt on old C libraries. */
+
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define I2CHIPD_SNAPSHOT_SHM "/i2chipd"    /* default shared memory name */
+#define I2CHIPD_SNAPSHOT_MAGIC 0x53434932u /* "I2CS" */
+#define I2CHIPD_SNAPSHOT_VERSION 1         /* layout version */
+#define I2CHIPD_SNAPSHOT_NAME 48           /* channel name with null */
+
+/* Segment header, followed by _channels_ channels, 64 bytes. */
+struct i2chipd_snapshot_header
+{
+  uint32_t magic;       /* I2CHIPD_SNAPSHOT_MAGIC when ready */
+  uint32_t version;     /* I2CHIPD_SNAPSHOT_VERSION */
+  uint32_t size;        /* segment size [bytes] */
+  uint32_t channels;    /* number of channels */
+  uint32_t channelsize; /* channel size [bytes] */
+  uint32_t closed;      /* nonzero when writer has stopped */
+  uint64_t seq;         /* sequence number, odd while written */
+  int64_t updated;      /* time of last write [us since epoch] */
+  uint64_t writes;      /* number of values written */
+  uint8_t reserved[ 16 ];
+};
+
+/* One channel, 64 bytes. */
+struct i2chipd_snapshot_channel
+{
+  char name[ I2CHIPD_SNAPSHOT_NAME ]; /* data file name */
+  int64_t ts;                        /* sample time [us since epoch], 0 if none */
+  double value;                      /* latest value */
+};
+
+/* Channel array after header. */
+static inline const struct i2chipd_snapshot_channel *i2chipd_snapshot_channels(const struct i2chipd_snapshot_header *h)
+{
+  return (const struct i2chipd_snapshot_channel *)( h + 1 );
+}
+
+/* Map segment read-only, return NULL if it does not exist or has other layout. */
+static inline const struct i2chipd_snapshot_header *i2chipd_snapshot_open(const char *shm, size_t *size)
+{
+  struct stat st;
+  const struct i2chipd_snapshot_header *h;
+  void *map;
+  int fd = shm_open(shm, O_RDONLY, 0);
+
+  if( fd < 0 ) return NULL;
+  if( fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof( struct i2chipd_snapshot_header ) )
+  {
+    close( fd );
+    return NULL;
+  }
+
+  map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close( fd );
+  if( map == MAP_FAILED ) return NULL;
+
+  h = (const struct i2chipd_snapshot_header *)map;
+  if( __atomic_load_n(&h->magic, __ATOMIC_ACQUIRE) != I2CHIPD_SNAPSHOT_MAGIC || h->version != I2CHIPD_SNAPSHOT_VERSION || h->channelsize != sizeof( struct i2chipd_snapshot_channel ) || h->size > (uint64_t)st.st_size )
+  {
+    munmap(map, st.st_size);
+    return NULL;
+  }
+
+  *size = st.st_size;
+
+  return h;
+}
+
+/* Unmap segment. */
+static inline void i2chipd_snapshot_close(const struct i2chipd_snapshot_header *h, size_t size)
+{
+  munmap((void *)h, size);
+}
+
+/* Copy at most max channels to channel, return number of channels and
+ * sequence number of the copy in seq if not NULL. */
+static inline uint32_t i2chipd_snapshot_read(const struct i2chipd_snapshot_header *h, struct i2chipd_snapshot_channel *channel, uint32_t max, uint64_t *seq)
+{
+  uint64_t s0, s1;
+  uint32_t n = h->channels < max ? h->channels : max;
+
+  do
+  {
+    while( ( s0 = __atomic_load_n(&h->seq, __ATOMIC_ACQUIRE) ) & 1 ) ;
+    memcpy(channel, i2chipd_snapshot_channels( h ), n * sizeof( struct i2chipd_snapshot_channel ));
+    __atomic_thread_fence( __ATOMIC_ACQUIRE );
+    s1 = __atomic_load_n(&h->seq, __ATOMIC_RELAXED);
+  }
+  while( s0 != s1 );
+
+  if( seq ) *seq = s0;
+
+  return n;
+}
+
+/* Index of channel with name or -1, names do not change after open. */
+static inline int i2chipd_snapshot_find(const struct i2chipd_snapshot_header *h, const char *name)
+{
+  const struct i2chipd_snapshot_channel *c = i2chipd_snapshot_channels( h );
+  uint32_t i;
+
+  for(i = 0; i < h->channels; i++)
+  {
+    if( strncmp(c[ i ].name, name, I2CHIPD_SNAPSHOT_NAME) == 0 ) return (int)i;
+  }
+
+  return -1;
+}
+
+/* Read value and time of one channel, return 0 if channel has no value. */
+static inline int i2chipd_snapshot_value(const struct i2chipd_snapshot_header *h, int index, double *value, int64_t *ts)
+{
+  const struct i2chipd_snapshot_channel *c = i2chipd_snapshot_channels( h ) + index;
+  uint64_t s0, s1;
+
+  do
+  {
+    while( ( s0 = __atomic_load_n(&h->seq, __ATOMIC_ACQUIRE) ) & 1 ) ;
+    *value = c->value;
+    *ts = c->ts;
+    __atomic_thread_fence( __ATOMIC_ACQUIRE );
+    s1 = __atomic_load_n(&h->seq, __ATOMIC_RELAXED);
+  }
+  while( s0 != s1 );
+
+  return *ts != 0;
+}
+
+#endif
@@ -0,0 +1,114 @@
+/**************************************************************************
+ * 
+ * Print latest values from shared memory snapshot.
+ *       
+ * Copyright (C) 2026 Jaakko Koivuniemi.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************
+ *
+ * Sun Oct 18 10:02:51 CDT 2026
+ * Edit: Sun Oct 18 12:34:09 CDT 2026
+ *
+ * Jaakko Koivuniemi
+ **/
+
+
+
+#include "i2chipd_snapshot.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <time.h>
+
+using namespace std;
+
+void printusage()
+{
+  std::cout << "Usage: snapshot [-s shm] [-i interval] [channel ...]" << std::endl;
+  std::cout << "  -s shm       shared memory name, default " << I2CHIPD_SNAPSHOT_SHM << std::endl;
+  std::cout << "  -i interval  print again every interval seconds" << std::endl;
+}
+
+/// print channels of snapshot
+
+/// Channels with a value are printed as lines _name ts value_, with
+/// channel names only those channels. The segment is opened again when
+/// i2chipd has restarted.
+int main(int argc, char **argv)
+{
+  std::string shm = I2CHIPD_SNAPSHOT_SHM;
+  double interval = 0;
+  int opt;
+
+  while( ( opt = getopt(argc, argv, "s:i:h") ) != -1 )
+  {
+    switch( opt )
+    {
+      case 's': shm = optarg; break;
+      case 'i': interval = atof( optarg ); break;
+      default: printusage(); return 0;
+    }
+  }
+
+  size_t size = 0;
+  const struct i2chipd_snapshot_header *h = i2chipd_snapshot_open(shm.c_str(), &size);
+  if( !h )
+  {
+    std::cerr << "no snapshot " << shm << std::endl;
+    return 1;
+  }
+
+  std::vector<struct i2chipd_snapshot_channel> channels;
+
+  while( true )
+  {
+    channels.resize( h->channels );
+    uint32_t n = i2chipd_snapshot_read(h, channels.data(), channels.size(), nullptr);
+
+    for(uint32_t i = 0; i < n; i++)
+    {
+      bool print = ( optind >= argc );
+      for(int a = optind; a < argc; a++) if( channels[ i ].name == std::string( argv[ a ] ) ) print = true;
+
+      if( print && channels[ i ].ts != 0 ) std::cout << channels[ i ].name << " " << channels[ i ].ts << " " << std::setprecision( 10 ) << channels[ i ].value << std::endl;
+    }
+
+    if( interval <= 0 ) break;
+
+    struct timespec wait = {(time_t)interval, (long)( ( interval - (time_t)interval ) * 1e9 )};
+    nanosleep(&wait, nullptr);
+
+    if( __atomic_load_n(&h->closed, __ATOMIC_ACQUIRE) )
+    {
+      size_t nextsize = 0;
+      const struct i2chipd_snapshot_header *next = i2chipd_snapshot_open(shm.c_str(), &nextsize);
+      if( next )
+      {
+        i2chipd_snapshot_close(h, size);
+        h = next;
+        size = nextsize;
+      }
+    }
+  }
+
+  i2chipd_snapshot_close(h, size);
+
+  return 0;
+}
@@ -0,0 +1,146 @@
+/**************************************************************************
+ * 
+ * Export compressed time series to CSV or SQLite database. 
+ *       
+ * Copyright (C) 2026 Jaakko Koivuniemi.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************
+ *
+ * Sat Oct 17 22:05:18 CDT 2026
+ * Edit: Sat Oct 17 22:05:18 CDT 2026
+ *
+ * Jaakko Koivuniemi
+ **/
+
+
+#include "TimeSeriesReader.hpp"
+#include <sqlite3.h>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+
+using namespace std;
+
+void printusage()
+{
+  std::cout << "Usage: tsexport [-l] [-f from] [-t to] [-o dbfile] dir [channel ...]" << std::endl;
+  std::cout << "  -l         list channels with points, time range and bytes" << std::endl;
+  std::cout << "  -f from    first timestamp [us since epoch]" << std::endl;
+  std::cout << "  -t to      end of time range [us since epoch]" << std::endl;
+  std::cout << "  -o dbfile  insert to table timeseries in SQLite database instead of CSV" << std::endl;
+}
+
+/// export time series from segment files
+
+/// Points of the given channels, or all channels in the directory, are
+/// printed as CSV lines _channel,ts,value_ or inserted to table
+/// _timeseries(channel, ts, value)_ in one transaction.
+int main(int argc, char **argv)
+{
+  int64_t from = 0, to = INT64_MAX;
+  std::string dbfile = "";
+  bool list = false;
+  int opt, error = 0;
+
+  while( ( opt = getopt(argc, argv, "lf:t:o:h") ) != -1 )
+  {
+    switch( opt )
+    {
+      case 'l': list = true; break;
+      case 'f': from = atoll( optarg ); break;
+      case 't': to = atoll( optarg ); break;
+      case 'o': dbfile = optarg; break;
+      default: printusage(); return 0;
+    }
+  }
+
+  if( optind >= argc )
+  {
+    printusage();
+    return 0;
+  }
+
+  std::string dir = argv[ optind ];
+  std::vector<std::string> channels;
+
+  for(int i = optind + 1; i < argc; i++) channels.push_back( argv[ i ] );
+  if( channels.empty() ) channels = TimeSeriesReader::GetChannels( dir );
+
+  sqlite3 *db = nullptr;
+  sqlite3_stmt *stmt = nullptr;
+
+  if( dbfile != "" && !list )
+  {
+    if( sqlite3_open( dbfile.c_str(), &db ) != SQLITE_OK )
+    {
+      cerr << "-- can not open " << dbfile << "\n";
+      return -1;
+    }
+
+    sqlite3_exec(db, "create table if not exists timeseries(channel varchar(60), ts integer, value real); create index if not exists timeseries_channel_ts on timeseries(channel,ts); begin;", NULL, NULL, NULL);
+    sqlite3_prepare_v2(db, "insert into timeseries (channel,ts,value) values (?,?,?)", -1, &stmt, 0);
+  }
+
+  if( list ) cout << "channel                          points       first              last               bytes\n";
+  else if( !db ) cout << "channel,ts,value\n";
+
+  cout << setprecision( 17 );
+
+  for(auto & c : channels)
+  {
+    TimeSeriesReader reader(dir, c);
+    std::vector<int64_t> ts;
+    std::vector<double> values;
+
+    if( !reader.Open( error ) ) return -1;
+
+    if( list )
+    {
+      cout << left << setw( 33 ) << c << setw( 13 ) << reader.GetPoints() << setw( 19 ) << reader.GetFirst() << setw( 19 ) << reader.GetLast() << reader.GetBytes() << "\n";
+      continue;
+    }
+
+    reader.Read(from, to, ts, values);
+
+    for(size_t i = 0; i < ts.size(); i++)
+    {
+      if( db )
+      {
+        sqlite3_bind_text(stmt, 1, c.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_int64(stmt, 2, ts[ i ]);
+        sqlite3_bind_double(stmt, 3, values[ i ]);
+        sqlite3_step( stmt );
+        sqlite3_reset( stmt );
+      }
+      else cout << c << "," << ts[ i ] << "," << values[ i ] << "\n";
+    }
+
+    if( db ) cerr << c << ": " << ts.size() << " points\n";
+  }
+
+  if( db )
+  {
+    sqlite3_finalize( stmt );
+    if( sqlite3_exec(db, "commit", NULL, NULL, NULL) != SQLITE_OK ) cerr << "-- commit failed: " << sqlite3_errmsg( db ) << "\n";
+    sqlite3_close( db );
+  }
+
+  return 0;
+};